@@ -0,0 +1,118 @@
+#ifndef GRID_MAP_H
+#define GRID_MAP_H
+
+#include <stdint.h>
+
+// Dijkstra map over a tile grid
+//
+// grid_map_build() stores in every cell its step count to the nearest goal
+// (4-connected, unit cost, so a breadth-first flood is Dijkstra). Built once
+// per change of goal, it answers "which way to the goal" for any number of
+// walkers with one lookup per neighbour, instead of each walker probing its
+// own way there.
+//
+// Everything lives in flat arrays the caller provides (width * height
+// entries each): no allocation and no recursion. Cells are indexed
+// y * width + x. A build stops at maxDistance, and the next build resets only
+// the cells the previous one reached, so a bounded map costs the area it
+// covers, not the whole grid. Plain C; usable from C++ as well.
+
+#define GRID_MAP_UNREACHED 0xFFFF
+
+// Whether a walker can stand on (x, y); user is passed through
+typedef int (*GridMapPassable)(int x, int y, void* user);
+
+typedef struct {
+    int width;
+    int height;
+    uint16_t* dist;      // Steps to the nearest goal, GRID_MAP_UNREACHED if none within reach
+    int* queue;          // Flood order; the first visitedCount entries are the reached cells
+    int visitedCount;
+} GridMap;
+
+static const int GRID_MAP_DX[4] = { 0, 1, 0, -1 };
+static const int GRID_MAP_DY[4] = { -1, 0, 1, 0 };
+
+static inline void grid_map_init(GridMap* map, int width, int height, uint16_t* dist, int* queue) {
+    map->width = width;
+    map->height = height;
+    map->dist = dist;
+    map->queue = queue;
+    map->visitedCount = 0;
+    for (int i = 0; i < width * height; i++) {
+        dist[i] = GRID_MAP_UNREACHED;
+    }
+}
+
+static inline int grid_map_contains(const GridMap* map, int x, int y) {
+    return x >= 0 && x < map->width && y >= 0 && y < map->height;
+}
+
+static inline uint16_t grid_map_distance(const GridMap* map, int x, int y) {
+    if (!grid_map_contains(map, x, y)) return GRID_MAP_UNREACHED;
+    return map->dist[y * map->width + x];
+}
+
+// Flood from goalCount goals (goals holds x, y pairs) through passable cells,
+// up to maxDistance steps. Goals are seeded even when not passable themselves
+// (a goal occupied by the player still attracts).
+static inline void grid_map_build(GridMap* map, const int* goals, int goalCount,
+                                  GridMapPassable passable, void* user, int maxDistance) {
+    for (int i = 0; i < map->visitedCount; i++) {
+        map->dist[map->queue[i]] = GRID_MAP_UNREACHED;
+    }
+    if (maxDistance >= GRID_MAP_UNREACHED) maxDistance = GRID_MAP_UNREACHED - 1;
+
+    int tail = 0;
+    for (int g = 0; g < goalCount; g++) {
+        int x = goals[g * 2];
+        int y = goals[g * 2 + 1];
+        if (!grid_map_contains(map, x, y)) continue;
+        int index = y * map->width + x;
+        if (map->dist[index] == 0) continue;
+        map->dist[index] = 0;
+        map->queue[tail++] = index;
+    }
+
+    for (int head = 0; head < tail; head++) {
+        int index = map->queue[head];
+        int next = map->dist[index] + 1;
+        if (next > maxDistance) continue;
+        int x = index % map->width;
+        int y = index / map->width;
+        for (int d = 0; d < 4; d++) {
+            int nx = x + GRID_MAP_DX[d];
+            int ny = y + GRID_MAP_DY[d];
+            if (!grid_map_contains(map, nx, ny)) continue;
+            int neighbor = ny * map->width + nx;
+            if (map->dist[neighbor] != GRID_MAP_UNREACHED) continue;
+            if (!passable(nx, ny, user)) continue;
+            map->dist[neighbor] = (uint16_t)next;
+            map->queue[tail++] = neighbor;
+        }
+    }
+    map->visitedCount = tail;
+}
+
+// Downhill step from (x, y): the neighbour nearest the goal that canEnter
+// accepts (canEnter may be null). Ties keep the first in N, E, S, W order.
+// Returns 0 with dx = dy = 0 when no neighbour is closer than (x, y).
+static inline int grid_map_step(const GridMap* map, int x, int y,
+                                GridMapPassable canEnter, void* user, int* dx, int* dy) {
+    uint16_t best = grid_map_distance(map, x, y);
+    *dx = 0;
+    *dy = 0;
+    for (int d = 0; d < 4; d++) {
+        int nx = x + GRID_MAP_DX[d];
+        int ny = y + GRID_MAP_DY[d];
+        uint16_t dist = grid_map_distance(map, nx, ny);
+        if (dist >= best) continue;
+        if (canEnter && !canEnter(nx, ny, user)) continue;
+        best = dist;
+        *dx = GRID_MAP_DX[d];
+        *dy = GRID_MAP_DY[d];
+    }
+    return *dx != 0 || *dy != 0;
+}
+
+#endif // GRID_MAP_H
@@ -3,6 +3,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <emscripten/emscripten.h>
+#include "grid_map.h"
 
 // Game constants
 #define MAP_WIDTH 50
@@ -13,6 +14,19 @@
 #define MAX_NPCS 50
 #define VIEWPORT_WIDTH 15
 #define VIEWPORT_HEIGHT 15
+#define VIEW_RADIUS 8
+#define AI_CHASE_RANGE 10   // Path steps within which monsters chase the player
+
+// Per-tile flags are bitsets indexed by TILE_INDEX
+#define TILE_COUNT (MAP_WIDTH * MAP_HEIGHT)
+#define TILE_BITSET_WORDS ((TILE_COUNT + 31) / 32)
+#define TILE_INDEX(x, y) ((y) * MAP_WIDTH + (x))
+
+// get_render_changes() layout: header, changed tiles, entities, items
+#define RENDER_CHANGE_HEADER 7
+#define RENDER_CHANGE_TILE_INTS 5
+#define RENDER_CHANGES_MAX_INTS (RENDER_CHANGE_HEADER + TILE_COUNT * RENDER_CHANGE_TILE_INTS + \
+                                 1 + MAX_ENTITIES * 7 + 1 + MAX_ITEMS * 3)
 
 // Tile types
 typedef enum {
@@ -124,13 +138,11 @@ typedef struct {
     int cooldown;
 } Entity;
 
-// Tile structure
+// Tile structure (visibility lives in GameState's bitsets)
 typedef struct {
     TileType type;
     int solid;
     int height;
-    int explored;
-    int visible;
 } Tile;
 
 // Game state
@@ -148,11 +160,31 @@ typedef struct {
     int messageTimer;
     int dungeonLevel;
     int questState;
+    
+    // Field of view: tiles in sight now, tiles ever seen, and the box the
+    // last update_visibility() covered (the only tiles that can go dark)
+    uint32_t visibleBits[TILE_BITSET_WORDS];
+    uint32_t exploredBits[TILE_BITSET_WORDS];
+    uint32_t previousBits[TILE_BITSET_WORDS];   // Scratch, all clear between updates
+    Position fovMin;
+    Position fovMax;
+    int fovValid;
+    
+    // Tiles changed since the last render export, each listed once
+    uint32_t dirtyBits[TILE_BITSET_WORDS];
+    uint16_t dirtyTiles[TILE_COUNT];
+    int dirtyCount;
+    int allDirty;
 } GameState;
 
 static GameState game;
 static uint32_t rng_state = 42;
 
+// Steps to the player, rebuilt once per turn for every monster
+static uint16_t chaseDist[MAP_WIDTH * MAP_HEIGHT];
+static int chaseQueue[MAP_WIDTH * MAP_HEIGHT];
+static GridMap chaseMap;
+
 // Random number generator
 EMSCRIPTEN_KEEPALIVE
 uint32_t random_range(uint32_t max) {
@@ -161,6 +193,51 @@ uint32_t random_range(uint32_t max) {
     return rng_state % max;
 }
 
+// Bitset helpers
+static inline int bit_get(const uint32_t* bits, int index) {
+    return (bits[index >> 5] >> (index & 31)) & 1;
+}
+
+static inline void bit_set(uint32_t* bits, int index) {
+    bits[index >> 5] |= 1u << (index & 31);
+}
+
+static inline void bit_clear(uint32_t* bits, int index) {
+    bits[index >> 5] &= ~(1u << (index & 31));
+}
+
+int tile_visible(int x, int y) {
+    return bit_get(game.visibleBits, TILE_INDEX(x, y));
+}
+
+int tile_explored(int x, int y) {
+    return bit_get(game.exploredBits, TILE_INDEX(x, y));
+}
+
+// Render code for a tile: 1 visible, 2 explored, 0 unknown
+int tile_visibility(int x, int y) {
+    int index = TILE_INDEX(x, y);
+    if (bit_get(game.visibleBits, index)) return 1;
+    return bit_get(game.exploredBits, index) ? 2 : 0;
+}
+
+// Queue a tile for the next get_render_changes()
+void mark_tile_dirty(int index) {
+    if (game.allDirty || bit_get(game.dirtyBits, index)) return;
+    bit_set(game.dirtyBits, index);
+    game.dirtyTiles[game.dirtyCount++] = (uint16_t)index;
+}
+
+// New map: nothing seen yet, and every tile must be sent again
+void reset_visibility() {
+    memset(game.visibleBits, 0, sizeof(game.visibleBits));
+    memset(game.exploredBits, 0, sizeof(game.exploredBits));
+    memset(game.dirtyBits, 0, sizeof(game.dirtyBits));
+    game.dirtyCount = 0;
+    game.allDirty = 1;
+    game.fovValid = 0;
+}
+
 // Distance calculation
 int distance(int x1, int y1, int x2, int y2) {
     int dx = abs(x2 - x1);
@@ -204,10 +281,9 @@ void generate_dungeon(int level) {
                 game.map[x][y].solid = isWall;
             }
             game.map[x][y].height = 0;
-            game.map[x][y].explored = 0;
-            game.map[x][y].visible = 0;
         }
     }
+    reset_visibility();
     
     // Apply cellular automata
     for (int iteration = 0; iteration < 5; iteration++) {
@@ -267,11 +343,9 @@ void generate_world() {
                 game.map[x][y].solid = 1;
                 game.map[x][y].height = 4;
             }
-            
-            game.map[x][y].explored = 0;
-            game.map[x][y].visible = 0;
         }
     }
+    reset_visibility();
     
     // Add some structures
     for (int i = 0; i < 5; i++) {
@@ -504,6 +578,7 @@ void spawn_items() {
 EMSCRIPTEN_KEEPALIVE
 void init_game() {
     memset(&game, 0, sizeof(game));
+    grid_map_init(&chaseMap, MAP_WIDTH, MAP_HEIGHT, chaseDist, chaseQueue);
     
     // Generate world
     if (game.dungeonLevel == 0) {
@@ -683,9 +758,28 @@ int move_entity(int entityId, int dx, int dy) {
     return 1;
 }
 
+// Terrain a monster can path through (other monsters are ignored)
+int chase_passable(int x, int y, void* user) {
+    (void)user;
+    return !game.map[x][y].solid;
+}
+
+// A chase step may land on the player (an attack) or on a free tile
+int chase_can_enter(int x, int y, void* user) {
+    const Entity* player = (const Entity*)user;
+    if (player->pos.x == x && player->pos.y == y) return 1;
+    return is_walkable(x, y);
+}
+
 // Update AI
+//
+// One Dijkstra map toward the player per turn, up to AI_CHASE_RANGE steps;
+// a monster inside it walks downhill, around walls, and attacks on
+// reaching the player. Monsters out of reach wander.
 void update_ai() {
     Entity* player = &game.entities[game.playerEntityId];
+    int goal[2] = { player->pos.x, player->pos.y };
+    grid_map_build(&chaseMap, goal, 1, chase_passable, NULL, AI_CHASE_RANGE);
     
     for (int i = 1; i < MAX_ENTITIES; i++) {
         Entity* entity = &game.entities[i];
@@ -696,31 +790,20 @@ void update_ai() {
             continue;
         }
         
-        int dist = distance(entity->pos.x, entity->pos.y, 
-                          player->pos.x, player->pos.y);
+        uint16_t steps = grid_map_distance(&chaseMap, entity->pos.x, entity->pos.y);
         
-        // Simple AI: move towards player if close enough
-        if (dist <= 8 && dist > 1) {
-            int dx = 0, dy = 0;
-            
-            if (player->pos.x > entity->pos.x) dx = 1;
-            else if (player->pos.x < entity->pos.x) dx = -1;
-            
-            if (player->pos.y > entity->pos.y) dy = 1;
-            else if (player->pos.y < entity->pos.y) dy = -1;
-            
-            // Try to move
-            if (random_range(2) == 0 && dx != 0) {
-                move_entity(i, dx, 0);
-            } else if (dy != 0) {
-                move_entity(i, 0, dy);
+        if (steps != GRID_MAP_UNREACHED) {
+            int dx, dy;
+            if (grid_map_step(&chaseMap, entity->pos.x, entity->pos.y,
+                              chase_can_enter, player, &dx, &dy)) {
+                move_entity(i, dx, dy);
             }
             
             entity->cooldown = 10 - entity->stats.speed;
             if (entity->cooldown < 0) entity->cooldown = 0;
         }
         // Random movement if far from player
-        else if (dist > 8 && random_range(100) < 20) {
+        else if (random_range(100) < 20) {
             int dir = random_range(4);
             switch(dir) {
                 case 0: move_entity(i, 0, -1); break;
@@ -733,30 +816,130 @@ void update_ai() {
     }
 }
 
+// Tiles that block line of sight
+int is_opaque(int x, int y) {
+    if (x < 0 || x >= MAP_WIDTH || y < 0 || y >= MAP_HEIGHT) return 1;
+    switch (game.map[x][y].type) {
+        case TILE_WALL:
+        case TILE_TREE:
+        case TILE_MOUNTAIN:
+        case TILE_DUNGEON_WALL:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// A tile is in sight this update; queue it when its render code changes
+void reveal_tile(int x, int y) {
+    if (x < 0 || x >= MAP_WIDTH || y < 0 || y >= MAP_HEIGHT) return;
+    int index = TILE_INDEX(x, y);
+    if (bit_get(game.visibleBits, index)) return;
+    bit_set(game.visibleBits, index);
+    if (!bit_get(game.exploredBits, index)) {
+        bit_set(game.exploredBits, index);
+        mark_tile_dirty(index);
+    } else if (!bit_get(game.previousBits, index)) {
+        mark_tile_dirty(index);
+    }
+}
+
+// Octant transforms for cast_light: xx, xy, yx, yy
+static const int FOV_OCTANTS[8][4] = {
+    { 1,  0,  0,  1}, { 0,  1,  1,  0}, { 0, -1,  1,  0}, {-1,  0,  0,  1},
+    {-1,  0,  0, -1}, { 0, -1, -1,  0}, { 0,  1, -1,  0}, { 1,  0,  0, -1}
+};
+
+// Recursive shadowcasting over one octant, rows row..radius, between the
+// start and end slopes. Rows are Chebyshev rings, so the lit area is the
+// same square the view radius always covered, minus what walls hide.
+void cast_light(int cx, int cy, int row, float start, float end, int radius,
+                int xx, int xy, int yx, int yy) {
+    if (start < end) return;
+    
+    float newStart = 0.0f;
+    for (int j = row; j <= radius; j++) {
+        int dx = -j - 1;
+        int dy = -j;
+        int blocked = 0;
+        
+        while (dx <= 0) {
+            dx++;
+            float leftSlope = (dx - 0.5f) / (dy + 0.5f);
+            float rightSlope = (dx + 0.5f) / (dy - 0.5f);
+            if (start < rightSlope) continue;
+            if (end > leftSlope) break;
+            
+            int x = cx + dx * xx + dy * xy;
+            int y = cy + dx * yx + dy * yy;
+            reveal_tile(x, y);
+            
+            int opaque = is_opaque(x, y);
+            if (blocked) {
+                if (opaque) {
+                    newStart = rightSlope;
+                    continue;
+                }
+                blocked = 0;
+                start = newStart;
+            } else if (opaque && j < radius) {
+                // Start of a wall run: light past it in a child scan
+                blocked = 1;
+                cast_light(cx, cy, j + 1, start, leftSlope, radius, xx, xy, yx, yy);
+                newStart = rightSlope;
+            }
+        }
+        if (blocked) break;
+    }
+}
+
 // Update visibility
+//
+// Only the last update's box can lose visibility and only the new box can
+// gain it, so a move costs O(VIEW_RADIUS^2) whatever the map size. Tiles
+// whose render code changed are queued for get_render_changes().
 void update_visibility() {
     Entity* player = &game.entities[game.playerEntityId];
-    int viewRange = 8;
+    int px = player->pos.x;
+    int py = player->pos.y;
     
-    // Reset visibility
-    for (int x = 0; x < MAP_WIDTH; x++) {
-        for (int y = 0; y < MAP_HEIGHT; y++) {
-            game.map[x][y].visible = 0;
+    // Move the old field into the scratch set
+    if (game.fovValid) {
+        for (int y = game.fovMin.y; y <= game.fovMax.y; y++) {
+            for (int x = game.fovMin.x; x <= game.fovMax.x; x++) {
+                int index = TILE_INDEX(x, y);
+                if (bit_get(game.visibleBits, index)) {
+                    bit_clear(game.visibleBits, index);
+                    bit_set(game.previousBits, index);
+                }
+            }
         }
     }
     
-    // Simple visibility calculation
-    for (int x = player->pos.x - viewRange; x <= player->pos.x + viewRange; x++) {
-        for (int y = player->pos.y - viewRange; y <= player->pos.y + viewRange; y++) {
-            if (x >= 0 && x < MAP_WIDTH && y >= 0 && y < MAP_HEIGHT) {
-                int dist = distance(x, y, player->pos.x, player->pos.y);
-                if (dist <= viewRange) {
-                    game.map[x][y].visible = 1;
-                    game.map[x][y].explored = 1;
+    reveal_tile(px, py);
+    for (int octant = 0; octant < 8; octant++) {
+        const int* m = FOV_OCTANTS[octant];
+        cast_light(px, py, 1, 1.0f, 0.0f, VIEW_RADIUS, m[0], m[1], m[2], m[3]);
+    }
+    
+    // Whatever was lit before and is not now went dark
+    if (game.fovValid) {
+        for (int y = game.fovMin.y; y <= game.fovMax.y; y++) {
+            for (int x = game.fovMin.x; x <= game.fovMax.x; x++) {
+                int index = TILE_INDEX(x, y);
+                if (bit_get(game.previousBits, index)) {
+                    bit_clear(game.previousBits, index);
+                    if (!bit_get(game.visibleBits, index)) mark_tile_dirty(index);
                 }
             }
         }
     }
+    
+    game.fovMin.x = px - VIEW_RADIUS < 0 ? 0 : px - VIEW_RADIUS;
+    game.fovMin.y = py - VIEW_RADIUS < 0 ? 0 : py - VIEW_RADIUS;
+    game.fovMax.x = px + VIEW_RADIUS >= MAP_WIDTH ? MAP_WIDTH - 1 : px + VIEW_RADIUS;
+    game.fovMax.y = py + VIEW_RADIUS >= MAP_HEIGHT ? MAP_HEIGHT - 1 : py + VIEW_RADIUS;
+    game.fovValid = 1;
 }
 
 // Player movement
@@ -843,37 +1026,8 @@ void use_item(int inventorySlot) {
     game.messageTimer = 90;
 }
 
-// Get render data
-EMSCRIPTEN_KEEPALIVE
-void get_render_data(int* buffer) {
-    int index = 0;
-    
-    // Pack viewport dimensions
-    buffer[index++] = VIEWPORT_WIDTH;
-    buffer[index++] = VIEWPORT_HEIGHT;
-    buffer[index++] = game.camera.x;
-    buffer[index++] = game.camera.y;
-    
-    // Pack visible map tiles
-    for (int y = 0; y < VIEWPORT_HEIGHT; y++) {
-        for (int x = 0; x < VIEWPORT_WIDTH; x++) {
-            int worldX = game.camera.x + x;
-            int worldY = game.camera.y + y;
-            
-            if (worldX >= 0 && worldX < MAP_WIDTH && 
-                worldY >= 0 && worldY < MAP_HEIGHT) {
-                Tile* tile = &game.map[worldX][worldY];
-                buffer[index++] = tile->type;
-                buffer[index++] = tile->height;
-                buffer[index++] = tile->visible ? 1 : (tile->explored ? 2 : 0);
-            } else {
-                buffer[index++] = 0;
-                buffer[index++] = 0;
-                buffer[index++] = 0;
-            }
-        }
-    }
-    
+// Pack visible entities and items after the tiles; returns the next index
+int pack_entities_and_items(int* buffer, int index) {
     // Pack visible entities
     int entityCount = 0;
     int entityCountIndex = index++;
@@ -889,7 +1043,7 @@ void get_render_data(int* buffer) {
             relY >= 0 && relY < VIEWPORT_HEIGHT) {
             
             // Check visibility
-            if (!game.map[entity->pos.x][entity->pos.y].visible && 
+            if (!tile_visible(entity->pos.x, entity->pos.y) && 
                 entity->type != ENTITY_PLAYER) continue;
             
             buffer[index++] = entity->type;
@@ -919,7 +1073,7 @@ void get_render_data(int* buffer) {
             relY >= 0 && relY < VIEWPORT_HEIGHT) {
             
             // Check visibility
-            if (!game.map[item->pos.x][item->pos.y].visible) continue;
+            if (!tile_visible(item->pos.x, item->pos.y)) continue;
             
             buffer[index++] = item->type;
             buffer[index++] = relX;
@@ -928,6 +1082,96 @@ void get_render_data(int* buffer) {
         }
     }
     buffer[itemCountIndex] = itemCount;
+    return index;
+}
+
+// Forget queued tile changes once they have been sent
+void clear_tile_changes() {
+    for (int i = 0; i < game.dirtyCount; i++) {
+        bit_clear(game.dirtyBits, game.dirtyTiles[i]);
+    }
+    game.dirtyCount = 0;
+    game.allDirty = 0;
+}
+
+// Get render data
+//
+// Full viewport: every tile under the camera, then entities and items.
+// It leaves the get_render_changes() queue alone: field of view reaches
+// past the viewport, so the queue also holds tiles this never sends.
+EMSCRIPTEN_KEEPALIVE
+void get_render_data(int* buffer) {
+    int index = 0;
+    
+    // Pack viewport dimensions
+    buffer[index++] = VIEWPORT_WIDTH;
+    buffer[index++] = VIEWPORT_HEIGHT;
+    buffer[index++] = game.camera.x;
+    buffer[index++] = game.camera.y;
+    
+    // Pack visible map tiles
+    for (int y = 0; y < VIEWPORT_HEIGHT; y++) {
+        for (int x = 0; x < VIEWPORT_WIDTH; x++) {
+            int worldX = game.camera.x + x;
+            int worldY = game.camera.y + y;
+            
+            if (worldX >= 0 && worldX < MAP_WIDTH && 
+                worldY >= 0 && worldY < MAP_HEIGHT) {
+                Tile* tile = &game.map[worldX][worldY];
+                buffer[index++] = tile->type;
+                buffer[index++] = tile->height;
+                buffer[index++] = tile_visibility(worldX, worldY);
+            } else {
+                buffer[index++] = 0;
+                buffer[index++] = 0;
+                buffer[index++] = 0;
+            }
+        }
+    }
+    
+    pack_entities_and_items(buffer, index);
+}
+
+// Get render changes
+//
+// Only the tiles whose type, height or visibility changed since the last
+// export, in world coordinates, for a JS-side copy of the map:
+//   [viewportW, viewportH, cameraX, cameraY, mapW, mapH, changedCount,
+//    changedCount x (worldX, worldY, type, height, visibility),
+//    entities and items as in get_render_data]
+// A new map sends every tile once. The buffer must hold
+// get_render_changes_size() ints. Returns the number of ints written.
+EMSCRIPTEN_KEEPALIVE
+int get_render_changes(int* buffer) {
+    int index = 0;
+    buffer[index++] = VIEWPORT_WIDTH;
+    buffer[index++] = VIEWPORT_HEIGHT;
+    buffer[index++] = game.camera.x;
+    buffer[index++] = game.camera.y;
+    buffer[index++] = MAP_WIDTH;
+    buffer[index++] = MAP_HEIGHT;
+    
+    int count = game.allDirty ? TILE_COUNT : game.dirtyCount;
+    buffer[index++] = count;
+    for (int i = 0; i < count; i++) {
+        int tileIndex = game.allDirty ? i : game.dirtyTiles[i];
+        int x = tileIndex % MAP_WIDTH;
+        int y = tileIndex / MAP_WIDTH;
+        Tile* tile = &game.map[x][y];
+        buffer[index++] = x;
+        buffer[index++] = y;
+        buffer[index++] = tile->type;
+        buffer[index++] = tile->height;
+        buffer[index++] = tile_visibility(x, y);
+    }
+    clear_tile_changes();
+    
+    return pack_entities_and_items(buffer, index);
+}
+
+EMSCRIPTEN_KEEPALIVE
+int get_render_changes_size() {
+    return RENDER_CHANGES_MAX_INTS;
 }
 
 // Get player stats
@@ -0,0 +1,38 @@
+#!/bin/bash
+
+# Build and run the headless engine benchmark (wasm/benchmarks/engine_benchmark.cpp)
+#
+# Compiles the engine core natively, i.e. every wasm/src translation unit that
+# does not include Emscripten headers (the bindings layer is left out). Extra
+# arguments are passed to the benchmark, e.g.
+#   scripts/bench-native.sh --scenario wolfpacks --frames 2000 --csv
+# CXX picks the compiler; BENCH_FLAGS adds flags (e.g. "-g -fno-omit-frame-pointer"
+# for perf/VTune).
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+ROOT_DIR="$(dirname "$SCRIPT_DIR")"
+WASM_DIR="$ROOT_DIR/wasm"
+OUT_DIR="$ROOT_DIR/build/native"
+CXX="${CXX:-c++}"
+
+if ! command -v "$CXX" &> /dev/null; then
+    echo "Error: no C++ compiler found (set CXX)."
+    exit 1
+fi
+
+SOURCES=$(grep -L "emscripten/" $(find "$WASM_DIR/src" -name '*.cpp' | sort))
+
+mkdir -p "$OUT_DIR"
+
+echo "Building native engine benchmark with $CXX..."
+$CXX $SOURCES "$WASM_DIR/benchmarks/engine_benchmark.cpp" \
+    -I"$WASM_DIR/include" \
+    -std=c++20 \
+    -O3 -ffast-math \
+    -DNDEBUG \
+    $BENCH_FLAGS \
+    -o "$OUT_DIR/engine_benchmark"
+
+"$OUT_DIR/engine_benchmark" "$@"
@@ -0,0 +1,65 @@
+#!/bin/bash
+
+# Build the headless dedicated server (wasm/server/dedicated_server.cpp)
+#
+# The engine core, i.e. every wasm/src translation unit that does not include
+# Emscripten headers, is archived into build/native/libsmash_engine.a for
+# native hosts to link, and the server and the balance sweep tool
+# (wasm/server/balance_sweep.cpp) are linked against it. Arguments are
+# passed to the server when --run is given first, e.g.
+#   scripts/build-server.sh --run --matches 200 --workers 4 --seconds 30
+# CXX picks the compiler; SERVER_FLAGS adds flags (e.g. "-g -fsanitize=thread").
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+ROOT_DIR="$(dirname "$SCRIPT_DIR")"
+WASM_DIR="$ROOT_DIR/wasm"
+OUT_DIR="$ROOT_DIR/build/native"
+OBJ_DIR="$OUT_DIR/engine_objects"
+CXX="${CXX:-c++}"
+AR="${AR:-ar}"
+
+RUN=false
+if [ "$1" = "--run" ]; then
+    RUN=true
+    shift
+fi
+
+if ! command -v "$CXX" &> /dev/null; then
+    echo "Error: no C++ compiler found (set CXX)."
+    exit 1
+fi
+
+FLAGS="-I$WASM_DIR/include -std=c++20 -O3 -ffast-math -DNDEBUG -pthread $SERVER_FLAGS"
+SOURCES=$(grep -L "emscripten/" $(find "$WASM_DIR/src" -name '*.cpp' | sort))
+
+rm -rf "$OBJ_DIR"
+mkdir -p "$OBJ_DIR"
+
+echo "Building native engine library with $CXX..."
+PIDS=()
+for source in $SOURCES; do
+    # Flatten the path so same-named files in different folders do not clash
+    object="$OBJ_DIR/$(echo "${source#$WASM_DIR/src/}" | tr '/' '_').o"
+    $CXX $FLAGS -c "$source" -o "$object" &
+    PIDS+=($!)
+done
+# A bare wait returns 0 whatever the compiles did
+for pid in "${PIDS[@]}"; do
+    wait "$pid" || exit 1
+done
+rm -f "$OUT_DIR/libsmash_engine.a"
+$AR rcs "$OUT_DIR/libsmash_engine.a" "$OBJ_DIR"/*.o
+
+echo "Building dedicated server and balance sweep..."
+$CXX $FLAGS "$WASM_DIR/server/dedicated_server.cpp" "$OUT_DIR/libsmash_engine.a" \
+    -o "$OUT_DIR/dedicated_server"
+$CXX $FLAGS "$WASM_DIR/server/balance_sweep.cpp" "$OUT_DIR/libsmash_engine.a" \
+    -o "$OUT_DIR/balance_sweep"
+
+echo "Built build/native/libsmash_engine.a, build/native/dedicated_server and build/native/balance_sweep"
+
+if [ "$RUN" = true ]; then
+    "$OUT_DIR/dedicated_server" "$@"
+fi
@@ -0,0 +1,59 @@
+#!/bin/bash
+
+# Build the pthread variant of the game engine (public/game_engine_threads.js)
+#
+# The threaded module needs SharedArrayBuffer, so it only loads on pages served
+# cross-origin isolated (COOP: same-origin, COEP: require-corp). The loader in
+# src/game/wasm-loader.js falls back to public/game_engine.js otherwise.
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+ROOT_DIR="$(dirname "$SCRIPT_DIR")"
+WASM_DIR="$ROOT_DIR/wasm"
+OUT_DIR="$ROOT_DIR/public"
+
+echo "Building threaded game engine WASM module..."
+
+# Check if emscripten is installed
+if ! command -v em++ &> /dev/null; then
+    echo "Error: Emscripten (em++) is not installed."
+    echo "Please install Emscripten first: https://emscripten.org/docs/getting_started/downloads.html"
+    exit 1
+fi
+
+SOURCES=$(find "$WASM_DIR/src" -name '*.cpp' | sort)
+
+mkdir -p "$OUT_DIR"
+
+# Workers are started by JobSystem as hardware_concurrency() - 1 (max 7);
+# the pool is pre-spawned at that size so thread creation never blocks
+em++ $SOURCES \
+    -I"$WASM_DIR/include" \
+    -std=c++20 \
+    -O3 -flto -ffast-math -msimd128 \
+    -DNDEBUG \
+    -DTHREADING_ENABLED \
+    -pthread \
+    -Wno-pthreads-mem-growth \
+    -s WASM=1 \
+    -s MODULARIZE=1 \
+    -s EXPORT_NAME='GameEngineModule' \
+    -s EXPORT_ES6=1 \
+    -s ENVIRONMENT='web,worker' \
+    -s PTHREAD_POOL_SIZE='Math.max(1, Math.min((navigator.hardwareConcurrency || 2) - 1, 7))' \
+    -s ALLOW_MEMORY_GROWTH=1 \
+    -s INITIAL_MEMORY=33554432 \
+    -s MAXIMUM_MEMORY=268435456 \
+    -s FILESYSTEM=0 \
+    -s NO_EXIT_RUNTIME=1 \
+    --bind \
+    -o "$OUT_DIR/game_engine_threads.js"
+
+if [ $? -eq 0 ]; then
+    echo "Build successful!"
+    echo "Generated files: public/game_engine_threads.js and public/game_engine_threads.wasm"
+else
+    echo "Build failed!"
+    exit 1
+fi
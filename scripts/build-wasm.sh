@@ -0,0 +1,129 @@
+#!/bin/bash
+
+# Build the single-threaded game engine (public/game_engine.js + .wasm)
+#
+# One engine, one set of bindings: every wasm/src translation unit, with the
+# optional modules from wasm/include/config/engine_features.h switched by
+# --without. Modes:
+#   --release   -O3, tuned for frame time (default)
+#   --size      -Oz, smallest download and fastest instantiate (mobile)
+# A size report (raw, gzip and, when available, brotli) is printed after
+# every build; --report prints it for the current artifacts without building.
+#
+#   scripts/build-wasm.sh --size --without wolf-ai,effects
+#   scripts/build-wasm.sh --report
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+ROOT_DIR="$(dirname "$SCRIPT_DIR")"
+WASM_DIR="$ROOT_DIR/wasm"
+OUT_DIR="$ROOT_DIR/public"
+OUT_NAME="game_engine"
+
+MODE=release
+WITHOUT=""
+REPORT_ONLY=false
+
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --release) MODE=release ;;
+        --size) MODE=size ;;
+        --without) WITHOUT="$2"; shift ;;
+        --without=*) WITHOUT="${1#*=}" ;;
+        --out) OUT_NAME="$2"; shift ;;
+        --report) REPORT_ONLY=true ;;
+        --help)
+            echo "Usage: $0 [--release | --size] [--without camera,targeting,wolf-ai,effects] [--out NAME] [--report]"
+            exit 0
+            ;;
+        *) echo "Unknown parameter: $1"; exit 1 ;;
+    esac
+    shift
+done
+
+size_report() {
+    echo ""
+    echo "Size report ($OUT_NAME):"
+    printf "  %-24s %10s %10s %10s\n" "file" "raw" "gzip" "brotli"
+    for file in "$OUT_DIR/$OUT_NAME.wasm" "$OUT_DIR/$OUT_NAME.js"; do
+        if [ ! -f "$file" ]; then
+            printf "  %-24s %10s\n" "$(basename "$file")" "missing"
+            continue
+        fi
+        raw=$(wc -c < "$file")
+        gz=$(gzip -9 -c "$file" | wc -c)
+        br="-"
+        if command -v brotli &> /dev/null; then
+            br=$(brotli -c -q 11 "$file" | wc -c)
+        fi
+        printf "  %-24s %10s %10s %10s\n" "$(basename "$file")" "$raw" "$gz" "$br"
+    done
+}
+
+if [ "$REPORT_ONLY" = true ]; then
+    size_report
+    exit 0
+fi
+
+echo "Building game engine WASM module ($MODE)..."
+
+# Check if emscripten is installed
+if ! command -v em++ &> /dev/null; then
+    echo "Error: Emscripten (em++) is not installed."
+    echo "Please install Emscripten first: https://emscripten.org/docs/getting_started/downloads.html"
+    exit 1
+fi
+
+FEATURES=""
+EXCLUDE=""
+for feature in ${WITHOUT//,/ }; do
+    case $feature in
+        camera) FEATURES="$FEATURES -DENGINE_FEATURE_CAMERA=0" ;;
+        targeting) FEATURES="$FEATURES -DENGINE_FEATURE_TARGETING=0" ;;
+        # The pack AI (wasm/src/ai) is only reachable through wolves
+        wolf-ai) FEATURES="$FEATURES -DENGINE_FEATURE_WOLF_AI=0"; EXCLUDE="$WASM_DIR/src/ai/" ;;
+        effects) FEATURES="$FEATURES -DENGINE_FEATURE_EFFECTS=0" ;;
+        *) echo "Unknown feature: $feature"; exit 1 ;;
+    esac
+done
+
+SOURCES=$(find "$WASM_DIR/src" -name '*.cpp' | sort)
+if [ -n "$EXCLUDE" ]; then
+    SOURCES=$(echo "$SOURCES" | grep -v "^$EXCLUDE")
+fi
+
+if [ "$MODE" = size ]; then
+    # -Oz for code size; closure minifies the JS glue, and no SIMD keeps it
+    # loadable on older mobile engines
+    OPT_FLAGS="-Oz -flto --closure 1"
+else
+    OPT_FLAGS="-O3 -flto -msimd128"
+fi
+
+mkdir -p "$OUT_DIR"
+
+em++ $SOURCES \
+    -I"$WASM_DIR/include" \
+    -std=c++20 \
+    $OPT_FLAGS \
+    -ffast-math \
+    -DNDEBUG \
+    $FEATURES \
+    -s WASM=1 \
+    -s MODULARIZE=1 \
+    -s EXPORT_NAME='GameEngineModule' \
+    -s EXPORT_ES6=1 \
+    -s ENVIRONMENT='web' \
+    -s ALLOW_MEMORY_GROWTH=1 \
+    -s INITIAL_MEMORY=16777216 \
+    -s MAXIMUM_MEMORY=268435456 \
+    -s FILESYSTEM=0 \
+    -s NO_EXIT_RUNTIME=1 \
+    -s ASSERTIONS=0 \
+    --bind \
+    -o "$OUT_DIR/$OUT_NAME.js"
+
+echo "Build successful!"
+echo "Generated files: public/$OUT_NAME.js and public/$OUT_NAME.wasm"
+size_report
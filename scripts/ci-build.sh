@@ -29,7 +29,7 @@ check_wasm_cache() {
         # Check if source files are newer than built files
         WASM_OUTDATED=false
         
-        for src in wasm/*.cpp wasm/include/*.h; do
+        for src in $(find wasm/src wasm/include -name '*.cpp' -o -name '*.h'); do
             if [ -f "$src" ] && [ "$src" -nt "public/game_engine.wasm" ]; then
                 WASM_OUTDATED=true
                 break
@@ -0,0 +1,98 @@
+#!/bin/bash
+
+# Build and run the native engine tests (tests/native/test_*.cpp)
+#
+# The engine core, i.e. every wasm/src translation unit that does not include
+# Emscripten headers, is archived into build/native/test/libsmash_engine.a
+# with assertions on, and each test file is linked against it and run. An
+# argument limits the run to tests whose name contains it, e.g.
+#   scripts/test-native.sh round_trip
+# test_vector_math is also built with the wasm_simd128 shim, so the SIMD
+# lane code runs on the host, and with em++ (when installed) as a real
+# -msimd128 module under node. Each of those builds also prints its kernel
+# timings over 4096 entities.
+# CXX picks the compiler; TEST_FLAGS adds flags (e.g. "-fsanitize=address").
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+ROOT_DIR="$(dirname "$SCRIPT_DIR")"
+WASM_DIR="$ROOT_DIR/wasm"
+TEST_DIR="$ROOT_DIR/tests/native"
+OUT_DIR="$ROOT_DIR/build/native/test"
+OBJ_DIR="$OUT_DIR/engine_objects"
+CXX="${CXX:-c++}"
+AR="${AR:-ar}"
+
+if ! command -v "$CXX" &> /dev/null; then
+    echo "Error: no C++ compiler found (set CXX)."
+    exit 1
+fi
+
+FLAGS="-I$WASM_DIR/include -std=c++20 -O2 -g -ffast-math -pthread $TEST_FLAGS"
+# Keeps the reference loops in test_vector_math scalar
+NO_VECTORIZE="-fno-tree-vectorize -fno-tree-slp-vectorize"
+SOURCES=$(grep -L "emscripten/" $(find "$WASM_DIR/src" -name '*.cpp' | sort))
+
+rm -rf "$OBJ_DIR"
+mkdir -p "$OBJ_DIR"
+
+echo "Building native engine library with $CXX..."
+PIDS=()
+for source in $SOURCES; do
+    object="$OBJ_DIR/$(echo "${source#$WASM_DIR/src/}" | tr '/' '_').o"
+    $CXX $FLAGS -c "$source" -o "$object" &
+    PIDS+=($!)
+done
+# A bare wait returns 0 whatever the compiles did
+for pid in "${PIDS[@]}"; do
+    wait "$pid" || exit 1
+done
+rm -f "$OUT_DIR/libsmash_engine.a"
+$AR rcs "$OUT_DIR/libsmash_engine.a" "$OBJ_DIR"/*.o
+
+FAILED=()
+run() {
+    local name="$1"
+    shift
+    echo ""
+    echo "== $name"
+    if ! "$@"; then
+        FAILED+=("$name")
+    fi
+}
+
+for test in "$TEST_DIR"/test_*.cpp; do
+    name=$(basename "$test" .cpp)
+    extra=""
+    [ "$name" = "test_vector_math" ] && extra="$NO_VECTORIZE"
+    $CXX $FLAGS $extra "$test" "$OUT_DIR/libsmash_engine.a" -o "$OUT_DIR/$name"
+    run "$name" "$OUT_DIR/$name" "$@"
+done
+
+# The SIMD lane code of the VectorMath kernels, on the host through the shim
+$CXX $FLAGS $NO_VECTORIZE -D__wasm_simd128__ -I"$TEST_DIR/wasm_simd128_shim" \
+    "$TEST_DIR/test_vector_math.cpp" -o "$OUT_DIR/test_vector_math_simd"
+run "test_vector_math (simd128 shim)" "$OUT_DIR/test_vector_math_simd" "$@"
+if [ $# -eq 0 ]; then
+    "$OUT_DIR/test_vector_math" --bench 4096
+    "$OUT_DIR/test_vector_math_simd" --bench 4096
+fi
+
+# And as real WebAssembly SIMD
+if command -v em++ &> /dev/null && command -v node &> /dev/null; then
+    em++ -I"$WASM_DIR/include" -std=c++20 -O3 -ffast-math -msimd128 $NO_VECTORIZE \
+        -sENVIRONMENT=node "$TEST_DIR/test_vector_math.cpp" -o "$OUT_DIR/test_vector_math_wasm.js"
+    run "test_vector_math (wasm -msimd128, node)" node "$OUT_DIR/test_vector_math_wasm.js" "$@"
+    [ $# -eq 0 ] && node "$OUT_DIR/test_vector_math_wasm.js" --bench 4096
+else
+    echo ""
+    echo "em++ or node not found: skipping the wasm -msimd128 build of test_vector_math"
+fi
+
+echo ""
+if [ ${#FAILED[@]} -ne 0 ]; then
+    echo "Failed: ${FAILED[*]}"
+    exit 1
+fi
+echo "All native tests passed"
@@ -52,6 +52,9 @@ export const EVENTS = {
     BOSS_ATTACK: 'boss:attack',
     BOSS_DEFEATED: 'boss:defeated',
     
+    // WASM engine gameplay events, one batch per frame (src/game/engine-events.js)
+    ENGINE_EVENTS: 'engine:events',
+    
     // System events
     GAME_START: 'game:start',
     GAME_PAUSE: 'game:pause',
@@ -31,6 +31,10 @@ export class DebugPanel {
         // Live adjustments
         this.liveAdjustments = {};
         
+        // WASM module, for engine tracing
+        this.wasmModule = null;
+        this.traceFrames = 300;
+        
         // Create panel UI
         this.createPanel();
         this.setupEventListeners();
@@ -356,7 +360,47 @@ export class DebugPanel {
             `;
         }
         
+        // Engine heap, per subsystem
+        const heap = this.getEngineHeapReport();
+        if (heap && heap.tracking) {
+            const mb = (bytes) => (bytes / 1048576).toFixed(2);
+            html += '<h4>🧮 Engine Heap</h4>';
+            html += `<div style="border: 1px solid #0f0; padding: 10px; margin-bottom: 10px;">
+                <div>WASM heap: ${mb(heap.heapSize)} MB</div>
+                <table style="width: 100%; font-size: 10px; margin-top: 5px;">
+                    <tr><th align="left">tag</th><th align="right">live MB</th><th align="right">peak MB</th><th align="right">allocs/frame</th></tr>`;
+            Object.entries(heap.tags).forEach(([tag, stats]) => {
+                const color = stats.overBudget ? '#f00' : '#0f0';
+                html += `<tr style="color: ${color};">
+                        <td>${tag}</td>
+                        <td align="right">${mb(stats.liveBytes)}</td>
+                        <td align="right">${mb(stats.peakBytes)}</td>
+                        <td align="right">${stats.frameAllocations}</td>
+                    </tr>`;
+            });
+            html += '</table>';
+            heap.growth.slice(-5).forEach(event => {
+                html += `<div style="font-size: 10px; color: #ff0;">
+                    Frame ${event.frame}: heap ${mb(event.fromBytes)} → ${mb(event.toBytes)} MB (${event.tag})
+                </div>`;
+            });
+            html += '</div>';
+        }
+        
+        // Engine frame trace
+        if (this.wasmModule && this.wasmModule.dumpTrace) {
+            html += '<h4>🔬 Engine Trace</h4>';
+            html += `
+                <div style="margin-bottom: 10px;">
+                    <button class="debug-btn" onclick="debugPanel.dumpTrace()">Dump Last ${this.traceFrames} Frames</button>
+                    <button class="debug-btn" onclick="debugPanel.clearTrace()">Clear</button>
+                    <div style="font-size: 10px; margin-top: 5px;">Open in chrome://tracing or ui.perfetto.dev</div>
+                </div>
+            `;
+        }
+        
         this.content.innerHTML = html;
+        this.addButtonStyles();
         
         // Setup performance sliders
         this.setupPerformanceHandlers();
@@ -1001,6 +1045,43 @@ export class DebugPanel {
         a.click();
     }
     
+    /**
+     * Attach the loaded WASM module so engine traces can be dumped
+     * @param {Object} module - Emscripten module from WASMLoader
+     */
+    attachWasmModule(module) {
+        this.wasmModule = module;
+        if (this.visible && this.activeTab === 'performance') {
+            this.updateContent();
+        }
+    }
+    
+    /**
+     * Download the engine's last frames as a Chrome trace-event file
+     */
+    dumpTrace() {
+        if (!this.wasmModule || !this.wasmModule.dumpTrace) return;
+        const json = this.wasmModule.dumpTrace(this.traceFrames);
+        const blob = new Blob([json], { type: 'application/json' });
+        const url = URL.createObjectURL(blob);
+        const a = document.createElement('a');
+        a.href = url;
+        a.download = `engine-trace-${Date.now()}.json`;
+        a.click();
+        URL.revokeObjectURL(url);
+    }
+    
+    getEngineHeapReport() {
+        if (!this.wasmModule || !this.wasmModule.getHeapReport) return null;
+        return this.wasmModule.getHeapReport();
+    }
+    
+    clearTrace() {
+        if (this.wasmModule && this.wasmModule.clearTrace) {
+            this.wasmModule.clearTrace();
+        }
+    }
+    
     filterEvents(filter) {
         // Would implement filtering logic here
         console.log('Filtering events:', filter);
@@ -1069,8 +1150,12 @@ export class DebugPanel {
      * Metrics management
      */
     exportMetrics() {
-        const report = metrics.exportToJSON();
-        const blob = new Blob([report], { type: 'application/json' });
+        const report = metrics.generateReport();
+        const heap = this.getEngineHeapReport();
+        if (heap) {
+            report.engineHeap = heap;
+        }
+        const blob = new Blob([JSON.stringify(report, null, 2)], { type: 'application/json' });
         const url = URL.createObjectURL(blob);
         const a = document.createElement('a');
         a.href = url;
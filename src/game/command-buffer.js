@@ -0,0 +1,87 @@
+/**
+ * Command Buffer Module
+ * Writes input commands into the engine's shared command ring
+ *
+ * Layout (CommandBuffer in wasm/include/systems/command_buffer.h, version 1),
+ * in 32-bit words: a 4-word header (write index, read index, capacity, stride)
+ * followed by capacity commands of 8 words - op, player id (int32), four
+ * float32 args, two reserved. JS only advances the write index; the engine
+ * drains everything queued at the start of its next update().
+ */
+
+export const CommandOp = Object.freeze({
+    PLAYER_INPUT: 1,   // dx, dy, aimX, aimY
+    PLAYER_SHOOT: 2,   // aimX, aimY
+    BOOST_ON: 3,
+    BOOST_OFF: 4,
+    BLOCK_START: 5,
+    BLOCK_END: 6,
+    ATTACK: 7,         // angle
+    ROLL: 8            // dirX, dirY
+});
+
+const LAYOUT_VERSION = 1;
+const HEADER_WORDS = 4;
+const WRITE_INDEX = 0;
+const READ_INDEX = 1;
+
+export class CommandWriter {
+    constructor(engine) {
+        this.engine = engine;
+        this.ints = null;
+        this.floats = null;
+        this.capacity = 0;
+        this.stride = 0;
+        this.dropped = 0;
+        this.supported = !!engine &&
+            typeof engine.getCommandBuffer === 'function' &&
+            engine.getCommandLayoutVersion() === LAYOUT_VERSION;
+    }
+
+    /**
+     * Views over WASM memory detach when the heap grows; re-acquire lazily
+     */
+    ensureViews() {
+        if (this.ints && this.ints.length > 0) return;
+        this.ints = this.engine.getCommandBuffer();
+        this.floats = new Float32Array(this.ints.buffer, this.ints.byteOffset, this.ints.length);
+        this.capacity = this.engine.getCommandCapacity();
+        this.stride = this.engine.getCommandStride();
+    }
+
+    /**
+     * Queue one command. Returns false (and counts a drop) when the ring is
+     * full or the engine has no command buffer.
+     */
+    push(op, id = 0, a = 0, b = 0, c = 0, d = 0) {
+        if (!this.supported) return false;
+        this.ensureViews();
+
+        const ints = this.ints;
+        const write = ints[WRITE_INDEX] >>> 0;
+        const read = ints[READ_INDEX] >>> 0;
+        if (((write - read) >>> 0) >= this.capacity) {
+            this.dropped++;
+            return false;
+        }
+
+        const o = HEADER_WORDS + (write & (this.capacity - 1)) * this.stride;
+        ints[o] = op;
+        ints[o + 1] = id;
+        this.floats[o + 2] = a;
+        this.floats[o + 3] = b;
+        this.floats[o + 4] = c;
+        this.floats[o + 5] = d;
+        ints[WRITE_INDEX] = (write + 1) | 0;
+        return true;
+    }
+
+    /**
+     * Commands queued and not yet drained
+     */
+    pending() {
+        if (!this.supported) return 0;
+        this.ensureViews();
+        return Math.min(((this.ints[WRITE_INDEX] - this.ints[READ_INDEX]) >>> 0), this.capacity);
+    }
+}
@@ -0,0 +1,75 @@
+/**
+ * Engine Events Module
+ * Reads the engine's per-frame gameplay events and publishes them on the EventBus
+ *
+ * Layout (GameplayEvent in wasm/include/systems/gameplay_events.h, version 1),
+ * in 32-bit words per event: type | detail << 8, source id, target id, then
+ * float32 x, y, dirX, dirY, amount. The list covers everything since the
+ * start of the last engine.update(), whose effects and score are already
+ * applied; listeners only react.
+ */
+
+import { EventBus, EVENTS } from '../core/EventBus.js';
+
+export const GameplayEventType = Object.freeze({
+    HIT: 1,                 // Enemy or wolf damaged; dir = knockback, amount = damage
+    PLAYER_HIT: 2,          // Player damaged; dir = knockback, amount = damage
+    BLOCK: 3,               // Player blocked; amount = damage still taken
+    PARRY: 4,               // Perfect parry; amount = energy restored
+    PICKUP: 5,              // Power-up taken; detail = power-up type
+    KILL: 6,                // Enemy or wolf killed; sourceId = credited entity
+    IMPACT: 7,              // Projectile stopped by an obstacle
+    OBSTACLE_DESTROYED: 8
+});
+
+const LAYOUT_VERSION = 1;
+
+export class EngineEventReader {
+    constructor(engine) {
+        this.engine = engine;
+        this.supported = !!engine &&
+            typeof engine.getGameplayEvents === 'function' &&
+            engine.getGameplayEventLayoutVersion() === LAYOUT_VERSION;
+        this.stride = this.supported ? engine.getGameplayEventStride() : 0;
+    }
+
+    /**
+     * Decode this frame's events. The view is taken fresh every call: it
+     * detaches when the heap grows and moves when the queue does.
+     */
+    read() {
+        if (!this.supported) return [];
+        const count = this.engine.getGameplayEventCount();
+        if (count === 0) return [];
+
+        const ints = this.engine.getGameplayEvents();
+        const floats = new Float32Array(ints.buffer, ints.byteOffset, ints.length);
+        const events = new Array(count);
+        for (let i = 0, o = 0; i < count; i++, o += this.stride) {
+            events[i] = {
+                type: ints[o] & 0xff,
+                detail: (ints[o] >> 8) & 0xff,
+                sourceId: ints[o + 1],
+                targetId: ints[o + 2],
+                x: floats[o + 3],
+                y: floats[o + 4],
+                dirX: floats[o + 5],
+                dirY: floats[o + 6],
+                amount: floats[o + 7]
+            };
+        }
+        return events;
+    }
+
+    /**
+     * Emit the frame's events as one EVENTS.ENGINE_EVENTS batch (nothing on
+     * a quiet frame). Returns the number published.
+     */
+    publish() {
+        const events = this.read();
+        if (events.length > 0) {
+            EventBus.emit(EVENTS.ENGINE_EVENTS, events);
+        }
+        return events.length;
+    }
+}
@@ -69,6 +69,9 @@ export class Game {
             }
             
             this.engine = this.wasmLoader.getEngine();
+            if (window.debugPanel) {
+                window.debugPanel.attachWasmModule(this.wasmLoader.getModule());
+            }
             
             // Setup canvas
             this.canvas = document.getElementById('gameCanvas');
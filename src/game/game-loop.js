@@ -3,6 +3,8 @@
  * Manages the main game loop, updates, and timing
  */
 
+import { EngineEventReader } from './engine-events.js';
+
 export class GameLoop {
     constructor(game) {
         this.game = game;
@@ -12,13 +14,15 @@ export class GameLoop {
         this.fps = 0;
         this.fpsUpdateTime = 0;
         this.animationId = null;
+        this.engineEvents = null;
         
         // Performance tracking
         this.performanceMetrics = {
             updateTime: 0,
             renderTime: 0,
             wasmTime: 0,
-            totalTime: 0
+            totalTime: 0,
+            substeps: 0
         };
     }
 
@@ -92,10 +96,20 @@ export class GameLoop {
         // Process input
         this.game.inputHandler.processInput(this.game.engine);
         
-        // Update WASM engine
+        // Update WASM engine. The engine banks dt and runs whole fixed ticks
+        // (with a substep budget), so render rate never changes the simulation.
         const wasmStart = performance.now();
         this.game.engine.update(dt);
         this.performanceMetrics.wasmTime = performance.now() - wasmStart;
+        if (this.game.engine.getLastSubstepCount) {
+            this.performanceMetrics.substeps = this.game.engine.getLastSubstepCount();
+        }
+
+        // Hits, kills and pickups from this update, as one EventBus batch
+        if (!this.engineEvents || this.engineEvents.engine !== this.game.engine) {
+            this.engineEvents = new EngineEventReader(this.game.engine);
+        }
+        this.engineEvents.publish();
 
         // Update animations for entities
         const entities = this.game.engine.getEntityPositions();
@@ -3,9 +3,13 @@
  * Manages keyboard, mouse, and mobile input
  */
 
+import { CommandWriter, CommandOp } from './command-buffer.js';
+
 export class InputHandler {
     constructor(game) {
         this.game = game;
+        this.commands = null;
+        this.boostHeld = false;
         this.keys = {};
         this.mouse = { x: 0, y: 0 };
         this.joystick = { x: 0, y: 0, active: false };
@@ -187,6 +191,14 @@ export class InputHandler {
     processInput(engine) {
         if (!engine) return;
         
+        if (!this.commands || this.commands.engine !== engine) {
+            this.commands = new CommandWriter(engine);
+        }
+        if (this.commands.supported) {
+            this.queueInput();
+            return;
+        }
+        
         // Movement input
         let moveX = 0;
         let moveY = 0;
@@ -229,6 +241,45 @@ export class InputHandler {
         }
     }
 
+    /**
+     * Queue this frame's input into the engine's command ring; the engine
+     * applies it at the start of its next update()
+     */
+    queueInput() {
+        const commands = this.commands;
+        const playerId = this.game.player || 0;
+        
+        let moveX = 0;
+        let moveY = 0;
+        if (this.keys['w'] || this.keys['arrowup']) moveY = -1;
+        if (this.keys['s'] || this.keys['arrowdown']) moveY = 1;
+        if (this.keys['a'] || this.keys['arrowleft']) moveX = -1;
+        if (this.keys['d'] || this.keys['arrowright']) moveX = 1;
+        if (this.joystick.active) {
+            moveX = this.joystick.x;
+            moveY = this.joystick.y;
+        }
+        
+        // Sent every frame: the engine applies friction when there is no input
+        commands.push(CommandOp.PLAYER_INPUT, playerId, moveX, moveY, this.mouse.x, this.mouse.y);
+        
+        if (this.keys['shoot'] || this.keys[' ']) {
+            commands.push(CommandOp.PLAYER_SHOOT, playerId, this.mouse.x, this.mouse.y);
+        }
+        
+        // Boost is held, so only the edges are sent
+        const boost = !!(this.keys['boost'] || this.keys['shift']);
+        if (boost !== this.boostHeld) {
+            commands.push(boost ? CommandOp.BOOST_ON : CommandOp.BOOST_OFF, playerId);
+            this.boostHeld = boost;
+        }
+        
+        // No engine command for the special ability yet
+        if ((this.keys['special'] || this.keys['e']) && commands.engine.playerSpecialAbility) {
+            commands.engine.playerSpecialAbility();
+        }
+    }
+
     /**
      * Get current input state
      */
@@ -247,6 +298,7 @@ export class InputHandler {
         this.keys = {};
         this.joystick = { x: 0, y: 0, active: false };
         this.touch = { active: false, id: null };
+        this.boostHeld = false;
     }
 
     /**
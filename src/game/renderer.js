@@ -15,6 +15,18 @@ export class Renderer {
         this.minimapCtx = minimap ? minimap.getContext('2d') : null;
         
         this.camera = { x: 0, y: 0 };
+        
+        // Reused entity objects for the packed render buffer path
+        this.entityScratch = [];
+        
+        // Engine-side culling: the packed buffer only holds what the engine
+        // camera sees, so the minimap refreshes the full list now and then
+        this.viewportWidth = 0;
+        this.viewportHeight = 0;
+        this.minimapEntities = [];
+        this.minimapRefreshInterval = 15;
+        this.framesSinceMinimapRefresh = Infinity;
+        this.particlePalette = null;
         this.gridSize = 50;
         this.setupCanvas();
 
@@ -100,11 +112,15 @@ export class Renderer {
         this.ctx.fillStyle = '#0a0a0a';
         this.ctx.fillRect(0, 0, this.canvas.width, this.canvas.height);
         
-        // Update camera to follow player
-        const playerState = engine.getPlayerState();
-        if (playerState) {
-            this.camera.x = playerState.x - this.canvas.width / 2;
-            this.camera.y = playerState.y - this.canvas.height / 2;
+        // Follow the engine camera when it culls for us, so both agree on
+        // what is on screen; otherwise center on the player
+        const culled = this.syncEngineCamera(engine);
+        if (!culled) {
+            const playerState = engine.getPlayerState();
+            if (playerState) {
+                this.camera.x = playerState.x - this.canvas.width / 2;
+                this.camera.y = playerState.y - this.canvas.height / 2;
+            }
         }
         
         // Save context state
@@ -117,18 +133,124 @@ export class Renderer {
         this.drawGrid();
         
         // Get and render entities
-        const entities = engine.getEntityPositions();
+        const packed = typeof engine.packRenderState === 'function';
+        const entities = packed ? this.readPackedEntities(engine) : engine.getEntityPositions();
         entities.forEach(entity => this.renderEntity(entity));
         
         // Draw visual effects
-        const effects = engine.getVisualEffects();
-        this.renderEffects(effects);
+        if (packed) {
+            this.renderPackedParticles(engine);
+        } else {
+            const effects = engine.getVisualEffects();
+            this.renderEffects(effects);
+        }
         
         // Restore context state
         this.ctx.restore();
         
         // Render minimap (doesn't need camera transform)
-        this.renderMinimap(entities);
+        this.renderMinimap(culled ? this.getMinimapEntities(engine) : entities);
+    }
+
+    /**
+     * Size the engine viewport to the canvas and copy its camera. Returns
+     * false when the engine was built without the camera module.
+     */
+    syncEngineCamera(engine) {
+        if (typeof engine.getCameraInfo !== 'function' ||
+            typeof engine.isRenderCulling !== 'function' || !engine.isRenderCulling()) {
+            return false;
+        }
+        
+        if (this.viewportWidth !== this.canvas.width || this.viewportHeight !== this.canvas.height) {
+            this.viewportWidth = this.canvas.width;
+            this.viewportHeight = this.canvas.height;
+            engine.setViewport(this.viewportWidth, this.viewportHeight);
+        }
+        
+        const info = engine.getCameraInfo();
+        this.camera.x = info.x;
+        this.camera.y = info.y;
+        return true;
+    }
+
+    /**
+     * Full entity list for the minimap, refetched every few frames
+     */
+    getMinimapEntities(engine) {
+        if (++this.framesSinceMinimapRefresh >= this.minimapRefreshInterval) {
+            this.minimapEntities = engine.getEntityPositions();
+            this.framesSinceMinimapRefresh = 0;
+        }
+        return this.minimapEntities;
+    }
+
+    /**
+     * Read entities from the engine's packed render buffer.
+     * Layout (RenderLayout in wasm/include/utils/render_buffer.h, version 1):
+     * 10 words per entity - id, type (int32), x, y, vx, vy, rotation,
+     * radius, health, maxHealth (float32), grouped by type (sizes in
+     * getRenderTypeCounts()). Objects are reused across frames.
+     */
+    readPackedEntities(engine) {
+        const count = engine.packRenderState();
+        if (engine.getRenderLayoutVersion() !== 1) {
+            return engine.getEntityPositions();
+        }
+        
+        const floats = engine.getEntityRenderBuffer();
+        const ints = new Int32Array(floats.buffer, floats.byteOffset, floats.length);
+        const stride = engine.getEntityRenderStride();
+        const scratch = this.entityScratch;
+        
+        while (scratch.length < count) {
+            scratch.push({ id: 0, type: 0, x: 0, y: 0, vx: 0, vy: 0, rotation: 0, radius: 0, health: 0, maxHealth: 0 });
+        }
+        scratch.length = count;
+        
+        for (let i = 0, o = 0; i < count; i++, o += stride) {
+            const e = scratch[i];
+            e.id = ints[o];
+            e.type = ints[o + 1];
+            e.x = floats[o + 2];
+            e.y = floats[o + 3];
+            e.vx = floats[o + 4];
+            e.vy = floats[o + 5];
+            e.rotation = floats[o + 6];
+            e.radius = floats[o + 7];
+            e.health = floats[o + 8];
+            e.maxHealth = floats[o + 9];
+        }
+        
+        return scratch;
+    }
+
+    /**
+     * Draw particles straight from the packed particle buffer
+     * (5 words per particle - x, y, size, alpha, palette index).
+     */
+    renderPackedParticles(engine) {
+        const count = engine.getParticleRenderCount();
+        if (count === 0) return;
+        
+        if (!this.particlePalette) {
+            this.particlePalette = engine.getParticlePalette();
+        }
+        
+        const floats = engine.getParticleRenderBuffer();
+        const ints = new Int32Array(floats.buffer, floats.byteOffset, floats.length);
+        const stride = engine.getParticleRenderStride();
+        const ctx = this.ctx;
+        
+        ctx.save();
+        for (let i = 0, o = 0; i < count; i++, o += stride) {
+            ctx.globalAlpha = Math.max(0, Math.min(1, floats[o + 3]));
+            ctx.fillStyle = this.particlePalette[ints[o + 4]] || '#ffffff';
+            ctx.beginPath();
+            ctx.arc(floats[o], floats[o + 1], floats[o + 2], 0, Math.PI * 2);
+            ctx.fill();
+        }
+        ctx.restore();
     }
 
     /**
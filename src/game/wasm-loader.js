@@ -7,6 +7,7 @@ export class WASMLoader {
     constructor() {
         this.module = null;
         this.engine = null;
+        this.threaded = false;
     }
 
     /**
@@ -31,8 +32,10 @@ export class WASMLoader {
         try {
             this.updateLoading(10, 'Loading WASM module...');
             
-            // Import the Emscripten module factory
-            const moduleFactory = (await import('/public/game_engine.js')).default;
+            // Import the Emscripten module factory. The pthread build needs
+            // SharedArrayBuffer, which browsers only expose to cross-origin
+            // isolated pages; everywhere else use the single-threaded build.
+            const { factory: moduleFactory, wasmPath } = await this.importModuleFactory();
             this.updateLoading(30, 'Initializing WASM...');
             
             // Create the module instance with proper configuration
@@ -44,7 +47,7 @@ export class WASMLoader {
                 // Locate the WASM file
                 locateFile: (path) => {
                     if (path.endsWith('.wasm')) {
-                        return '/public/game_engine.wasm';
+                        return wasmPath;
                     }
                     return path;
                 },
@@ -80,7 +83,8 @@ export class WASMLoader {
             }
             this.updateLoading(90, 'Finalizing...');
             
-            console.log('WASM module loaded successfully');
+            console.log('WASM module loaded successfully', this.threaded
+                ? `(threaded, ${this.engine.getWorkerCount()} workers)` : '(single-threaded)');
             return true;
             
         } catch (error) {
@@ -104,6 +108,32 @@ export class WASMLoader {
         }
     }
 
+    /**
+     * Whether the threaded module can run on this page
+     */
+    static canUseThreads() {
+        return typeof SharedArrayBuffer !== 'undefined' &&
+            typeof self !== 'undefined' && self.crossOriginIsolated === true;
+    }
+
+    /**
+     * Pick the threaded module when possible, falling back if it is missing
+     */
+    async importModuleFactory() {
+        this.threaded = false;
+        if (WASMLoader.canUseThreads()) {
+            try {
+                const factory = (await import('/public/game_engine_threads.js')).default;
+                this.threaded = true;
+                return { factory, wasmPath: '/public/game_engine_threads.wasm' };
+            } catch (error) {
+                console.warn('Threaded WASM build unavailable, using single-threaded build:', error);
+            }
+        }
+        const factory = (await import('/public/game_engine.js')).default;
+        return { factory, wasmPath: '/public/game_engine.wasm' };
+    }
+
     /**
      * Get the game engine instance
      */
@@ -6,6 +6,9 @@
     return;
   }
   
+  // First byte of a binary state ack: 'A', then u32 sequence (little-endian)
+  const STATE_ACK_MAGIC = 0x41;
+  
   class MultiplayerGame {
   constructor() {
     this.pc = null;
@@ -73,6 +76,11 @@
     this.lastSyncTime = 0;
     this.adaptiveSyncRate = 60; // Actual sync rate that adapts to network conditions
     
+    // Binary engine state sync (see wasm/include/systems/state_codec.h)
+    this.engine = null;
+    this.lastAckedStateSeq = 0; // Host: newest packet the peer acked
+    this.onStateDecoded = null; // Guest: called with (sequence, engine) after each decode
+    
     this.init();
   }
   
@@ -113,7 +121,12 @@
       if (this.dataChannel) {
         console.log('Data channel state:', this.dataChannel && this.dataChannel && this.dataChannel && this.dataChannel.readyState);
         
+        this.dataChannel.binaryType = 'arraybuffer';
         this.dataChannel.onmessage = (msgEvent) => {
+          if (typeof msgEvent.data !== 'string') {
+            this.handleBinaryMessage(msgEvent.data);
+            return;
+          }
           try {
             const message = JSON.parse(msgEvent.data);
             console.log('Received message:', message.type);
@@ -193,7 +206,12 @@
         
         // Set up data channel handlers
         if (this.dataChannel) {
+          this.dataChannel.binaryType = 'arraybuffer';
           this.dataChannel.onmessage = (msgEvent) => {
+            if (typeof msgEvent.data !== 'string') {
+              this.handleBinaryMessage(msgEvent.data);
+              return;
+            }
             try {
               const message = JSON.parse(msgEvent.data);
               this.handleMessage(message);
@@ -251,6 +269,51 @@
     }
   }
   
+  // Attach a wasm GameEngine so state sync goes through its binary codec
+  attachEngine(engine) {
+    this.engine = engine;
+    this.lastAckedStateSeq = 0;
+  }
+  
+  // Send engine state as a delta against the last acked packet (host only)
+  sendEngineState() {
+    if (!this.engine || !this.dataChannel || this.dataChannel.readyState !== 'open') return;
+    // slice() copies out of wasm memory, which the next encode reuses
+    const packet = this.engine.encodeState(this.lastAckedStateSeq).slice();
+    this.dataChannel.send(packet);
+  }
+  
+  // Binary frames: state packets from the host, 5-byte acks from the guest
+  handleBinaryMessage(data) {
+    const bytes = new Uint8Array(data);
+    
+    if (bytes.length === 5 && bytes[0] === STATE_ACK_MAGIC) {
+      const seq = new DataView(bytes.buffer, bytes.byteOffset, 5).getUint32(1, true);
+      // Acks can arrive out of order; only move forward (0 asks for a keyframe)
+      if (seq === 0 || seq > this.lastAckedStateSeq) {
+        this.lastAckedStateSeq = seq;
+      }
+      return;
+    }
+    
+    if (!this.engine) return;
+    this.engine.getStateDecodeBuffer(bytes.length).set(bytes);
+    const seq = this.engine.decodeState(bytes.length);
+    this.sendStateAck(seq);
+    
+    if (seq !== 0 && this.onStateDecoded) {
+      this.onStateDecoded(seq, this.engine);
+    }
+  }
+  
+  sendStateAck(seq) {
+    if (!this.dataChannel || this.dataChannel.readyState !== 'open') return;
+    const ack = new Uint8Array(5);
+    ack[0] = STATE_ACK_MAGIC;
+    new DataView(ack.buffer).setUint32(1, seq >>> 0, true);
+    this.dataChannel.send(ack);
+  }
+  
   // Handle incoming messages
   handleMessage(message) {
     switch (message.type) {
@@ -316,8 +379,11 @@
       this.syncLocalState();
       this.lastSyncTime = now;
       
-      // Host sends full state sync periodically to prevent drift
-      if (this.role === 'host' && now - this.lastFullSyncTime > FULL_SYNC_INTERVAL) {
+      // With an engine attached the host streams quantized deltas every tick
+      if (this.role === 'host' && this.engine) {
+        this.sendEngineState();
+      } else if (this.role === 'host' && now - this.lastFullSyncTime > FULL_SYNC_INTERVAL) {
+        // Host sends full state sync periodically to prevent drift
         this.sendFullStateSync();
         this.lastFullSyncTime = now;
       }
@@ -915,7 +981,12 @@
     this.dataChannel = dataChannel;
     
     if (this.dataChannel) {
+      this.dataChannel.binaryType = 'arraybuffer';
       this.dataChannel.onmessage = (event) => {
+        if (typeof event.data !== 'string') {
+          this.handleBinaryMessage(event.data);
+          return;
+        }
         try {
           const message = JSON.parse(event.data);
           this.handleMessage(message);
@@ -0,0 +1,115 @@
+/**
+ * Snapshot Decoder
+ * Reads the delta blobs produced by GameEngine.getSnapshotSince()
+ * (layout documented in wasm/include/systems/snapshot_system.h)
+ */
+
+export const SNAPSHOT_VERSION = 1;
+const FLAG_FULL = 1;
+const ENTITY_SPAWNED = 1;
+
+/**
+ * Decode one snapshot blob into plain objects
+ */
+export function decodeSnapshot(bytes) {
+    const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+    let o = 0;
+
+    const version = view.getUint8(o); o += 1;
+    if (version !== SNAPSHOT_VERSION) {
+        throw new Error(`Unsupported snapshot version ${version}`);
+    }
+    const flags = view.getUint8(o); o += 3;
+    const sequence = view.getUint32(o, true); o += 4;
+    const baseSequence = view.getUint32(o, true); o += 4;
+    const gameState = view.getUint8(o); o += 2;
+    const wave = view.getUint16(o, true); o += 2;
+    const score = view.getInt32(o, true); o += 4;
+    const entityCount = view.getUint16(o, true); o += 2;
+    const despawnCount = view.getUint16(o, true); o += 2;
+
+    const entities = new Array(entityCount);
+    for (let i = 0; i < entityCount; i++) {
+        const e = {
+            id: view.getInt32(o, true),
+            type: view.getUint8(o + 4),
+            spawned: (view.getUint8(o + 5) & ENTITY_SPAWNED) !== 0,
+            x: view.getFloat32(o + 8, true),
+            y: view.getFloat32(o + 12, true),
+            vx: view.getFloat32(o + 16, true),
+            vy: view.getFloat32(o + 20, true),
+            rotation: view.getFloat32(o + 24, true),
+            health: view.getFloat32(o + 28, true)
+        };
+        o += 32;
+        if (e.spawned) {
+            e.radius = view.getFloat32(o, true);
+            e.maxHealth = view.getFloat32(o + 4, true);
+            o += 8;
+        }
+        entities[i] = e;
+    }
+
+    const despawned = new Array(despawnCount);
+    for (let i = 0; i < despawnCount; i++) {
+        despawned[i] = view.getInt32(o, true);
+        o += 4;
+    }
+
+    return {
+        full: (flags & FLAG_FULL) !== 0,
+        sequence,
+        baseSequence,
+        gameState,
+        wave,
+        score,
+        entities,
+        despawned
+    };
+}
+
+/**
+ * Keeps a local copy of engine state up to date from snapshot deltas
+ */
+export class SnapshotMirror {
+    constructor() {
+        this.sequence = 0;
+        this.entities = new Map();
+        this.gameState = 0;
+        this.wave = 0;
+        this.score = 0;
+    }
+
+    /**
+     * Apply a blob; returns false if it does not follow our sequence
+     */
+    apply(bytes) {
+        const snapshot = decodeSnapshot(bytes);
+        if (snapshot.full) {
+            this.entities.clear();
+        } else if (snapshot.baseSequence !== this.sequence) {
+            return false;
+        }
+
+        for (const e of snapshot.entities) {
+            const existing = this.entities.get(e.id);
+            this.entities.set(e.id, existing && !e.spawned ? Object.assign(existing, e) : e);
+        }
+        for (const id of snapshot.despawned) {
+            this.entities.delete(id);
+        }
+
+        this.sequence = snapshot.sequence;
+        this.gameState = snapshot.gameState;
+        this.wave = snapshot.wave;
+        this.score = snapshot.score;
+        return true;
+    }
+
+    /**
+     * Pull and apply the latest delta from an engine instance
+     */
+    sync(engine) {
+        return this.apply(engine.getSnapshotSince(this.sequence));
+    }
+}
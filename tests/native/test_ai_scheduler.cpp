@@ -0,0 +1,130 @@
+// AIScheduler: the perception budget is counted in work units
+//
+// Which agents perceive must not depend on how fast the machine is, so two
+// identical packs run side by side have to schedule identically, budget
+// deferrals included.
+
+#include "test_harness.h"
+#include "../../wasm/include/ai/wolf_ai.h"
+#include "../../wasm/include/entities/obstacle.h"
+#include "../../wasm/include/entities/player.h"
+#include "../../wasm/include/utils/sim_context.h"
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace {
+
+using AI::AIScheduler;
+
+AIScheduler::Settings everyFrame(int budgetUnits) {
+    AIScheduler::Settings settings;
+    settings.activeInterval = settings.alertInterval = 1;
+    settings.ambientInterval = settings.dormantInterval = 1;
+    settings.budgetUnits = budgetUnits;
+    return settings;
+}
+
+TEST_CASE(budget_defers_by_units_spent) {
+    AIScheduler scheduler;
+    scheduler.setSettings(everyFrame(5));
+    std::vector<AIScheduler::Ticket> tickets(8);
+    AIScheduler::Ticket hunter;
+    // A ticket's first claim only registers it
+    scheduler.beginFrame();
+    for (AIScheduler::Ticket& ticket : tickets) scheduler.claim(ticket, AIScheduler::Tier::AMBIENT, 0);
+    scheduler.claim(hunter, AIScheduler::Tier::ACTIVE, 0);
+    scheduler.beginFrame();
+
+    // Two units each: the third claim starts at 4 < 5 and runs, then the
+    // budget is spent and the rest wait
+    int granted = 0;
+    for (AIScheduler::Ticket& ticket : tickets) {
+        if (scheduler.claim(ticket, AIScheduler::Tier::AMBIENT, 0)) {
+            scheduler.charge(2);
+            granted++;
+        }
+    }
+    CHECK_EQ(granted, 3);
+
+    // ACTIVE agents run past the budget
+    CHECK(scheduler.claim(hunter, AIScheduler::Tier::ACTIVE, 0));
+
+    // Wall time is reported but never defers anyone
+    scheduler.beginFrame();
+    CHECK_EQ(scheduler.getLastFrameUnits(), 6);
+    CHECK_EQ(scheduler.getDeferredCount(), 5);
+    scheduler.reportMs(1e6);
+    int next = 0;
+    for (AIScheduler::Ticket& ticket : tickets) {
+        if (scheduler.claim(ticket, AIScheduler::Tier::AMBIENT, 0)) next++;
+    }
+    CHECK_EQ(next, 8);
+}
+
+struct PackRun {
+    SimContext context;
+    AI::WolfPack pack;
+    std::vector<std::shared_ptr<AI::Wolf>> wolves;
+    std::vector<std::unique_ptr<Entity>> owned;
+    std::vector<Entity*> obstacles;
+    Player player{Vector2(1000, 1000)};
+
+    PackRun(int budgetUnits) {
+        context.reset(2024);
+        SimContext::Scope scope(context);
+        pack.setWorldBounds(2000, 2000);
+        AIScheduler::Settings settings = pack.getScheduler().getSettings();
+        settings.budgetUnits = budgetUnits;
+        pack.getScheduler().setSettings(settings);
+        for (int i = 0; i < 60; i++) {
+            float angle = i * 0.37f;
+            float radius = 150.0f + (i % 10) * 90.0f;
+            auto wolf = std::make_shared<AI::Wolf>(1000 + radius * std::cos(angle),
+                                                   1000 + radius * std::sin(angle), i % 6 == 0);
+            wolf->setRotation(angle + 3.14159f);
+            wolves.push_back(wolf);
+            pack.addWolf(std::make_shared<AI::WolfAI>(wolf));
+        }
+        for (int i = 0; i < 20; i++) {
+            owned.push_back(std::make_unique<Obstacle>(Vector2(200.0f + i * 80, 900.0f + (i % 3) * 60), 25.0f));
+            obstacles.push_back(owned.back().get());
+        }
+    }
+
+    // Per-frame ran, deferred and units, with the player running circles
+    std::vector<int> run(int frames) {
+        SimContext::Scope scope(context);
+        std::vector<int> trace;
+        for (int f = 0; f < frames; f++) {
+            float angle = f * 0.05f;
+            player.velocity = Vector2(std::cos(angle) * 6, std::sin(angle) * 6);
+            player.position += player.velocity;
+            pack.update(1.0f / 60.0f, &player, obstacles);
+            const AIScheduler& scheduler = pack.getScheduler();
+            trace.push_back(scheduler.getRanCount());
+            trace.push_back(scheduler.getDeferredCount());
+            trace.push_back(scheduler.getLastFrameUnits());
+        }
+        return trace;
+    }
+};
+
+TEST_CASE(packs_schedule_identically_under_a_tight_budget) {
+    PackRun a(6), b(6);
+    std::vector<int> first = a.run(240);
+    std::vector<int> second = b.run(240);
+    CHECK(first == second);
+
+    int deferred = 0;
+    for (size_t i = 1; i < first.size(); i += 3) deferred += first[i];
+    CHECK(deferred > 0);    // The budget did bite
+    for (size_t i = 0; i < a.wolves.size(); i++) {
+        CHECK_EQ(a.wolves[i]->x(), b.wolves[i]->x());
+        CHECK_EQ(a.wolves[i]->y(), b.wolves[i]->y());
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) { return runTests(argc, argv); }
@@ -0,0 +1,145 @@
+// CollisionSystem: swept tests for fast movers
+//
+// Each case places entities at the two ends of one step (previousPosition
+// and position) so that they never overlap at either end, then runs a
+// collision pass through both broadphases: the entity list and the SoA
+// store. A mover that crossed something during the step has to collide
+// with it anyway.
+
+#include "test_harness.h"
+#include "../../wasm/include/systems/collision_system.h"
+#include <memory>
+#include <vector>
+
+namespace {
+
+using Entities = std::vector<std::unique_ptr<Entity>>;
+using EventType = GameplayEvent::Type;
+
+// Dynamic entities first, then obstacles, as the engine keeps them
+struct World {
+    Entities entities;
+    size_t dynamicCount = 0;
+    EventQueue events;
+    CollisionSystem collisions;
+    ObstacleIndex statics;
+    EntityStore store;
+
+    World() : collisions(&events) { collisions.setWorldBounds(1000, 1000); }
+
+    // Added where its last step went from `from` to `to`
+    template<typename T>
+    T* addDynamic(std::unique_ptr<T> entity, const Vector2& from, const Vector2& to) {
+        T* raw = entity.get();
+        raw->previousPosition = from;
+        raw->position = to;
+        raw->velocity = to - from;
+        entities.insert(entities.begin() + dynamicCount++, std::move(entity));
+        return raw;
+    }
+
+    Obstacle* addWall(const Vector2& at, float w, float h, float rotation = 0) {
+        entities.push_back(std::make_unique<Obstacle>(at, ObstacleShape::RECTANGLE, w, h, rotation, true));
+        return static_cast<Obstacle*>(entities.back().get());
+    }
+
+    void step(bool soa) {
+        statics.markDirty();
+        statics.rebuildIfDirty(entities);
+        if (soa) {
+            store.gather(entities, dynamicCount);
+            collisions.checkCollisions(store, statics);
+        } else {
+            collisions.checkCollisions(entities, dynamicCount, statics);
+        }
+    }
+
+    int count(EventType type) const {
+        int n = 0;
+        for (size_t i = 0; i < events.size(); i++) n += events[i].type == type;
+        return n;
+    }
+};
+
+const bool BROADPHASES[] = {false, true};
+
+TEST_CASE(projectile_hits_an_enemy_it_stepped_over) {
+    for (bool soa : BROADPHASES) {
+        World world;
+        Enemy* enemy = world.addDynamic(std::make_unique<Enemy>(Vector2(500, 500)),
+                                        Vector2(500, 500), Vector2(500, 500));
+        // 100 units clear of the enemy at both ends of the step
+        Projectile* shot = world.addDynamic(std::make_unique<Projectile>(Vector2(0, 0), Vector2(1, 0), 25, -1),
+                                            Vector2(380, 500), Vector2(620, 500));
+        CHECK(shot->distanceTo(*enemy) > shot->radius + enemy->radius);
+        world.step(soa);
+        CHECK_EQ(world.count(EventType::HIT), 1);
+        CHECK(!shot->active);
+        CHECK_NEAR(enemy->health, Config::ENEMY_HEALTH - 25, 1e-4);
+    }
+}
+
+TEST_CASE(projectile_passing_beside_an_enemy_misses) {
+    for (bool soa : BROADPHASES) {
+        World world;
+        Enemy* enemy = world.addDynamic(std::make_unique<Enemy>(Vector2(500, 500)),
+                                        Vector2(500, 500), Vector2(500, 500));
+        // Closest approach 21, reach 20
+        Projectile* shot = world.addDynamic(std::make_unique<Projectile>(Vector2(0, 0), Vector2(1, 0), 25, -1),
+                                            Vector2(380, 521), Vector2(620, 521));
+        world.step(soa);
+        CHECK_EQ(world.count(EventType::HIT), 0);
+        CHECK(shot->active);
+        CHECK_EQ(enemy->health, Config::ENEMY_HEALTH);
+    }
+}
+
+TEST_CASE(movers_crossing_paths_collide) {
+    for (bool soa : BROADPHASES) {
+        World world;
+        // Both moving: they meet at (500, 500) halfway through the step and
+        // are far apart at either end
+        Player* player = world.addDynamic(std::make_unique<Player>(Vector2(0, 0)),
+                                          Vector2(400, 500), Vector2(600, 500));
+        Enemy* enemy = world.addDynamic(std::make_unique<Enemy>(Vector2(0, 0)),
+                                        Vector2(500, 400), Vector2(500, 600));
+        CHECK_NEAR(player->sweptContactTime(*enemy), 0.5f - 35 / (200 * std::sqrt(2.0f)), 1e-4);
+        world.step(soa);
+        CHECK_EQ(world.count(EventType::PLAYER_HIT), 1);
+    }
+}
+
+TEST_CASE(projectile_tunnelling_through_a_thin_wall_impacts) {
+    for (bool soa : BROADPHASES) {
+        World world;
+        // A 10 unit thick wall, rotated; the shot crosses it along the wall's
+        // local y axis
+        const float rotation = 0.3f;
+        world.addWall(Vector2(500, 500), 300, 10, rotation);
+        Vector2 across(-std::sin(rotation), std::cos(rotation));
+        Projectile* shot = world.addDynamic(std::make_unique<Projectile>(Vector2(0, 0), across, 25, -1),
+                                            Vector2(500, 500) - across * 60, Vector2(500, 500) + across * 60);
+        world.step(soa);
+        CHECK_EQ(world.count(EventType::IMPACT), 1);
+        CHECK(!shot->active);
+    }
+}
+
+TEST_CASE(player_stops_at_a_wall_it_stepped_through) {
+    for (bool soa : BROADPHASES) {
+        World world;
+        world.addWall(Vector2(500, 500), 10, 300);
+        Player* player = world.addDynamic(std::make_unique<Player>(Vector2(0, 0)),
+                                          Vector2(300, 480), Vector2(700, 480));
+        world.step(soa);
+        // Placed where it first touched the near face, 5 + 20 short of the
+        // wall's centre line, with the velocity into the wall removed
+        CHECK_NEAR(player->position.x, 475, 1e-2);
+        CHECK_NEAR(player->position.y, 480, 1e-2);
+        CHECK_NEAR(player->velocity.x, 0, 1e-3);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) { return runTests(argc, argv); }
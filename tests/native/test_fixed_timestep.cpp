@@ -0,0 +1,113 @@
+// Fixed-step simulation is independent of the display rate
+//
+// Two engines with the same seed get the same input every frame, one at
+// 60 Hz and one at 144 Hz. After the same number of ticks their worlds must
+// be identical, player included.
+
+#include "test_harness.h"
+#include "../../wasm/include/game_engine.h"
+
+namespace {
+
+constexpr uint32_t SEED = 4242;
+
+struct Session {
+    GameEngine engine{1920, 1080, 0};
+
+    explicit Session() {
+        engine.setSeed(SEED);
+        engine.setAdaptiveQuality(false);
+        engine.startGame();
+    }
+
+    const Entity* player() {
+        for (const auto& entity : engine.getEntities()) {
+            if (entity->id == engine.getPlayerId()) return entity.get();
+        }
+        return nullptr;
+    }
+
+    // Steps at displayHz, feeding the input every frame, until ticks have run
+    void runTo(uint32_t ticks, float displayHz) {
+        while (engine.getFrameNumber() < ticks) {
+            uint32_t tick = engine.getFrameNumber();
+            float moveX = tick < 90 ? 1.0f : -0.5f;
+            float moveY = (tick / 30) % 2 ? 1.0f : 0.0f;
+            engine.updatePlayerInput(moveX, moveY, 2000, 500);
+            // Never past the target: the last frame is shortened to one tick
+            float dt = 1.0f / displayHz;
+            engine.update(dt);
+        }
+    }
+};
+
+TEST_CASE(display_rate_does_not_change_the_simulation) {
+    Session slow, fast;
+    slow.runTo(180, 60.0f);
+    fast.runTo(180, 144.0f);
+
+    // The 144 Hz session can overshoot by a tick; bring the 60 Hz one level
+    if (fast.engine.getFrameNumber() > slow.engine.getFrameNumber()) {
+        slow.runTo(fast.engine.getFrameNumber(), 60.0f);
+    }
+    CHECK_EQ(slow.engine.getFrameNumber(), fast.engine.getFrameNumber());
+
+    const Entity* a = slow.player();
+    const Entity* b = fast.player();
+    CHECK(a && b);
+    if (!a || !b) return;
+    CHECK(a->position.x != 1920 / 2.0f);    // It did move
+    CHECK_EQ(a->position.x, b->position.x);
+    CHECK_EQ(a->position.y, b->position.y);
+    CHECK_EQ(a->velocity.x, b->velocity.x);
+    CHECK_EQ(a->velocity.y, b->velocity.y);
+    CHECK_EQ(slow.engine.stateChecksum(), fast.engine.stateChecksum());
+}
+
+TEST_CASE(frames_without_a_tick_do_not_move_the_player) {
+    Session session;
+    session.runTo(10, 60.0f);
+    const Entity* player = session.player();
+    CHECK(player != nullptr);
+    if (!player) return;
+
+    Vector2 velocity = player->velocity;
+    uint32_t tick = session.engine.getFrameNumber();
+    // A quarter tick per frame: input every frame, a tick only every fourth
+    for (int frame = 0; frame < 3; frame++) {
+        session.engine.updatePlayerInput(1, 0, 0, 0);
+        session.engine.update(1.0f / 240.0f);
+    }
+    CHECK_EQ(session.engine.getFrameNumber(), tick);
+    CHECK_EQ(player->velocity.x, velocity.x);
+    CHECK_EQ(player->velocity.y, velocity.y);
+}
+
+TEST_CASE(each_substep_applies_the_input) {
+    // One long frame of three ticks accelerates like three 60 Hz frames
+    Session once, thrice;
+    once.runTo(5, 60.0f);
+    thrice.runTo(5, 60.0f);
+
+    uint32_t target = once.engine.getFrameNumber() + 3;
+    while (once.engine.getFrameNumber() < target) {
+        once.engine.updatePlayerInput(0, 1, 0, 0);
+        once.engine.update(1.0f / 60.0f);
+    }
+    // Half a tick spare so float rounding cannot drop the third
+    thrice.engine.updatePlayerInput(0, 1, 0, 0);
+    thrice.engine.update(3.5f / 60.0f);
+
+    CHECK_EQ(once.engine.getFrameNumber(), thrice.engine.getFrameNumber());
+    const Entity* a = once.player();
+    const Entity* b = thrice.player();
+    CHECK(a && b);
+    if (!a || !b) return;
+    CHECK(a->velocity.y > 0);
+    CHECK_EQ(a->velocity.y, b->velocity.y);
+    CHECK_EQ(a->position.y, b->position.y);
+}
+
+} // namespace
+
+int main(int argc, char** argv) { return runTests(argc, argv); }
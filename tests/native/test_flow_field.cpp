@@ -0,0 +1,155 @@
+// FlowField: removing an obstacle repairs the field in place
+//
+// removeObstacle() relaxes outward from the cells the obstacle freed instead
+// of rerunning the breadth-first pass, so after any run of additions and
+// removals the field has to agree, cell for cell, with one built from
+// scratch over the obstacles that are left.
+
+#include "test_harness.h"
+#include "../../wasm/include/systems/flow_field.h"
+#include "../../wasm/include/utils/sim_context.h"
+#include <memory>
+#include <vector>
+
+namespace {
+
+using Entities = std::vector<std::unique_ptr<Entity>>;
+
+constexpr float WIDTH = 800;
+constexpr float HEIGHT = 600;
+
+Obstacle* addCircle(Entities& entities, float x, float y, float radius) {
+    entities.push_back(std::make_unique<Obstacle>(Vector2(x, y), radius, true));
+    return static_cast<Obstacle*>(entities.back().get());
+}
+
+Obstacle* addBox(Entities& entities, float x, float y, float w, float h, float rotation = 0) {
+    entities.push_back(std::make_unique<Obstacle>(Vector2(x, y), ObstacleShape::RECTANGLE, w, h, rotation, true));
+    return static_cast<Obstacle*>(entities.back().get());
+}
+
+// Counts the cells where field differs from a full rebuild over the active
+// obstacles: distance, blocked state, and the steering direction
+int mismatchesWithRebuild(const FlowField& field, const Entities& entities, const Vector2& target) {
+    FlowField rebuilt;
+    rebuilt.setWorldBounds(WIDTH, HEIGHT);
+    rebuilt.update(entities, target);
+
+    int mismatches = 0;
+    float cell = field.getCellSize();
+    for (int row = 0; row < field.getRows(); row++) {
+        for (int col = 0; col < field.getColumns(); col++) {
+            Vector2 p((col + 0.5f) * cell, (row + 0.5f) * cell);
+            Vector2 got(0, 0), expected(0, 0);
+            bool steers = field.steer(p, target, got);
+            bool expectedSteers = rebuilt.steer(p, target, expected);
+            if (field.getDistanceAt(p) != rebuilt.getDistanceAt(p) ||
+                field.isBlockedAt(p) != rebuilt.isBlockedAt(p) ||
+                steers != expectedSteers || got.x != expected.x || got.y != expected.y) {
+                mismatches++;
+            }
+        }
+    }
+    return mismatches;
+}
+
+// Removes obstacle the way the engine does and checks the repair
+void removeAndCheck(FlowField& field, Entities& entities, Obstacle* obstacle, const Vector2& target) {
+    int recomputes = field.getRecomputeCount();
+    field.removeObstacle(*obstacle);
+    obstacle->active = false;
+    field.update(entities, target);
+    CHECK_EQ(field.getRecomputeCount(), recomputes);
+    CHECK_EQ(mismatchesWithRebuild(field, entities, target), 0);
+}
+
+TEST_CASE(repair_matches_rebuild_after_adds_and_removals) {
+    Entities entities;
+    Vector2 target(100, 300);
+    std::vector<Obstacle*> obstacles;
+    // A wall with a gap, a rotated box, two overlapping circles that share
+    // cells, and a circle over the target itself
+    obstacles.push_back(addBox(entities, 400, 150, 30, 300));
+    obstacles.push_back(addBox(entities, 400, 520, 30, 160));
+    obstacles.push_back(addBox(entities, 250, 420, 160, 40, 0.6f));
+    obstacles.push_back(addCircle(entities, 600, 300, 50));
+    obstacles.push_back(addCircle(entities, 640, 320, 50));
+    obstacles.push_back(addCircle(entities, 100, 300, 20));
+
+    FlowField field;
+    field.setWorldBounds(WIDTH, HEIGHT);
+    field.update(entities, target);
+    CHECK_EQ(mismatchesWithRebuild(field, entities, target), 0);
+
+    // Additions rebuild; a scattered set covering many cells more than once
+    SimRandom rng(7);
+    for (int i = 0; i < 24; i++) {
+        float x = 40 + rng.nextFloat() * (WIDTH - 80);
+        float y = 40 + rng.nextFloat() * (HEIGHT - 80);
+        if (i % 2) {
+            obstacles.push_back(addCircle(entities, x, y, 15 + rng.nextFloat() * 40));
+        } else {
+            obstacles.push_back(addBox(entities, x, y, 20 + rng.nextFloat() * 120, 20 + rng.nextFloat() * 60,
+                                       rng.nextFloat() * 3.14159f));
+        }
+    }
+    field.markDirty();
+    field.update(entities, target);
+    CHECK_EQ(mismatchesWithRebuild(field, entities, target), 0);
+
+    // Then take them all out again, in a scrambled order
+    int repairs = field.getRepairCount();
+    for (size_t i = 0; i < obstacles.size(); i++) {
+        size_t pick = i + static_cast<size_t>(rng.nextInt(static_cast<int>(obstacles.size() - i)));
+        std::swap(obstacles[i], obstacles[pick]);
+        removeAndCheck(field, entities, obstacles[i], target);
+    }
+    CHECK(field.getRepairCount() > repairs);
+}
+
+TEST_CASE(repair_reconnects_a_sealed_room) {
+    Entities entities;
+    Vector2 target(100, 100);
+    // A closed ring of walls around (600, 400); its inside cannot be reached
+    addBox(entities, 600, 270, 260, 30);
+    Obstacle* south = addBox(entities, 600, 530, 260, 30);
+    addBox(entities, 470, 400, 30, 260);
+    addBox(entities, 730, 400, 30, 260);
+
+    FlowField field;
+    field.setWorldBounds(WIDTH, HEIGHT);
+    field.update(entities, target);
+    Vector2 inside(600, 400);
+    CHECK_EQ(field.getDistanceAt(inside), FlowField::UNREACHABLE);
+
+    removeAndCheck(field, entities, south, target);
+    CHECK(field.getDistanceAt(inside) != FlowField::UNREACHABLE);
+    Vector2 out(0, 0);
+    CHECK(field.steer(inside, target, out));
+    // The way out is through the opened south side
+    CHECK(out.y > 0);
+}
+
+TEST_CASE(repair_waits_for_a_pending_rebuild) {
+    Entities entities;
+    Vector2 target(100, 300);
+    Obstacle* wall = addBox(entities, 400, 300, 30, 400);
+    FlowField field;
+    field.setWorldBounds(WIDTH, HEIGHT);
+    field.update(entities, target);
+
+    // An addition marks the field dirty; the removal then leaves it to the
+    // rebuild instead of repairing a field that is already stale
+    addCircle(entities, 600, 100, 40);
+    field.markDirty();
+    int repairs = field.getRepairCount();
+    field.removeObstacle(*wall);
+    wall->active = false;
+    CHECK_EQ(field.getRepairCount(), repairs);
+    field.update(entities, target);
+    CHECK_EQ(mismatchesWithRebuild(field, entities, target), 0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) { return runTests(argc, argv); }
@@ -0,0 +1,62 @@
+// FrameArena: alignment, tail reuse and heap fallback
+//
+// The block comes from new[], which only promises alignof(max_align_t), so
+// over-aligned requests must be aligned by address rather than by offset.
+
+#include "test_harness.h"
+#include "../../wasm/include/memory/frame_arena.h"
+#include <cstdint>
+
+namespace {
+
+bool aligned(const void* p, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+}
+
+TEST_CASE(allocations_are_aligned_by_address) {
+    FrameArena arena(4096);
+    const size_t alignments[] = {1, 4, 8, 16, 32, 64, 128, 256};
+    for (int frame = 0; frame < 2; frame++) {
+        for (size_t alignment : alignments) {
+            // An odd-sized allocation first, so the offset is never aligned
+            arena.allocate(3, 1);
+            void* p = arena.allocate(24, alignment);
+            CHECK(aligned(p, alignment));
+            CHECK(arena.owns(p));
+        }
+        CHECK_EQ(arena.getLastFrameFallbacks(), 0u);
+        arena.reset();
+    }
+}
+
+TEST_CASE(last_allocation_can_be_given_back) {
+    FrameArena arena(1024);
+    arena.allocate(10, 1);
+    void* p = arena.allocate(100, 64);
+    size_t used = arena.getUsed();
+    // The padding before it stays used
+    arena.deallocate(p, 100);
+    CHECK_EQ(arena.getUsed(), used - 100);
+    // Served from the same place again
+    CHECK(arena.allocate(100, 64) == p);
+    CHECK_EQ(arena.getUsed(), used);
+}
+
+TEST_CASE(overflow_falls_back_and_regrows) {
+    FrameArena arena(256);
+    void* inside = arena.allocate(200);
+    void* outside = arena.allocate(200, 64);
+    CHECK(arena.owns(inside));
+    CHECK(!arena.owns(outside));
+    CHECK(aligned(outside, 64));
+    CHECK_EQ(arena.getFallbackCount(), 1u);
+    arena.reset();
+    CHECK(arena.getCapacity() >= 400);
+    CHECK(arena.owns(arena.allocate(200)));
+    CHECK(arena.owns(arena.allocate(200, 64)));
+    CHECK_EQ(arena.getFallbackCount(), 1u);
+}
+
+} // namespace
+
+int main(int argc, char** argv) { return runTests(argc, argv); }
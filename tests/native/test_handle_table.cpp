@@ -0,0 +1,154 @@
+// Generational entity handles: stale ids never reach a reused slot
+//
+// HandleTable on its own, then through GameEngine, whose entity ids are
+// handles into its swap-removed entity list.
+
+#include "test_harness.h"
+#include "../../wasm/include/utils/handle_table.h"
+#include "../../wasm/include/game_engine.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+TEST_CASE(released_handle_is_stale_after_slot_reuse) {
+    HandleTable table;
+    int a = table.allocate(0);
+    int b = table.allocate(1);
+    CHECK(a != HandleTable::NULL_HANDLE && b != HandleTable::NULL_HANDLE);
+    CHECK(a != b);
+    CHECK_EQ(table.resolve(a), 0u);
+    CHECK_EQ(table.resolve(b), 1u);
+
+    CHECK(table.release(a));
+    CHECK(!table.isValid(a));
+    CHECK(!table.release(a));    // Twice is a no-op
+
+    // The slot comes back with the next generation
+    int c = table.allocate(0);
+    CHECK_EQ(static_cast<uint32_t>(c) & HandleTable::INDEX_MASK,
+             static_cast<uint32_t>(a) & HandleTable::INDEX_MASK);
+    CHECK(c != a);
+    CHECK_EQ(table.resolve(a), HandleTable::INVALID_INDEX);
+    CHECK_EQ(table.resolve(c), 0u);
+    CHECK_EQ(table.size(), 2u);
+}
+
+TEST_CASE(bogus_handles_resolve_to_nothing) {
+    HandleTable table;
+    int live = table.allocate(7);
+    CHECK_EQ(table.resolve(HandleTable::NULL_HANDLE), HandleTable::INVALID_INDEX);
+    CHECK_EQ(table.resolve(-live), HandleTable::INVALID_INDEX);
+    // A slot never issued, and the right slot with a generation never issued
+    CHECK_EQ(table.resolve(HandleTable::makeHandle(5, 1)), HandleTable::INVALID_INDEX);
+    uint32_t index = static_cast<uint32_t>(live) & HandleTable::INDEX_MASK;
+    CHECK_EQ(table.resolve(HandleTable::makeHandle(index, 9)), HandleTable::INVALID_INDEX);
+    CHECK_EQ(table.resolve(live), 7u);
+}
+
+TEST_CASE(generation_wraps_without_reissuing_a_live_handle) {
+    HandleTable table;
+    int first = table.allocate(0);
+    int handle = first;
+    for (uint32_t i = 0; i < HandleTable::MAX_GENERATION; i++) {
+        CHECK(table.release(handle));
+        handle = table.allocate(0);
+        CHECK(handle > 0);
+    }
+    // A full cycle later the first handle is issued again; nothing between
+    CHECK_EQ(handle, first);
+    CHECK_EQ(table.capacity(), 1u);
+}
+
+TEST_CASE(release_all_keeps_old_handles_stale) {
+    HandleTable table;
+    std::vector<int> handles;
+    for (uint32_t i = 0; i < 10; i++) handles.push_back(table.allocate(i));
+    table.releaseAll();
+    CHECK_EQ(table.size(), 0u);
+    for (int handle : handles) CHECK(!table.isValid(handle));
+    for (uint32_t i = 0; i < 10; i++) {
+        int fresh = table.allocate(i);
+        CHECK(std::find(handles.begin(), handles.end(), fresh) == handles.end());
+    }
+}
+
+TEST_CASE(relocate_follows_swap_removal) {
+    HandleTable table;
+    int a = table.allocate(0);
+    int b = table.allocate(1);
+    int c = table.allocate(2);
+    // Remove a by moving the last object, c, into its place
+    table.release(a);
+    table.relocate(c, 0);
+    CHECK_EQ(table.resolve(c), 0u);
+    CHECK_EQ(table.resolve(b), 1u);
+    CHECK(!table.isValid(a));
+}
+
+bool hasEntity(const GameEngine& engine, int id) {
+    for (const auto& entity : engine.getEntities()) {
+        if (entity->id == id) return true;
+    }
+    return false;
+}
+
+TEST_CASE(engine_ignores_stale_entity_ids) {
+    GameEngine engine(1000, 1000, 0);
+    engine.clearEntities();
+    int a = engine.createEnemy(100, 100);
+    int b = engine.createEnemy(200, 100);
+    int c = engine.createEnemy(300, 100);
+    CHECK_EQ(engine.getEntityCount(), 3);
+
+    // b's slot goes to d; b must not reach d
+    engine.removeEntity(b);
+    int d = engine.createEnemy(400, 100);
+    CHECK(d != b);
+    engine.removeEntity(b);
+    CHECK_EQ(engine.getEntityCount(), 3);
+    CHECK(hasEntity(engine, d));
+
+    // Swap removal moved entities around; every live id still removes
+    // exactly its own entity
+    for (int id : {a, d, c}) {
+        int before = engine.getEntityCount();
+        engine.removeEntity(id);
+        CHECK_EQ(engine.getEntityCount(), before - 1);
+        CHECK(!hasEntity(engine, id));
+    }
+    CHECK_EQ(engine.getEntityCount(), 0);
+}
+
+TEST_CASE(engine_player_calls_reject_a_stale_player_id) {
+    GameEngine engine(1000, 1000, 0);
+    engine.clearEntities();
+    int old = engine.createPlayer(500, 500);
+    engine.removeEntity(old);
+    int current = engine.createPlayer(500, 500);
+    CHECK(current != old);
+    CHECK_EQ(engine.getPlayerId(), current);
+
+    const Player* player = nullptr;
+    for (const auto& entity : engine.getEntities()) {
+        if (entity->id == current) player = static_cast<const Player*>(entity.get());
+    }
+    CHECK(player != nullptr);
+    if (!player) return;
+
+    engine.activateBoost(old);
+    CHECK(!player->boosting);
+    engine.activateBoost(current);
+    CHECK(player->boosting);
+
+    // Ids from before a restart are stale in the new game too
+    engine.clearEntities();
+    int fresh = engine.createEnemy(10, 10);
+    CHECK(fresh != current && fresh != old);
+    engine.removeEntity(current);
+    CHECK_EQ(engine.getEntityCount(), 1);
+}
+
+} // namespace
+
+int main(int argc, char** argv) { return runTests(argc, argv); }
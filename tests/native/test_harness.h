@@ -0,0 +1,77 @@
+#ifndef TEST_HARNESS_H
+#define TEST_HARNESS_H
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Minimal test registry for the native engine tests (scripts/test-native.sh)
+//
+// TEST_CASE(name) { ... } registers a case; CHECK* record a failure with
+// its location and let the case carry on, so one run reports every broken
+// expectation. Each test file ends with
+//   int main(int argc, char** argv) { return runTests(argc, argv); }
+// and runs every case, or only those whose name contains argv[1].
+
+namespace TestHarness {
+
+struct TestCase {
+    const char* name;
+    void (*fn)();
+};
+
+inline std::vector<TestCase>& registry() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline bool add(const char* name, void (*fn)()) {
+    registry().push_back({name, fn});
+    return true;
+}
+
+inline void fail(const char* file, int line, const char* what) {
+    std::printf("    %s:%d: %s\n", file, line, what);
+    failures()++;
+}
+
+} // namespace TestHarness
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static const bool name##_registered = TestHarness::add(#name, &name); \
+    static void name()
+
+#define CHECK(cond) \
+    do { if (!(cond)) TestHarness::fail(__FILE__, __LINE__, "CHECK(" #cond ")"); } while (0)
+
+#define CHECK_EQ(a, b) \
+    do { if (!((a) == (b))) TestHarness::fail(__FILE__, __LINE__, "CHECK_EQ(" #a ", " #b ")"); } while (0)
+
+#define CHECK_NEAR(a, b, eps) \
+    do { if (!(std::fabs(static_cast<double>(a) - static_cast<double>(b)) <= (eps))) \
+        TestHarness::fail(__FILE__, __LINE__, "CHECK_NEAR(" #a ", " #b ", " #eps ")"); } while (0)
+
+inline int runTests(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int run = 0, failed = 0;
+    for (const TestHarness::TestCase& test : TestHarness::registry()) {
+        if (filter && !std::strstr(test.name, filter)) continue;
+        int before = TestHarness::failures();
+        test.fn();
+        run++;
+        bool ok = TestHarness::failures() == before;
+        if (!ok) failed++;
+        std::printf("  %s %s\n", ok ? "ok  " : "FAIL", test.name);
+    }
+    std::printf("%d of %d passed\n", run - failed, run);
+    return failed ? 1 : 0;
+}
+
+#endif // TEST_HARNESS_H
@@ -0,0 +1,177 @@
+// InputLog files and replay: a recorded session re-simulates to its checksum
+//
+// Sessions are recorded through GameEngine's public calls, serialised,
+// loaded back and replayed headless with GameEngine::runReplay.
+
+#include "test_harness.h"
+#include "../../wasm/include/game_engine.h"
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// A session touching most recorded ops: movement, shots, boosts, spawns,
+// removals and uneven frame times with several substeps
+void playSession(GameEngine& engine, int frames) {
+    engine.startGame();
+    int wolf = engine.createWolf(300, 300, true);
+    for (int f = 0; f < frames; f++) {
+        float angle = f * 0.05f;
+        engine.updatePlayerInput(std::cos(angle), std::sin(angle), 400 + 300 * std::cos(angle * 2), 500);
+        if (f % 7 == 0) engine.playerShoot(std::cos(angle * 2), std::sin(angle * 2));
+        if (f % 40 == 10) engine.activateBoost(engine.getPlayerId());
+        if (f % 40 == 25) engine.deactivateBoost(engine.getPlayerId());
+        if (f == 30) engine.createEnemy(900, 200);
+        if (f == 60) engine.removeEntity(wolf);
+        engine.update(f % 5 == 0 ? 2.5f / 60.0f : 1.0f / 60.0f);
+    }
+}
+
+struct Recording {
+    GameEngine engine{1600, 1000, 0};
+    std::vector<uint8_t> bytes;
+
+    explicit Recording(int frames, uint32_t seed = 77) {
+        engine.startRecording(seed);
+        playSession(engine, frames);
+        engine.stopRecording();
+        bytes = engine.getInputLog().getBytes();
+    }
+};
+
+TEST_CASE(serialize_and_load_round_trip) {
+    Recording session(120);
+    const InputLog& original = session.engine.getInputLog();
+    CHECK(!original.isRecording());
+    CHECK_EQ(session.bytes.size(),
+             sizeof(InputLog::Header) + original.getRecords().size() * sizeof(InputLog::Record));
+
+    InputLog loaded;
+    CHECK(loaded.load(session.bytes.data(), session.bytes.size()));
+    const InputLog::Header& a = original.header();
+    const InputLog::Header& b = loaded.header();
+    CHECK_EQ(b.version, InputLog::VERSION);
+    CHECK_EQ(b.seed, 77u);
+    CHECK_EQ(b.worldWidth, 1600.0f);
+    CHECK_EQ(b.worldHeight, 1000.0f);
+    CHECK_EQ(b.recordCount, a.recordCount);
+    CHECK_EQ(b.finalChecksum, session.engine.stateChecksum());
+    CHECK_EQ(b.finalTick, session.engine.getFrameNumber());
+    CHECK_EQ(b.complete, 1);
+    CHECK_EQ(loaded.getRecords().size(), original.getRecords().size());
+    CHECK(std::memcmp(loaded.getRecords().data(), original.getRecords().data(),
+                      original.getRecords().size() * sizeof(InputLog::Record)) == 0);
+
+    // The JavaScript path: bytes copied into loadBuffer, then load(size)
+    InputLog viaBuffer;
+    std::memcpy(viaBuffer.loadBuffer(session.bytes.size()), session.bytes.data(), session.bytes.size());
+    CHECK(viaBuffer.load(session.bytes.size()));
+    CHECK_EQ(viaBuffer.getRecords().size(), original.getRecords().size());
+}
+
+TEST_CASE(one_step_record_per_tick) {
+    Recording session(90);
+    uint32_t steps = 0;
+    uint32_t lastTick = 0;
+    bool ordered = true;
+    for (const InputLog::Record& record : session.engine.getInputLog().getRecords()) {
+        if (record.tick < lastTick) ordered = false;
+        lastTick = record.tick;
+        if (record.op == InputLog::Op::STEP) steps++;
+    }
+    CHECK(ordered);
+    CHECK_EQ(steps, session.engine.getFrameNumber());
+}
+
+TEST_CASE(load_rejects_bad_logs) {
+    Recording session(20);
+    std::vector<uint8_t> bytes = session.bytes;
+    InputLog log;
+
+    CHECK(!log.load(bytes.data(), sizeof(InputLog::Header) - 1));
+    CHECK(!log.load(bytes.data(), bytes.size() - 1));    // Last record cut short
+
+    auto patched = [&bytes](size_t offset, uint16_t value) {
+        std::vector<uint8_t> copy = bytes;
+        std::memcpy(copy.data() + offset, &value, sizeof(value));
+        return copy;
+    };
+    std::vector<uint8_t> badMagic = patched(offsetof(InputLog::Header, magic), 0x1234);
+    std::vector<uint8_t> oldVersion = patched(offsetof(InputLog::Header, version), InputLog::VERSION - 1);
+    std::vector<uint8_t> badRecord = patched(offsetof(InputLog::Header, recordSize), sizeof(InputLog::Record) + 4);
+    CHECK(!log.load(badMagic.data(), badMagic.size()));
+    CHECK(!log.load(oldVersion.data(), oldVersion.size()));
+    CHECK(!log.load(badRecord.data(), badRecord.size()));
+
+    CHECK(log.load(bytes.data(), bytes.size()));
+}
+
+TEST_CASE(replay_reproduces_the_checksum) {
+    Recording session(240);
+    InputLog log;
+    CHECK(log.load(session.bytes.data(), session.bytes.size()));
+
+    GameEngine::ReplayResult result = GameEngine::runReplay(log);
+    CHECK(result.loaded);
+    CHECK(result.complete);
+    CHECK(result.matches);
+    CHECK_EQ(result.ticks, session.engine.getFrameNumber());
+    CHECK_EQ(result.checksum, session.engine.stateChecksum());
+
+    // Replays are themselves deterministic
+    GameEngine::ReplayResult again = GameEngine::runReplay(log);
+    CHECK_EQ(again.checksum, result.checksum);
+}
+
+TEST_CASE(replay_of_an_altered_log_diverges) {
+    Recording session(240);
+    std::vector<uint8_t> bytes = session.bytes;
+    InputLog log;
+    CHECK(log.load(bytes.data(), bytes.size()));
+
+    // Nudge one early movement record; the checksum must notice
+    size_t first = sizeof(InputLog::Header);
+    size_t count = log.getRecords().size();
+    bool altered = false;
+    for (size_t i = 0; i < count && !altered; i++) {
+        InputLog::Record record;
+        std::memcpy(&record, bytes.data() + first + i * sizeof(record), sizeof(record));
+        if (record.op == InputLog::Op::PLAYER_INPUT && record.tick > 5) {
+            record.v[0] = -record.v[0];
+            std::memcpy(bytes.data() + first + i * sizeof(record), &record, sizeof(record));
+            altered = true;
+        }
+    }
+    CHECK(altered);
+
+    InputLog changed;
+    CHECK(changed.load(bytes.data(), bytes.size()));
+    GameEngine::ReplayResult result = GameEngine::runReplay(changed);
+    CHECK(result.loaded);
+    CHECK(!result.matches);
+    CHECK(result.checksum != session.engine.stateChecksum());
+}
+
+TEST_CASE(unfinished_recording_never_matches) {
+    GameEngine engine(1600, 1000, 0);
+    engine.startRecording(5);
+    playSession(engine, 30);
+    CHECK(engine.isRecording());
+    // Serialised mid-session: no final checksum, so nothing to match
+    InputLog partial = engine.getInputLog();
+    std::vector<uint8_t> bytes = partial.serialize();
+    InputLog log;
+    CHECK(log.load(bytes.data(), bytes.size()));
+    GameEngine::ReplayResult result = GameEngine::runReplay(log);
+    CHECK(result.loaded);
+    CHECK(!result.complete);
+    CHECK(!result.matches);
+    CHECK_EQ(result.ticks, engine.getFrameNumber());
+    CHECK_EQ(result.checksum, engine.stateChecksum());
+}
+
+} // namespace
+
+int main(int argc, char** argv) { return runTests(argc, argv); }
@@ -0,0 +1,109 @@
+// ObjectPool and the per-thread entity pools
+//
+// Run with TEST_FLAGS="-fsanitize=address" to confirm a worker thread's
+// pools are released when it exits.
+
+#include "test_harness.h"
+#include "../../wasm/include/memory/object_pool.h"
+#include "../../wasm/include/entities/projectile.h"
+#include "../../wasm/include/entities/enemy.h"
+#include "../../wasm/include/entities/wolf.h"
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+TEST_CASE(slots_are_reused_and_counted) {
+    ObjectPool<double> pool(4);
+    std::vector<void*> slots;
+    for (int i = 0; i < 6; i++) slots.push_back(pool.allocate());
+    ObjectPool<double>::Stats stats = pool.getStats();
+    CHECK_EQ(stats.capacity, 8u);
+    CHECK_EQ(stats.slabs, 2u);
+    CHECK_EQ(stats.inUse, 6u);
+    for (void* slot : slots) CHECK(pool.owns(slot));
+
+    void* last = slots.back();
+    pool.deallocate(last);
+    CHECK_EQ(pool.allocate(), last);    // Most recently freed comes back first
+    for (void* slot : slots) pool.deallocate(slot);
+    CHECK_EQ(pool.getInUseCount(), 0u);
+    CHECK_EQ(pool.getStats().peakInUse, 6u);
+
+    double outside = 0;
+    CHECK(!pool.owns(&outside));
+}
+
+TEST_CASE(entities_use_their_thread_pool) {
+    size_t before = Projectile::pool().getInUseCount();
+    {
+        auto shot = std::make_unique<Projectile>(Vector2(1, 1), Vector2(1, 0), 10, 1);
+        CHECK(Projectile::pool().owns(shot.get()));
+        CHECK_EQ(Projectile::pool().getInUseCount(), before + 1);
+    }
+    CHECK_EQ(Projectile::pool().getInUseCount(), before);
+
+    // A worker's pools are its own and go away with it
+    const ObjectPool<Projectile>* mainPool = &Projectile::pool();
+    std::thread worker([mainPool]() {
+        CHECK(&Projectile::pool() != mainPool);
+        std::vector<std::unique_ptr<Entity>> made;
+        for (int i = 0; i < 3000; i++) {
+            made.push_back(std::make_unique<Projectile>(Vector2(0, 0), Vector2(0, 1), 5, 1));
+            made.push_back(std::make_unique<Enemy>(Vector2(0, 0)));
+            if (i % 10 == 0) made.push_back(std::make_unique<Wolf>(Vector2(0, 0), false));
+        }
+        CHECK_EQ(Projectile::pool().getInUseCount(), 3000u);
+        made.clear();
+        CHECK_EQ(Projectile::pool().getInUseCount(), 0u);
+        CHECK_EQ(Wolf::pool().getInUseCount(), 0u);
+    });
+    worker.join();
+    CHECK_EQ(Projectile::pool().getInUseCount(), before);
+}
+
+TEST_CASE(cross_thread_free_is_reported_and_dropped) {
+    ErrorHandler& errors = ErrorHandler::getInstance();
+    std::promise<Projectile*> made;
+    std::promise<void> freed;
+    // The worker stays alive until the free, so its slab does too
+    std::thread worker([&made, &freed]() {
+        made.set_value(new Projectile(Vector2(0, 0), Vector2(1, 0), 5, 1));
+        freed.get_future().wait();
+    });
+    Projectile* foreign = made.get_future().get();
+
+    size_t inUse = Projectile::pool().getInUseCount();
+    size_t capacity = Projectile::pool().getCapacity();
+    uint64_t reported = errors.totalReported();
+    delete foreign;
+    CHECK_EQ(errors.totalReported(), reported + 1);
+    CHECK_EQ(Projectile::pool().getInUseCount(), inUse);
+
+    // Not chained into this thread's free list
+    std::vector<std::unique_ptr<Projectile>> fill;
+    for (size_t i = 0; i < capacity - inUse; i++) {
+        fill.push_back(std::make_unique<Projectile>(Vector2(0, 0), Vector2(1, 0), 5, 1));
+        CHECK(fill.back().get() != foreign);
+    }
+    freed.set_value();
+    worker.join();
+}
+
+TEST_CASE(pool_used_from_another_thread_is_reported) {
+    ErrorHandler& errors = ErrorHandler::getInstance();
+    ObjectPool<int> pool(4);
+    uint64_t reported = errors.totalReported();
+    std::thread worker([&pool]() {
+        ObjectPool<int>::UniquePtr value = pool.acquire(7);
+    });
+    worker.join();
+    // The acquire and the release each fail the owner check
+    CHECK_EQ(errors.totalReported(), reported + 2);
+}
+
+} // namespace
+
+int main(int argc, char** argv) { return runTests(argc, argv); }
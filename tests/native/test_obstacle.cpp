@@ -0,0 +1,167 @@
+// Obstacle: rotated-box push-out, swept contact and the cached frame
+//
+// Collision treats every obstacle as a rounded box in its local frame.
+// The expectations below are written in that frame and mapped to world
+// space, so a wrong sign in a rotation shows up as a wrong normal.
+
+#include "test_harness.h"
+#include "../../wasm/include/entities/obstacle.h"
+#include <cmath>
+
+namespace {
+
+constexpr float EPS = 1e-3f;
+const Vector2 CENTRE(200, 200);
+const float ROTATION = 0.5235988f;  // 30 degrees
+
+// 100 x 40 box at CENTRE, rotated by ROTATION
+Obstacle rotatedBox() {
+    return Obstacle(CENTRE, ObstacleShape::RECTANGLE, 100, 40, ROTATION);
+}
+
+// A point given in the box's local frame
+Vector2 world(float lx, float ly) {
+    float c = std::cos(ROTATION), s = std::sin(ROTATION);
+    return Vector2(CENTRE.x + lx * c - ly * s, CENTRE.y + lx * s + ly * c);
+}
+
+// A direction given in the box's local frame
+Vector2 worldDirection(float lx, float ly) {
+    return world(lx, ly) - CENTRE;
+}
+
+void checkVector(const Vector2& got, const Vector2& expected) {
+    CHECK_NEAR(got.x, expected.x, EPS);
+    CHECK_NEAR(got.y, expected.y, EPS);
+}
+
+// A mover of radius r that stepped from `from` to `to`
+Entity mover(const Vector2& from, const Vector2& to, float r) {
+    Entity entity(EntityType::PROJECTILE, to, r);
+    entity.previousPosition = from;
+    return entity;
+}
+
+TEST_CASE(penetration_through_a_face) {
+    Obstacle box = rotatedBox();
+    Vector2 normal;
+    // 2 units into the top face
+    float depth = box.penetration(world(10, 28), 10, normal);
+    CHECK_NEAR(depth, 2, EPS);
+    checkVector(normal, worldDirection(0, 1));
+}
+
+TEST_CASE(penetration_at_a_corner) {
+    Obstacle box = rotatedBox();
+    Vector2 normal;
+    // 3-4-5 from the (+x, +y) corner: 5 units into a radius of 10
+    float depth = box.penetration(world(53, 24), 10, normal);
+    CHECK_NEAR(depth, 5, EPS);
+    checkVector(normal, worldDirection(0.6f, 0.8f));
+}
+
+TEST_CASE(penetration_from_inside_leaves_through_nearest_face) {
+    Obstacle box = rotatedBox();
+    Vector2 normal;
+    // 20 from the -x face but only 5 from the -y face
+    float depth = box.penetration(world(-30, -15), 10, normal);
+    CHECK_NEAR(depth, 15, EPS);
+    checkVector(normal, worldDirection(0, -1));
+}
+
+TEST_CASE(penetration_push_out_clears_the_box) {
+    Obstacle box = rotatedBox();
+    const Vector2 centres[] = {world(10, 28), world(53, 24), world(-30, -15), world(-45, 2)};
+    for (const Vector2& centre : centres) {
+        Vector2 normal;
+        float depth = box.penetration(centre, 10, normal);
+        CHECK(depth > 0);
+        CHECK(box.overlapsCircle(centre, 10));
+        Vector2 resolved = centre + normal * (depth + 0.01f);
+        CHECK(!box.overlapsCircle(resolved, 10));
+        CHECK_NEAR(box.penetration(resolved, 10, normal), -0.01f, EPS);
+    }
+}
+
+TEST_CASE(penetration_is_negative_when_apart) {
+    Obstacle box = rotatedBox();
+    Vector2 normal;
+    CHECK_NEAR(box.penetration(world(0, 100), 10, normal), -70, EPS);
+    CHECK(!box.overlapsCircle(world(0, 100), 10));
+}
+
+TEST_CASE(penetration_of_a_circle_obstacle) {
+    Obstacle circle(Vector2(0, 0), 30);
+    Vector2 normal;
+    CHECK_NEAR(circle.penetration(Vector2(0, -40), 15, normal), 5, EPS);
+    checkVector(normal, Vector2(0, -1));
+}
+
+TEST_CASE(swept_contact_through_a_rotated_box) {
+    Obstacle box = rotatedBox();
+    // Along the local x axis, right through the box in one step: it
+    // touches when its centre is halfWidth + radius = 55 short of the middle
+    Entity bullet = mover(world(-200, 0), world(200, 0), 5);
+    CHECK_NEAR(box.sweptContactTime(bullet), (200 - 55) / 400.0f, EPS);
+    // Coming the other way enters through the other face
+    Entity back = mover(world(200, 10), world(-200, 10), 5);
+    CHECK_NEAR(box.sweptContactTime(back), (200 - 55) / 400.0f, EPS);
+}
+
+TEST_CASE(swept_contact_misses_and_starts) {
+    Obstacle box = rotatedBox();
+    // Parallel to the long side, just outside halfHeight + radius
+    CHECK_EQ(box.sweptContactTime(mover(world(-200, 26), world(200, 26), 5)), -1.0f);
+    // Stops short of the box
+    CHECK_EQ(box.sweptContactTime(mover(world(-200, 0), world(-60, 0), 5)), -1.0f);
+    // Moving away from it
+    CHECK_EQ(box.sweptContactTime(mover(world(-100, 0), world(-200, 0), 5)), -1.0f);
+    // Already inside at the start of the step
+    CHECK_EQ(box.sweptContactTime(mover(world(0, 0), world(300, 0), 5)), 0.0f);
+}
+
+TEST_CASE(swept_contact_with_a_circle_obstacle) {
+    Obstacle circle(Vector2(0, 0), 30);
+    // Touches once the centres are 35 apart
+    CHECK_NEAR(circle.sweptContactTime(mover(Vector2(-100, 0), Vector2(100, 0), 5)), 65 / 200.0f, EPS);
+    CHECK_EQ(circle.sweptContactTime(mover(Vector2(-100, 40), Vector2(100, 40), 5)), -1.0f);
+}
+
+TEST_CASE(frame_sets_radius_to_the_corner_distance) {
+    // A box's radius is its centre-to-corner distance, not max(w, h) / 2
+    Obstacle box(CENTRE, ObstacleShape::RECTANGLE, 60, 80);
+    CHECK_NEAR(box.radius, 50, EPS);
+    CHECK_NEAR(box.extentX, 30, EPS);
+    CHECK_NEAR(box.extentY, 40, EPS);
+
+    // Squares take their height from the width
+    Obstacle square(CENTRE, ObstacleShape::SQUARE, 40, 10);
+    CHECK_NEAR(square.radius, 20 * std::sqrt(2.0f), EPS);
+
+    // Circles keep theirs, as the rounding of a zero-size box
+    Obstacle circle(CENTRE, 25);
+    CHECK_NEAR(circle.radius, 25, EPS);
+    CHECK_NEAR(circle.cornerRadius, 25, EPS);
+    CHECK_NEAR(circle.halfWidth, 0, EPS);
+}
+
+TEST_CASE(frame_follows_changes_in_place) {
+    Obstacle box(CENTRE, ObstacleShape::RECTANGLE, 60, 80);
+    box.width = 120;
+    box.syncFrame();
+    CHECK_NEAR(box.halfWidth, 60, EPS);
+    CHECK_NEAR(box.radius, std::sqrt(60.0f * 60 + 40 * 40), EPS);
+
+    // A quarter turn swaps the world extents
+    box.setRotation(1.5707963f);
+    CHECK_NEAR(box.extentX, 40, EPS);
+    CHECK_NEAR(box.extentY, 60, EPS);
+    CHECK_NEAR(box.cosR, 0, EPS);
+    CHECK_NEAR(box.sinR, 1, EPS);
+    CHECK(box.containsPoint(CENTRE + Vector2(0, 55)));
+    CHECK(!box.containsPoint(CENTRE + Vector2(55, 0)));
+}
+
+} // namespace
+
+int main(int argc, char** argv) { return runTests(argc, argv); }
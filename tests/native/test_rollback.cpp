@@ -0,0 +1,209 @@
+// Rollback saves: records round trip, and restore + resimulate converges
+//
+// EntityRecord on its own for every entity type, then GameEngine's ring:
+// a rolled-back and re-simulated engine must match one that never rolled
+// back, tick for tick.
+
+#include "test_harness.h"
+#include "../../wasm/include/systems/rollback_buffer.h"
+#include "../../wasm/include/game_engine.h"
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+
+using Record = RollbackBuffer::EntityRecord;
+
+// capture -> instantiate -> apply -> capture gives the same bytes
+void checkRecordRoundTrip(const Entity& entity) {
+    Record saved;
+    saved.capture(entity);
+    std::unique_ptr<Entity> rebuilt = saved.instantiate();
+    CHECK(rebuilt != nullptr);
+    if (!rebuilt) return;
+    saved.apply(*rebuilt);
+    Record again;
+    again.capture(*rebuilt);
+    CHECK(std::memcmp(&saved, &again, sizeof(Record)) == 0);
+    CHECK_EQ(rebuilt->id, entity.id);
+    CHECK(rebuilt->type == entity.type);
+}
+
+void scramble(Entity& entity, float seed) {
+    entity.position = Vector2(100 + seed, 200 - seed);
+    entity.previousPosition = Vector2(99 + seed, 201 - seed);
+    entity.velocity = Vector2(seed * 0.5f, -3.25f);
+    entity.rotation = 1.5f + seed;
+    entity.health = entity.maxHealth * 0.4f;
+    entity.invulnerable = true;
+    entity.invulnerabilityTimer = 120;
+}
+
+TEST_CASE(entity_records_round_trip_every_type) {
+    Player player(Vector2(0, 0));
+    scramble(player, 1);
+    player.energy = 33;
+    player.boosting = true;
+    player.rollDirection = Vector2(0.6f, 0.8f);
+    player.score = 4200;
+    player.kills = 17;
+    player.multiShotDuration = 3.5f;
+    checkRecordRoundTrip(player);
+
+    Enemy enemy(Vector2(0, 0));
+    scramble(enemy, 2);
+    enemy.stunned = true;
+    enemy.stunDuration = 0.75f;
+    checkRecordRoundTrip(enemy);
+
+    Wolf wolf(Vector2(0, 0), true);
+    scramble(wolf, 3);
+    wolf.lungeTimer = 0.2f;
+    wolf.circlePosition = Vector2(40, 50);
+    wolf.packIndex = 2;
+    wolf.packSize = 5;
+    checkRecordRoundTrip(wolf);
+
+    Projectile projectile(Vector2(10, 10), Vector2(0, 1), 25, 7);
+    scramble(projectile, 4);
+    projectile.lifetime = 0.5f;
+    checkRecordRoundTrip(projectile);
+
+    PowerUp powerUp(Vector2(10, 10), PowerUpType::SHIELD);
+    scramble(powerUp, 5);
+    checkRecordRoundTrip(powerUp);
+
+    Obstacle box(Vector2(10, 10), ObstacleShape::RECTANGLE, 80, 30, 0.3f, true);
+    scramble(box, 6);
+    box.durability = 12;
+    checkRecordRoundTrip(box);
+}
+
+TEST_CASE(record_reader_stops_at_the_end) {
+    std::vector<uint8_t> block;
+    RollbackBuffer::Writer out(block);
+    out.put(uint32_t(7));
+    const float values[3] = {1, 2, 3};
+    out.putArray(values, 3);
+    CHECK_EQ(block.size(), sizeof(uint32_t) + sizeof(values));
+
+    RollbackBuffer::Reader in(block.data(), block.size());
+    uint32_t first = 0;
+    float back[3] = {};
+    CHECK(in.get(first));
+    CHECK(in.getArray(back, 3));
+    CHECK_EQ(first, 7u);
+    CHECK_EQ(back[2], 3.0f);
+    uint8_t extra = 0;
+    CHECK(!in.get(extra));
+    CHECK(!in.ok());
+    CHECK(!in.get(first));    // Still refused once failed
+}
+
+// Movement for a tick; the rolled-back engine first sees the wrong one
+void inputFor(GameEngine& engine, uint32_t tick, bool late) {
+    float angle = tick * 0.07f + (late ? 2.0f : 0.0f);
+    engine.updatePlayerInput(std::cos(angle), std::sin(angle), 900, 300);
+    if (tick % 9 == 0) engine.playerShoot(std::cos(angle), std::sin(angle));
+}
+
+struct Match {
+    GameEngine engine{1600, 1000, 0};
+
+    explicit Match(int depth) {
+        engine.setSeed(31);
+        engine.setAdaptiveQuality(false);
+        engine.setRollbackDepth(depth);
+        engine.startGame();
+    }
+
+    // One fixed tick with its input, the way a rollback client runs them
+    void tick(bool late = false) {
+        inputFor(engine, engine.getFrameNumber() + 1, late);
+        engine.resimulate(1);
+    }
+};
+
+TEST_CASE(rollback_restores_the_saved_tick) {
+    Match match(16);
+    std::vector<uint32_t> checksums;
+    for (int i = 0; i < 40; i++) {
+        match.tick();
+        checksums.push_back(match.engine.stateChecksum());
+    }
+    uint32_t newest = match.engine.getFrameNumber();
+    CHECK_EQ(match.engine.getOldestRollbackFrame(), static_cast<int>(newest - 15));
+    CHECK(!match.engine.canRollbackTo(newest - 16));
+    CHECK(!match.engine.rollbackTo(newest - 16));
+
+    uint32_t target = newest - 10;
+    CHECK(match.engine.rollbackTo(target));
+    CHECK_EQ(match.engine.getFrameNumber(), target);
+    CHECK_EQ(match.engine.stateChecksum(), checksums[target - 1]);
+    // Newer saves are gone: that timeline no longer exists
+    CHECK(!match.engine.canRollbackTo(target + 1));
+    CHECK(match.engine.canRollbackTo(target));
+
+    // Rolling back to the tick just restored changes nothing
+    CHECK(match.engine.rollbackTo(target));
+    CHECK_EQ(match.engine.stateChecksum(), checksums[target - 1]);
+}
+
+TEST_CASE(resimulation_matches_an_uninterrupted_run) {
+    Match truth(32), rolled(32);
+    const int LATE = 12;
+
+    for (int i = 0; i < 150; i++) truth.tick();
+    for (int i = 0; i < 150 - LATE; i++) rolled.tick();
+    // The last ticks ran on a prediction that turned out wrong
+    for (int i = 0; i < LATE; i++) rolled.tick(true);
+    CHECK_EQ(rolled.engine.getFrameNumber(), truth.engine.getFrameNumber());
+    CHECK(rolled.engine.stateChecksum() != truth.engine.stateChecksum());
+
+    // The real input arrives: back to the last agreed tick and forward again
+    uint32_t agreed = rolled.engine.getFrameNumber() - LATE;
+    CHECK(rolled.engine.rollbackTo(agreed));
+    for (int i = 0; i < LATE; i++) rolled.tick();
+    CHECK_EQ(rolled.engine.getFrameNumber(), truth.engine.getFrameNumber());
+    CHECK_EQ(rolled.engine.stateChecksum(), truth.engine.stateChecksum());
+
+    // And the two stay together afterwards: nothing unsaved leaked through
+    for (int i = 0; i < 60; i++) {
+        truth.tick();
+        rolled.tick();
+    }
+    CHECK_EQ(rolled.engine.stateChecksum(), truth.engine.stateChecksum());
+}
+
+TEST_CASE(latched_input_is_part_of_the_save) {
+    Match truth(8), rolled(8);
+    for (int i = 0; i < 20; i++) {
+        truth.tick();
+        rolled.tick();
+    }
+    // Roll back one tick and resimulate without any new input: the input
+    // latched at that tick must come back with the save
+    uint32_t frame = rolled.engine.getFrameNumber();
+    rolled.engine.updatePlayerInput(-1, 0, 0, 0);
+    CHECK(rolled.engine.rollbackTo(frame));
+    truth.engine.resimulate(5);
+    rolled.engine.resimulate(5);
+    CHECK_EQ(rolled.engine.stateChecksum(), truth.engine.stateChecksum());
+}
+
+TEST_CASE(rollback_is_refused_while_recording) {
+    GameEngine engine(1600, 1000, 0);
+    engine.setRollbackDepth(8);
+    engine.startRecording(3);
+    engine.startGame();
+    engine.resimulate(4);
+    CHECK(!engine.saveRollbackState());
+    CHECK(!engine.rollbackTo(engine.getFrameNumber()));
+    CHECK_EQ(engine.getOldestRollbackFrame(), -1);
+}
+
+} // namespace
+
+int main(int argc, char** argv) { return runTests(argc, argv); }
@@ -0,0 +1,299 @@
+// SnapshotSystem delta blobs, decoded by the layout in snapshot_system.h
+//
+// A mirror that applies every delta the way snapshot-decoder.js does must
+// end up holding exactly the live entities, whatever base it syncs from.
+
+#include "test_harness.h"
+#include "../../wasm/include/systems/snapshot_system.h"
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct Decoded {
+    struct Item {
+        int32_t id;
+        uint8_t type;
+        bool spawned;
+        float x, y, vx, vy, rotation, health;
+        float radius, maxHealth;
+    };
+
+    uint8_t version;
+    bool full;
+    uint32_t sequence;
+    uint32_t baseSequence;
+    uint8_t gameState;
+    uint16_t wave;
+    int32_t score;
+    std::vector<Item> entities;
+    std::vector<int32_t> despawned;
+    bool consumed;    // Every byte read, none past the end
+};
+
+class Reader {
+    const std::vector<uint8_t>& bytes;
+    size_t offset = 0;
+public:
+    bool overrun = false;
+    explicit Reader(const std::vector<uint8_t>& data) : bytes(data) {}
+    template<typename T>
+    T get() {
+        T value{};
+        if (offset + sizeof(T) > bytes.size()) {
+            overrun = true;
+            return value;
+        }
+        std::memcpy(&value, &bytes[offset], sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+    bool atEnd() const { return offset == bytes.size(); }
+};
+
+Decoded decode(const std::vector<uint8_t>& blob) {
+    Reader r(blob);
+    Decoded d;
+    d.version = r.get<uint8_t>();
+    d.full = (r.get<uint8_t>() & SnapshotSystem::FLAG_FULL) != 0;
+    r.get<uint16_t>();
+    d.sequence = r.get<uint32_t>();
+    d.baseSequence = r.get<uint32_t>();
+    d.gameState = r.get<uint8_t>();
+    r.get<uint8_t>();
+    d.wave = r.get<uint16_t>();
+    d.score = r.get<int32_t>();
+    uint16_t entityCount = r.get<uint16_t>();
+    uint16_t despawnCount = r.get<uint16_t>();
+    for (uint16_t i = 0; i < entityCount; i++) {
+        Decoded::Item e{};
+        e.id = r.get<int32_t>();
+        e.type = r.get<uint8_t>();
+        e.spawned = (r.get<uint8_t>() & SnapshotSystem::ENTITY_SPAWNED) != 0;
+        r.get<uint16_t>();
+        e.x = r.get<float>();
+        e.y = r.get<float>();
+        e.vx = r.get<float>();
+        e.vy = r.get<float>();
+        e.rotation = r.get<float>();
+        e.health = r.get<float>();
+        if (e.spawned) {
+            e.radius = r.get<float>();
+            e.maxHealth = r.get<float>();
+        }
+        d.entities.push_back(e);
+    }
+    for (uint16_t i = 0; i < despawnCount; i++) d.despawned.push_back(r.get<int32_t>());
+    d.consumed = !r.overrun && r.atEnd();
+    return d;
+}
+
+// SnapshotMirror from snapshot-decoder.js
+struct Mirror {
+    uint32_t sequence = 0;
+    std::map<int32_t, Decoded::Item> entities;
+
+    bool apply(const Decoded& d) {
+        if (d.full) entities.clear();
+        else if (d.baseSequence != sequence) return false;
+        for (const Decoded::Item& e : d.entities) {
+            auto it = entities.find(e.id);
+            if (it != entities.end() && !e.spawned) {
+                Decoded::Item& held = it->second;
+                held.x = e.x;
+                held.y = e.y;
+                held.vx = e.vx;
+                held.vy = e.vy;
+                held.rotation = e.rotation;
+                held.health = e.health;
+            } else {
+                entities[e.id] = e;
+            }
+        }
+        for (int32_t id : d.despawned) entities.erase(id);
+        sequence = d.sequence;
+        return true;
+    }
+};
+
+using EntityList = std::vector<std::unique_ptr<Entity>>;
+
+Entity* add(EntityList& list, EntityType type, float x, float y, float radius = 10) {
+    list.push_back(std::make_unique<Entity>(type, Vector2(x, y), radius));
+    return list.back().get();
+}
+
+// The mirror holds exactly the active entities with their current values
+void checkMirrors(const Mirror& mirror, const EntityList& list) {
+    size_t live = 0;
+    for (const auto& entity : list) {
+        if (!entity->active) continue;
+        live++;
+        auto it = mirror.entities.find(entity->id);
+        CHECK(it != mirror.entities.end());
+        if (it == mirror.entities.end()) continue;
+        const Decoded::Item& e = it->second;
+        CHECK_EQ(e.type, static_cast<uint8_t>(entity->type));
+        CHECK_EQ(e.x, entity->position.x);
+        CHECK_EQ(e.y, entity->position.y);
+        CHECK_EQ(e.vx, entity->velocity.x);
+        CHECK_EQ(e.vy, entity->velocity.y);
+        CHECK_EQ(e.rotation, entity->rotation);
+        CHECK_EQ(e.health, entity->health);
+        CHECK_EQ(e.radius, entity->radius);
+        CHECK_EQ(e.maxHealth, entity->maxHealth);
+    }
+    CHECK_EQ(mirror.entities.size(), live);
+}
+
+const SnapshotSystem::Globals GLOBALS = {2, 7, 12345};
+
+TEST_CASE(first_snapshot_is_full_with_globals) {
+    EntityList list;
+    add(list, EntityType::PLAYER, 100, 100, 20);
+    add(list, EntityType::OBSTACLE, 300, 200, 45);
+    SnapshotSystem snapshots;
+    uint32_t seq = snapshots.capture(list);
+
+    Decoded d = decode(snapshots.buildSince(0, GLOBALS));
+    CHECK(d.consumed);
+    CHECK_EQ(d.version, SnapshotSystem::VERSION);
+    CHECK(d.full);
+    CHECK_EQ(d.sequence, seq);
+    CHECK_EQ(d.baseSequence, 0u);
+    CHECK_EQ(d.gameState, 2);
+    CHECK_EQ(d.wave, 7);
+    CHECK_EQ(d.score, 12345);
+    CHECK_EQ(d.entities.size(), 2u);
+    for (const Decoded::Item& e : d.entities) CHECK(e.spawned);
+    CHECK(d.despawned.empty());
+
+    Mirror mirror;
+    CHECK(mirror.apply(d));
+    checkMirrors(mirror, list);
+}
+
+TEST_CASE(delta_sends_only_changes_and_despawns) {
+    EntityList list;
+    Entity* mover = add(list, EntityType::ENEMY, 100, 100);
+    Entity* wall = add(list, EntityType::OBSTACLE, 500, 500, 40);
+    Entity* doomed = add(list, EntityType::PROJECTILE, 50, 50, 3);
+    SnapshotSystem snapshots;
+    uint32_t first = snapshots.capture(list);
+
+    mover->position = Vector2(110, 95);
+    mover->health = 80;
+    doomed->active = false;
+    snapshots.capture(list);
+
+    Decoded d = decode(snapshots.buildSince(first, GLOBALS));
+    CHECK(d.consumed);
+    CHECK(!d.full);
+    CHECK_EQ(d.baseSequence, first);
+    CHECK_EQ(d.entities.size(), 1u);
+    if (!d.entities.empty()) {
+        CHECK_EQ(d.entities[0].id, mover->id);
+        CHECK(!d.entities[0].spawned);
+        CHECK_EQ(d.entities[0].x, 110.0f);
+        CHECK_EQ(d.entities[0].health, 80.0f);
+    }
+    CHECK_EQ(d.despawned.size(), 1u);
+    if (!d.despawned.empty()) CHECK_EQ(d.despawned[0], doomed->id);
+
+    // The static obstacle never appears again, even a thousand captures later
+    uint32_t base = snapshots.getSequence();
+    for (int i = 0; i < 1000; i++) snapshots.capture(list);
+    Decoded idle = decode(snapshots.buildSince(base, GLOBALS));
+    CHECK(idle.entities.empty());
+    (void)wall;
+}
+
+TEST_CASE(mirrors_converge_from_any_base) {
+    EntityList list;
+    SnapshotSystem snapshots;
+    uint32_t rng = 99;
+    auto next = [&rng](uint32_t n) {
+        rng = rng * 1664525u + 1013904223u;
+        return (rng >> 8) % n;
+    };
+    for (int i = 0; i < 40; i++) add(list, EntityType::ENEMY, float(next(1000)), float(next(1000)));
+
+    // One mirror syncs every capture, one every fifth, one only at the end
+    Mirror every, fifth, last;
+    for (int step = 1; step <= 60; step++) {
+        for (auto& entity : list) {
+            if (!entity->active) continue;
+            switch (next(6)) {
+                case 0: entity->position.x += 1.5f; break;
+                case 1: entity->velocity = Vector2(float(next(9)) - 4, 2); break;
+                case 2: entity->health -= 1; break;
+                case 3: if (next(8) == 0) entity->active = false; break;
+                default: break;
+            }
+        }
+        for (int spawn = next(3); spawn > 0; spawn--) {
+            add(list, EntityType::WOLF, float(next(1000)), float(next(1000)), 12);
+        }
+        snapshots.capture(list);
+
+        CHECK(every.apply(decode(snapshots.buildSince(every.sequence, GLOBALS))));
+        if (step % 5 == 0) CHECK(fifth.apply(decode(snapshots.buildSince(fifth.sequence, GLOBALS))));
+    }
+    CHECK(last.apply(decode(snapshots.buildSince(last.sequence, GLOBALS))));
+
+    checkMirrors(every, list);
+    checkMirrors(fifth, list);
+    checkMirrors(last, list);
+}
+
+TEST_CASE(out_of_order_delta_is_rejected) {
+    EntityList list;
+    add(list, EntityType::ENEMY, 10, 10);
+    SnapshotSystem snapshots;
+    uint32_t first = snapshots.capture(list);
+    list[0]->position.x = 20;
+    snapshots.capture(list);
+
+    Mirror mirror;
+    CHECK(mirror.apply(decode(snapshots.buildSince(0, GLOBALS))));
+    // A delta from an older base than the mirror holds does not apply
+    Decoded stale = decode(snapshots.buildSince(first, GLOBALS));
+    CHECK(!stale.full);
+    CHECK(!mirror.apply(stale));
+    CHECK_EQ(mirror.sequence, snapshots.getSequence());
+}
+
+TEST_CASE(full_snapshot_when_despawn_ring_overflows) {
+    EntityList list;
+    SnapshotSystem snapshots;
+    add(list, EntityType::PLAYER, 0, 0);
+    uint32_t base = snapshots.capture(list);
+
+    // More despawns than the ring holds, one capture each
+    for (size_t i = 0; i < SnapshotSystem::DESPAWN_RING_SIZE + 10; i++) {
+        Entity* shot = add(list, EntityType::PROJECTILE, 1, 1, 3);
+        snapshots.capture(list);
+        shot->active = false;
+        snapshots.capture(list);
+    }
+
+    Decoded d = decode(snapshots.buildSince(base, GLOBALS));
+    CHECK(d.consumed);
+    CHECK(d.full);
+    CHECK(d.despawned.empty());
+    CHECK_EQ(d.entities.size(), 1u);
+
+    // A recent base is still served as a delta
+    uint32_t recent = snapshots.getSequence() - 2;
+    Decoded delta = decode(snapshots.buildSince(recent, GLOBALS));
+    CHECK(!delta.full);
+    CHECK_EQ(delta.despawned.size(), 1u);
+
+    // As is a base from the future, as a full snapshot
+    CHECK(decode(snapshots.buildSince(snapshots.getSequence() + 1, GLOBALS)).full);
+}
+
+} // namespace
+
+int main(int argc, char** argv) { return runTests(argc, argv); }
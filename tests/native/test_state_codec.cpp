@@ -0,0 +1,244 @@
+// StateCodec packets: quantisation bounds, baselines and id coding
+//
+// A server codec encodes, a client codec decodes, and the decoded state is
+// compared with the entities within one quantum.
+
+#include "test_harness.h"
+#include "../../wasm/include/systems/state_codec.h"
+#include <memory>
+#include <vector>
+
+namespace {
+
+using EntityList = std::vector<std::unique_ptr<Entity>>;
+
+constexpr float WORLD = 2000.0f;
+constexpr float TWO_PI = 6.2831853f;
+
+Entity* add(EntityList& list, EntityType type, float x, float y) {
+    list.push_back(std::make_unique<Entity>(type, Vector2(x, y), 10));
+    return list.back().get();
+}
+
+const StateCodec::DecodedEntity* find(const StateCodec& codec, int id) {
+    for (const StateCodec::DecodedEntity& e : codec.getDecoded()) {
+        if (e.id == id) return &e;
+    }
+    return nullptr;
+}
+
+// Send one packet and decode it; returns the decoded sequence (0 on reject)
+uint32_t send(StateCodec& server, StateCodec& client, const EntityList& list, uint32_t baseline) {
+    const std::vector<uint8_t>& packet = server.encode(list, baseline);
+    return client.decode(packet.data(), packet.size());
+}
+
+// Baseline field of an encoded packet (bits 48..79)
+uint32_t packetBaseline(const std::vector<uint8_t>& packet) {
+    BitReader reader(packet.data(), packet.size());
+    reader.read(8);
+    reader.read(8);
+    reader.read(32);
+    return reader.read(32);
+}
+
+TEST_CASE(round_trip_within_one_quantum) {
+    EntityList list;
+    uint32_t rng = 5;
+    auto next = [&rng]() {
+        rng = rng * 1664525u + 1013904223u;
+        return (rng >> 8) / 16777216.0f;
+    };
+    for (int i = 0; i < 200; i++) {
+        Entity* e = add(list, static_cast<EntityType>(i % 7), next() * WORLD, next() * WORLD);
+        e->velocity = Vector2(next() * 40 - 20, next() * 40 - 20);
+        e->rotation = next() * 4 * TWO_PI - 2 * TWO_PI;
+        e->health = next() * e->maxHealth;
+    }
+
+    StateCodec server, client;
+    server.setWorldBounds(WORLD, WORLD);
+    client.setWorldBounds(WORLD, WORLD);
+    uint32_t sequence = send(server, client, list, 0);
+    CHECK(sequence != 0);
+    CHECK_EQ(client.getDecoded().size(), list.size());
+
+    for (const auto& entity : list) {
+        const StateCodec::DecodedEntity* e = find(client, entity->id);
+        CHECK(e != nullptr);
+        if (!e) continue;
+        CHECK_EQ(e->type, static_cast<int32_t>(entity->type));
+        CHECK_NEAR(e->x, entity->position.x, StateCodec::POSITION_QUANTUM / 2 + 1e-3);
+        CHECK_NEAR(e->y, entity->position.y, StateCodec::POSITION_QUANTUM / 2 + 1e-3);
+        CHECK_NEAR(e->vx, entity->velocity.x, StateCodec::VELOCITY_QUANTUM / 2 + 1e-4);
+        CHECK_NEAR(e->vy, entity->velocity.y, StateCodec::VELOCITY_QUANTUM / 2 + 1e-4);
+        // Rotation comes back in [0, 2pi); compare on the circle
+        float turn = (e->rotation - entity->rotation) / TWO_PI;
+        turn -= std::round(turn);
+        CHECK_NEAR(turn * TWO_PI, 0.0, TWO_PI / (1 << StateCodec::ANGLE_BITS) / 2 + 1e-3);
+        CHECK_NEAR(e->health, entity->health / entity->maxHealth, 0.5 / 255 + 1e-4);
+    }
+}
+
+TEST_CASE(quantisation_clamps_out_of_range_values) {
+    EntityList list;
+    Entity* low = add(list, EntityType::ENEMY, StateCodec::POSITION_ORIGIN - 500, -1e6f);
+    Entity* high = add(list, EntityType::ENEMY, 1e7f, WORLD + 50);
+    low->velocity = Vector2(-1000, 1000);
+    low->health = -5;
+    high->health = 500;              // Over max health
+    high->maxHealth = 100;
+    Entity* dead = add(list, EntityType::WOLF, 0, 0);
+    dead->maxHealth = 0;             // No fraction to send
+
+    StateCodec server, client;
+    server.setWorldBounds(WORLD, WORLD);
+    CHECK(send(server, client, list, 0) != 0);
+
+    const StateCodec::DecodedEntity* l = find(client, low->id);
+    const StateCodec::DecodedEntity* h = find(client, high->id);
+    const StateCodec::DecodedEntity* d = find(client, dead->id);
+    CHECK(l && h && d);
+    if (!l || !h || !d) return;
+
+    // Positions clamp to the grid: the origin below, the top of the 15-bit
+    // field that covers a 2000 px world above
+    float top = ((1u << 15) - 1) * StateCodec::POSITION_QUANTUM + StateCodec::POSITION_ORIGIN;
+    CHECK_EQ(l->x, StateCodec::POSITION_ORIGIN);
+    CHECK_EQ(l->y, StateCodec::POSITION_ORIGIN);
+    CHECK_EQ(h->x, top);
+    CHECK_NEAR(h->y, WORLD + 50, StateCodec::POSITION_QUANTUM);
+
+    // Velocity saturates symmetrically at the 12-bit limit
+    float limit = ((1 << (StateCodec::VELOCITY_BITS - 1)) - 1) * StateCodec::VELOCITY_QUANTUM;
+    CHECK_EQ(l->vx, -limit);
+    CHECK_EQ(l->vy, limit);
+
+    CHECK_EQ(l->health, 0.0f);
+    CHECK_EQ(h->health, 1.0f);
+    CHECK_EQ(d->health, 0.0f);
+}
+
+TEST_CASE(unchanged_entities_are_not_resent) {
+    EntityList list;
+    for (int i = 0; i < 50; i++) add(list, EntityType::OBSTACLE, i * 30.0f, 100);
+    StateCodec server, client;
+    uint32_t key = send(server, client, list, 0);
+    size_t keyframeSize = server.getPacket().size();
+
+    uint32_t idle = send(server, client, list, key);
+    CHECK(idle != 0);
+    size_t idleSize = server.getPacket().size();
+    // Header only: 8 + 8 + 32 + 32 + 5 + 16 + 16 bits
+    CHECK_EQ(idleSize, 15u);
+    CHECK(idleSize < keyframeSize);
+    CHECK_EQ(client.getDecoded().size(), list.size());
+
+    // One change, one despawn: a small delta that still decodes to the full set
+    list[7]->position.x += 10;
+    list.erase(list.begin() + 20);
+    CHECK(send(server, client, list, idle) != 0);
+    CHECK(server.getPacket().size() < 30u);
+    CHECK_EQ(client.getDecoded().size(), list.size());
+    const StateCodec::DecodedEntity* moved = find(client, list[7]->id);
+    CHECK(moved && std::fabs(moved->x - list[7]->position.x) < StateCodec::POSITION_QUANTUM);
+}
+
+TEST_CASE(baseline_ring_wraps_at_32) {
+    EntityList list;
+    Entity* mover = add(list, EntityType::ENEMY, 100, 100);
+    StateCodec server, client;
+
+    // Sequences 1..40, all decoded; the rings now hold 9..40
+    std::vector<uint32_t> sequences;
+    for (int i = 0; i < 40; i++) {
+        mover->position.x += 1;
+        sequences.push_back(send(server, client, list, sequences.empty() ? 0 : sequences.back()));
+        CHECK(sequences.back() != 0);
+    }
+    uint32_t newest = sequences.back();
+    CHECK_EQ(newest, 40u);
+
+    // 31 back is the oldest baseline still held: a delta
+    uint32_t oldest = newest - (StateCodec::BASELINE_RING_SIZE - 1);
+    const std::vector<uint8_t>& held = server.encode(list, oldest);
+    CHECK_EQ(packetBaseline(held), oldest);
+    CHECK(client.decode(held.data(), held.size()) != 0);
+
+    // 32 back has been overwritten by the packet just sent: a keyframe
+    const std::vector<uint8_t>& expired = server.encode(list, newest + 1 - StateCodec::BASELINE_RING_SIZE);
+    CHECK_EQ(packetBaseline(expired), 0u);
+    CHECK(client.decode(expired.data(), expired.size()) != 0);
+    CHECK_EQ(client.getDecoded().size(), 1u);
+}
+
+TEST_CASE(delta_against_unknown_baseline_is_rejected) {
+    EntityList list;
+    Entity* mover = add(list, EntityType::ENEMY, 100, 100);
+    StateCodec server, client;
+    uint32_t key = send(server, client, list, 0);
+
+    // The client never sees this packet
+    mover->position.x += 5;
+    server.encode(list, key);
+    uint32_t lost = server.getEncodeSequence();
+
+    mover->position.x += 5;
+    const std::vector<uint8_t>& delta = server.encode(list, lost);
+    CHECK_EQ(packetBaseline(delta), lost);
+    CHECK_EQ(client.decode(delta.data(), delta.size()), 0u);
+
+    // Malformed packets are rejected too
+    std::vector<uint8_t> bad = delta;
+    bad[0] ^= 0xff;
+    CHECK_EQ(client.decode(bad.data(), bad.size()), 0u);
+    const std::vector<uint8_t>& full = server.encode(list, 0);
+    CHECK_EQ(client.decode(full.data(), full.size() / 2), 0u);
+    CHECK(client.decode(full.data(), full.size()) != 0);
+}
+
+TEST_CASE(id_deltas_use_every_width_class) {
+    // Gaps at both edges of the 4, 8, 16 and 32-bit classes
+    const uint32_t gaps[] = {1, 15, 16, 255, 256, 65535, 65536, 1u << 20, 0x7ff00000u};
+    EntityList list;
+    uint32_t id = 0;
+    std::vector<int> ids;
+    for (uint32_t gap : gaps) {
+        id += gap;
+        Entity* e = add(list, EntityType::PROJECTILE, 10, 10);
+        e->id = static_cast<int>(id);
+        ids.push_back(e->id);
+    }
+
+    StateCodec server, client;
+    uint32_t key = send(server, client, list, 0);
+    CHECK(key != 0);
+    CHECK_EQ(client.getDecoded().size(), ids.size());
+    for (size_t i = 0; i < ids.size() && i < client.getDecoded().size(); i++) {
+        CHECK_EQ(client.getDecoded()[i].id, ids[i]);
+    }
+
+    // Despawns are id-delta coded the same way
+    EntityList survivors;
+    survivors.push_back(std::move(list[0]));
+    survivors.push_back(std::move(list[4]));
+    CHECK(send(server, client, survivors, key) != 0);
+    CHECK_EQ(client.getDecoded().size(), 2u);
+    CHECK(find(client, ids[0]) != nullptr);
+    CHECK(find(client, ids[4]) != nullptr);
+    CHECK(find(client, ids[8]) == nullptr);
+
+    // A keyframe of one entity: 117 header bits, the id, a 5-bit mask and
+    // 75 field bits (15-bit positions). A 4-bit id class costs 2 + 4 bits,
+    // the 32-bit class 2 + 32.
+    EntityList small, large;
+    add(small, EntityType::ENEMY, 0, 0)->id = 3;
+    add(large, EntityType::ENEMY, 0, 0)->id = 0x40000000;
+    StateCodec a, b;
+    CHECK_EQ(a.encode(small, 0).size(), (117u + 6 + 5 + 75 + 7) / 8);
+    CHECK_EQ(b.encode(large, 0).size(), (117u + 34 + 5 + 75 + 7) / 8);
+}
+
+} // namespace
+
+int main(int argc, char** argv) { return runTests(argc, argv); }
@@ -0,0 +1,182 @@
+// TargetCandidates: the gathered list against a full scan
+//
+// query() serves candidates from the ids gathered out of the collision grid
+// while the player is within GATHER_MARGIN of the gather centre, and scans
+// every entity otherwise. The cached list must equal the scan as long as
+// player plus enemy displacement since the gather stays within the margin,
+// on both sides of the point where query() switches to scanning.
+
+#include "test_harness.h"
+#include "../../wasm/include/systems/targeting_system.h"
+#include "../../wasm/include/entities/enemy.h"
+#include "../../wasm/include/entities/powerup.h"
+#include <cmath>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using Entities = std::vector<std::unique_ptr<Entity>>;
+
+constexpr float MARGIN = TargetCandidates::GATHER_MARGIN;
+constexpr float GATHER_RANGE = Config::MAX_TARGET_DISTANCE + MARGIN;
+
+struct World {
+    Entities entities;   // The player first
+    std::unordered_map<int, Entity*> live;
+    std::vector<int> extraIds;   // Created since the last gather
+    SpatialHashGrid grid;
+    TargetCandidates cache;
+    int lookups = 0;
+
+    World() {
+        grid.setWorldBounds(3000, 3000);
+        add(std::make_unique<Entity>(EntityType::PLAYER, Vector2(1500, 1500), Config::PLAYER_RADIUS));
+    }
+
+    Entity& player() { return *entities[0]; }
+
+    Entity* add(std::unique_ptr<Entity> entity) {
+        Entity* raw = entity.get();
+        live[raw->id] = raw;
+        extraIds.push_back(raw->id);
+        entities.push_back(std::move(entity));
+        return raw;
+    }
+
+    Entity* addEnemy(const Vector2& at) { return add(std::make_unique<Enemy>(at)); }
+
+    void remove(size_t index) {
+        live.erase(entities[index]->id);
+        entities.erase(entities.begin() + index);
+    }
+
+    // End of tick: bin everything and gather, as GameEngine::runTick does
+    void gather() {
+        grid.clear();
+        for (const auto& entity : entities) {
+            if (entity->active) grid.insert(entity.get());
+        }
+        cache.gather(grid, player());
+        extraIds.clear();
+    }
+
+    const TargetCandidates::List& query() {
+        return cache.query(player(), entities, entities.size(), extraIds, [this](int id) -> Entity* {
+            lookups++;
+            auto it = live.find(id);
+            return it == live.end() ? nullptr : it->second;
+        });
+    }
+};
+
+// Candidates from a TargetCandidates that never gathered, so it scans
+TargetCandidates::List scan(World& world) {
+    TargetCandidates fresh;
+    return fresh.query(world.player(), world.entities, world.entities.size(), {},
+                       [](int) -> Entity* { return nullptr; });
+}
+
+bool sameList(const TargetCandidates::List& a, const TargetCandidates::List& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].entity != b[i].entity || a[i].angle != b[i].angle || a[i].distance != b[i].distance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Enemies on rings just inside and just outside the targeting and gather
+// ranges, at angles that do not line up with the moves below, and a line
+// of them straight ahead
+void addRings(World& world) {
+    const float radii[] = {50, Config::MAX_TARGET_DISTANCE - 1, Config::MAX_TARGET_DISTANCE + 1,
+                           GATHER_RANGE - 1, GATHER_RANGE + 1, GATHER_RANGE + MARGIN / 2};
+    int k = 0;
+    for (float r : radii) {
+        for (int i = 0; i < 16; i++, k++) {
+            float angle = 0.1f + i * 0.3927f + k * 0.013f;
+            world.addEnemy(world.player().position + Vector2(std::cos(angle), std::sin(angle)) * r);
+        }
+    }
+    // On the +x axis the moves below follow, where the gathered set is
+    // tightest: these only reach MAX_TARGET_DISTANCE because the player
+    // (and enemy) closed the distance
+    const float onAxis[] = {GATHER_RANGE - 60, GATHER_RANGE - 20, GATHER_RANGE - 1, GATHER_RANGE + 1};
+    for (float r : onAxis) world.addEnemy(world.player().position + Vector2(r, 0));
+    // Not targetable, so never a candidate
+    world.add(std::make_unique<PowerUp>(world.player().position + Vector2(30, 0), PowerUpType::HEALTH));
+}
+
+TEST_CASE(cached_list_matches_scan_across_the_regather_boundary) {
+    const float moves[] = {0, MARGIN / 2, MARGIN - 0.5f, MARGIN + 0.5f, 2 * MARGIN};
+    for (float move : moves) {
+        World world;
+        addRings(world);
+        world.gather();
+        CHECK(world.cache.gatheredCount() > 0);
+
+        // The player moves toward the outer rings; enemies stay put
+        world.player().position += Vector2(move, 0);
+        world.lookups = 0;
+        const TargetCandidates::List& cached = world.query();
+        CHECK(sameList(cached, scan(world)));
+        // Within the margin the gathered ids serve the query; beyond it, a scan
+        CHECK_EQ(world.lookups > 0, move <= MARGIN);
+    }
+}
+
+TEST_CASE(cached_list_matches_scan_when_player_and_enemies_share_the_margin) {
+    World world;
+    addRings(world);
+    world.gather();
+
+    // The player covers part of the margin and every enemy the rest, each
+    // toward the other, so the ring just outside the gather range walks in
+    const Vector2 playerMove(MARGIN * 0.4f, 0);
+    const float enemyMove = MARGIN * 0.6f - 0.01f;
+    Vector2 centre = world.player().position;
+    world.player().position += playerMove;
+    for (size_t i = 1; i < world.entities.size(); i++) {
+        Entity& entity = *world.entities[i];
+        entity.position += (centre - entity.position).normalized() * enemyMove;
+    }
+    CHECK(sameList(world.query(), scan(world)));
+    CHECK(world.lookups > 0);
+}
+
+TEST_CASE(cached_list_matches_scan_over_many_ticks) {
+    World world;
+    addRings(world);
+    SimRandom rng(11);
+    world.gather();
+    for (int tick = 0; tick < 200; tick++) {
+        // Per tick moves well inside the margin: up to 30 for the player,
+        // 60 for each enemy
+        float angle = rng.nextFloat() * 6.2831853f;
+        world.player().position += Vector2(std::cos(angle), std::sin(angle)) * (rng.nextFloat() * 30);
+        for (size_t i = 1; i < world.entities.size(); i++) {
+            float a = rng.nextFloat() * 6.2831853f;
+            world.entities[i]->position += Vector2(std::cos(a), std::sin(a)) * (rng.nextFloat() * 60);
+        }
+
+        // Deaths, removals and arrivals between gathers
+        if (tick % 7 == 3) world.entities[1 + rng.nextInt(static_cast<int>(world.entities.size()) - 1)]->active = false;
+        if (tick % 11 == 5) world.remove(1 + rng.nextInt(static_cast<int>(world.entities.size()) - 1));
+        if (tick % 5 == 0) {
+            float a = rng.nextFloat() * 6.2831853f;
+            world.addEnemy(world.player().position + Vector2(std::cos(a), std::sin(a)) * (rng.nextFloat() * 450));
+        }
+
+        world.lookups = 0;
+        CHECK(sameList(world.query(), scan(world)));
+        CHECK(world.lookups > 0);
+        world.gather();
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) { return runTests(argc, argv); }
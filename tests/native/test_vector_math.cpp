@@ -0,0 +1,368 @@
+// VectorMath kernels against plain reference loops
+//
+// scripts/test-native.sh builds this three ways: scalar (the fallback
+// loops), with the wasm_simd128 shim (the __wasm_simd128__ lane code on the
+// host), and, when em++ is installed, as a real -msimd128 module run under
+// node. Every build checks parity with the reference loops below over sizes
+// that exercise full groups of four and every tail length, then
+//   test_vector_math --bench [N]
+// times each kernel against its reference over N entities (default 4096).
+// The file is built with auto-vectorisation off, so the reference loops
+// stay scalar and the timing compares the kernels with one lane at a time.
+
+#include "test_harness.h"
+#include "../../wasm/include/math/vector_math.h"
+#include "../../wasm/include/utils/platform.h"
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+// Deterministic inputs, so a failure reproduces
+struct Lcg {
+    uint32_t state;
+    explicit Lcg(uint32_t seed) : state(seed) {}
+    float next() {
+        state = state * 1664525u + 1013904223u;
+        return (state >> 8) / 16777216.0f;
+    }
+    float range(float lo, float hi) { return lo + (hi - lo) * next(); }
+};
+
+std::vector<float> randomArray(Lcg& rng, size_t count, float lo, float hi) {
+    std::vector<float> values(count);
+    for (float& v : values) v = rng.range(lo, hi);
+    return values;
+}
+
+// Unit facings for senseTarget
+void randomFacings(Lcg& rng, size_t count, std::vector<float>& fx, std::vector<float>& fy) {
+    fx.resize(count);
+    fy.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        float angle = rng.range(0, 6.2831853f);
+        fx[i] = std::cos(angle);
+        fy[i] = std::sin(angle);
+    }
+}
+
+namespace Reference {
+    void integrate(float* x, float* y, const float* vx, const float* vy, size_t count, float scale) {
+        for (size_t i = 0; i < count; i++) {
+            x[i] += vx[i] * scale;
+            y[i] += vy[i] * scale;
+        }
+    }
+
+    void damp(float* vx, float* vy, size_t count, float factor) {
+        for (size_t i = 0; i < count; i++) {
+            vx[i] *= factor;
+            vy[i] *= factor;
+        }
+    }
+
+    void clampToBounds(float* x, float* y, const float* radius, size_t count, float width, float height) {
+        for (size_t i = 0; i < count; i++) {
+            x[i] = std::min(std::max(x[i], radius[i]), width - radius[i]);
+            y[i] = std::min(std::max(y[i], radius[i]), height - radius[i]);
+        }
+    }
+
+    // Signed margin of each overlap test; lanes within rounding of zero are skipped
+    float circleMargin(float x, float y, float r, float cx, float cy, float cr) {
+        float rs = r + cr;
+        return (x - cx) * (x - cx) + (y - cy) * (y - cy) - rs * rs;
+    }
+
+    size_t circleOverlapMasks(const float* x, const float* y, const float* radius, size_t count,
+                              float cx, float cy, float cr, uint32_t* masks) {
+        size_t hits = 0;
+        for (size_t word = 0; word < (count + 31) / 32; word++) masks[word] = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (circleMargin(x[i], y[i], radius[i], cx, cy, cr) < 0) {
+                masks[i / 32] |= 1u << (i % 32);
+                hits++;
+            }
+        }
+        return hits;
+    }
+
+    float boxMargin(float cx, float cy, float cr, float bx, float by, float cosR, float sinR,
+                    float halfW, float halfH, float round) {
+        float dx = cx - bx, dy = cy - by;
+        float lx = dx * cosR + dy * sinR;
+        float ly = dy * cosR - dx * sinR;
+        float ex = lx - std::min(std::max(lx, -halfW), halfW);
+        float ey = ly - std::min(std::max(ly, -halfH), halfH);
+        float reach = cr + round;
+        return ex * ex + ey * ey - reach * reach;
+    }
+
+    size_t circleBoxOverlap(const float* cx, const float* cy, const float* cr,
+                            const float* bx, const float* by, const float* cosR, const float* sinR,
+                            const float* halfW, const float* halfH, const float* round,
+                            size_t count, uint8_t* overlap) {
+        size_t hits = 0;
+        for (size_t i = 0; i < count; i++) {
+            overlap[i] = boxMargin(cx[i], cy[i], cr[i], bx[i], by[i], cosR[i], sinR[i],
+                                   halfW[i], halfH[i], round[i]) < 0 ? 1 : 0;
+            hits += overlap[i];
+        }
+        return hits;
+    }
+
+    void senseTarget(const float* x, const float* y, const float* fx, const float* fy, size_t count,
+                     float tx, float ty, float sightRange, float cosHalfCone, float hearingRange,
+                     float* distSq, uint8_t* flags) {
+        for (size_t i = 0; i < count; i++) {
+            float dx = tx - x[i], dy = ty - y[i];
+            float d2 = dx * dx + dy * dy;
+            float dot = dx * fx[i] + dy * fy[i];
+            uint8_t sensed = 0;
+            if (d2 <= sightRange * sightRange && dot >= 0.0f && dot * dot >= cosHalfCone * cosHalfCone * d2) {
+                sensed |= VectorMath::SENSE_SIGHT;
+            }
+            if (d2 < hearingRange * hearingRange) sensed |= VectorMath::SENSE_HEARING;
+            distSq[i] = d2;
+            flags[i] = sensed;
+        }
+    }
+}
+
+// Every tail length after 0-3 full groups, then a long run across mask words
+const size_t SIZES[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 13, 16, 31, 32, 33, 63, 64, 65, 1027};
+
+// Tolerance for float outputs: the lane code computes the same operations,
+// but the build may contract or reorder them (-ffast-math)
+constexpr float EPS = 1e-4f;
+
+bool closeTo(float a, float b) {
+    return std::fabs(a - b) <= EPS * std::max(1.0f, std::fabs(b));
+}
+
+TEST_CASE(integrate_matches_reference) {
+    Lcg rng(1);
+    for (size_t n : SIZES) {
+        std::vector<float> x = randomArray(rng, n, 0, 2000), y = randomArray(rng, n, 0, 2000);
+        std::vector<float> vx = randomArray(rng, n, -10, 10), vy = randomArray(rng, n, -10, 10);
+        std::vector<float> rx = x, ry = y;
+        VectorMath::integrate(x.data(), y.data(), vx.data(), vy.data(), n, 0.75f);
+        Reference::integrate(rx.data(), ry.data(), vx.data(), vy.data(), n, 0.75f);
+        for (size_t i = 0; i < n; i++) {
+            CHECK(closeTo(x[i], rx[i]));
+            CHECK(closeTo(y[i], ry[i]));
+        }
+    }
+}
+
+TEST_CASE(lanewise_updates_match_reference) {
+    Lcg rng(2);
+    for (size_t n : SIZES) {
+        std::vector<float> vx = randomArray(rng, n, -10, 10), vy = randomArray(rng, n, -10, 10);
+        std::vector<float> factor = randomArray(rng, n, 0.5f, 1.0f);
+        std::vector<float> rx = vx, ry = vy;
+
+        VectorMath::damp(vx.data(), vy.data(), n, 0.98f);
+        Reference::damp(rx.data(), ry.data(), n, 0.98f);
+        VectorMath::accelerateY(vy.data(), n, 0.5f);
+        for (size_t i = 0; i < n; i++) ry[i] += 0.5f;
+        VectorMath::dampEach(vx.data(), vy.data(), factor.data(), n);
+        for (size_t i = 0; i < n; i++) {
+            rx[i] *= factor[i];
+            ry[i] *= factor[i];
+        }
+        VectorMath::addEach(vx.data(), factor.data(), n);
+        for (size_t i = 0; i < n; i++) rx[i] += factor[i];
+        VectorMath::scaleEach(vy.data(), factor.data(), n);
+        for (size_t i = 0; i < n; i++) ry[i] *= factor[i];
+
+        for (size_t i = 0; i < n; i++) {
+            CHECK(closeTo(vx[i], rx[i]));
+            CHECK(closeTo(vy[i], ry[i]));
+        }
+    }
+}
+
+TEST_CASE(clamp_to_bounds_matches_reference) {
+    Lcg rng(3);
+    for (size_t n : SIZES) {
+        // Some circles start outside on every side
+        std::vector<float> x = randomArray(rng, n, -100, 1100), y = randomArray(rng, n, -100, 900);
+        std::vector<float> radius = randomArray(rng, n, 5, 40);
+        std::vector<float> rx = x, ry = y;
+        VectorMath::clampToBounds(x.data(), y.data(), radius.data(), n, 1000, 800);
+        Reference::clampToBounds(rx.data(), ry.data(), radius.data(), n, 1000, 800);
+        for (size_t i = 0; i < n; i++) {
+            CHECK_EQ(x[i], rx[i]);
+            CHECK_EQ(y[i], ry[i]);
+        }
+    }
+}
+
+TEST_CASE(circle_overlap_masks_match_reference) {
+    Lcg rng(4);
+    for (size_t n : SIZES) {
+        std::vector<float> x = randomArray(rng, n, 0, 400), y = randomArray(rng, n, 0, 400);
+        std::vector<float> radius = randomArray(rng, n, 5, 30);
+        std::vector<uint32_t> masks((n + 31) / 32 + 1, 0xDEADBEEFu), expected(masks.size(), 0);
+        size_t hits = VectorMath::circleOverlapMasks(x.data(), y.data(), radius.data(), n,
+                                                     200, 200, 60, masks.data());
+        size_t expectedHits = Reference::circleOverlapMasks(x.data(), y.data(), radius.data(), n,
+                                                            200, 200, 60, expected.data());
+        size_t borderline = 0;
+        for (size_t i = 0; i < n; i++) {
+            float margin = Reference::circleMargin(x[i], y[i], radius[i], 200, 200, 60);
+            bool got = (masks[i / 32] >> (i % 32)) & 1u;
+            if (std::fabs(margin) < 0.01f) {
+                borderline++;
+                continue;
+            }
+            CHECK_EQ(got, margin < 0);
+        }
+        if (!borderline) CHECK_EQ(hits, expectedHits);
+        // Bits past count stay clear
+        if (n % 32) CHECK_EQ(masks[n / 32] >> (n % 32), 0u);
+    }
+}
+
+TEST_CASE(circle_box_overlap_matches_reference) {
+    Lcg rng(5);
+    for (size_t n : SIZES) {
+        std::vector<float> cx = randomArray(rng, n, 0, 200), cy = randomArray(rng, n, 0, 200);
+        std::vector<float> cr = randomArray(rng, n, 5, 20);
+        std::vector<float> bx = randomArray(rng, n, 50, 150), by = randomArray(rng, n, 50, 150);
+        std::vector<float> cosR(n), sinR(n);
+        for (size_t i = 0; i < n; i++) {
+            float angle = rng.range(0, 6.2831853f);
+            cosR[i] = std::cos(angle);
+            sinR[i] = std::sin(angle);
+        }
+        std::vector<float> halfW = randomArray(rng, n, 0, 60), halfH = randomArray(rng, n, 0, 40);
+        std::vector<float> round = randomArray(rng, n, 0, 15);
+        // Every third lane is a plain circle: a zero-size box rounded by its radius
+        for (size_t i = 0; i < n; i += 3) halfW[i] = halfH[i] = 0;
+
+        std::vector<uint8_t> overlap(n, 7), expected(n);
+        VectorMath::circleBoxOverlap(cx.data(), cy.data(), cr.data(), bx.data(), by.data(),
+                                     cosR.data(), sinR.data(), halfW.data(), halfH.data(),
+                                     round.data(), n, overlap.data());
+        Reference::circleBoxOverlap(cx.data(), cy.data(), cr.data(), bx.data(), by.data(),
+                                    cosR.data(), sinR.data(), halfW.data(), halfH.data(),
+                                    round.data(), n, expected.data());
+        for (size_t i = 0; i < n; i++) {
+            float margin = Reference::boxMargin(cx[i], cy[i], cr[i], bx[i], by[i], cosR[i], sinR[i],
+                                                halfW[i], halfH[i], round[i]);
+            if (std::fabs(margin) < 0.01f) continue;
+            CHECK_EQ(overlap[i], expected[i]);
+        }
+    }
+}
+
+TEST_CASE(sense_target_matches_reference) {
+    Lcg rng(6);
+    const float cosHalfCone = std::cos(0.6f);
+    for (size_t n : SIZES) {
+        std::vector<float> x = randomArray(rng, n, 0, 1000), y = randomArray(rng, n, 0, 1000);
+        std::vector<float> fx, fy;
+        randomFacings(rng, n, fx, fy);
+        std::vector<float> distSq(n), expectedDist(n);
+        std::vector<uint8_t> flags(n, 0xFF), expected(n);
+        VectorMath::senseTarget(x.data(), y.data(), fx.data(), fy.data(), n, 500, 500,
+                                400, cosHalfCone, 250, distSq.data(), flags.data());
+        Reference::senseTarget(x.data(), y.data(), fx.data(), fy.data(), n, 500, 500,
+                               400, cosHalfCone, 250, expectedDist.data(), expected.data());
+        for (size_t i = 0; i < n; i++) {
+            CHECK(closeTo(distSq[i], expectedDist[i]));
+            // Skip lanes on a range or cone boundary
+            float dx = 500 - x[i], dy = 500 - y[i];
+            float dot = dx * fx[i] + dy * fy[i];
+            float d2 = expectedDist[i];
+            if (std::fabs(d2 - 400 * 400) < 1 || std::fabs(d2 - 250 * 250) < 1 ||
+                std::fabs(dot * dot - cosHalfCone * cosHalfCone * d2) < 1) continue;
+            CHECK_EQ(flags[i], expected[i]);
+        }
+    }
+}
+
+// Best of several runs of reps calls, in ns per entity
+template<typename Fn>
+double timePerEntity(size_t count, int reps, Fn&& fn) {
+    double best = 0;
+    for (int run = 0; run < 5; run++) {
+        double start = Platform::now();
+        for (int r = 0; r < reps; r++) fn();
+        double ns = (Platform::now() - start) * 1e6 / (static_cast<double>(reps) * count);
+        if (run == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+// Side effect the optimiser cannot drop
+volatile size_t sink;
+
+int runBench(size_t count) {
+    const int reps = static_cast<int>(std::max<size_t>(1, 2000000 / std::max<size_t>(count, 1)));
+    Lcg rng(7);
+    std::vector<float> x = randomArray(rng, count, 0, 1000), y = randomArray(rng, count, 0, 1000);
+    std::vector<float> vx = randomArray(rng, count, -1, 1), vy = randomArray(rng, count, -1, 1);
+    std::vector<float> radius = randomArray(rng, count, 5, 30);
+    std::vector<float> fx, fy;
+    randomFacings(rng, count, fx, fy);
+    std::vector<float> cosR(count, 1.0f), sinR(count, 0.0f);
+    std::vector<float> halfW = randomArray(rng, count, 0, 40), halfH = randomArray(rng, count, 0, 40);
+    std::vector<float> bx = randomArray(rng, count, 0, 1000), by = randomArray(rng, count, 0, 1000);
+    std::vector<uint32_t> masks((count + 31) / 32);
+    std::vector<uint8_t> flags(count);
+    std::vector<float> distSq(count);
+
+#ifdef __wasm_simd128__
+    const char* mode = "simd128";
+#else
+    const char* mode = "scalar fallback";
+#endif
+    std::printf("VectorMath kernels (%s) vs scalar reference, %zu entities, ns per entity\n", mode, count);
+    std::printf("  %-20s %10s %10s %8s\n", "kernel", "kernel", "reference", "speedup");
+    auto row = [](const char* name, double kernel, double reference) {
+        std::printf("  %-20s %10.3f %10.3f %7.2fx\n", name, kernel, reference, kernel > 0 ? reference / kernel : 0.0);
+    };
+
+    // Tiny scales keep positions from drifting over thousands of reps
+    row("integrate",
+        timePerEntity(count, reps, [&] { VectorMath::integrate(x.data(), y.data(), vx.data(), vy.data(), count, 1e-6f); }),
+        timePerEntity(count, reps, [&] { Reference::integrate(x.data(), y.data(), vx.data(), vy.data(), count, 1e-6f); }));
+    row("clampToBounds",
+        timePerEntity(count, reps, [&] { VectorMath::clampToBounds(x.data(), y.data(), radius.data(), count, 1000, 1000); }),
+        timePerEntity(count, reps, [&] { Reference::clampToBounds(x.data(), y.data(), radius.data(), count, 1000, 1000); }));
+    row("circleOverlapMasks",
+        timePerEntity(count, reps, [&] { sink = VectorMath::circleOverlapMasks(x.data(), y.data(), radius.data(), count, 500, 500, 40, masks.data()); }),
+        timePerEntity(count, reps, [&] { sink = Reference::circleOverlapMasks(x.data(), y.data(), radius.data(), count, 500, 500, 40, masks.data()); }));
+    row("circleBoxOverlap",
+        timePerEntity(count, reps, [&] {
+            sink = VectorMath::circleBoxOverlap(x.data(), y.data(), radius.data(), bx.data(), by.data(), cosR.data(),
+                                                sinR.data(), halfW.data(), halfH.data(), radius.data(), count, flags.data());
+        }),
+        timePerEntity(count, reps, [&] {
+            sink = Reference::circleBoxOverlap(x.data(), y.data(), radius.data(), bx.data(), by.data(), cosR.data(),
+                                               sinR.data(), halfW.data(), halfH.data(), radius.data(), count, flags.data());
+        }));
+    row("senseTarget",
+        timePerEntity(count, reps, [&] {
+            VectorMath::senseTarget(x.data(), y.data(), fx.data(), fy.data(), count, 500, 500, 400, 0.8f, 250,
+                                    distSq.data(), flags.data());
+        }),
+        timePerEntity(count, reps, [&] {
+            Reference::senseTarget(x.data(), y.data(), fx.data(), fy.data(), count, 500, 500, 400, 0.8f, 250,
+                                   distSq.data(), flags.data());
+        }));
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1 && !std::strcmp(argv[1], "--bench")) {
+        return runBench(argc > 2 ? static_cast<size_t>(std::max(1, std::atoi(argv[2]))) : 4096);
+    }
+    return runTests(argc, argv);
+}
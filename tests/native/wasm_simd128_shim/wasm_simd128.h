@@ -0,0 +1,120 @@
+#ifndef WASM_SIMD128_SHIM_H
+#define WASM_SIMD128_SHIM_H
+
+// Native stand-in for the subset of <wasm_simd128.h> the engine kernels use
+//
+// Lets the __wasm_simd128__ paths of math/vector_math.h build and run with a
+// host compiler (GCC/Clang vector extensions), so their lane logic can be
+// checked against the scalar loops without an Emscripten toolchain. Only
+// for tests: scripts/test-native.sh compiles with -D__wasm_simd128__ and
+// this directory on the include path. Semantics follow the wasm spec for
+// finite inputs; min/max also propagate NaN and order -0 below +0.
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+typedef int32_t v128_t __attribute__((vector_size(16), aligned(16)));
+typedef float wasm_shim_f32x4 __attribute__((vector_size(16)));
+
+static inline v128_t wasm_v128_load(const void* mem) {
+    v128_t v;
+    std::memcpy(&v, mem, sizeof(v));
+    return v;
+}
+
+static inline void wasm_v128_store(void* mem, v128_t a) {
+    std::memcpy(mem, &a, sizeof(a));
+}
+
+static inline v128_t wasm_f32x4_splat(float a) {
+    wasm_shim_f32x4 f = {a, a, a, a};
+    return (v128_t)f;
+}
+
+static inline v128_t wasm_i32x4_splat(int32_t a) {
+    v128_t v = {a, a, a, a};
+    return v;
+}
+
+#define wasm_i32x4_extract_lane(a, lane) ((int32_t)(a)[lane])
+
+static inline v128_t wasm_i32x4_add(v128_t a, v128_t b) { return a + b; }
+
+static inline v128_t wasm_f32x4_add(v128_t a, v128_t b) { return (v128_t)((wasm_shim_f32x4)a + (wasm_shim_f32x4)b); }
+static inline v128_t wasm_f32x4_sub(v128_t a, v128_t b) { return (v128_t)((wasm_shim_f32x4)a - (wasm_shim_f32x4)b); }
+static inline v128_t wasm_f32x4_mul(v128_t a, v128_t b) { return (v128_t)((wasm_shim_f32x4)a * (wasm_shim_f32x4)b); }
+static inline v128_t wasm_f32x4_neg(v128_t a) { return (v128_t)(-(wasm_shim_f32x4)a); }
+
+// Equal lanes take the sign-bit OR (min) or AND (max) of both, so -0 < +0;
+// a NaN in either lane gives NaN
+static inline v128_t wasm_f32x4_min(v128_t a, v128_t b) {
+    wasm_shim_f32x4 fa = (wasm_shim_f32x4)a, fb = (wasm_shim_f32x4)b;
+    v128_t r = fa < fb ? a : b;
+    r = fa == fb ? (a | b) : r;
+    return (fa != fa) | (fb != fb) ? wasm_f32x4_splat(NAN) : r;
+}
+
+static inline v128_t wasm_f32x4_max(v128_t a, v128_t b) {
+    wasm_shim_f32x4 fa = (wasm_shim_f32x4)a, fb = (wasm_shim_f32x4)b;
+    v128_t r = fa > fb ? a : b;
+    r = fa == fb ? (a & b) : r;
+    return (fa != fa) | (fb != fb) ? wasm_f32x4_splat(NAN) : r;
+}
+
+// Pseudo-min/max: b < a ? b : a and a < b ? b : a, the same as std::min
+// and std::max, so one minps/maxps on x86
+static inline v128_t wasm_f32x4_pmin(v128_t a, v128_t b) {
+    return (wasm_shim_f32x4)b < (wasm_shim_f32x4)a ? b : a;
+}
+
+static inline v128_t wasm_f32x4_pmax(v128_t a, v128_t b) {
+    return (wasm_shim_f32x4)a < (wasm_shim_f32x4)b ? b : a;
+}
+
+static inline v128_t wasm_f32x4_lt(v128_t a, v128_t b) { return (v128_t)((wasm_shim_f32x4)a < (wasm_shim_f32x4)b); }
+static inline v128_t wasm_f32x4_le(v128_t a, v128_t b) { return (v128_t)((wasm_shim_f32x4)a <= (wasm_shim_f32x4)b); }
+static inline v128_t wasm_f32x4_ge(v128_t a, v128_t b) { return (v128_t)((wasm_shim_f32x4)a >= (wasm_shim_f32x4)b); }
+
+static inline v128_t wasm_v128_and(v128_t a, v128_t b) { return a & b; }
+static inline v128_t wasm_v128_or(v128_t a, v128_t b) { return a | b; }
+
+static inline void wasm_v128_store32_lane(void* mem, v128_t a, int lane) {
+    std::memcpy(mem, (const char*)&a + 4 * lane, 4);
+}
+
+// Saturating narrows: a fills the low half of the result, b the high half
+static inline v128_t wasm_u16x8_narrow_i32x4(v128_t a, v128_t b) {
+    typedef int16_t i16x8 __attribute__((vector_size(16)));
+    v128_t lo = wasm_i32x4_splat(0), hi = wasm_i32x4_splat(0xFFFF);
+    a = a < lo ? lo : (a > hi ? hi : a);
+    b = b < lo ? lo : (b > hi ? hi : b);
+    return (v128_t)__builtin_shufflevector((i16x8)a, (i16x8)b, 0, 2, 4, 6, 8, 10, 12, 14);
+}
+
+static inline v128_t wasm_u8x16_narrow_i16x8(v128_t a, v128_t b) {
+    typedef int16_t i16x8 __attribute__((vector_size(16)));
+    typedef int8_t i8x16 __attribute__((vector_size(16)));
+    i16x8 va = (i16x8)a, vb = (i16x8)b, lo = {}, hi = lo + 0xFF;
+    va = va < lo ? lo : (va > hi ? hi : va);
+    vb = vb < lo ? lo : (vb > hi ? hi : vb);
+    return (v128_t)__builtin_shufflevector((i8x16)va, (i8x16)vb,
+                                           0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+}
+
+// movmskps where the host has it, as wasm engines lower it on x86
+static inline int wasm_i32x4_bitmask(v128_t a) {
+#ifdef __SSE__
+    return _mm_movemask_ps((__m128)a);
+#else
+    int mask = 0;
+    for (int i = 0; i < 4; i++) mask |= (a[i] < 0 ? 1 : 0) << i;
+    return mask;
+#endif
+}
+
+#endif // WASM_SIMD128_SHIM_H
@@ -0,0 +1,518 @@
+// Headless benchmark for the engine core
+//
+// Builds natively (no Emscripten): see scripts/bench-native.sh. Each scenario
+// sets up a world, runs warm-up frames, then times every system separately
+// over the measured frames and reports ns per processed entity plus heap
+// allocations per frame. Output is a table, or CSV with --csv for CI diffs.
+//
+// --replay re-simulates a session recorded with GameEngine::startRecording
+// (saved from the browser via getRecording()) and reports the time per tick
+// and whether the final state checksum matches. --record writes a scripted
+// session of --frames ticks to replay in the same way.
+//
+//   engine_benchmark [--frames N] [--warmup N] [--scenario NAME] [--scale F] [--csv]
+//   engine_benchmark --record FILE [--frames N]
+//   engine_benchmark --replay FILE
+
+#include "../include/game_engine.h"
+#include "../include/entities/entity.h"
+#include "../include/entities/player.h"
+#include "../include/entities/enemy.h"
+#include "../include/entities/wolf.h"
+#include "../include/entities/projectile.h"
+#include "../include/entities/obstacle.h"
+#include "../include/effects/visual_effects.h"
+#include "../include/systems/collision_system.h"
+#include "../include/systems/wave_system.h"
+#include "../include/systems/obstacle_index.h"
+#include "../include/systems/flow_field.h"
+#include "../include/systems/input_log.h"
+#include "../include/systems/state_codec.h"
+#include "../include/ai/wolf_ai.h"
+#include "../include/memory/heap_tracker.h"
+#include "../include/utils/platform.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+// Heap allocation counter. Entity pools and the frame arena only show up
+// here when they grow, which is exactly what a regression looks like.
+//
+// With HEAP_TRACKING on (-DHEAP_TRACKING=1 in BENCH_FLAGS) HeapTracker owns
+// the global operator new/delete, and the count is the sum of its tags.
+// Otherwise the benchmark installs its own hook: every replaceable form is
+// defined, plain, sized and aligned, and all of them go through
+// countedAlloc/countedFree. Those are kept out of line so GCC does not
+// inline malloc/free into callers and then warn about a new/free pair
+// (-Wmismatched-new-delete).
+#if HEAP_TRACKING
+namespace {
+    uint64_t heapAllocationCount() {
+        const HeapTracker& tracker = HeapTracker::getInstance();
+        uint64_t total = 0;
+        for (size_t tag = 0; tag < HeapTracker::TAG_COUNT; tag++) {
+            total += tracker.stats(static_cast<AllocTag>(tag)).allocations;
+        }
+        return total;
+    }
+}
+#else
+namespace {
+    std::atomic<uint64_t> heapAllocations{0};
+
+    uint64_t heapAllocationCount() { return heapAllocations.load(std::memory_order_relaxed); }
+
+    __attribute__((noinline)) void* countedAlloc(size_t size, size_t alignment) {
+        heapAllocations.fetch_add(1, std::memory_order_relaxed);
+        size = size ? size : 1;
+        void* memory = alignment > alignof(std::max_align_t)
+            ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+            : std::malloc(size);
+        if (!memory) throw std::bad_alloc();
+        return memory;
+    }
+
+    __attribute__((noinline)) void countedFree(void* memory) noexcept { std::free(memory); }
+}
+
+void* operator new(size_t size) { return countedAlloc(size, 0); }
+void* operator new[](size_t size) { return countedAlloc(size, 0); }
+void* operator new(size_t size, std::align_val_t alignment) {
+    return countedAlloc(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return countedAlloc(size, static_cast<size_t>(alignment));
+}
+void operator delete(void* memory) noexcept { countedFree(memory); }
+void operator delete[](void* memory) noexcept { countedFree(memory); }
+void operator delete(void* memory, size_t) noexcept { countedFree(memory); }
+void operator delete[](void* memory, size_t) noexcept { countedFree(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { countedFree(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { countedFree(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { countedFree(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { countedFree(memory); }
+#endif
+
+namespace {
+
+constexpr float WORLD_WIDTH = 3000.0f;
+constexpr float WORLD_HEIGHT = 3000.0f;
+constexpr float FRAME_DT = 1.0f / 60.0f;
+
+// Deterministic placement, so runs are comparable
+struct Lcg {
+    uint32_t state;
+    explicit Lcg(uint32_t seed) : state(seed) {}
+    float next() {
+        state = state * 1664525u + 1013904223u;
+        return (state >> 8) / 16777216.0f;
+    }
+    float range(float lo, float hi) { return lo + (hi - lo) * next(); }
+};
+
+struct World {
+    std::vector<std::unique_ptr<Entity>> entities;
+    std::vector<std::unique_ptr<Entity>> statics;   // Obstacles, as GameEngine's static layer
+    Player* player = nullptr;
+    VisualEffects effects;
+    EventQueue events;
+    CollisionSystem collisions;
+    WaveSystem waves;
+    WaveSystem::SpawnBatch spawned;
+    EntityCounts counts;   // Of entities, refreshed by cleanup() as the engine keeps them
+    ObstacleIndex obstacleIndex;
+    FlowField flowField;
+    AI::WolfPack pack;
+    std::vector<std::shared_ptr<AI::Wolf>> packWolves;
+    std::vector<Entity*> obstaclePtrs;
+    bool runWaves = false;
+    // Network sync: every frame is encoded against the last packet the
+    // client decoded, with a keyframe every keyframeInterval frames
+    bool runCodec = false;
+    uint32_t keyframeInterval = 60;
+    StateCodec serverCodec;
+    StateCodec clientCodec;
+    uint32_t ackedSequence = 0;
+    uint32_t codecFrames = 0;
+    uint64_t packetBytes = 0;      // Measured frames only
+    size_t keyframeBytes = 0;
+    float projectileRate = 0;    // Projectiles fired per frame
+    float projectileDebt = 0;
+    Lcg rng{12345};
+
+    World() : collisions(&events) {
+        collisions.setWorldBounds(WORLD_WIDTH, WORLD_HEIGHT);
+        serverCodec.setWorldBounds(WORLD_WIDTH, WORLD_HEIGHT);
+        clientCodec.setWorldBounds(WORLD_WIDTH, WORLD_HEIGHT);
+        flowField.setWorldBounds(WORLD_WIDTH, WORLD_HEIGHT);
+        pack.setWorldBounds(WORLD_WIDTH, WORLD_HEIGHT);
+        pack.setObstacleIndex(&obstacleIndex);
+        pack.setFlowField(&flowField);
+        auto p = std::make_unique<Player>(Vector2(WORLD_WIDTH / 2, WORLD_HEIGHT / 2));
+        player = p.get();
+        entities.push_back(std::move(p));
+    }
+
+    Vector2 randomPoint() {
+        return Vector2(rng.range(50, WORLD_WIDTH - 50), rng.range(50, WORLD_HEIGHT - 50));
+    }
+
+    void addEnemies(int count) {
+        for (int i = 0; i < count; i++) {
+            entities.push_back(std::make_unique<Enemy>(randomPoint()));
+        }
+    }
+
+    void addWolves(int count) {
+        std::vector<Wolf*> members;
+        for (int i = 0; i < count; i++) {
+            auto wolf = std::make_unique<Wolf>(randomPoint(), i == 0);
+            members.push_back(wolf.get());
+            entities.push_back(std::move(wolf));
+        }
+        for (Wolf* wolf : members) wolf->joinPack(members);
+    }
+
+    void addPackWolves(int count) {
+        for (int i = 0; i < count; i++) {
+            Vector2 at = randomPoint();
+            auto wolf = std::make_shared<AI::Wolf>(at.x, at.y, i % 6 == 0);
+            packWolves.push_back(wolf);
+            pack.addWolf(std::make_shared<AI::WolfAI>(wolf));
+        }
+    }
+
+    void addObstacles(int count) {
+        for (int i = 0; i < count; i++) {
+            auto obstacle = std::make_unique<Obstacle>(randomPoint(), rng.range(20, 60));
+            obstaclePtrs.push_back(obstacle.get());
+            statics.push_back(std::move(obstacle));
+        }
+        obstacleIndex.markDirty();
+        flowField.markDirty();
+    }
+
+    void fireProjectiles() {
+        projectileDebt += projectileRate;
+        while (projectileDebt >= 1.0f) {
+            float angle = rng.range(0, 6.2831853f);
+            entities.push_back(std::make_unique<Projectile>(
+                randomPoint(), Vector2(std::cos(angle), std::sin(angle)),
+                Config::PROJECTILE_DAMAGE, player->id));
+            projectileDebt -= 1.0f;
+        }
+    }
+
+    void retarget() {
+        for (auto& entity : entities) {
+            if (!entity->active) continue;
+            if (entity->type == EntityType::ENEMY || entity->type == EntityType::WOLF) {
+                Enemy* enemy = static_cast<Enemy*>(entity.get());
+                enemy->setFlowField(&flowField);
+                if (!enemy->target) enemy->setTarget(player);
+            }
+        }
+    }
+
+    // The player never dies and obstacles are indestructible, so scenarios
+    // keep a steady population
+    void cleanup() {
+        player->health = player->maxHealth;
+        player->lives = 3;
+        player->active = true;
+        entities.erase(std::remove_if(entities.begin(), entities.end(),
+            [](const std::unique_ptr<Entity>& e) { return !e->active; }), entities.end());
+        counts.clear();
+        for (const auto& entity : entities) counts.add(entity->type);
+    }
+};
+
+struct SystemStat {
+    const char* name;
+    double ns = 0;
+    uint64_t items = 0;    // Entities processed, summed over frames
+    uint64_t allocations = 0;
+};
+
+struct Scenario {
+    const char* name;
+    const char* description;
+    std::function<void(World&, float)> setup;  // scale multiplies counts
+};
+
+class Bench {
+public:
+    std::vector<SystemStat> stats;
+    bool measuring = false;
+
+    template<typename Fn>
+    void time(size_t slot, const char* name, uint64_t items, Fn&& fn) {
+        if (stats.size() <= slot) stats.resize(slot + 1);
+        uint64_t allocsBefore = heapAllocationCount();
+        double start = Platform::now();
+        fn();
+        double elapsed = Platform::now() - start;
+        if (!measuring) return;
+        SystemStat& s = stats[slot];
+        s.name = name;
+        s.ns += elapsed * 1e6;
+        s.items += items;
+        s.allocations += heapAllocationCount() - allocsBefore;
+    }
+};
+
+void stepWorld(World& world, Bench& bench) {
+    // As GameEngine::runTick does; swept collision reads the step's motion
+    for (auto& entity : world.entities) entity->storePreviousTransform();
+
+    size_t count = world.entities.size();
+    size_t slot = 0;
+
+    bench.time(slot++, "spawn", count, [&] { world.fireProjectiles(); });
+    count = world.entities.size();
+    bench.time(slot++, "obstacleIndex", count, [&] { world.obstacleIndex.rebuildIfDirty(world.statics); });
+    bench.time(slot++, "flowField", count, [&] { world.flowField.update(world.statics, world.player->position); });
+    bench.time(slot++, "entities", count, [&] {
+        for (auto& entity : world.entities) {
+            if (entity->active) entity->update(FRAME_DT);
+        }
+    });
+    bench.time(slot++, "targets", count, [&] { world.retarget(); });
+    bench.time(slot++, "wolfAI", world.packWolves.size(), [&] {
+        if (!world.packWolves.empty()) world.pack.update(FRAME_DT, world.player, world.obstaclePtrs);
+    });
+    bench.time(slot++, "collision", count, [&] {
+        world.events.clear();
+        world.collisions.checkCollisions(world.entities, world.entities.size(), world.obstacleIndex);
+        for (size_t i = 0; i < world.events.size(); i++) world.effects.playEvent(world.events[i]);
+    });
+    bench.time(slot++, "effects", world.effects.getParticles().getCount(), [&] { world.effects.update(FRAME_DT); });
+    bench.time(slot++, "waves", count, [&] {
+        if (!world.runWaves) return;
+        world.waves.update(FRAME_DT, world.counts, world.spawned, WORLD_WIDTH, WORLD_HEIGHT);
+        for (auto& entity : world.spawned) {
+            world.counts.add(entity->type);
+            world.entities.push_back(std::move(entity));
+        }
+        world.spawned.clear();
+    });
+    bench.time(slot++, "cleanup", count, [&] { world.cleanup(); });
+
+    if (world.runCodec) {
+        count = world.entities.size();
+        bool keyframe = world.codecFrames++ % world.keyframeInterval == 0;
+        uint32_t baseline = keyframe ? 0 : world.ackedSequence;
+        bench.time(slot++, "encode", count, [&] { world.serverCodec.encode(world.entities, baseline); });
+        const std::vector<uint8_t>& packet = world.serverCodec.getPacket();
+        bench.time(slot++, "decode", count, [&] {
+            world.ackedSequence = world.clientCodec.decode(packet.data(), packet.size());
+        });
+        if (bench.measuring) world.packetBytes += packet.size();
+        if (keyframe) world.keyframeBytes = packet.size();
+    }
+}
+
+std::vector<Scenario> scenarios() {
+    return {
+        {"enemies", "chasing enemies around one player",
+            [](World& w, float s) { w.addEnemies(static_cast<int>(500 * s)); }},
+        {"wolfpacks", "entity wolf packs plus the WolfAI pack coordinator",
+            [](World& w, float s) {
+                int packs = std::max(1, static_cast<int>(8 * s));
+                for (int i = 0; i < packs; i++) w.addWolves(6);
+                w.addPackWolves(packs * 6);
+                w.addObstacles(static_cast<int>(60 * s));
+            }},
+        {"projectiles", "projectile storm across a crowd",
+            [](World& w, float s) {
+                w.addEnemies(static_cast<int>(150 * s));
+                w.projectileRate = 20.0f * s;
+            }},
+        {"obstacles", "dense obstacle map with flow-field chasers",
+            [](World& w, float s) {
+                w.addObstacles(static_cast<int>(600 * s));
+                w.addEnemies(static_cast<int>(200 * s));
+            }},
+        {"waves", "wave system spawning into an empty arena",
+            [](World& w, float) { w.runWaves = true; }},
+        {"codec", "StateCodec encode and decode of a chasing crowd",
+            [](World& w, float s) {
+                w.addEnemies(static_cast<int>(500 * s));
+                w.runCodec = true;
+            }},
+        {"keyframes", "StateCodec keyframes only, the worst case for a rejoining client",
+            [](World& w, float s) {
+                w.addEnemies(static_cast<int>(500 * s));
+                w.runCodec = true;
+                w.keyframeInterval = 1;
+            }},
+    };
+}
+
+struct Options {
+    int frames = 600;
+    int warmup = 60;
+    float scale = 1.0f;
+    bool csv = false;
+    std::string only;
+    std::string recordPath;
+    std::string replayPath;
+};
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        auto value = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "missing value for %s\n", argv[i]);
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        if (!std::strcmp(argv[i], "--frames")) options.frames = std::max(1, std::atoi(value()));
+        else if (!std::strcmp(argv[i], "--warmup")) options.warmup = std::max(0, std::atoi(value()));
+        else if (!std::strcmp(argv[i], "--scale")) options.scale = std::max(0.01f, static_cast<float>(std::atof(value())));
+        else if (!std::strcmp(argv[i], "--scenario")) options.only = value();
+        else if (!std::strcmp(argv[i], "--csv")) options.csv = true;
+        else if (!std::strcmp(argv[i], "--record")) options.recordPath = value();
+        else if (!std::strcmp(argv[i], "--replay")) options.replayPath = value();
+        else {
+            std::fprintf(stderr,
+                "usage: %s [--frames N] [--warmup N] [--scenario NAME] [--scale F] [--csv]\n"
+                "       %s --record FILE [--frames N] | --replay FILE\n", argv[0], argv[0]);
+            std::exit(2);
+        }
+    }
+    return options;
+}
+
+// A scripted session: the player circles and fires every few ticks while the
+// wave system spawns against them
+int recordSession(const Options& options) {
+    GameEngine engine(1920, 1080, 0);
+    engine.startRecording(SimRandom::DEFAULT_SEED);
+    engine.startGame();
+    for (int f = 0; f < options.frames; f++) {
+        float angle = f * 0.02f;
+        engine.updatePlayerInput(std::cos(angle), std::sin(angle), std::cos(angle * 3), std::sin(angle * 3));
+        if (f % 8 == 0) engine.playerShoot(std::cos(angle * 3), std::sin(angle * 3));
+        engine.update(1.0f / 60.0f);
+    }
+    engine.stopRecording();
+
+    const std::vector<uint8_t>& bytes = engine.getInputLog().getBytes();
+    FILE* file = std::fopen(options.recordPath.c_str(), "wb");
+    if (!file || std::fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size()) {
+        std::fprintf(stderr, "could not write %s\n", options.recordPath.c_str());
+        if (file) std::fclose(file);
+        return 1;
+    }
+    std::fclose(file);
+    std::printf("recorded %zu records, %u ticks, checksum %08x -> %s\n",
+                engine.getInputLog().getRecords().size(), engine.getFrameNumber(),
+                engine.stateChecksum(), options.recordPath.c_str());
+    return 0;
+}
+
+int replaySession(const Options& options) {
+    FILE* file = std::fopen(options.replayPath.c_str(), "rb");
+    if (!file) {
+        std::fprintf(stderr, "could not open %s\n", options.replayPath.c_str());
+        return 1;
+    }
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) bytes.insert(bytes.end(), chunk, chunk + n);
+    std::fclose(file);
+
+    InputLog log;
+    if (!log.load(bytes.data(), bytes.size())) {
+        std::fprintf(stderr, "%s is not a valid input log\n", options.replayPath.c_str());
+        return 1;
+    }
+    GameEngine::ReplayResult result = GameEngine::runReplay(log);
+    double perTick = result.ticks ? result.elapsedMs / result.ticks : 0.0;
+    if (options.csv) {
+        std::printf("ticks,ms_per_tick,checksum,expected,matches\n");
+        std::printf("%u,%.4f,%08x,%08x,%d\n", result.ticks, perTick, result.checksum,
+                    result.expectedChecksum, result.matches ? 1 : 0);
+    } else {
+        std::printf("replayed %u ticks in %.1f ms (%.4f ms/tick)\n", result.ticks, result.elapsedMs, perTick);
+        std::printf("checksum %08x, recorded %08x: %s\n", result.checksum, result.expectedChecksum,
+                    result.matches ? "match" : (result.complete ? "DIVERGED" : "log incomplete"));
+    }
+    return result.matches ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options = parseOptions(argc, argv);
+    if (!options.recordPath.empty()) return recordSession(options);
+    if (!options.replayPath.empty()) return replaySession(options);
+
+    if (options.csv) {
+        std::printf("scenario,system,ns_per_entity,ms_per_frame,allocs_per_frame\n");
+    }
+
+    bool ran = false;
+    for (const Scenario& scenario : scenarios()) {
+        if (!options.only.empty() && options.only != scenario.name) continue;
+        ran = true;
+
+        World world;
+        scenario.setup(world, options.scale);
+        Bench bench;
+
+        for (int f = 0; f < options.warmup; f++) stepWorld(world, bench);
+        bench.measuring = true;
+        uint64_t allocsBefore = heapAllocationCount();
+        double start = Platform::now();
+        for (int f = 0; f < options.frames; f++) stepWorld(world, bench);
+        double totalMs = Platform::now() - start;
+        uint64_t frameAllocs = heapAllocationCount() - allocsBefore;
+
+        if (!options.csv) {
+            std::printf("\n%s: %s (%zu entities + %zu obstacles at end)\n", scenario.name,
+                        scenario.description, world.entities.size(), world.statics.size());
+            std::printf("  %-14s %14s %12s %14s\n", "system", "ns/entity", "ms/frame", "allocs/frame");
+        }
+        for (const SystemStat& s : bench.stats) {
+            double perEntity = s.items ? s.ns / s.items : 0.0;
+            double perFrame = s.ns / 1e6 / options.frames;
+            double allocs = static_cast<double>(s.allocations) / options.frames;
+            if (options.csv) {
+                std::printf("%s,%s,%.1f,%.4f,%.2f\n", scenario.name, s.name, perEntity, perFrame, allocs);
+            } else {
+                std::printf("  %-14s %14.1f %12.4f %14.2f\n", s.name, perEntity, perFrame, allocs);
+            }
+        }
+        double perFrame = totalMs / options.frames;
+        double allocs = static_cast<double>(frameAllocs) / options.frames;
+        if (options.csv) {
+            std::printf("%s,frame,,%.4f,%.2f\n", scenario.name, perFrame, allocs);
+        } else {
+            std::printf("  %-14s %14s %12.4f %14.2f\n", "frame", "", perFrame, allocs);
+            if (world.runCodec) {
+                std::printf("  packets: %.0f bytes per frame, keyframe %zu bytes\n",
+                            static_cast<double>(world.packetBytes) / options.frames, world.keyframeBytes);
+            }
+        }
+    }
+
+    if (!ran) {
+        std::fprintf(stderr, "unknown scenario '%s'\n", options.only.c_str());
+        return 2;
+    }
+    return 0;
+}
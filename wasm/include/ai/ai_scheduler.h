@@ -0,0 +1,143 @@
+#ifndef AI_SCHEDULER_H
+#define AI_SCHEDULER_H
+
+#include <cstdint>
+#include "../utils/platform.h"
+#include <algorithm>
+
+namespace AI {
+
+// Level-of-detail scheduler for expensive agent perception
+//
+// Agents keep moving and running their state machine every frame, but sight
+// lines, hearing and cover scans only run when the scheduler grants a
+// perception tick. How often an agent is due depends on its tier (what it is
+// doing) and how far it is from the player; due agents beyond the per-frame
+// work budget are deferred to the next frame, except ACTIVE ones, which
+// always run. Work is counted in units (WORK_* below), never in wall time,
+// so which agents run is the same on every machine and in every replay;
+// the wall time spent is kept for the stats only.
+class AIScheduler {
+public:
+    enum class Tier {
+        ACTIVE,    // Engaged (hunting, flanking): every frame
+        ALERT,     // Investigating or searching
+        AMBIENT,   // Patrolling
+        DORMANT    // Idle
+    };
+
+    struct Settings {
+        int activeInterval = 1;
+        int alertInterval = 2;
+        int ambientInterval = 4;
+        int dormantInterval = 8;
+        float farDistance = 1200.0f;  // Intervals double beyond this
+        int budgetUnits = 48;         // Perception work per frame, in WORK_* units
+    };
+
+    // Work units charged per granted perception tick
+    static constexpr int WORK_PERCEPTION = 1;   // Every tick: senses, hearing, pack range query
+    static constexpr int WORK_SIGHT_LINE = 1;   // An obstacle line-of-sight query
+    static constexpr int WORK_COVER_SCAN = 2;   // A cover spot scan over the obstacles
+
+    // Per-agent bookkeeping, owned by the agent
+    struct Ticket {
+        uint32_t lastFrame = 0;
+        bool registered = false;
+    };
+
+private:
+    Settings settings;
+    uint32_t frame;
+    uint32_t nextPhase;
+    int spentUnits;
+    int lastFrameUnits;
+    double spentMs;
+    double lastFrameMs;
+    int ran;
+    int skipped;
+    int deferred;
+    int lastRan;
+    int lastSkipped;
+    int lastDeferred;
+
+public:
+    AIScheduler()
+        : frame(0), nextPhase(0), spentUnits(0), lastFrameUnits(0), spentMs(0), lastFrameMs(0),
+          ran(0), skipped(0), deferred(0), lastRan(0), lastSkipped(0), lastDeferred(0) {}
+
+    void setSettings(const Settings& s) { settings = s; }
+    const Settings& getSettings() const { return settings; }
+    void setBudgetUnits(int units) { settings.budgetUnits = std::max(0, units); }
+
+    void beginFrame() {
+        lastFrameUnits = spentUnits;
+        lastFrameMs = spentMs;
+        lastRan = ran;
+        lastSkipped = skipped;
+        lastDeferred = deferred;
+        frame++;
+        spentUnits = 0;
+        spentMs = 0;
+        ran = skipped = deferred = 0;
+    }
+
+    int intervalFor(Tier tier, float distanceToPlayer) const {
+        int interval = settings.activeInterval;
+        switch (tier) {
+            case Tier::ACTIVE:  interval = settings.activeInterval; break;
+            case Tier::ALERT:   interval = settings.alertInterval; break;
+            case Tier::AMBIENT: interval = settings.ambientInterval; break;
+            case Tier::DORMANT: interval = settings.dormantInterval; break;
+        }
+        if (tier != Tier::ACTIVE && distanceToPlayer > settings.farDistance) interval *= 2;
+        return std::max(1, interval);
+    }
+
+    // Whether the agent should run perception this frame
+    bool claim(Ticket& ticket, Tier tier, float distanceToPlayer) {
+        int interval = intervalFor(tier, distanceToPlayer);
+
+        // New agents get staggered phases so a freshly spawned pack does not
+        // all perceive on the same frame
+        if (!ticket.registered) {
+            ticket.registered = true;
+            ticket.lastFrame = frame - (nextPhase++ % static_cast<uint32_t>(interval));
+        }
+
+        bool due = frame - ticket.lastFrame >= static_cast<uint32_t>(interval);
+        if (!due) {
+            skipped++;
+            return false;
+        }
+        if (tier != Tier::ACTIVE && spentUnits >= settings.budgetUnits) {
+            skipped++;
+            deferred++;
+            return false;
+        }
+
+        ticket.lastFrame = frame;
+        ran++;
+        return true;
+    }
+
+    // Account the work one granted perception tick did
+    void charge(int units) { spentUnits += units; }
+
+    // Wall time of a granted tick, for getLastFrameMs() only; it never
+    // decides who runs
+    void reportMs(double ms) { spentMs += ms; }
+    static double nowMs() { return Platform::now(); }
+
+    // Stats for the last completed frame
+    int getRanCount() const { return lastRan; }
+    int getSkippedCount() const { return lastSkipped; }
+    int getDeferredCount() const { return lastDeferred; }
+    int getLastFrameUnits() const { return lastFrameUnits; }
+    double getLastFrameMs() const { return lastFrameMs; }
+    uint32_t getFrame() const { return frame; }
+};
+
+} // namespace AI
+
+#endif // AI_SCHEDULER_H
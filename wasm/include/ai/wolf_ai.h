@@ -5,8 +5,15 @@
 #include <memory>
 #include <cmath>
 #include <algorithm>
-#include <random>
+#include <unordered_map>
 #include "../entities/entity.h"
+#include "../math/vector_math.h"
+#include "../systems/obstacle_index.h"
+#include "../systems/spatial_hash_grid.h"
+#include "../systems/flow_field.h"
+#include "../systems/stimulus_buffer.h"
+#include "ai_scheduler.h"
+#include "../utils/sim_context.h"
 
 namespace AI {
 
@@ -31,7 +38,7 @@ enum class WolfRole {
     TRACKER
 };
 
-// Sound memory structure
+// A heard stimulus, as remembered by one wolf
 struct SoundMemory {
     Vector2 position;
     float intensity;
@@ -50,10 +57,23 @@ public:
     WolfAI(std::shared_ptr<Wolf> wolf);
     ~WolfAI() = default;
 
-    // Main update function
-    void update(float deltaTime, const Entity* player, 
-                const std::vector<std::shared_ptr<WolfAI>>& packMembers,
-                const std::vector<Entity*>& obstacles);
+    // Main update function. Without runPerception the wolf keeps acting on
+    // what it last saw; sight, hearing, cover scans and the pack range query
+    // are skipped. pack may be null for a lone wolf. Both return the
+    // perception work done, in AIScheduler::WORK_* units (0 without).
+    int update(float deltaTime, const Entity* player, WolfPack* pack,
+                const std::vector<Entity*>& obstacles,
+                bool runPerception = true);
+    // A perception tick whose range, cone and hearing tests were already
+    // done by the pack's batched pass (VectorMath::senseTarget); senses
+    // holds that wolf's SENSE_* flags, and only a wolf with SENSE_SIGHT
+    // goes on to the obstacle line-of-sight query
+    int updateSensed(float deltaTime, const Entity* player, WolfPack* pack,
+                      const std::vector<Entity*>& obstacles, uint8_t senses);
+    
+    // LOD tier for the AI scheduler, from the current state
+    AIScheduler::Tier getScheduleTier() const;
+    AIScheduler::Ticket& getScheduleTicket() { return scheduleTicket; }
 
     // State management
     void setState(WolfState newState);
@@ -63,11 +83,28 @@ public:
     void setRole(WolfRole newRole) { role = newRole; }
     WolfRole getRole() const { return role; }
     void alertPackMembers(const Vector2& targetPos);
+    // Drop the cached in-range members (they are non-owning pointers)
+    void clearPackMembers() { packMembers.clear(); }
+    
+    // Shared static index for sight lines; without one every obstacle in
+    // the list is tested
+    void setObstacleIndex(const ObstacleIndex* index) { obstacleIndex = index; }
+    // Shared chase field; moves toward its target follow it around obstacles
+    void setFlowField(const FlowField* field) { flowField = field; }
+    // Shared noise events; without a buffer the wolf only hears the
+    // player's own movement, tested directly
+    void setStimuli(const StimulusBuffer* buffer) { stimuli = buffer; }
     
     // Getters
     std::shared_ptr<Wolf> getWolf() const { return wolf; }
     float getAlertLevel() const { return alertLevel; }
     const Vector2& getLastSeenPosition() const { return lastSeenPosition; }
+    // Sounds heard within MEMORY_DURATION, newest first; returns the count
+    size_t getRecentSounds(SoundMemory* out, size_t capacity) const;
+    
+    // The player's movement as a stimulus (radius HEARING_RANGE), if it is
+    // fast enough to be heard at all
+    static bool movementStimulus(const Entity* player, Stimulus& out);
 
 private:
     // State handlers
@@ -87,10 +124,13 @@ private:
     void enterInvestigateState(const Vector2& position);
     void enterSearchState();
 
-    // Perception
-    bool checkLineOfSight(const Entity* player, const std::vector<Entity*>& obstacles);
-    SoundMemory* checkForSounds(const Entity* player);
-    void cleanSoundMemory();
+    // Perception; senses are the wolf's VectorMath::SENSE_* flags
+    int think(float deltaTime, const Entity* player, WolfPack* pack,
+               const std::vector<Entity*>& obstacles, bool runPerception, uint8_t senses);
+    uint8_t sensePlayer(const Entity* player) const;
+    bool checkLineOfSight(const Entity* player, const std::vector<Entity*>& obstacles, uint8_t senses);
+    const SoundMemory* checkForSounds(const Entity* player, uint8_t senses);
+    const SoundMemory* rememberSound(const Stimulus& sound);
 
     // Movement and pathfinding
     Vector2 calculateInterceptPoint(const Entity* player);
@@ -98,13 +138,12 @@ private:
     void moveTowards(const Vector2& target, float speed, float dt);
     
     // Pack coordination
-    void coordinateAttack(const std::vector<std::shared_ptr<WolfAI>>& nearbyPackMembers, 
+    void coordinateAttack(const std::vector<WolfAI*>& nearbyPackMembers, 
                           const Entity* player);
-    void updatePackAwareness(const std::vector<std::shared_ptr<WolfAI>>& allWolves);
+    void updatePackAwareness(WolfPack* pack);
     
     // Utility functions
     float getDistance(const Vector2& a, const Vector2& b) const;
-    float normalizeAngle(float angle) const;
     bool lineIntersectsCircle(const Vector2& lineStart, const Vector2& lineEnd,
                              const Vector2& circleCenter, float radius) const;
     Vector2 estimatePlayerVelocity(const Entity* player);
@@ -115,6 +154,9 @@ private:
 private:
     // Core references
     std::shared_ptr<Wolf> wolf;
+    const ObstacleIndex* obstacleIndex;
+    const FlowField* flowField;
+    const StimulusBuffer* stimuli;
     WolfState state;
     WolfRole role;
     
@@ -129,15 +171,29 @@ private:
     float investigateTimer;
     float communicationCooldown;
     
+    // Simulation clock (ms), advanced by update(); replaces wall-clock reads
+    float clockMs;
+    
+    // Perception results carried between scheduled perception ticks
+    bool cachedCanSeePlayer;
+    bool coverScanPending;
+    AIScheduler::Ticket scheduleTicket;
+    
     // Alert and awareness
     float alertLevel; // 0 = unaware, 1 = suspicious, 2 = combat
-    std::vector<std::shared_ptr<WolfAI>> packMembers;
+    // Pack members within COMMUNICATION_RANGE at the last perception tick;
+    // owned by the WolfPack, which clears these when a wolf is removed
+    std::vector<WolfAI*> packMembers;
+    std::vector<WolfAI*> huntingScratch;
     
-    // Memory systems
-    std::vector<SoundMemory> soundMemory;
-    std::vector<CoverSpot> coverSpots;
+    // Memory systems. Sounds go into a fixed ring, oldest overwritten, and
+    // expire by age when read.
     static constexpr int MAX_SOUND_MEMORY = 5;
     static constexpr float MEMORY_DURATION = 5.0f;
+    SoundMemory soundMemory[MAX_SOUND_MEMORY];
+    int soundHead;     // Next slot written
+    int soundCount;
+    std::vector<CoverSpot> coverSpots;
     
     // Patrol system
     std::vector<Vector2> patrolPath;
@@ -158,10 +214,14 @@ private:
     static constexpr float FLANK_DISTANCE = 200.0f;
     static constexpr float INTERCEPT_LOOKAHEAD = 1.5f;
     static constexpr float VISION_CONE_ANGLE = M_PI / 3.0f; // 60 degrees
+    static constexpr float VISION_CONE_COS_HALF = 0.8660254f; // cos(VISION_CONE_ANGLE / 2)
+    static constexpr float NOISY_SPEED = 150.0f;
+    static constexpr float LOUD_SPEED = 200.0f;
     
-    // Random number generator
-    std::mt19937 rng;
-    std::uniform_real_distribution<float> randomDist;
+    friend class WolfPack;
+    
+    // Per-wolf stream, seeded from the simulation's at construction
+    SimRandom rng;
 };
 
 // Wolf entity class
@@ -173,8 +233,18 @@ public:
     void update(float deltaTime);
     
     bool getIsAlpha() const { return isAlpha; }
-    void setRotation(float rot) { rotation = rot; }
+    void setRotation(float rot) {
+        rotation = rot;
+        facing = Vector2(std::cos(rot), std::sin(rot));
+    }
+    // Rotation from a unit heading, which becomes the facing as is
+    void setHeading(const Vector2& heading) {
+        rotation = std::atan2(heading.y, heading.x);
+        facing = heading;
+    }
     float getRotation() const { return rotation; }
+    // Unit vector along the rotation, for the vision cone dot test
+    const Vector2& getFacing() const { return facing; }
     
     // Combat
     void takeDamage(float damage);
@@ -190,6 +260,7 @@ public:
     
 private:
     bool isAlpha;
+    Vector2 facing;
 };
 
 // Wolf Pack coordinator
@@ -201,11 +272,51 @@ public:
     void addWolf(std::shared_ptr<WolfAI> wolf);
     void removeWolf(std::shared_ptr<WolfAI> wolf);
     void update(float deltaTime, const Entity* player, const std::vector<Entity*>& obstacles);
+    void setObstacleIndex(const ObstacleIndex* index);
+    void setFlowField(const FlowField* field);
+    // Noise events emitted by the host. Without one the pack emits the
+    // player's movement into a buffer of its own each update.
+    void setStimuli(const StimulusBuffer* buffer);
+    void setWorldBounds(float width, float height);
+    
+    // Members within range of center (exact distance), from the grid built
+    // at the start of update(). out is cleared first; returns the count.
+    size_t queryMembers(const Vector2& center, float range,
+                        std::vector<WolfAI*>& out, const WolfAI* exclude = nullptr);
+    
+    // Perception LOD and budget; stats describe the last update
+    AIScheduler& getScheduler() { return scheduler; }
+    const AIScheduler& getScheduler() const { return scheduler; }
     
     const std::vector<std::shared_ptr<WolfAI>>& getWolves() const { return wolves; }
     
 private:
     std::vector<std::shared_ptr<WolfAI>> wolves;
+    const ObstacleIndex* obstacleIndex;
+    const FlowField* flowField;
+    const StimulusBuffer* sharedStimuli;
+    StimulusBuffer ownStimuli;
+    AIScheduler scheduler;
+    
+    // Range queries: wolves are re-inserted once per update
+    static constexpr float GRID_CELL_SIZE = 250.0f;
+    SpatialHashGrid grid;
+    std::unordered_map<const Entity*, WolfAI*> agentByEntity;
+    std::vector<Entity*> queryScratch;
+    
+    // Batched perception: wolf positions and facings as SoA, and the
+    // kernel's squared distances and SENSE_* flags, indexed like wolves
+    std::vector<float> senseX, senseY, senseFacingX, senseFacingY, senseDistSq;
+    std::vector<uint8_t> senseFlags;
+    
+    // State of each wolf when roles were last considered; roles are only
+    // reassigned after a wolf joins, leaves or changes state
+    std::vector<WolfState> knownStates;
+    bool rolesDirty;
+    
+    void rebuildGrid();
+    const StimulusBuffer* activeStimuli() const { return sharedStimuli ? sharedStimuli : &ownStimuli; }
+    void sensePlayer(const Entity* player);
     void coordinatePack();
     void assignRoles();
 };
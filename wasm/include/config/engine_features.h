@@ -0,0 +1,48 @@
+#ifndef ENGINE_FEATURES_H
+#define ENGINE_FEATURES_H
+
+// Compile-time feature modules
+//
+// Each module defaults on; a build turns one off with -DENGINE_FEATURE_X=0
+// (scripts/build-wasm.sh --without x). A disabled module keeps its part of
+// the core API callable but compiles its work away, and its JavaScript-only
+// methods are not bound at all, so nothing it pulls in reaches the module.
+//   CAMERA     viewport following the player, world/screen transforms
+//   TARGETING  target lock, target switching and the mobile target button
+//   WOLF_AI    wolves and wolf packs (createWolf returns -1, waves skip them)
+//   EFFECTS    particles and screen shake (effect calls become no-ops)
+#ifndef ENGINE_FEATURE_CAMERA
+#define ENGINE_FEATURE_CAMERA 1
+#endif
+
+#ifndef ENGINE_FEATURE_TARGETING
+#define ENGINE_FEATURE_TARGETING 1
+#endif
+
+#ifndef ENGINE_FEATURE_WOLF_AI
+#define ENGINE_FEATURE_WOLF_AI 1
+#endif
+
+#ifndef ENGINE_FEATURE_EFFECTS
+#define ENGINE_FEATURE_EFFECTS 1
+#endif
+
+namespace Features {
+    constexpr bool CAMERA = ENGINE_FEATURE_CAMERA != 0;
+    constexpr bool TARGETING = ENGINE_FEATURE_TARGETING != 0;
+    constexpr bool WOLF_AI = ENGINE_FEATURE_WOLF_AI != 0;
+    constexpr bool EFFECTS = ENGINE_FEATURE_EFFECTS != 0;
+
+    // Bit mask reported to JS (GameEngine::getFeatures)
+    constexpr int CAMERA_BIT = 1 << 0;
+    constexpr int TARGETING_BIT = 1 << 1;
+    constexpr int WOLF_AI_BIT = 1 << 2;
+    constexpr int EFFECTS_BIT = 1 << 3;
+
+    constexpr int mask() {
+        return (CAMERA ? CAMERA_BIT : 0) | (TARGETING ? TARGETING_BIT : 0) |
+               (WOLF_AI ? WOLF_AI_BIT : 0) | (EFFECTS ? EFFECTS_BIT : 0);
+    }
+}
+
+#endif // ENGINE_FEATURES_H
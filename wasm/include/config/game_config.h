@@ -35,6 +35,14 @@ namespace Config {
     constexpr float WOLF_WAVE_SPAWN_DELAY = 2000.0f;
     constexpr int MAX_WOLVES = 20;
     
+    // Noise heard by wolves (systems/stimulus_buffer.h); radii in world units
+    constexpr float STIMULUS_CELL_SIZE = 256.0f;
+    constexpr float STIMULUS_SPRINT_SPEED = PLAYER_MAX_SPEED * 0.8f;  // Slower movement is silent
+    constexpr float STIMULUS_SPRINT_RADIUS = 300.0f;  // Boosting or rolling counts as loud
+    constexpr float STIMULUS_SHOT_RADIUS = 450.0f;
+    constexpr float STIMULUS_ATTACK_RADIUS = 200.0f;
+    constexpr float STIMULUS_OBSTACLE_RADIUS = 500.0f;
+    
     // Projectile settings
     constexpr float PROJECTILE_RADIUS = 5.0f;
     constexpr float PROJECTILE_SPEED = 15.0f;
@@ -51,6 +59,9 @@ namespace Config {
     constexpr float OBSTACLE_MIN_RADIUS = 20.0f;
     constexpr float OBSTACLE_MAX_RADIUS = 50.0f;
     constexpr int MAX_OBSTACLES = 10;
+    constexpr float OBSTACLE_PASSAGE_WIDTH = PLAYER_RADIUS * 4;  // Kept clear between generated obstacles
+    constexpr float OBSTACLE_SPAWN_CLEARANCE = 150.0f;           // Kept clear around the player spawn
+    constexpr int OBSTACLE_SAMPLE_ATTEMPTS = 12;                 // Candidates per active sample
     
     // Shield/Block system
     constexpr float SHIELD_DURATION = 2000.0f;
@@ -77,6 +88,17 @@ namespace Config {
     constexpr float ROLL_SPEED_MULTIPLIER = 2.5f;
     constexpr float ROLL_ENERGY_COST = 15.0f;
     
+    // Special ability (area blast around the player)
+    constexpr float SPECIAL_ENERGY_COST = 50.0f;
+    constexpr float SPECIAL_RADIUS = 150.0f;
+    constexpr float SPECIAL_DAMAGE = 75.0f;
+    constexpr float SPECIAL_KNOCKBACK = 20.0f;
+    
+    // Targeting
+    constexpr float MAX_TARGET_DISTANCE = 400.0f;
+    constexpr float TARGET_LONG_PRESS = 500.0f;        // ms; shorter presses switch target
+    constexpr float TARGET_DISABLE_DURATION = 2000.0f; // ms a long press suspends targeting
+    
     // Game settings
     constexpr int INITIAL_LIVES = 3;
     constexpr float INVULNERABILITY_DURATION = 2000.0f;
@@ -89,10 +111,30 @@ namespace Config {
     constexpr int MAX_PARTICLES = 500;
     constexpr float SCREEN_SHAKE_DURATION = 300.0f;
     constexpr int TRAIL_LENGTH = 10;
+    constexpr float RENDER_CULL_MARGIN = 64.0f;  // World units kept around the viewport
     
     // System settings
     constexpr int MAX_ENTITIES = 1000;
     constexpr float PHYSICS_TIMESTEP = 16.0f; // 60 FPS
+    constexpr float SIMULATION_TICK_RATE = 60.0f; // Fixed simulation steps per second
+    constexpr float REFERENCE_FRAME_RATE = 60.0f; // Speeds are units per frame, particle lifetimes frames, at this rate
+    constexpr int MAX_SUBSTEPS = 5;               // Catch-up budget per update() call
+    constexpr float SWEPT_MIN_TRAVEL = 0.5f;      // Step travel, in radii, above which collision is swept
+    constexpr int ROLLBACK_MAX_DEPTH = 64;        // Saved ticks kept for rollback at most
+    
+    // Streamed worlds (systems/chunk_manager.h)
+    constexpr float CHUNK_SIZE = 1024.0f;         // World units per chunk side
+    constexpr int CHUNK_LOAD_RADIUS = 1;          // Live chunks around the player's chunk
+    constexpr int CHUNK_SWEEP_INTERVAL = 30;      // Ticks between checks for entities leaving the window
+    constexpr int CHUNK_OBSTACLES = 6;            // Generated per chunk
+    constexpr int CHUNK_ENEMIES = 1;
+    constexpr int CHUNK_POWERUP_CHANCE = 25;      // Percent
+    constexpr float CHUNK_SAFE_RADIUS = 150.0f;   // Kept clear around the player spawn
+    
+    // Slab pool sizes (slots per slab); pools add a slab when they run out
+    constexpr int PROJECTILE_POOL_SIZE = 256;     // Rapid fire + multishot
+    constexpr int ENEMY_POOL_SIZE = 64;
+    constexpr int WOLF_POOL_SIZE = 64;
 }
 
 #endif // GAME_CONFIG_H
\ No newline at end of file
@@ -2,112 +2,258 @@
 #define PARTICLE_H
 
 #include "../math/vector2.h"
-#include <string>
+#include "../math/vector_math.h"
+#include "../config/game_config.h"
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
 
-class Particle {
-public:
+enum class ParticleType : uint8_t {
+    EXPLOSION,
+    BLOOD,
+    SPARK,
+    SMOKE,
+    BOOST_TRAIL,
+    HIT_EFFECT,
+    HEAL,
+    ENERGY,
+    DUST
+};
+
+// Fixed particle colour table; particles store an index into it
+namespace ParticlePalette {
+    enum Color : uint8_t {
+        WHITE,
+        ORANGE,
+        SMOKE_GREY,
+        BLOOD_RED,
+        CYAN,
+        YELLOW,
+        GREEN,
+        BLUE,
+        DUST_BROWN,
+        COUNT
+    };
+
+    inline const char* toString(uint8_t index) {
+        static const char* const colors[COUNT] = {
+            "#ffffff", "#ff6600", "#333333", "#cc0000", "#00ffff",
+            "#ffff00", "#00ff00", "#0099ff", "#996633"
+        };
+        return index < COUNT ? colors[index] : colors[WHITE];
+    }
+
+    // Map a CSS colour to its palette slot; unknown colours become white
+    inline uint8_t fromString(const char* color) {
+        for (uint8_t i = 0; i < COUNT; i++) {
+            if (std::strcmp(toString(i), color) == 0) return i;
+        }
+        return WHITE;
+    }
+}
+
+// Plain particle description used to spawn into a ParticleBuffer
+struct Particle {
     Vector2 position;
     Vector2 velocity;
-    float lifetime;
-    float maxLifetime;
+    float lifetime;    // Frames at Config::REFERENCE_FRAME_RATE
     float size;
-    float alpha;
-    std::string color;
-    bool active;
-    
-    enum class ParticleType {
-        EXPLOSION,
-        BLOOD,
-        SPARK,
-        SMOKE,
-        BOOST_TRAIL,
-        HIT_EFFECT,
-        HEAL,
-        ENERGY,
-        DUST
-    };
-    
+    uint8_t color;
     ParticleType type;
-    
-    Particle()
-        : position(0, 0), velocity(0, 0),
-          lifetime(0), maxLifetime(60),
-          size(5), alpha(1.0f),
-          color("#ffffff"), active(false),
-          type(ParticleType::SPARK) {}
-    
-    void init(const Vector2& pos, const Vector2& vel, float life, 
-              float particleSize, const std::string& col, ParticleType t) {
-        position = pos;
-        velocity = vel;
-        lifetime = life;
-        maxLifetime = life;
-        size = particleSize;
-        color = col;
-        type = t;
-        alpha = 1.0f;
-        active = true;
+};
+
+// Fixed-capacity structure-of-arrays particle storage
+//
+// Live particles occupy indices [0, count). Dead particles are removed by
+// swapping the last live particle into their slot, so the arrays stay dense
+// and the per-frame update is a handful of straight-line kernels. Storage is
+// sized once up front; spawning past the cap follows the drop policy and
+// never allocates.
+class ParticleBuffer {
+public:
+    enum class DropPolicy {
+        DROP_NEW,      // Reject spawns while full
+        RECYCLE        // Overwrite live particles in round-robin order
+    };
+
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<float> lifetime;
+    std::vector<float> maxLifetime;
+    std::vector<float> size;
+    std::vector<float> drag;     // Per-frame velocity multiplier
+    std::vector<float> gravity;  // Added to vy before drag
+    std::vector<float> growth;   // Per-frame size multiplier
+    std::vector<uint8_t> color;
+    std::vector<ParticleType> type;
+
+    explicit ParticleBuffer(size_t maxParticles = 500)
+        : capacity(0), count(0), recycleCursor(0), dropped(0),
+          policy(DropPolicy::DROP_NEW) {
+        setCapacity(maxParticles);
     }
-    
+
+    // Resize storage; live particles beyond the new cap are discarded
+    void setCapacity(size_t maxParticles) {
+        capacity = maxParticles;
+        count = std::min(count, capacity);
+        recycleCursor = 0;
+        x.resize(capacity);
+        y.resize(capacity);
+        vx.resize(capacity);
+        vy.resize(capacity);
+        lifetime.resize(capacity);
+        maxLifetime.resize(capacity);
+        size.resize(capacity);
+        drag.resize(capacity);
+        gravity.resize(capacity);
+        growth.resize(capacity);
+        color.resize(capacity);
+        type.resize(capacity);
+    }
+
+    void setDropPolicy(DropPolicy newPolicy) { policy = newPolicy; }
+
+    // Returns false when the particle was dropped
+    bool spawn(const Particle& p) {
+        size_t i;
+        if (count < capacity) {
+            i = count++;
+        } else if (policy == DropPolicy::RECYCLE && capacity > 0) {
+            i = recycleCursor;
+            recycleCursor = (recycleCursor + 1) % capacity;
+            dropped++;
+        } else {
+            dropped++;
+            return false;
+        }
+
+        x[i] = p.position.x;
+        y[i] = p.position.y;
+        vx[i] = p.velocity.x;
+        vy[i] = p.velocity.y;
+        lifetime[i] = p.lifetime;
+        maxLifetime[i] = p.lifetime;
+        size[i] = p.size;
+        color[i] = p.color;
+        type[i] = p.type;
+        applyTypePhysics(i, p.type);
+        return true;
+    }
+
     void update(float deltaTime) {
-        if (!active) return;
-        
-        lifetime -= deltaTime;
-        if (lifetime <= 0) {
-            active = false;
-            return;
+        expire(deltaTime);
+        integrate(0, count, deltaTime);
+    }
+
+    // Age and drop expired particles first, as the per-object update did.
+    // Compaction reorders particles, so this part stays serial.
+    void expire(float deltaTime) {
+        float frames = deltaTime * Config::REFERENCE_FRAME_RATE;
+        for (size_t i = 0; i < count;) {
+            lifetime[i] -= frames;
+            if (lifetime[i] <= 0) {
+                removeAt(i);
+            } else {
+                i++;
+            }
         }
-        
-        // Update position
-        position += velocity * (deltaTime / 16.0f);
-        
-        // Apply physics based on type
-        switch (type) {
+    }
+
+    // Motion for the live particles in [begin, end); slices are independent
+    void integrate(size_t begin, size_t end, float deltaTime) {
+        size_t n = end - begin;
+        VectorMath::integrate(x.data() + begin, y.data() + begin,
+                              vx.data() + begin, vy.data() + begin, n, deltaTime * Config::REFERENCE_FRAME_RATE);
+        VectorMath::addEach(vy.data() + begin, gravity.data() + begin, n);
+        VectorMath::dampEach(vx.data() + begin, vy.data() + begin, drag.data() + begin, n);
+        VectorMath::scaleEach(size.data() + begin, growth.data() + begin, n);
+    }
+
+    void clear() {
+        count = 0;
+        recycleCursor = 0;
+    }
+
+    size_t getCount() const { return count; }
+    size_t getCapacity() const { return capacity; }
+    size_t getDroppedCount() const { return dropped; }
+    bool isFull() const { return count >= capacity; }
+
+    float getAlpha(size_t i) const {
+        // Pulsing effect
+        if (type[i] == ParticleType::HEAL || type[i] == ParticleType::ENERGY) {
+            return 0.5f + 0.5f * std::sin((maxLifetime[i] - lifetime[i]) * 0.1f);
+        }
+        return lifetime[i] / maxLifetime[i];
+    }
+
+    float getSize(size_t i) const {
+        if (type[i] == ParticleType::EXPLOSION) {
+            return size[i] * (1.0f + (1.0f - lifetime[i] / maxLifetime[i]));
+        }
+        return size[i];
+    }
+
+private:
+    size_t capacity;
+    size_t count;
+    size_t recycleCursor;
+    size_t dropped;
+    DropPolicy policy;
+
+    void removeAt(size_t i) {
+        size_t last = --count;
+        if (i != last) {
+            x[i] = x[last];
+            y[i] = y[last];
+            vx[i] = vx[last];
+            vy[i] = vy[last];
+            lifetime[i] = lifetime[last];
+            maxLifetime[i] = maxLifetime[last];
+            size[i] = size[last];
+            drag[i] = drag[last];
+            gravity[i] = gravity[last];
+            growth[i] = growth[last];
+            color[i] = color[last];
+            type[i] = type[last];
+        }
+    }
+
+    // Per-type motion, folded into coefficients so the update stays branch-free
+    void applyTypePhysics(size_t i, ParticleType t) {
+        gravity[i] = 0.0f;
+        growth[i] = 1.0f;
+
+        switch (t) {
             case ParticleType::SMOKE:
-                velocity.y -= 0.1f; // Float upward
-                velocity *= 0.98f; // Air resistance
+                gravity[i] = -0.1f; // Float upward
+                drag[i] = 0.98f;    // Air resistance
                 break;
-                
+
             case ParticleType::BLOOD:
             case ParticleType::SPARK:
-                velocity.y += 0.3f; // Gravity
-                velocity *= 0.95f; // Friction
+                gravity[i] = 0.3f;  // Gravity
+                drag[i] = 0.95f;    // Friction
                 break;
-                
+
             case ParticleType::BOOST_TRAIL:
-                velocity *= 0.9f; // Quick fade
+                drag[i] = 0.9f;     // Quick fade
                 break;
-                
+
             case ParticleType::EXPLOSION:
-                velocity *= 0.92f; // Explosion slowdown
-                size *= 1.02f; // Expand
+                drag[i] = 0.92f;    // Explosion slowdown
+                growth[i] = 1.02f;  // Expand
                 break;
-                
+
             default:
-                velocity *= 0.98f;
+                drag[i] = 0.98f;
                 break;
         }
-        
-        // Update alpha based on lifetime
-        alpha = lifetime / maxLifetime;
-        
-        // Special effects for certain types
-        if (type == ParticleType::HEAL || type == ParticleType::ENERGY) {
-            // Pulsing effect
-            alpha = 0.5f + 0.5f * sin((maxLifetime - lifetime) * 0.1f);
-        }
-    }
-    
-    float getAlpha() const {
-        return alpha;
-    }
-    
-    float getSize() const {
-        if (type == ParticleType::EXPLOSION) {
-            return size * (1.0f + (1.0f - lifetime / maxLifetime));
-        }
-        return size;
     }
 };
 
-#endif // PARTICLE_H
\ No newline at end of file
+#endif // PARTICLE_H
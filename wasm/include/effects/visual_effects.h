@@ -3,54 +3,78 @@
 
 #include "particle.h"
 #include "../math/vector2.h"
-#include <vector>
-#include <memory>
+#include "../config/game_config.h"
+#include "../config/engine_features.h"
+#include "../entities/entity.h"
+#include "../systems/job_system.h"
+#include "../systems/gameplay_events.h"
+#include "../utils/frame_tracer.h"
+#include "../utils/sim_context.h"
+#include <string>
+#include <algorithm>
 #include <cstdlib>
 #include <cmath>
 
+// Particle effects and screen shake. Built without ENGINE_FEATURE_EFFECTS
+// every effect call returns immediately (and draws no random numbers), so
+// callers need no guards of their own.
 class VisualEffects {
 private:
-    std::vector<std::unique_ptr<Particle>> particles;
-    int maxParticles;
+    ParticleBuffer particles;
+    JobSystem* jobs;
     
     // Screen shake
     float screenShakeIntensity;
     float screenShakeDuration;
     Vector2 screenShakeOffset;
     
+    // Fraction of effect particles actually spawned (quality level)
+    float spawnDensity;
+    float spawnCredit;
+    
+    // Effects describe every particle, drawing its random numbers, and the
+    // density decides which ones are kept, so the simulation's random stream
+    // does not depend on the quality level
+    void emit(const Particle& p) {
+        spawnCredit += spawnDensity;
+        if (spawnCredit < 1.0f) return;
+        spawnCredit -= 1.0f;
+        particles.spawn(p);
+    }
+    
 public:
-    VisualEffects(int maxParts = 500)
-        : maxParticles(maxParts),
+    VisualEffects(int maxParts = Config::MAX_PARTICLES)
+        : particles(Features::EFFECTS ? maxParts : 0),
+          jobs(nullptr),
           screenShakeIntensity(0),
           screenShakeDuration(0),
-          screenShakeOffset(0, 0) {
-        particles.reserve(maxParticles);
-    }
+          screenShakeOffset(0, 0),
+          spawnDensity(1.0f),
+          spawnCredit(0) {}
     
     void update(float deltaTime) {
-        // Update particles
-        for (auto& particle : particles) {
-            if (particle && particle->active) {
-                particle->update(deltaTime);
-            }
+        if (!Features::EFFECTS) return;
+        // Update particles; motion is split across the job system when set
+        if (jobs) {
+            TRACE_ZONE("effects.particles");
+            particles.expire(deltaTime);
+            jobs->parallelFor(particles.getCount(), JobSystem::DEFAULT_MIN_CHUNK,
+                [this, deltaTime](size_t begin, size_t end) {
+                    TRACE_ZONE("effects.particleChunk");
+                    particles.integrate(begin, end, deltaTime);
+                });
+        } else {
+            TRACE_ZONE("effects.particles");
+            particles.update(deltaTime);
         }
         
-        // Remove inactive particles
-        particles.erase(
-            std::remove_if(particles.begin(), particles.end(),
-                [](const std::unique_ptr<Particle>& p) {
-                    return !p || !p->active;
-                }),
-            particles.end()
-        );
-        
         // Update screen shake
         if (screenShakeDuration > 0) {
             screenShakeDuration -= deltaTime;
             
             float shakeAmount = screenShakeIntensity * (screenShakeDuration / (Config::SCREEN_SHAKE_DURATION / 1000.0f));
-            screenShakeOffset.x = (rand() % 200 - 100) / 100.0f * shakeAmount;
-            screenShakeOffset.y = (rand() % 200 - 100) / 100.0f * shakeAmount;
+            screenShakeOffset.x = (Sim::randomInt(200) - 100) / 100.0f * shakeAmount;
+            screenShakeOffset.y = (Sim::randomInt(200) - 100) / 100.0f * shakeAmount;
             
             if (screenShakeDuration <= 0) {
                 screenShakeIntensity = 0;
@@ -60,29 +84,24 @@ public:
     }
     
     void createExplosion(const Vector2& pos, float intensity = 1.0f) {
+        if (!Features::EFFECTS) return;
         int particleCount = 20 * intensity;
         
-        for (int i = 0; i < particleCount && particles.size() < maxParticles; i++) {
-            auto particle = std::make_unique<Particle>();
-            
-            float angle = (rand() % 360) * M_PI / 180.0f;
-            float speed = 5.0f + (rand() % 10);
+        for (int i = 0; i < particleCount; i++) {
+            float angle = Sim::randomInt(360) * M_PI / 180.0f;
+            float speed = 5.0f + Sim::randomInt(10);
             Vector2 vel(cos(angle) * speed, sin(angle) * speed);
             
-            particle->init(pos, vel, 60, 8, "#ff6600", Particle::ParticleType::EXPLOSION);
-            particles.push_back(std::move(particle));
+            emit({pos, vel, 60, 8, ParticlePalette::ORANGE, ParticleType::EXPLOSION});
         }
         
         // Add smoke
-        for (int i = 0; i < 10 && particles.size() < maxParticles; i++) {
-            auto particle = std::make_unique<Particle>();
-            
-            float angle = (rand() % 360) * M_PI / 180.0f;
-            float speed = 1.0f + (rand() % 3);
+        for (int i = 0; i < 10; i++) {
+            float angle = Sim::randomInt(360) * M_PI / 180.0f;
+            float speed = 1.0f + Sim::randomInt(3);
             Vector2 vel(cos(angle) * speed, sin(angle) * speed - 1);
             
-            particle->init(pos, vel, 90, 12, "#333333", Particle::ParticleType::SMOKE);
-            particles.push_back(std::move(particle));
+            emit({pos, vel, 90, 12, ParticlePalette::SMOKE_GREY, ParticleType::SMOKE});
         }
         
         // Trigger screen shake
@@ -90,34 +109,30 @@ public:
     }
     
     void createBloodSplatter(const Vector2& pos, const Vector2& direction) {
+        if (!Features::EFFECTS) return;
         int particleCount = 15;
         
-        for (int i = 0; i < particleCount && particles.size() < maxParticles; i++) {
-            auto particle = std::make_unique<Particle>();
-            
+        for (int i = 0; i < particleCount; i++) {
             float spread = 0.5f;
-            Vector2 vel = direction * (3 + rand() % 5);
-            vel.x += (rand() % 100 - 50) / 100.0f * spread;
-            vel.y += (rand() % 100 - 50) / 100.0f * spread;
+            Vector2 vel = direction * (3 + Sim::randomInt(5));
+            vel.x += (Sim::randomInt(100) - 50) / 100.0f * spread;
+            vel.y += (Sim::randomInt(100) - 50) / 100.0f * spread;
             
-            particle->init(pos, vel, 45, 4, "#cc0000", Particle::ParticleType::BLOOD);
-            particles.push_back(std::move(particle));
+            emit({pos, vel, 45, 4, ParticlePalette::BLOOD_RED, ParticleType::BLOOD});
         }
     }
     
     void createHitEffect(const Vector2& pos, bool perfectParry = false) {
+        if (!Features::EFFECTS) return;
         int particleCount = perfectParry ? 30 : 10;
-        std::string color = perfectParry ? "#00ffff" : "#ffff00";
+        uint8_t color = perfectParry ? ParticlePalette::CYAN : ParticlePalette::YELLOW;
         
-        for (int i = 0; i < particleCount && particles.size() < maxParticles; i++) {
-            auto particle = std::make_unique<Particle>();
-            
-            float angle = (rand() % 360) * M_PI / 180.0f;
+        for (int i = 0; i < particleCount; i++) {
+            float angle = Sim::randomInt(360) * M_PI / 180.0f;
             float speed = perfectParry ? 8.0f : 4.0f;
             Vector2 vel(cos(angle) * speed, sin(angle) * speed);
             
-            particle->init(pos, vel, 30, 3, color, Particle::ParticleType::SPARK);
-            particles.push_back(std::move(particle));
+            emit({pos, vel, 30, 3, color, ParticleType::SPARK});
         }
         
         if (perfectParry) {
@@ -126,64 +141,102 @@ public:
     }
     
     void createBoostTrail(const Vector2& pos, const std::string& color, const Vector2& velocity) {
-        if (particles.size() >= maxParticles) return;
-        
-        auto particle = std::make_unique<Particle>();
-        
+        createBoostTrail(pos, ParticlePalette::fromString(color.c_str()), velocity);
+    }
+    
+    void createBoostTrail(const Vector2& pos, uint8_t color, const Vector2& velocity) {
+        if (!Features::EFFECTS) return;
         Vector2 vel = velocity * -0.5f;
-        vel.x += (rand() % 100 - 50) / 100.0f;
-        vel.y += (rand() % 100 - 50) / 100.0f;
+        vel.x += (Sim::randomInt(100) - 50) / 100.0f;
+        vel.y += (Sim::randomInt(100) - 50) / 100.0f;
         
-        particle->init(pos, vel, 20, 6, color, Particle::ParticleType::BOOST_TRAIL);
-        particles.push_back(std::move(particle));
+        emit({pos, vel, 20, 6, color, ParticleType::BOOST_TRAIL});
     }
     
     void createHealEffect(const Vector2& pos) {
+        if (!Features::EFFECTS) return;
         int particleCount = 20;
         
-        for (int i = 0; i < particleCount && particles.size() < maxParticles; i++) {
-            auto particle = std::make_unique<Particle>();
-            
-            float angle = (rand() % 360) * M_PI / 180.0f;
-            float radius = rand() % 30;
+        for (int i = 0; i < particleCount; i++) {
+            float angle = Sim::randomInt(360) * M_PI / 180.0f;
+            float radius = Sim::randomInt(30);
             Vector2 offset(cos(angle) * radius, sin(angle) * radius);
-            Vector2 vel(0, -1.0f - (rand() % 20) / 10.0f);
+            Vector2 vel(0, -1.0f - Sim::randomInt(20) / 10.0f);
             
-            particle->init(pos + offset, vel, 60, 4, "#00ff00", Particle::ParticleType::HEAL);
-            particles.push_back(std::move(particle));
+            emit({pos + offset, vel, 60, 4, ParticlePalette::GREEN, ParticleType::HEAL});
         }
     }
     
     void createEnergyEffect(const Vector2& pos) {
+        if (!Features::EFFECTS) return;
         int particleCount = 15;
         
-        for (int i = 0; i < particleCount && particles.size() < maxParticles; i++) {
-            auto particle = std::make_unique<Particle>();
-            
+        for (int i = 0; i < particleCount; i++) {
             float angle = i * (360.0f / particleCount) * M_PI / 180.0f;
             Vector2 vel(cos(angle) * 2, sin(angle) * 2);
             
-            particle->init(pos, vel, 45, 3, "#0099ff", Particle::ParticleType::ENERGY);
-            particles.push_back(std::move(particle));
+            emit({pos, vel, 45, 3, ParticlePalette::BLUE, ParticleType::ENERGY});
         }
     }
     
     void createDustCloud(const Vector2& pos) {
+        if (!Features::EFFECTS) return;
         int particleCount = 8;
         
-        for (int i = 0; i < particleCount && particles.size() < maxParticles; i++) {
-            auto particle = std::make_unique<Particle>();
-            
-            float angle = (rand() % 360) * M_PI / 180.0f;
-            float speed = 0.5f + (rand() % 20) / 10.0f;
+        for (int i = 0; i < particleCount; i++) {
+            float angle = Sim::randomInt(360) * M_PI / 180.0f;
+            float speed = 0.5f + Sim::randomInt(20) / 10.0f;
             Vector2 vel(cos(angle) * speed, sin(angle) * speed - 0.5f);
             
-            particle->init(pos, vel, 40, 8, "#996633", Particle::ParticleType::DUST);
-            particles.push_back(std::move(particle));
+            emit({pos, vel, 40, 8, ParticlePalette::DUST_BROWN, ParticleType::DUST});
+        }
+    }
+    
+    // The particles and shake a gameplay event calls for
+    void playEvent(const GameplayEvent& event) {
+        if (!Features::EFFECTS) return;
+        using Type = GameplayEvent::Type;
+        Vector2 pos(event.x, event.y);
+        switch (event.type) {
+            case Type::HIT:
+                createHitEffect(pos, false);
+                if (event.dirX != 0 || event.dirY != 0) {
+                    createBloodSplatter(pos, Vector2(event.dirX, event.dirY));
+                }
+                break;
+            case Type::PLAYER_HIT:
+                createBloodSplatter(pos, Vector2(event.dirX, event.dirY));
+                addScreenShake(3);
+                break;
+            case Type::BLOCK:
+            case Type::IMPACT:
+                createHitEffect(pos, false);
+                break;
+            case Type::PARRY:
+                createHitEffect(pos, true);
+                break;
+            case Type::PICKUP:
+                if (event.detail == static_cast<uint8_t>(PowerUpType::HEALTH)) {
+                    createHealEffect(pos);
+                } else if (event.detail == static_cast<uint8_t>(PowerUpType::ENERGY)) {
+                    createEnergyEffect(pos);
+                } else {
+                    createHitEffect(pos, true);
+                }
+                break;
+            case Type::KILL:
+                createExplosion(pos, 0.5f);
+                break;
+            case Type::OBSTACLE_DESTROYED:
+                createExplosion(pos, 0.3f);
+                break;
+            default:
+                break;
         }
     }
     
     void addScreenShake(float intensity) {
+        if (!Features::EFFECTS) return;
         screenShakeIntensity = std::max(screenShakeIntensity, intensity);
         screenShakeDuration = Config::SCREEN_SHAKE_DURATION / 1000.0f;  // Convert ms to seconds
     }
@@ -192,10 +245,45 @@ public:
         return screenShakeOffset;
     }
     
-    const std::vector<std::unique_ptr<Particle>>& getParticles() const {
+    // Shake draws from the simulation's random stream while it runs, so
+    // world saves (systems/rollback_buffer.h) keep it; particles they do not
+    struct ShakeState {
+        float intensity;
+        float duration;
+        float offsetX;
+        float offsetY;
+    };
+    
+    ShakeState getShakeState() const {
+        return {screenShakeIntensity, screenShakeDuration, screenShakeOffset.x, screenShakeOffset.y};
+    }
+    
+    void setShakeState(const ShakeState& state) {
+        screenShakeIntensity = state.intensity;
+        screenShakeDuration = state.duration;
+        screenShakeOffset = Vector2(state.offsetX, state.offsetY);
+    }
+    
+    const ParticleBuffer& getParticles() const {
         return particles;
     }
     
+    // Hard cap on live particles and what happens to spawns beyond it
+    void setMaxParticles(int maxParts) {
+        if (!Features::EFFECTS) return;
+        particles.setCapacity(std::max(0, maxParts));
+    }
+    
+    // Fraction of effect particles spawned, in [0, 1]
+    void setSpawnDensity(float density) { spawnDensity = std::clamp(density, 0.0f, 1.0f); }
+    float getSpawnDensity() const { return spawnDensity; }
+    
+    void setDropPolicy(ParticleBuffer::DropPolicy policy) {
+        particles.setDropPolicy(policy);
+    }
+    
+    void setJobSystem(JobSystem* jobSystem) { jobs = jobSystem; }
+    
     void clear() {
         particles.clear();
         screenShakeIntensity = 0;
@@ -3,6 +3,8 @@
 
 #include "entity.h"
 #include "../config/game_config.h"
+#include "../systems/flow_field.h"
+#include "../memory/object_pool.h"
 #include <cmath>
 
 class Enemy : public Entity {
@@ -24,6 +26,7 @@ public:
     
     AIState aiState;
     Entity* target;
+    const FlowField* flowField;  // Shared, owned by the engine; may be null
     
     Enemy(const Vector2& pos)
         : Entity(EntityType::ENEMY, pos, Config::ENEMY_RADIUS),
@@ -33,13 +36,14 @@ public:
           stunned(false),
           stunDuration(0),
           aiState(AIState::IDLE),
-          target(nullptr) {
+          target(nullptr),
+          flowField(nullptr) {
         health = Config::ENEMY_HEALTH;
         maxHealth = Config::ENEMY_HEALTH;
     }
     
-    void update(float deltaTime) override {
-        Entity::update(deltaTime);
+    void updateLogic(float deltaTime) override {
+        Entity::updateLogic(deltaTime);
         
         // Update stun
         if (stunned) {
@@ -79,7 +83,7 @@ public:
             case AIState::CHASING:
                 // Move towards target
                 if (distanceToTarget > Config::WOLF_ATTACK_RADIUS) {
-                    Vector2 direction = (target->position - position).normalized();
+                    Vector2 direction = seekDirection();
                     velocity = direction * speed;
                     // Update rotation to face target
                     rotation = atan2(direction.y, direction.x);
@@ -123,6 +127,18 @@ public:
         }
     }
     
+    void setFlowField(const FlowField* field) { flowField = field; }
+    
+    // Heading toward the target: along the flow field when it leads there,
+    // otherwise straight at it
+    Vector2 seekDirection() const {
+        Vector2 direction;
+        if (flowField && flowField->steer(position, target->position, direction)) {
+            return direction;
+        }
+        return (target->position - position).normalized();
+    }
+    
     void stun(float duration) {
         stunned = true;
         stunDuration = duration;
@@ -133,6 +149,14 @@ public:
     bool canAttack() const {
         return !stunned && attackCooldown <= 0;
     }
+    
+    // Per-thread slab pool; see memory/object_pool.h
+    static ObjectPool<Enemy>& pool() {
+        static thread_local ObjectPool<Enemy> instance(Config::ENEMY_POOL_SIZE);
+        return instance;
+    }
+    static void* operator new(size_t size) { return poolAllocate(pool(), size); }
+    static void operator delete(void* memory, size_t size) { poolDeallocate(pool(), memory, size); }
 };
 
 #endif // ENEMY_H
\ No newline at end of file
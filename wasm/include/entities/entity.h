@@ -2,18 +2,11 @@
 #define ENTITY_H
 
 #include "../math/vector2.h"
+#include "../config/game_config.h"
+#include "entity_type.h"
+#include "../systems/collision_layers.h"
 #include <algorithm>
-
-// Entity types in the game
-enum class EntityType {
-    PLAYER,
-    ENEMY,
-    WOLF,
-    PROJECTILE,
-    POWERUP,
-    OBSTACLE,
-    PARTICLE
-};
+#include <cmath>
 
 // Power-up types
 enum class PowerUpType {
@@ -32,6 +25,7 @@ public:
     int id;
     EntityType type;
     Vector2 position;
+    Vector2 previousPosition;  // Position at the start of the last fixed step
     Vector2 velocity;
     float rotation;  // Rotation angle in radians
     float radius;
@@ -40,17 +34,41 @@ public:
     bool active;
     bool invulnerable;
     float invulnerabilityTimer;
+    // This entity's collision layer bit and the layers it responds to
+    // (systems/collision_layers.h); both default from the type
+    uint16_t collisionLayer;
+    uint16_t collisionMask;
     
     Entity(EntityType type, const Vector2& pos, float radius)
-        : id(nextId++), type(type), position(pos), velocity(0, 0),
+        : id(nextId++), type(type), position(pos), previousPosition(pos), velocity(0, 0),
           rotation(0), radius(radius), health(100), maxHealth(100), active(true),
-          invulnerable(false), invulnerabilityTimer(0) {}
+          invulnerable(false), invulnerabilityTimer(0),
+          collisionLayer(CollisionLayers::layerOf(type)),
+          collisionMask(CollisionLayers::maskOf(type)) {}
     
     virtual ~Entity() = default;
     
+    // Full per-frame update: movement integration followed by game logic.
+    // Callers that integrate positions in bulk (EntityStore) run
+    // updateLogic() on its own afterwards.
     virtual void update(float deltaTime) {
-        position += velocity * (deltaTime / 16.0f);
-        
+        if (isMoverType(type)) {
+            integrate(deltaTime);
+        }
+        updateLogic(deltaTime);
+    }
+    
+    // Renderers interpolate from previousPosition to position
+    void storePreviousTransform() {
+        previousPosition = position;
+    }
+    
+    void integrate(float deltaTime) {
+        position += velocity * (deltaTime * Config::REFERENCE_FRAME_RATE);
+    }
+    
+    // Timers, AI and other per-type behaviour; subclasses extend this
+    virtual void updateLogic(float deltaTime) {
         if (invulnerabilityTimer > 0) {
             invulnerabilityTimer -= deltaTime;
             if (invulnerabilityTimer <= 0) {
@@ -59,10 +77,58 @@ public:
         }
     }
     
+    // Overlap now, or at any point of the last step when either side moved
+    // fast enough to pass through the other between two discrete tests
     bool collidesWith(const Entity& other) const {
         if (!active || !other.active) return false;
         float distance = position.distanceTo(other.position);
-        return distance < (radius + other.radius);
+        if (distance < (radius + other.radius)) return true;
+        return (movedFast() || other.movedFast()) && sweptContactTime(other) >= 0;
+    }
+    
+    Vector2 stepMotion() const { return position - previousPosition; }
+    
+    bool movedFast() const {
+        float limit = radius * Config::SWEPT_MIN_TRAVEL;
+        return stepMotion().magnitudeSquared() > limit * limit;
+    }
+    
+    // Earliest fraction of the last step (0..1) at which the two circles,
+    // each moving linearly from previousPosition to position, touched; -1
+    // if they never did. Solved in the frame of other, so both may move.
+    float sweptContactTime(const Entity& other) const {
+        Vector2 start = previousPosition - other.previousPosition;
+        Vector2 motion = stepMotion() - other.stepMotion();
+        float reach = radius + other.radius;
+        
+        float c = start.magnitudeSquared() - reach * reach;
+        if (c < 0) return 0;                    // Already touching at the start
+        float a = motion.magnitudeSquared();
+        float b = start.dot(motion);
+        if (a <= 0 || b >= 0) return -1;        // Not approaching
+        float discriminant = b * b - a * c;
+        if (discriminant < 0) return -1;
+        float t = (-b - std::sqrt(discriminant)) / a;
+        return t <= 1.0f ? t : -1;
+    }
+    
+    // Bounds covering the whole last step, for the broadphase
+    void sweptBounds(float& minX, float& minY, float& maxX, float& maxY) const {
+        minX = std::min(position.x, previousPosition.x) - radius;
+        minY = std::min(position.y, previousPosition.y) - radius;
+        maxX = std::max(position.x, previousPosition.x) + radius;
+        maxY = std::max(position.y, previousPosition.y) + radius;
+    }
+    
+    // Back to the type's layer and mask (subclasses that change type call this)
+    void resetCollisionFilter() {
+        collisionLayer = CollisionLayers::layerOf(type);
+        collisionMask = CollisionLayers::maskOf(type);
+    }
+    
+    // Whether a response exists for this pair; both sides must accept the other
+    bool collidesWithLayer(const Entity& other) const {
+        return (collisionMask & other.collisionLayer) != 0 && (other.collisionMask & collisionLayer) != 0;
     }
     
     float distanceTo(const Entity& other) const {
@@ -83,8 +149,21 @@ public:
         health = std::min(health + amount, maxHealth);
     }
     
+    // Types kept in the engine's static layer: never moved, updated or
+    // broadphased, only re-indexed when the set changes
+    static bool isStaticType(EntityType type) {
+        return type == EntityType::OBSTACLE;
+    }
+    
+    // Types whose position is advanced by velocity every frame
+    static bool isMoverType(EntityType type) {
+        return type == EntityType::PLAYER || type == EntityType::ENEMY ||
+               type == EntityType::WOLF || type == EntityType::PROJECTILE;
+    }
+    
 protected:
-    static int nextId;
+    // Provisional ids until an owner assigns a handle; per thread, like the pools
+    static thread_local int nextId;
 };
 
 #endif // ENTITY_H
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef ENTITY_COUNTS_H
+#define ENTITY_COUNTS_H
+
+#include "entity.h"
+
+// Entities per type, kept by the owner of an entity list as it adopts and
+// removes them, so census questions (is the wave cleared, is the power-up cap
+// reached) cost O(1) instead of a scan. An entity counts until it is removed:
+// one that died this tick is still counted until the end-of-tick cleanup.
+class EntityCounts {
+public:
+    static constexpr int TYPE_COUNT = static_cast<int>(EntityType::PARTICLE) + 1;
+
+private:
+    int counts[TYPE_COUNT];
+    int total;
+
+public:
+    EntityCounts() { clear(); }
+
+    void clear() {
+        for (int& count : counts) count = 0;
+        total = 0;
+    }
+
+    void add(EntityType type) {
+        counts[static_cast<int>(type)]++;
+        total++;
+    }
+
+    void remove(EntityType type) {
+        counts[static_cast<int>(type)]--;
+        total--;
+    }
+
+    int of(EntityType type) const { return counts[static_cast<int>(type)]; }
+    int hostiles() const { return of(EntityType::ENEMY) + of(EntityType::WOLF); }
+    int getTotal() const { return total; }
+};
+
+#endif // ENTITY_COUNTS_H
@@ -0,0 +1,151 @@
+#ifndef ENTITY_STORE_H
+#define ENTITY_STORE_H
+
+#include "entity.h"
+#include "../math/vector_math.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+// Structure-of-arrays mirror of the engine's entity list
+//
+// gather() copies the hot fields of every active entity into contiguous
+// per-field arrays, grouped by EntityType so each type occupies one index
+// range. Bulk passes (integration, bounds, broadphase) walk these arrays
+// linearly; the Entity objects stay the handles gameplay code works with.
+// Positions integrated here are written back with scatter(), and refresh()
+// re-reads the mutable fields after gameplay code has touched the handles.
+class EntityStore {
+public:
+    static constexpr int TYPE_COUNT = static_cast<int>(EntityType::PARTICLE) + 1;
+
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> px;   // previousPosition, for swept collision bounds
+    std::vector<float> py;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<float> radius;
+    std::vector<float> health;
+    std::vector<uint8_t> type;
+    std::vector<uint8_t> active;
+    std::vector<Entity*> handles;
+
+    EntityStore() {
+        for (int i = 0; i <= TYPE_COUNT; i++) groupStart[i] = 0;
+    }
+
+    void gather(const std::vector<std::unique_ptr<Entity>>& entities) {
+        gather(entities, entities.size());
+    }
+    
+    // Gather only entities[0, count), e.g. the engine's dynamic range
+    void gather(const std::vector<std::unique_ptr<Entity>>& entities, size_t count) {
+        // Count active entities per type
+        size_t counts[TYPE_COUNT] = {};
+        for (size_t e = 0; e < count; e++) {
+            const Entity* entity = entities[e].get();
+            if (entity && entity->active) {
+                counts[static_cast<int>(entity->type)]++;
+            }
+        }
+
+        groupStart[0] = 0;
+        for (int t = 0; t < TYPE_COUNT; t++) {
+            groupStart[t + 1] = groupStart[t] + counts[t];
+        }
+        resize(groupStart[TYPE_COUNT]);
+
+        // Place each entity in its type's range, keeping list order
+        size_t cursor[TYPE_COUNT];
+        for (int t = 0; t < TYPE_COUNT; t++) cursor[t] = groupStart[t];
+
+        for (size_t e = 0; e < count; e++) {
+            Entity* entity = entities[e].get();
+            if (!entity || !entity->active) continue;
+            int t = static_cast<int>(entity->type);
+            size_t i = cursor[t]++;
+            handles[i] = entity;
+            type[i] = static_cast<uint8_t>(t);
+            radius[i] = entity->radius;
+            load(i);
+        }
+    }
+
+    // Re-read mutable fields from the handles without regrouping
+    void refresh() {
+        for (size_t i = 0; i < handles.size(); i++) {
+            load(i);
+        }
+    }
+
+    // Advance every mover by its velocity. Movers are the leading type
+    // groups (PLAYER..PROJECTILE), so this is one contiguous range.
+    void integrate(float deltaTime) {
+        integrate(0, moverCount(), deltaTime);
+    }
+    
+    // Integrate a slice of the mover range, for callers that split the work
+    void integrate(size_t begin, size_t end, float deltaTime) {
+        VectorMath::integrate(x.data() + begin, y.data() + begin,
+                              vx.data() + begin, vy.data() + begin,
+                              end - begin, deltaTime * Config::REFERENCE_FRAME_RATE);
+    }
+
+    // Write integrated positions back to the mover handles
+    void scatter() const {
+        size_t end = moverCount();
+        for (size_t i = 0; i < end; i++) {
+            handles[i]->position.x = x[i];
+            handles[i]->position.y = y[i];
+        }
+    }
+    
+    // Also write velocities back, for passes that change them (damping)
+    void scatterVelocities() const {
+        size_t end = moverCount();
+        for (size_t i = 0; i < end; i++) {
+            handles[i]->velocity.x = vx[i];
+            handles[i]->velocity.y = vy[i];
+        }
+    }
+    
+    size_t moverCount() const { return groupEnd(EntityType::PROJECTILE); }
+
+    size_t size() const { return handles.size(); }
+    size_t groupBegin(EntityType t) const { return groupStart[static_cast<int>(t)]; }
+    size_t groupEnd(EntityType t) const { return groupStart[static_cast<int>(t) + 1]; }
+    size_t groupSize(EntityType t) const { return groupEnd(t) - groupBegin(t); }
+
+private:
+    size_t groupStart[TYPE_COUNT + 1];
+
+    void resize(size_t count) {
+        x.resize(count);
+        y.resize(count);
+        px.resize(count);
+        py.resize(count);
+        vx.resize(count);
+        vy.resize(count);
+        radius.resize(count);
+        health.resize(count);
+        type.resize(count);
+        active.resize(count);
+        handles.resize(count);
+    }
+
+    void load(size_t i) {
+        const Entity* entity = handles[i];
+        x[i] = entity->position.x;
+        y[i] = entity->position.y;
+        px[i] = entity->previousPosition.x;
+        py[i] = entity->previousPosition.y;
+        vx[i] = entity->velocity.x;
+        vy[i] = entity->velocity.y;
+        health[i] = entity->health;
+        active[i] = entity->active ? 1 : 0;
+    }
+};
+
+#endif // ENTITY_STORE_H
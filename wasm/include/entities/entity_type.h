@@ -0,0 +1,15 @@
+#ifndef ENTITY_TYPE_H
+#define ENTITY_TYPE_H
+
+// Entity types in the game
+enum class EntityType {
+    PLAYER,
+    ENEMY,
+    WOLF,
+    PROJECTILE,
+    POWERUP,
+    OBSTACLE,
+    PARTICLE
+};
+
+#endif // ENTITY_TYPE_H
@@ -4,6 +4,7 @@
 #include "entity.h"
 #include "../config/game_config.h"
 #include <algorithm>
+#include <cmath>
 
 enum class ObstacleShape {
     CIRCLE,
@@ -11,6 +12,17 @@ enum class ObstacleShape {
     RECTANGLE
 };
 
+// Static obstacle: a circle, or a square or rectangle rotated about its
+// centre
+//
+// Collision treats every obstacle as a rounded box in its local frame: a
+// box of halfWidth x halfHeight with corners rounded by cornerRadius, which
+// is the radius for circles (a zero-size box) and 0 for boxes. The frame
+// (axes, half sizes, the tight world AABB) is cached and recomputed by
+// syncFrame() only when rotation, width, height or shape changed, so tests
+// never call sin/cos. Refreshing the frame of a box also rewrites radius to
+// its centre-to-corner distance, so radius stays the bounding circle of the
+// shape for the broadphase and the circle-only paths.
 class Obstacle : public Entity {
 public:
     bool destructible;
@@ -20,6 +32,48 @@ public:
     float height; // For rectangles
     float rotation; // For rotated rectangles
     
+    // Cached frame; local x runs along (cosR, sinR), local y along (-sinR, cosR)
+    float cosR;
+    float sinR;
+    float halfWidth;
+    float halfHeight;
+    float cornerRadius;
+    float extentX;    // Half size of the world-space AABB
+    float extentY;
+    
+private:
+    float frameRotation;
+    float frameWidth;
+    float frameHeight;
+    ObstacleShape frameShape;
+    
+    // Side effect: for a box, Entity::radius is overwritten with the
+    // corner distance (a circle keeps the radius it was given)
+    void refreshFrame() {
+        frameRotation = rotation;
+        frameWidth = width;
+        frameHeight = height;
+        frameShape = shape;
+        if (shape == ObstacleShape::CIRCLE) {
+            cosR = 1;
+            sinR = 0;
+            halfWidth = halfHeight = 0;
+            cornerRadius = radius;
+            extentX = extentY = radius;
+            return;
+        }
+        cosR = std::cos(rotation);
+        sinR = std::sin(rotation);
+        halfWidth = width * 0.5f;
+        halfHeight = height * 0.5f;
+        cornerRadius = 0;
+        extentX = std::abs(cosR) * halfWidth + std::abs(sinR) * halfHeight;
+        extentY = std::abs(sinR) * halfWidth + std::abs(cosR) * halfHeight;
+        radius = std::sqrt(halfWidth * halfWidth + halfHeight * halfHeight);
+    }
+    
+public:
+    
     // Constructor for circular obstacles (backwards compatibility)
     Obstacle(const Vector2& pos, float rad, bool canDestroy = false)
         : Entity(EntityType::OBSTACLE, pos, rad),
@@ -31,11 +85,12 @@ public:
           rotation(0) {
         health = destructible ? 100 : 999999;
         maxHealth = health;
+        refreshFrame();
     }
     
     // Constructor for shaped obstacles
     Obstacle(const Vector2& pos, ObstacleShape obstacleShape, float w, float h, float rot = 0, bool canDestroy = false)
-        : Entity(EntityType::OBSTACLE, pos, std::max(w, h) / 2), // Use half of max dimension as radius for collision
+        : Entity(EntityType::OBSTACLE, pos, std::max(w, h) / 2), // Boxes get their corner distance in refreshFrame()
           destructible(canDestroy),
           durability(100),
           shape(obstacleShape),
@@ -49,9 +104,22 @@ public:
         if (shape == ObstacleShape::SQUARE) {
             height = width;
         }
+        refreshFrame();
+    }
+    
+    // Recompute the cached frame if the shape was changed in place
+    void syncFrame() {
+        if (rotation != frameRotation || width != frameWidth || height != frameHeight || shape != frameShape) {
+            refreshFrame();
+        }
+    }
+    
+    void setRotation(float newRotation) {
+        rotation = newRotation;
+        syncFrame();
     }
     
-    void update(float deltaTime) override {
+    void updateLogic(float deltaTime) override {
         // Obstacles don't move
         velocity = Vector2(0, 0);
         
@@ -68,29 +136,101 @@ public:
     
     // Check if a point is inside this obstacle (for more accurate collision)
     bool containsPoint(const Vector2& point) const {
+        float dx = point.x - position.x;
+        float dy = point.y - position.y;
         if (shape == ObstacleShape::CIRCLE) {
-            return (point - position).magnitude() <= radius;
+            return dx * dx + dy * dy <= radius * radius;
+        }
+        float lx = dx * cosR + dy * sinR;
+        float ly = dy * cosR - dx * sinR;
+        return std::abs(lx) <= halfWidth && std::abs(ly) <= halfHeight;
+    }
+    
+    // Whether a circle overlaps the obstacle (same test as
+    // VectorMath::circleBoxOverlap)
+    bool overlapsCircle(const Vector2& center, float circleRadius) const {
+        float dx = center.x - position.x;
+        float dy = center.y - position.y;
+        float lx = dx * cosR + dy * sinR;
+        float ly = dy * cosR - dx * sinR;
+        float ex = lx - std::min(std::max(lx, -halfWidth), halfWidth);
+        float ey = ly - std::min(std::max(ly, -halfHeight), halfHeight);
+        float reach = circleRadius + cornerRadius;
+        return ex * ex + ey * ey < reach * reach;
+    }
+    
+    // Push-out for a circle: sets the unit world normal pointing away from
+    // the obstacle and returns how far the circle must move along it to
+    // stop touching (<= 0 when it does not touch). A centre inside the box
+    // leaves through the nearest face.
+    float penetration(const Vector2& center, float circleRadius, Vector2& normal) const {
+        float dx = center.x - position.x;
+        float dy = center.y - position.y;
+        float lx = dx * cosR + dy * sinR;
+        float ly = dy * cosR - dx * sinR;
+        float ex = lx - std::min(std::max(lx, -halfWidth), halfWidth);
+        float ey = ly - std::min(std::max(ly, -halfHeight), halfHeight);
+        float reach = circleRadius + cornerRadius;
+        float distSq = ex * ex + ey * ey;
+        
+        float nx, ny, depth;
+        if (distSq > 0) {
+            float dist = std::sqrt(distSq);
+            nx = ex / dist;
+            ny = ey / dist;
+            depth = reach - dist;
         } else {
-            // For rectangles and squares, check with rotation
-            Vector2 localPoint = point - position;
-            
-            // Rotate point to obstacle's local space
-            if (rotation != 0) {
-                float cos_r = cos(-rotation);
-                float sin_r = sin(-rotation);
-                float local_x = localPoint.x * cos_r - localPoint.y * sin_r;
-                float local_y = localPoint.x * sin_r + localPoint.y * cos_r;
-                localPoint.x = local_x;
-                localPoint.y = local_y;
+            float faceX = halfWidth - std::abs(lx);
+            float faceY = halfHeight - std::abs(ly);
+            if (faceX <= faceY) {
+                nx = lx < 0 ? -1.0f : 1.0f;
+                ny = 0;
+                depth = faceX + reach;
+            } else {
+                nx = 0;
+                ny = ly < 0 ? -1.0f : 1.0f;
+                depth = faceY + reach;
             }
-            
-            // Check if point is within rectangle bounds
-            return std::abs(localPoint.x) <= width / 2 && std::abs(localPoint.y) <= height / 2;
         }
+        normal = Vector2(nx * cosR - ny * sinR, nx * sinR + ny * cosR);
+        return depth;
+    }
+    
+    // Earliest fraction of mover's last step (0..1) at which it touched the
+    // obstacle, or -1. Circles are solved exactly; boxes as the box grown by
+    // the mover's radius, which is slightly generous at the corners.
+    float sweptContactTime(const Entity& mover) const {
+        if (shape == ObstacleShape::CIRCLE) return mover.sweptContactTime(*this);
+        
+        float dx = mover.previousPosition.x - position.x;
+        float dy = mover.previousPosition.y - position.y;
+        Vector2 motion = mover.stepMotion();
+        float ox = dx * cosR + dy * sinR;
+        float oy = dy * cosR - dx * sinR;
+        float mx = motion.x * cosR + motion.y * sinR;
+        float my = motion.y * cosR - motion.x * sinR;
+        
+        float tEnter = 0, tExit = 1;
+        if (!slab(ox, mx, halfWidth + mover.radius, tEnter, tExit) ||
+            !slab(oy, my, halfHeight + mover.radius, tEnter, tExit)) {
+            return -1;
+        }
+        return tEnter;
     }
     
     // Get the shape type (for rendering)
     int getShapeType() const { return static_cast<int>(shape); }
+    
+private:
+    static bool slab(float origin, float delta, float half, float& tEnter, float& tExit) {
+        if (delta == 0) return origin >= -half && origin <= half;
+        float a = (-half - origin) / delta;
+        float b = (half - origin) / delta;
+        if (a > b) std::swap(a, b);
+        tEnter = std::max(tEnter, a);
+        tExit = std::min(tExit, b);
+        return tEnter <= tExit;
+    }
 };
 
 #endif // OBSTACLE_H
\ No newline at end of file
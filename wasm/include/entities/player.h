@@ -3,7 +3,7 @@
 
 #include "entity.h"
 #include "../config/game_config.h"
-#include <emscripten/emscripten.h>
+#include "../utils/sim_context.h"
 
 class Player : public Entity {
 public:
@@ -64,8 +64,8 @@ public:
         maxHealth = Config::PLAYER_MAX_HEALTH;
     }
     
-    void update(float deltaTime) override {
-        Entity::update(deltaTime);
+    void updateLogic(float deltaTime) override {
+        Entity::updateLogic(deltaTime);
         
         // Update boost
         if (boosting) {
@@ -81,7 +81,7 @@ public:
         // Update block
         if (blocking) {
             blockDuration -= deltaTime;
-            perfectParryWindow = (emscripten_get_now() - blockStartTime) <= Config::PERFECT_PARRY_WINDOW;
+            perfectParryWindow = (Sim::now() - blockStartTime) <= Config::PERFECT_PARRY_WINDOW;
             
             if (blockDuration <= 0) {
                 endBlock();
@@ -110,7 +110,7 @@ public:
                 rollCooldown = Config::ROLL_COOLDOWN / 1000.0f;  // Convert ms to seconds
             } else {
                 // Move in roll direction
-                position += rollDirection * Config::ROLL_SPEED_MULTIPLIER * (deltaTime / 16.0f);
+                position += rollDirection * Config::ROLL_SPEED_MULTIPLIER * (deltaTime * Config::REFERENCE_FRAME_RATE);
             }
         } else if (rollCooldown > 0) {
             rollCooldown -= deltaTime;
@@ -140,7 +140,22 @@ public:
         
         // Regenerate energy
         if (energy < maxEnergy && !boosting && !rolling) {
-            energy = std::min(energy + 0.1f * (deltaTime / 16.0f), maxEnergy);
+            energy = std::min(energy + 0.1f * (deltaTime * Config::REFERENCE_FRAME_RATE), maxEnergy);
+        }
+    }
+    
+    // A lethal hit costs a life and restores full health; losing the last
+    // one takes the player out of the game
+    void takeDamage(float damage) override {
+        if (invulnerable || !active) return;
+        health -= damage;
+        if (health > 0) return;
+        lives--;
+        if (lives > 0) {
+            health = maxHealth;
+        } else {
+            health = 0;
+            active = false;
         }
     }
     
@@ -156,7 +171,7 @@ public:
         if (!blocking && blockCooldown <= 0 && !rolling) {
             blocking = true;
             blockDuration = Config::SHIELD_DURATION / 1000.0f;  // Convert ms to seconds
-            blockStartTime = emscripten_get_now();
+            blockStartTime = Sim::now();
             perfectParryWindow = true;
         }
     }
@@ -167,13 +182,15 @@ public:
         blockCooldown = Config::SHIELD_COOLDOWN / 1000.0f;  // Convert ms to seconds
     }
     
-    void startAttack(float angle) {
-        if (!attacking && attackCooldown <= 0 && energy >= Config::SWORD_ENERGY_COST) {
-            attacking = true;
-            attackAngle = angle;
-            attackCooldown = Config::SWORD_ANIMATION_TIME / 1000.0f;  // Convert ms to seconds
-            energy -= Config::SWORD_ENERGY_COST;
-        }
+    // Whether a swing started; not while one is under way, cooling down or
+    // short of energy
+    bool startAttack(float angle) {
+        if (attacking || attackCooldown > 0 || energy < Config::SWORD_ENERGY_COST) return false;
+        attacking = true;
+        attackAngle = angle;
+        attackCooldown = Config::SWORD_ANIMATION_TIME / 1000.0f;  // Convert ms to seconds
+        energy -= Config::SWORD_ENERGY_COST;
+        return true;
     }
     
     void startRoll(const Vector2& direction) {
@@ -14,14 +14,14 @@ public:
     PowerUp(const Vector2& pos, PowerUpType type)
         : Entity(EntityType::POWERUP, pos, Config::POWERUP_RADIUS),
           powerType(type),
-          lifetime(30000), // 30 seconds before despawn
+          lifetime(30.0f), // Seconds before despawn
           bobOffset(0),
           bobSpeed(2.0f) {
     }
     
-    void update(float deltaTime) override {
+    void updateLogic(float deltaTime) override {
         // Bobbing animation
-        bobOffset += bobSpeed * (deltaTime / 1000.0f);
+        bobOffset += bobSpeed * deltaTime;
         
         // Update lifetime
         lifetime -= deltaTime;
@@ -3,6 +3,7 @@
 
 #include "entity.h"
 #include "../config/game_config.h"
+#include "../memory/object_pool.h"
 #include <cmath>
 
 class Projectile : public Entity {
@@ -24,8 +25,8 @@ public:
         rotation = atan2(direction.y, direction.x);
     }
     
-    void update(float deltaTime) override {
-        Entity::update(deltaTime);
+    void updateLogic(float deltaTime) override {
+        Entity::updateLogic(deltaTime);
         
         lifetime -= deltaTime;
         if (lifetime <= 0) {
@@ -36,6 +37,14 @@ public:
     bool isExpired() const {
         return lifetime <= 0;
     }
+    
+    // Per-thread slab pool; see memory/object_pool.h
+    static ObjectPool<Projectile>& pool() {
+        static thread_local ObjectPool<Projectile> instance(Config::PROJECTILE_POOL_SIZE);
+        return instance;
+    }
+    static void* operator new(size_t size) { return poolAllocate(pool(), size); }
+    static void operator delete(void* memory, size_t size) { poolDeallocate(pool(), memory, size); }
 };
 
 #endif // PROJECTILE_H
\ No newline at end of file
@@ -3,11 +3,19 @@
 
 #include "enemy.h"
 #include "../config/game_config.h"
+#include "../systems/stimulus_buffer.h"
+#include "../utils/frame_tracer.h"
+#include "../utils/sim_context.h"
 #include <cstdlib>
 #include <vector>
 
 class Wolf : public Enemy {
 public:
+    // Per wolf, so a world save holds them (they used to be function statics
+    // shared by every wolf)
+    static constexpr float LUNGE_DURATION = 0.3f;     // Seconds
+    static constexpr float RECOVERY_DURATION = 0.5f;  // Seconds
+    
     // Wolf-specific states
     enum class WolfState {
         PATROLLING,
@@ -23,12 +31,18 @@ public:
     float lungeCooldown;
     float lungeSpeed;
     bool isAlpha;
-    std::vector<Wolf*> packMembers;
+    // Place in the pack formed at spawn and its size at the time; packHunt
+    // only needs these, and unlike member pointers they cannot dangle
+    int packIndex;
+    int packSize;
     
     // Advanced behaviors
     float howlCooldown;
     float packCoordinationTimer;
     Vector2 circlePosition; // For pack circling behavior
+    float lungeTimer;       // Left of the current lunge (s)
+    float recoveryTimer;    // Left of the recovery after it (s)
+    const StimulusBuffer* stimuli;  // Shared, owned by the engine; may be null
     
     Wolf(const Vector2& pos, bool alpha = false)
         : Enemy(pos),
@@ -36,10 +50,16 @@ public:
           lungeCooldown(0),
           lungeSpeed(Config::WOLF_LUNGE_SPEED),
           isAlpha(alpha),
+          packIndex(0),
+          packSize(0),
           howlCooldown(0),
-          packCoordinationTimer(0) {
+          packCoordinationTimer(0),
+          lungeTimer(LUNGE_DURATION),
+          recoveryTimer(RECOVERY_DURATION),
+          stimuli(nullptr) {
         
         type = EntityType::WOLF;
+        resetCollisionFilter();
         radius = Config::WOLF_RADIUS;
         health = Config::WOLF_HEALTH;
         maxHealth = Config::WOLF_HEALTH;
@@ -56,8 +76,8 @@ public:
         generatePatrolTarget();
     }
     
-    void update(float deltaTime) override {
-        Enemy::update(deltaTime);
+    void updateLogic(float deltaTime) override {
+        Enemy::updateLogic(deltaTime);
         
         if (stunned) return;
         
@@ -75,6 +95,7 @@ public:
         }
         
         // Update wolf AI
+        TRACE_ZONE("wolf.ai");
         updateWolfAI(deltaTime);
     }
     
@@ -116,7 +137,7 @@ public:
                 
             case WolfState::HOWLING:
                 // Animation state, wait for howl to complete
-                if (howlCooldown <= 8000) { // Howl lasts 2 seconds
+                if (howlCooldown <= 8.0f) { // Howl lasts 2 seconds
                     wolfState = WolfState::STALKING;
                 }
                 break;
@@ -127,7 +148,16 @@ public:
         }
     }
     
+    void setStimuli(const StimulusBuffer* buffer) { stimuli = buffer; }
+    
     void patrol(float deltaTime) {
+        // A noise in earshot replaces the wander point
+        if (stimuli) {
+            if (const Stimulus* heard = stimuli->loudestAt(position.x, position.y, id)) {
+                patrolTarget = Vector2(heard->x, heard->y);
+            }
+        }
+        
         // Move towards patrol target
         Vector2 toPatrol = patrolTarget - position;
         if (toPatrol.magnitude() < 10) {
@@ -146,14 +176,14 @@ public:
         
         if (distance > Config::WOLF_ATTACK_RADIUS * 2) {
             // Move closer
-            velocity = toTarget.normalized() * speed;
+            velocity = seekDirection() * speed;
         } else {
             // Circle around
             Vector2 perpendicular(-toTarget.y, toTarget.x);
             perpendicular = perpendicular.normalized();
             
             // Randomly change circling direction
-            if (rand() % 100 < 2) {
+            if (Sim::randomInt(100) < 2) {
                 perpendicular = perpendicular * -1;
             }
             
@@ -167,58 +197,48 @@ public:
         wolfState = WolfState::LUNGING;
         Vector2 toTarget = (target->position - position).normalized();
         velocity = toTarget * lungeSpeed;
-        lungeCooldown = 2000; // 2 second cooldown
+        lungeCooldown = 2.0f; // Seconds
     }
     
     void performLunge(float deltaTime) {
         // Lunge continues for a short duration
-        static float lungeDuration = 300; // 300ms lunge
-        lungeDuration -= deltaTime;
+        lungeTimer -= deltaTime;
         
-        if (lungeDuration <= 0) {
+        if (lungeTimer <= 0) {
             wolfState = WolfState::RECOVERING;
-            lungeDuration = 300; // Reset for next lunge
+            lungeTimer = LUNGE_DURATION; // Reset for next lunge
             velocity = velocity * 0.2f; // Slow down after lunge
         }
     }
     
     void recover(float deltaTime) {
-        static float recoveryTime = 500; // 500ms recovery
-        recoveryTime -= deltaTime;
+        recoveryTimer -= deltaTime;
         
         velocity = velocity * 0.9f; // Gradual slowdown
         
-        if (recoveryTime <= 0) {
+        if (recoveryTimer <= 0) {
             wolfState = WolfState::STALKING;
-            recoveryTime = 500; // Reset for next recovery
+            recoveryTimer = RECOVERY_DURATION; // Reset for next recovery
         }
     }
     
     void howl() {
         wolfState = WolfState::HOWLING;
-        howlCooldown = 10000; // 10 second cooldown
+        howlCooldown = 10.0f; // Seconds
         
         // Alert nearby wolves
         // This would be handled by the game engine to call other wolves
     }
     
     void packHunt(float deltaTime) {
-        if (!target || packMembers.empty()) {
+        if (!target || packSize == 0) {
             wolfState = WolfState::STALKING;
             return;
         }
         
-        // Coordinate with pack members to surround target
-        int packIndex = 0;
-        for (int i = 0; i < packMembers.size(); i++) {
-            if (packMembers[i] == this) {
-                packIndex = i;
-                break;
-            }
-        }
-        
-        // Position in a circle around target
-        float angle = (2 * M_PI * packIndex) / packMembers.size();
+        // Coordinate with pack members to surround target: position in a
+        // circle around it
+        float angle = (2 * M_PI * packIndex) / packSize;
         float circleRadius = Config::WOLF_ATTACK_RADIUS * 2;
         
         Vector2 idealPosition = target->position + 
@@ -231,24 +251,42 @@ public:
             // In position, prepare to attack
             if (packCoordinationTimer <= 0) {
                 startLunge();
-                packCoordinationTimer = 1000; // Coordinate attacks every second
+                packCoordinationTimer = 1.0f; // Coordinate attacks every second
             }
         }
     }
     
-    void joinPack(std::vector<Wolf*>& pack) {
-        packMembers = pack;
-        if (!packMembers.empty()) {
+    template<typename Container>
+    void joinPack(const Container& pack) {
+        packIndex = 0;
+        packSize = static_cast<int>(pack.size());
+        int i = 0;
+        for (const Wolf* member : pack) {
+            if (member == this) {
+                packIndex = i;
+                break;
+            }
+            i++;
+        }
+        if (packSize > 0) {
             wolfState = WolfState::PACK_HUNTING;
         }
     }
     
     void generatePatrolTarget() {
         // Generate a random patrol point within a reasonable distance
-        float angle = (rand() % 360) * M_PI / 180.0f;
-        float distance = 100 + (rand() % 200);
+        float angle = Sim::randomInt(360) * M_PI / 180.0f;
+        float distance = 100 + Sim::randomInt(200);
         patrolTarget = position + Vector2(cos(angle) * distance, sin(angle) * distance);
     }
+    
+    // Per-thread slab pool; see memory/object_pool.h
+    static ObjectPool<Wolf>& pool() {
+        static thread_local ObjectPool<Wolf> instance(Config::WOLF_POOL_SIZE);
+        return instance;
+    }
+    static void* operator new(size_t size) { return poolAllocate(pool(), size); }
+    static void operator delete(void* memory, size_t size) { poolDeallocate(pool(), memory, size); }
 };
 
 #endif // WOLF_H
\ No newline at end of file
@@ -1,13 +1,15 @@
 #ifndef GAME_ENGINE_H
 #define GAME_ENGINE_H
 
-#include <emscripten/emscripten.h>
-#include <emscripten/bind.h>
+#ifdef __EMSCRIPTEN__
+#include <emscripten/val.h>
+#endif
 #include <vector>
 #include <memory>
 #include <algorithm>
 
 #include "config/game_config.h"
+#include "config/engine_features.h"
 #include "math/vector2.h"
 #include "entities/entity.h"
 #include "entities/player.h"
@@ -16,9 +18,32 @@
 #include "entities/projectile.h"
 #include "entities/powerup.h"
 #include "entities/obstacle.h"
+#include "entities/entity_store.h"
+#include "entities/entity_counts.h"
 #include "effects/visual_effects.h"
 #include "systems/collision_system.h"
 #include "systems/wave_system.h"
+#include "systems/snapshot_system.h"
+#include "systems/state_codec.h"
+#include "systems/job_system.h"
+#include "systems/obstacle_index.h"
+#include "systems/flow_field.h"
+#include "systems/stimulus_buffer.h"
+#include "systems/input_log.h"
+#include "systems/command_buffer.h"
+#include "systems/gameplay_events.h"
+#include "systems/camera.h"
+#include "systems/targeting_system.h"
+#include "systems/chunk_manager.h"
+#include "systems/obstacle_generator.h"
+#include "systems/rollback_buffer.h"
+#include "systems/quality_governor.h"
+#include "utils/render_buffer.h"
+#include "utils/handle_table.h"
+#include "utils/frame_tracer.h"
+#include "utils/sim_context.h"
+#include "memory/frame_arena.h"
+#include "memory/heap_tracker.h"
 
 class GameEngine {
 private:
@@ -26,20 +51,94 @@ private:
     float worldWidth;
     float worldHeight;
     
-    // Entities
+    // Entities. entities[0, dynamicCount) is the dynamic layer; obstacles sit
+    // after it in the static layer, which per-tick passes skip (collision
+    // reaches them through obstacleIndex).
     std::vector<std::unique_ptr<Entity>> entities;
+    HandleTable entityHandles;  // Entity ids are handles into entities
+    EntityCounts entityCounts;  // Per type, kept on adopt and remove
+    size_t dynamicCount;
     Player* player;
     int nextEntityId;
     
+    // SoA mirror used by the bulk physics, bounds and broadphase passes
+    EntityStore entityStore;
+    bool useEntityStore;
+    
+    // Packed render state read by JS straight from the heap
+    RenderBuffer<EntityRenderRecord> entityRenderBuffer;
+    RenderBuffer<ParticleRenderRecord> particleRenderBuffer;
+    int32_t renderTypeCounts[RenderLayout::TYPE_COUNT];
+    std::vector<Entity*> renderScratch;
+    
+    // Camera culling for the render export. visibleIds is taken from the
+    // collision grid at the end of each tick; unculledIds holds dynamic
+    // entities adopted after that grid was built, tested one by one.
+    bool useRenderCulling;
+    float cullMargin;
+    std::vector<int> visibleIds;
+    std::vector<int> unculledIds;
+    std::vector<Entity*> cullScratch;
+    
+    // Per-frame scratch, reset at the end of update()
+    FrameArena frameArena;
+    
+    // Randomness and simulated time for this engine's gameplay code
+    SimContext simContext;
+    uint32_t seed;
+    
+    // Session recording (see systems/input_log.h)
+    InputLog inputLog;
+    InputLog replayLog;   // Loaded from JS for replayRecording()
+    int apiDepth;         // Nesting of public calls; only the outermost is recorded
+    
+    // Input queued by JS, applied at the start of update()
+    CommandBuffer commandBuffer;
+    
     // Systems
+    JobSystem jobSystem;
+    EventQueue gameplayEvents;    // This frame's side effects, applied after each pass
     CollisionSystem collisionSystem;
     WaveSystem waveSystem;
     VisualEffects visualEffects;
+    SnapshotSystem snapshotSystem;
+    StateCodec stateCodec;
+    ObstacleIndex obstacleIndex;  // Rebuilt lazily when obstacles change
+    FlowField flowField;          // Shared chase paths toward the player
+    const std::vector<ObstacleGenerator::Placement>* obstacleLayout;   // Not owned; may be null
+    StimulusBuffer stimuli;       // Noise events, heard by wolves the tick after
+    
+    // Streamed world; off until setChunkedWorld()
+    ChunkManager chunkManager;
+    bool useChunkedWorld;
+    std::vector<ChunkManager::Spawn> chunkSpawns;
+    std::vector<ChunkManager::Coord> chunkLoads;
+    std::vector<int> chunkEvictions;
+    WaveSystem::SpawnBatch waveSpawns;   // Reused by every wave update
+    
+    // World saves for rollback. Scratch is kept so that steady-state saves
+    // and restores do not allocate.
+    RollbackBuffer rollback;
+    std::vector<RollbackBuffer::EntityRecord> rollbackRecords;
+    std::vector<Stimulus> rollbackStimuli;
+    std::vector<std::unique_ptr<Entity>> rollbackRecycle;   // Live entities by handle slot
+    HandleTable rollbackHandles;
+    
+    // Optional modules (config/engine_features.h)
+#if ENGINE_FEATURE_CAMERA
+    Camera camera;
+#endif
+#if ENGINE_FEATURE_TARGETING
+    TargetingSystem targeting;
+    TargetCandidates targetCandidates;   // Gathered from the collision grid each tick
+#endif
     
     // Performance metrics
     float physicsTime;
     float collisionTime;
     int collisionChecks;
+    int broadphaseCandidates;
+    int narrowphaseHits;
     
     // Game state
     enum class GameState {
@@ -51,11 +150,42 @@ private:
     };
     
     GameState gameState;
+    uint32_t frameNumber;
+    
+    // Fixed-step simulation: update() banks render time and runs whole ticks
+    bool useFixedTimestep;
+    float fixedTimestep;        // Seconds per tick
+    int maxSubsteps;
+    float accumulator;
+    float interpolationAlpha;   // Fraction of a tick left in the accumulator
+    int lastSubstepCount;
+    float droppedTime;          // Time discarded by the catch-up budget
+    
+    // Movement input as last given, at most unit length; step() applies it
+    // once per tick, so the display rate does not change how the player
+    // moves. Saved with the world.
+    struct PlayerIntent {
+        float moveX, moveY;
+    };
+    PlayerIntent playerIntent;
+    QualityGovernor quality;
     int score;
     int highScore;
     
 public:
-    GameEngine(float width, float height);
+    // Outcome of re-simulating a recorded session
+    struct ReplayResult {
+        bool loaded;
+        bool complete;        // The log was stopped cleanly
+        bool matches;         // Final checksum and tick agree with the recording
+        uint32_t ticks;
+        double elapsedMs;
+        uint32_t checksum;
+        uint32_t expectedChecksum;
+    };
+    
+    // workers < 0 picks JobSystem::defaultWorkerCount()
+    GameEngine(float width, float height, int workers = -1);
     ~GameEngine();
     
     // Entity management
@@ -80,8 +210,27 @@ public:
     void performAttack(int playerId, float angle);
     void performRoll(int playerId, float dirX, float dirY);
     
+    // Local player shortcuts for the mobile controls (public/js/mobile-controls.js)
+    void playerAttack();
+    void playerRoll(float dirX, float dirY);
+    void setJoystickInput(float x, float y);
+    bool isAttacking() const { return player && player->active && player->attacking; }
+    bool isRolling() const { return player && player->active && player->rolling; }
+    int getEntityCount() const { return static_cast<int>(entities.size()); }
+    int getPlayerId() const { return player ? player->id : -1; }
+    bool isGameOver() const { return gameState == GameState::GAME_OVER; }
+    // Native hosts (server/match_host.h) encode state straight from the list
+    const std::vector<std::unique_ptr<Entity>>& getEntities() const { return entities; }
+    // Entities of one EntityType, without a scan
+    int getEntityCountOfType(int type) const {
+        return type >= 0 && type < EntityCounts::TYPE_COUNT
+            ? entityCounts.of(static_cast<EntityType>(type)) : 0;
+    }
+    const EntityCounts& getEntityCounts() const { return entityCounts; }
+    
     // Game loop
     void update(float deltaTime);
+    void step(float deltaTime);
     void updatePhysics(float deltaTime);
     void updateAI(float deltaTime);
     void checkCollisions();
@@ -98,27 +247,243 @@ public:
     void setWorldBounds(float width, float height);
     void generateObstacles(int count);
     void generateEnhancedObstacles(int count, bool ensurePlayability = true);
+    // Obstacles startGame() places instead of generating its own, e.g. one
+    // layout shared by every match of a batch (server/batch_simulator.h).
+    // Not copied, so it must outlive the engine's games; null goes back to
+    // generating. Ignored while recording, since a replay regenerates.
+    void setObstacleLayout(const std::vector<ObstacleGenerator::Placement>* layout) { obstacleLayout = layout; }
     void clearEntities();
+    void setMaxParticles(int maxParticles, bool recycleOldest);
+    
+    // Streamed world (systems/chunk_manager.h): chunks of chunkSize are
+    // generated around the player and frozen once out of range, and
+    // startGame() leaves obstacle placement to them. Toggling drops every
+    // frozen chunk; entities already in the world stay. chunkSize <= 0 and
+    // loadRadius < 0 pick the Config defaults.
+    void setChunkedWorld(bool enabled, float chunkSize, int loadRadius);
+    bool isChunkedWorld() const { return useChunkedWorld; }
+    float getChunkSize() const { return chunkManager.getChunkSize(); }
+    int getLoadedChunkCount() const { return chunkManager.loadedCount(); }
+    int getStoredChunkCount() const { return chunkManager.storedCount(); }
+    int getStoredChunkBytes() const { return static_cast<int>(chunkManager.storedBytes()); }
+    
+    // Determinism and replay. startRecording() resets the session (ids issued
+    // before it must be dropped) and logs every simulation-changing call until
+    // stopRecording(); runReplay() re-simulates a log headless on a fresh engine.
+    void setSeed(uint32_t newSeed);
+    uint32_t getSeed() const { return seed; }
+    void startRecording(uint32_t newSeed);
+    void stopRecording();
+    bool isRecording() const { return inputLog.isRecording(); }
+    const InputLog& getInputLog() const { return inputLog; }
+    uint32_t stateChecksum() const;
+    static ReplayResult runReplay(const InputLog& log);
     
-    // JavaScript interface
+    // Rollback (systems/rollback_buffer.h). With a depth > 0 the world is
+    // saved after every tick, keyed by getFrameNumber(). rollbackTo(frame)
+    // puts the simulation back to right after that tick, before any input
+    // for the next one, and drops the newer saves; resimulate() then runs
+    // ticks forward again with corrected input. Effects, the render export
+    // and the fixed-step accumulator are not part of a save. Not available
+    // while recording or in a streamed world.
+    void setRollbackDepth(int ticks);
+    int getRollbackDepth() const { return rollback.getDepth(); }
+    bool saveRollbackState();
+    bool rollbackTo(uint32_t frame);
+    int resimulate(int ticks);
+    bool canRollbackTo(uint32_t frame) const { return rollback.find(frame) != nullptr; }
+    int getOldestRollbackFrame() const;
+    int getRollbackBytes() const { return static_cast<int>(rollback.bytesUsed()); }
+    
+#ifdef __EMSCRIPTEN__
+    // JavaScript interface (src/game_engine_bindings.cpp)
     emscripten::val getEntityPositions();
     emscripten::val getAllEntities();
     emscripten::val getPlayerState();
     emscripten::val getGameState();
     emscripten::val getPerformanceMetrics();
+    emscripten::val getQualityStats();
     emscripten::val getVisualEffects();
     emscripten::val getWaveInfo();
+    emscripten::val getEntityRenderBuffer();
+    emscripten::val getParticleRenderBuffer();
+    emscripten::val getParticlePalette();
+    emscripten::val getRenderTypeCounts();
+    emscripten::val getSnapshotSince(uint32_t sequence);
+    emscripten::val raycastObstacles(float x1, float y1, float x2, float y2);
+    emscripten::val encodeState(uint32_t baselineSequence);
+    emscripten::val getStateDecodeBuffer(int size);
+    emscripten::val getDecodedEntities();
+    emscripten::val getRecording();
+    emscripten::val getReplayBuffer(int size);
+    emscripten::val replayRecording(int size);
+    emscripten::val getCommandBuffer();
+    emscripten::val getGameplayEvents();
+#if ENGINE_FEATURE_CAMERA
+    emscripten::val getCameraInfo();
+    emscripten::val worldToScreen(float worldX, float worldY);
+    emscripten::val screenToWorld(float screenX, float screenY);
+#endif
+#if ENGINE_FEATURE_TARGETING
+    emscripten::val getTargetButtonState();
+#endif
+#endif
+    
+    // Modules compiled into this build, as Features::*_BIT flags
+    int getFeatures() const { return Features::mask(); }
+    
+#if ENGINE_FEATURE_CAMERA
+    // Camera (follows the player each tick; viewport defaults to the world size)
+    void setViewport(float width, float height) { camera.setViewport(width, height); }
+    bool isOnScreen(float worldX, float worldY, float radius) const {
+        return camera.isOnScreen(worldX, worldY, radius);
+    }
+    const Camera& getCamera() const { return camera; }
+#endif
+    
+#if ENGINE_FEATURE_TARGETING
+    // Target lock (systems/targeting_system.h). Button coordinates are screen space.
+    void switchTarget(int direction);
+    void switchToNextTarget() { switchTarget(1); }
+    void enableTargeting();
+    void disableTargeting(float duration);
+    void handleTargetingButton(float pressDuration);
+    void onTargetButtonTouchStart(float x, float y, int touchId);
+    void onTargetButtonTouchEnd(int touchId);
+    void setTargetButtonPosition(float x, float y);
+    void setTargetButtonVisible(bool visible) { targeting.getButton().visible = visible; }
+    int getCurrentTargetId();
+    bool isTargetingEnabled() const { return targeting.isEnabled(); }
+    bool isAutoDisabledDueToDistance() const { return targeting.isAutoDisabled(); }
+    const TargetingSystem& getTargeting() const { return targeting; }
+#endif
+    
+    // Batched input (layout in systems/command_buffer.h). update() drains the
+    // ring itself; drainCommands() applies queued commands immediately.
+    int drainCommands();
+    int getCommandLayoutVersion() const { return CommandBuffer::VERSION; }
+    int getCommandStride() const { return CommandBuffer::STRIDE; }
+    int getCommandCapacity() const { return static_cast<int>(CommandBuffer::CAPACITY); }
+    CommandBuffer& getCommands() { return commandBuffer; }
+    
+    // Gameplay events since the start of the last update() (layout in
+    // systems/gameplay_events.h), already applied to effects and score
+    int getGameplayEventCount() const { return static_cast<int>(gameplayEvents.size()); }
+    int getGameplayEventLayoutVersion() const { return EventQueue::VERSION; }
+    int getGameplayEventStride() const { return EventQueue::STRIDE; }
+    const EventQueue& getGameplayEventQueue() const { return gameplayEvents; }
+    
+    // Zero-copy render export (layout in utils/render_buffer.h)
+    int packRenderState();
+    int getEntityRenderCount() const { return static_cast<int>(entityRenderBuffer.size()); }
+    int getParticleRenderCount() const { return static_cast<int>(particleRenderBuffer.size()); }
+    int getRenderLayoutVersion() const { return RenderLayout::VERSION; }
+    int getEntityRenderStride() const { return RenderLayout::ENTITY_STRIDE; }
+    int getParticleRenderStride() const { return RenderLayout::PARTICLE_STRIDE; }
+    int getRenderTypeCount(int type) const {
+        GAME_ASSERT_BOUNDS(type, 0, RenderLayout::TYPE_COUNT - 1, "render type");
+        return type >= 0 && type < RenderLayout::TYPE_COUNT ? renderTypeCounts[type] : 0;
+    }
+    
+    // Limit the export to what the camera sees (plus margin). Without the
+    // camera module every entity and particle is exported.
+    void setRenderCulling(bool enabled) { useRenderCulling = enabled; }
+    bool isRenderCulling() const { return Features::CAMERA && useRenderCulling; }
+    void setCullMargin(float margin) { cullMargin = std::max(0.0f, margin); }
+    float getCullMargin() const { return cullMargin; }
+    
+    // Adaptive quality (systems/quality_governor.h). On by default; the
+    // level scales particle density, the cull margin and the substep budget.
+    void setAdaptiveQuality(bool enabled);
+    bool isAdaptiveQuality() const { return quality.isEnabled(); }
+    void pinQualityLevel(int level);
+    int getQualityLevel() const { return quality.current(); }
+    int getPinnedQualityLevel() const { return quality.getPinned(); }
+    void setQualityTarget(float frameMs, float engineBudgetMs);
+    void setQualityLevelValues(int level, float particleDensity, float cullMarginScale,
+                               int maxSubsteps);
+    const QualityGovernor& getQualityGovernor() const { return quality; }
+    
+    // Delta snapshots (layout in systems/snapshot_system.h)
+    uint32_t getSnapshotSequence() const { return snapshotSystem.getSequence(); }
+    uint32_t getFrameNumber() const { return frameNumber; }
+    
+    // Obstacle queries (exact shapes, via the static obstacle index)
+    bool hasLineOfSight(float x1, float y1, float x2, float y2);
+    const ObstacleIndex& getObstacleIndex();
+    
+    // Worker pool (pthread builds only; 0 workers runs everything inline)
+    void setWorkerCount(int workers);
+    int getWorkerCount() const { return jobSystem.getWorkerCount(); }
+    
+    // Fixed timestep
+    void setFixedTimestep(float ticksPerSecond, int maxSubstepsPerUpdate);
+    void setUseFixedTimestep(bool enabled);
+    bool isUsingFixedTimestep() const { return useFixedTimestep; }
+    float getFixedTimestep() const { return fixedTimestep; }
+    float getInterpolationAlpha() const { return interpolationAlpha; }
+    int getLastSubstepCount() const { return lastSubstepCount; }
+    
+    // Quantized network state (layout in systems/state_codec.h)
+    uint32_t decodeState(int size) { return size > 0 ? stateCodec.decode(static_cast<size_t>(size)) : 0; }
+    int getDecodedEntityCount() const { return static_cast<int>(stateCodec.getDecoded().size()); }
+    int getDecodedEntityStride() const { return StateCodec::DECODED_STRIDE; }
     
     // Getters
     bool isBlocking(int playerId);
     bool isPerfectParryWindow(int playerId);
+    bool isUsingEntityStore() const { return useEntityStore; }
+    void setUseEntityStore(bool enabled);
+    bool isUsingFlowField() const { return flowField.isEnabled(); }
+    void setUseFlowField(bool enabled);
     int getScore() const { return score; }
     int getHighScore() const { return highScore; }
+    int getWaveNumber() const { return waveSystem.getCurrentWave(); }
     
 private:
+    // Binds simContext for a public call and tracks nesting, so that e.g.
+    // playerShoot -> createProjectile is recorded once, as the shot
+    class ApiCall {
+        GameEngine& engine;
+        SimContext::Scope scope;
+    public:
+        explicit ApiCall(GameEngine& owner) : engine(owner), scope(owner.simContext) { engine.apiDepth++; }
+        ~ApiCall() { engine.apiDepth--; }
+    };
+    
+    void record(InputLog::Op op, int id = 0, int arg = 0, float v0 = 0, float v1 = 0,
+                float v2 = 0, float v3 = 0, float v4 = 0, bool flag = false);
+    void resetSession(uint32_t newSeed);
+    void runTick(float deltaTime);
+    void applyRecord(const InputLog::Record& record);
+    bool rollbackAllowed() const { return rollback.isEnabled() && !useChunkedWorld && !inputLog.isRecording(); }
+    void saveWorld(std::vector<uint8_t>& block) const;
+    bool restoreWorld(const std::vector<uint8_t>& block);
+    
     Entity* findEntityById(int id);
+    Player* findPlayer(int playerId);
+    int adoptEntity(std::unique_ptr<Entity> entity);
+    void adoptSpawned(std::vector<std::unique_ptr<Entity>>& batch);
+    void swapRemoveEntity(size_t index);
+    void placeDynamic(size_t index);
+    void moveEntity(size_t from, size_t to);
     void updateEntityTargets();
+    void applyPlayerIntent();
+    void emitPlayerStimuli();
+    void applyGameplayEvents(size_t from);
     void cleanupInactiveEntities();
+    void captureVisibleSet();
+#if ENGINE_FEATURE_TARGETING
+    const TargetCandidates::List& queryTargetCandidates(const Entity& from);
+#endif
+    void gatherRenderSet();
+    void streamChunks();
+    ChunkManager::Spawn describeForChunk(const Entity& entity) const;
+    void spawnFromChunk(const ChunkManager::Spawn& spawn);
+    void evictEntity(int id);
+    void placeObstacle(const ObstacleGenerator::Placement& placement);
+    void applyQuality();
+    float effectiveCullMargin() const { return cullMargin * quality.values().cullMarginScale; }
 };
 
 #endif // GAME_ENGINE_H
\ No newline at end of file
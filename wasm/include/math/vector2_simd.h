@@ -2,10 +2,13 @@
 #define VECTOR2_SIMD_H
 
 #include <cmath>
-#include <wasm_simd128.h>
+#include <cstddef>
 #include "vector2.h"  // Include Vector2 for conversion functions
 // Removed emmintrin.h - not needed for WebAssembly SIMD
 
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+
 // SIMD-optimized Vector2 class for WebAssembly
 // Uses WASM SIMD128 instructions for better performance
 class Vector2SIMD {
@@ -142,6 +145,71 @@ public:
     }
 };
 
+#else
+
+// Scalar fallback with the same interface for builds without -msimd128
+class Vector2SIMD {
+private:
+    float vx;
+    float vy;
+    
+public:
+    Vector2SIMD() : vx(0.0f), vy(0.0f) {}
+    Vector2SIMD(float x, float y) : vx(x), vy(y) {}
+    
+    float x() const { return vx; }
+    float y() const { return vy; }
+    void setX(float x) { vx = x; }
+    void setY(float y) { vy = y; }
+    
+    Vector2SIMD operator+(const Vector2SIMD& other) const { return Vector2SIMD(vx + other.vx, vy + other.vy); }
+    Vector2SIMD operator-(const Vector2SIMD& other) const { return Vector2SIMD(vx - other.vx, vy - other.vy); }
+    Vector2SIMD operator*(float scalar) const { return Vector2SIMD(vx * scalar, vy * scalar); }
+    Vector2SIMD operator/(float scalar) const { return Vector2SIMD(vx / scalar, vy / scalar); }
+    
+    Vector2SIMD& operator+=(const Vector2SIMD& other) { vx += other.vx; vy += other.vy; return *this; }
+    Vector2SIMD& operator-=(const Vector2SIMD& other) { vx -= other.vx; vy -= other.vy; return *this; }
+    Vector2SIMD& operator*=(float scalar) { vx *= scalar; vy *= scalar; return *this; }
+    
+    float magnitudeSquared() const { return vx * vx + vy * vy; }
+    float magnitude() const { return std::sqrt(magnitudeSquared()); }
+    
+    Vector2SIMD normalized() const {
+        float mag = magnitude();
+        if (mag > 0.0f) {
+            return *this / mag;
+        }
+        return Vector2SIMD();
+    }
+    
+    float dot(const Vector2SIMD& other) const { return vx * other.vx + vy * other.vy; }
+    float distanceTo(const Vector2SIMD& other) const { return (*this - other).magnitude(); }
+    float distanceSquaredTo(const Vector2SIMD& other) const { return (*this - other).magnitudeSquared(); }
+    
+    static void batchAdd(Vector2SIMD* result, const Vector2SIMD* a,
+                         const Vector2SIMD* b, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            result[i] = a[i] + b[i];
+        }
+    }
+    
+    static void batchScale(Vector2SIMD* result, const Vector2SIMD* vectors,
+                           float scalar, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            result[i] = vectors[i] * scalar;
+        }
+    }
+    
+    static Vector2SIMD lerp(const Vector2SIMD& a, const Vector2SIMD& b, float t) {
+        return a * (1.0f - t) + b * t;
+    }
+    
+    Vector2 toVector2() const { return Vector2(vx, vy); }
+    static Vector2SIMD fromVector2(const Vector2& v) { return Vector2SIMD(v.x, v.y); }
+};
+
+#endif // __wasm_simd128__
+
 // Type alias for easier use
 using Vec2 = Vector2SIMD;
 
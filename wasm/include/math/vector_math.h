@@ -0,0 +1,313 @@
+#ifndef VECTOR_MATH_H
+#define VECTOR_MATH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+// Batch kernels over structure-of-arrays float data
+//
+// Each kernel processes four lanes per instruction when the module is built
+// with -msimd128 and falls back to a plain loop otherwise. Arrays do not need
+// any particular alignment; the remainder after the last full group of four
+// is handled by the scalar path. tests/native/test_vector_math.cpp checks
+// both paths against plain loops and times them.
+namespace VectorMath {
+
+    // x += vx * scale, y += vy * scale
+    inline void integrate(float* x, float* y, const float* vx, const float* vy,
+                          size_t count, float scale) {
+        size_t i = 0;
+#ifdef __wasm_simd128__
+        v128_t s = wasm_f32x4_splat(scale);
+        for (; i + 4 <= count; i += 4) {
+            v128_t px = wasm_v128_load(x + i);
+            v128_t py = wasm_v128_load(y + i);
+            px = wasm_f32x4_add(px, wasm_f32x4_mul(wasm_v128_load(vx + i), s));
+            py = wasm_f32x4_add(py, wasm_f32x4_mul(wasm_v128_load(vy + i), s));
+            wasm_v128_store(x + i, px);
+            wasm_v128_store(y + i, py);
+        }
+#endif
+        for (; i < count; i++) {
+            x[i] += vx[i] * scale;
+            y[i] += vy[i] * scale;
+        }
+    }
+
+    // Uniform velocity damping (friction / air resistance)
+    inline void damp(float* vx, float* vy, size_t count, float factor) {
+        size_t i = 0;
+#ifdef __wasm_simd128__
+        v128_t f = wasm_f32x4_splat(factor);
+        for (; i + 4 <= count; i += 4) {
+            wasm_v128_store(vx + i, wasm_f32x4_mul(wasm_v128_load(vx + i), f));
+            wasm_v128_store(vy + i, wasm_f32x4_mul(wasm_v128_load(vy + i), f));
+        }
+#endif
+        for (; i < count; i++) {
+            vx[i] *= factor;
+            vy[i] *= factor;
+        }
+    }
+
+    // Constant acceleration along y (gravity)
+    inline void accelerateY(float* vy, size_t count, float amount) {
+        size_t i = 0;
+#ifdef __wasm_simd128__
+        v128_t a = wasm_f32x4_splat(amount);
+        for (; i + 4 <= count; i += 4) {
+            wasm_v128_store(vy + i, wasm_f32x4_add(wasm_v128_load(vy + i), a));
+        }
+#endif
+        for (; i < count; i++) {
+            vy[i] += amount;
+        }
+    }
+
+    // Per-lane damping: v *= factor[i]
+    inline void dampEach(float* vx, float* vy, const float* factor, size_t count) {
+        size_t i = 0;
+#ifdef __wasm_simd128__
+        for (; i + 4 <= count; i += 4) {
+            v128_t f = wasm_v128_load(factor + i);
+            wasm_v128_store(vx + i, wasm_f32x4_mul(wasm_v128_load(vx + i), f));
+            wasm_v128_store(vy + i, wasm_f32x4_mul(wasm_v128_load(vy + i), f));
+        }
+#endif
+        for (; i < count; i++) {
+            vx[i] *= factor[i];
+            vy[i] *= factor[i];
+        }
+    }
+
+    // dst[i] += src[i]
+    inline void addEach(float* dst, const float* src, size_t count) {
+        size_t i = 0;
+#ifdef __wasm_simd128__
+        for (; i + 4 <= count; i += 4) {
+            wasm_v128_store(dst + i, wasm_f32x4_add(wasm_v128_load(dst + i), wasm_v128_load(src + i)));
+        }
+#endif
+        for (; i < count; i++) {
+            dst[i] += src[i];
+        }
+    }
+
+    // dst[i] *= factor[i]
+    inline void scaleEach(float* dst, const float* factor, size_t count) {
+        size_t i = 0;
+#ifdef __wasm_simd128__
+        for (; i + 4 <= count; i += 4) {
+            wasm_v128_store(dst + i, wasm_f32x4_mul(wasm_v128_load(dst + i), wasm_v128_load(factor + i)));
+        }
+#endif
+        for (; i < count; i++) {
+            dst[i] *= factor[i];
+        }
+    }
+
+    // Keep circles inside [0, width] x [0, height]
+    inline void clampToBounds(float* x, float* y, const float* radius, size_t count,
+                              float width, float height) {
+        size_t i = 0;
+#ifdef __wasm_simd128__
+        v128_t w = wasm_f32x4_splat(width);
+        v128_t h = wasm_f32x4_splat(height);
+        for (; i + 4 <= count; i += 4) {
+            v128_t r = wasm_v128_load(radius + i);
+            v128_t px = wasm_v128_load(x + i);
+            v128_t py = wasm_v128_load(y + i);
+            px = wasm_f32x4_pmin(wasm_f32x4_pmax(px, r), wasm_f32x4_sub(w, r));
+            py = wasm_f32x4_pmin(wasm_f32x4_pmax(py, r), wasm_f32x4_sub(h, r));
+            wasm_v128_store(x + i, px);
+            wasm_v128_store(y + i, py);
+        }
+#endif
+        for (; i < count; i++) {
+            // A copy, or the store to x[i] (which may alias it) forces a reload
+            float r = radius[i];
+            x[i] = std::min(std::max(x[i], r), width - r);
+            y[i] = std::min(std::max(y[i], r), height - r);
+        }
+    }
+
+    // Overlap bitmasks of circle (cx, cy, cr) against a run of circles; bit
+    // i % 32 of masks[i / 32] is set when circle i overlaps it, and masks
+    // must hold (count + 31) / 32 words. Returns the number of overlapping
+    // circles, counted per lane rather than with a popcount, which is a
+    // library call on hosts built without one.
+    inline size_t circleOverlapMasks(const float* x, const float* y, const float* radius,
+                                     size_t count, float cx, float cy, float cr,
+                                     uint32_t* masks) {
+        size_t hits = 0;
+#ifdef __wasm_simd128__
+        v128_t qx = wasm_f32x4_splat(cx);
+        v128_t qy = wasm_f32x4_splat(cy);
+        v128_t qr = wasm_f32x4_splat(cr);
+        v128_t laneHits = wasm_i32x4_splat(0);  // Minus the hits in each lane
+#endif
+        for (size_t base = 0, word = 0; base < count; base += 32, word++) {
+            size_t end = std::min<size_t>(count - base, 32);
+            const float* wx = x + base;
+            const float* wy = y + base;
+            const float* wr = radius + base;
+            uint32_t mask = 0;
+            size_t i = 0;
+#ifdef __wasm_simd128__
+            for (; i + 4 <= end; i += 4) {
+                v128_t dx = wasm_f32x4_sub(wasm_v128_load(wx + i), qx);
+                v128_t dy = wasm_f32x4_sub(wasm_v128_load(wy + i), qy);
+                v128_t rs = wasm_f32x4_add(wasm_v128_load(wr + i), qr);
+                v128_t d2 = wasm_f32x4_add(wasm_f32x4_mul(dx, dx), wasm_f32x4_mul(dy, dy));
+                v128_t hit = wasm_f32x4_lt(d2, wasm_f32x4_mul(rs, rs));
+                mask |= static_cast<uint32_t>(wasm_i32x4_bitmask(hit)) << i;
+                laneHits = wasm_i32x4_add(laneHits, hit);
+            }
+#endif
+            for (; i < end; i++) {
+                float dx = wx[i] - cx;
+                float dy = wy[i] - cy;
+                float rs = wr[i] + cr;
+                if (dx * dx + dy * dy < rs * rs) {
+                    mask |= 1u << i;
+                    hits++;
+                }
+            }
+            masks[word] = mask;
+        }
+#ifdef __wasm_simd128__
+        hits -= static_cast<size_t>(static_cast<int32_t>(
+            wasm_i32x4_extract_lane(laneHits, 0) + wasm_i32x4_extract_lane(laneHits, 1) +
+            wasm_i32x4_extract_lane(laneHits, 2) + wasm_i32x4_extract_lane(laneHits, 3)));
+#endif
+        return hits;
+    }
+
+    // Test one circle against up to 32 circles starting at index 0.
+    // Bit i of the result is set when circle i overlaps (cx, cy, cr).
+    inline uint32_t circleOverlapMask(const float* x, const float* y, const float* radius,
+                                      size_t count, float cx, float cy, float cr) {
+        uint32_t mask = 0;
+        circleOverlapMasks(x, y, radius, std::min<size_t>(count, 32), cx, cy, cr, &mask);
+        return mask;
+    }
+
+    // One circle against one rounded box per lane: box i is centred at
+    // (bx, by), rotated by (cosR, sinR), with half size (halfW, halfH) and
+    // corners rounded by round (a circle is a zero-size box rounded by its
+    // radius). overlap[i] is 1 when circle (cx, cy, cr) reaches the box,
+    // judged from the distance between the circle's centre and its closest
+    // point on the box, in box space. Returns the number of overlaps.
+    inline size_t circleBoxOverlap(const float* cx, const float* cy, const float* cr,
+                                   const float* bx, const float* by,
+                                   const float* cosR, const float* sinR,
+                                   const float* halfW, const float* halfH, const float* round,
+                                   size_t count, uint8_t* overlap) {
+        size_t hits = 0;
+        size_t i = 0;
+#ifdef __wasm_simd128__
+        v128_t one = wasm_i32x4_splat(1);
+        v128_t laneHits = wasm_i32x4_splat(0);
+        for (; i + 4 <= count; i += 4) {
+            v128_t dx = wasm_f32x4_sub(wasm_v128_load(cx + i), wasm_v128_load(bx + i));
+            v128_t dy = wasm_f32x4_sub(wasm_v128_load(cy + i), wasm_v128_load(by + i));
+            v128_t c = wasm_v128_load(cosR + i);
+            v128_t s = wasm_v128_load(sinR + i);
+            v128_t lx = wasm_f32x4_add(wasm_f32x4_mul(dx, c), wasm_f32x4_mul(dy, s));
+            v128_t ly = wasm_f32x4_sub(wasm_f32x4_mul(dy, c), wasm_f32x4_mul(dx, s));
+            v128_t hw = wasm_v128_load(halfW + i);
+            v128_t hh = wasm_v128_load(halfH + i);
+            v128_t ex = wasm_f32x4_sub(lx, wasm_f32x4_pmin(wasm_f32x4_pmax(lx, wasm_f32x4_neg(hw)), hw));
+            v128_t ey = wasm_f32x4_sub(ly, wasm_f32x4_pmin(wasm_f32x4_pmax(ly, wasm_f32x4_neg(hh)), hh));
+            v128_t reach = wasm_f32x4_add(wasm_v128_load(cr + i), wasm_v128_load(round + i));
+            v128_t d2 = wasm_f32x4_add(wasm_f32x4_mul(ex, ex), wasm_f32x4_mul(ey, ey));
+            v128_t hit = wasm_v128_and(wasm_f32x4_lt(d2, wasm_f32x4_mul(reach, reach)), one);
+            laneHits = wasm_i32x4_add(laneHits, hit);
+            // Narrow the four 0/1 lanes to bytes and store them at once
+            v128_t bytes = wasm_u8x16_narrow_i16x8(wasm_u16x8_narrow_i32x4(hit, hit), hit);
+            wasm_v128_store32_lane(overlap + i, bytes, 0);
+        }
+        hits += static_cast<size_t>(wasm_i32x4_extract_lane(laneHits, 0) + wasm_i32x4_extract_lane(laneHits, 1) +
+                                    wasm_i32x4_extract_lane(laneHits, 2) + wasm_i32x4_extract_lane(laneHits, 3));
+#endif
+        for (; i < count; i++) {
+            float dx = cx[i] - bx[i];
+            float dy = cy[i] - by[i];
+            float lx = dx * cosR[i] + dy * sinR[i];
+            float ly = dy * cosR[i] - dx * sinR[i];
+            // By value: std::min on an array element and a negated temporary
+            // returns a reference to either, which compiles to a branch
+            float hw = halfW[i];
+            float hh = halfH[i];
+            float ex = lx - std::min(std::max(lx, -hw), hw);
+            float ey = ly - std::min(std::max(ly, -hh), hh);
+            float reach = cr[i] + round[i];
+            uint8_t hit = ex * ex + ey * ey < reach * reach;
+            overlap[i] = hit;
+            hits += hit;
+        }
+        return hits;
+    }
+
+    // Per-lane results of senseTarget()
+    constexpr uint8_t SENSE_SIGHT = 1;    // In sight range and inside the vision cone
+    constexpr uint8_t SENSE_HEARING = 2;  // Strictly inside hearing range
+
+    // Range, vision cone and hearing tests of many viewers against one
+    // target. (fx, fy) are unit facings; cosHalfCone is cos(cone angle / 2)
+    // and must be positive. The cone test is dot(facing, toTarget) >=
+    // cosHalfCone * |toTarget|, compared squared, so there is no sqrt or
+    // trig per lane. distSq receives the squared distance to the target.
+    inline void senseTarget(const float* x, const float* y, const float* fx, const float* fy,
+                            size_t count, float tx, float ty,
+                            float sightRange, float cosHalfCone, float hearingRange,
+                            float* distSq, uint8_t* flags) {
+        float sightSq = sightRange * sightRange;
+        float coneSq = cosHalfCone * cosHalfCone;
+        float hearingSq = hearingRange * hearingRange;
+        size_t i = 0;
+#ifdef __wasm_simd128__
+        v128_t qx = wasm_f32x4_splat(tx);
+        v128_t qy = wasm_f32x4_splat(ty);
+        v128_t sight = wasm_f32x4_splat(sightSq);
+        v128_t cone = wasm_f32x4_splat(coneSq);
+        v128_t hearing = wasm_f32x4_splat(hearingSq);
+        v128_t zero = wasm_f32x4_splat(0.0f);
+        v128_t sightFlag = wasm_i32x4_splat(SENSE_SIGHT);
+        v128_t hearingFlag = wasm_i32x4_splat(SENSE_HEARING);
+        for (; i + 4 <= count; i += 4) {
+            v128_t dx = wasm_f32x4_sub(qx, wasm_v128_load(x + i));
+            v128_t dy = wasm_f32x4_sub(qy, wasm_v128_load(y + i));
+            v128_t d2 = wasm_f32x4_add(wasm_f32x4_mul(dx, dx), wasm_f32x4_mul(dy, dy));
+            v128_t dot = wasm_f32x4_add(wasm_f32x4_mul(dx, wasm_v128_load(fx + i)),
+                                        wasm_f32x4_mul(dy, wasm_v128_load(fy + i)));
+            v128_t seen = wasm_v128_and(wasm_f32x4_le(d2, sight),
+                          wasm_v128_and(wasm_f32x4_ge(dot, zero),
+                                        wasm_f32x4_ge(wasm_f32x4_mul(dot, dot), wasm_f32x4_mul(cone, d2))));
+            v128_t sensed = wasm_v128_or(wasm_v128_and(seen, sightFlag),
+                                         wasm_v128_and(wasm_f32x4_lt(d2, hearing), hearingFlag));
+            wasm_v128_store(distSq + i, d2);
+            // Narrow the four flag lanes to bytes and store them at once
+            v128_t bytes = wasm_u8x16_narrow_i16x8(wasm_u16x8_narrow_i32x4(sensed, sensed), sensed);
+            wasm_v128_store32_lane(flags + i, bytes, 0);
+        }
+#endif
+        for (; i < count; i++) {
+            float dx = tx - x[i];
+            float dy = ty - y[i];
+            float d2 = dx * dx + dy * dy;
+            float dot = dx * fx[i] + dy * fy[i];
+            // & rather than &&: no branch on lanes that are a coin toss
+            bool seen = (d2 <= sightSq) & (dot >= 0.0f) & (dot * dot >= coneSq * d2);
+            distSq[i] = d2;
+            flags[i] = static_cast<uint8_t>(seen * SENSE_SIGHT | (d2 < hearingSq) * SENSE_HEARING);
+        }
+    }
+}
+
+#endif // VECTOR_MATH_H
@@ -0,0 +1,162 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+// Linear allocator for scratch data that only lives until the end of a frame
+//
+// allocate() bumps an offset into one preallocated block; nothing is freed
+// individually (except the most recent allocation, so a growing vector can
+// reuse its tail). reset() at the end of the frame makes the whole block
+// available again. A request that does not fit is served from the global heap
+// and counted as a fallback; at the next reset the block is regrown to the
+// frame's total, so a steady workload stops touching the heap after its first
+// frame.
+//
+// Not thread-safe: allocate only from the thread that owns the frame.
+class FrameArena {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;
+
+private:
+    std::unique_ptr<unsigned char[]> block;
+    size_t capacity;
+    size_t offset;
+    size_t lastOffset;       // Start of the most recent allocation
+    size_t fallbackBytes;    // Heap bytes handed out this frame
+
+    struct Fallback {
+        void* memory;
+        size_t alignment;
+    };
+    std::vector<Fallback> fallbacks;
+
+    size_t highWater;        // Largest frame total seen, block plus heap
+    uint32_t fallbackCount;  // Heap fallbacks since construction
+    uint32_t lastFrameFallbacks;
+    uint32_t frameFallbacks;
+
+public:
+    explicit FrameArena(size_t initialCapacity = DEFAULT_CAPACITY)
+        : block(new unsigned char[initialCapacity]), capacity(initialCapacity),
+          offset(0), lastOffset(0), fallbackBytes(0), highWater(0),
+          fallbackCount(0), lastFrameFallbacks(0), frameFallbacks(0) {
+        fallbacks.reserve(16);
+    }
+
+    ~FrameArena() { releaseFallbacks(); }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // alignment must be a power of two. The address is aligned, not the
+    // offset: new[] only guarantees the block alignof(max_align_t).
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.get());
+        size_t start = ((base + offset + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+        if (start + bytes <= capacity) {
+            lastOffset = start;
+            offset = start + bytes;
+            return block.get() + start;
+        }
+
+        // Overflow: borrow from the heap until the next reset
+        void* memory = ::operator new(bytes, std::align_val_t(alignment));
+        fallbacks.push_back({memory, alignment});
+        fallbackBytes += bytes;
+        frameFallbacks++;
+        fallbackCount++;
+        return memory;
+    }
+
+    // Only the most recent block allocation can be given back
+    void deallocate(void* memory, size_t bytes) {
+        unsigned char* p = static_cast<unsigned char*>(memory);
+        if (p == block.get() + lastOffset && lastOffset + bytes == offset) {
+            offset = lastOffset;
+        }
+    }
+
+    bool owns(const void* memory) const {
+        const unsigned char* p = static_cast<const unsigned char*>(memory);
+        return p >= block.get() && p < block.get() + capacity;
+    }
+
+    // End of frame: everything allocated since the last reset is invalid
+    void reset() {
+        size_t frameTotal = offset + fallbackBytes;
+        highWater = std::max(highWater, frameTotal);
+        lastFrameFallbacks = frameFallbacks;
+
+        if (!fallbacks.empty()) {
+            releaseFallbacks();
+            // Regrow so the same frame fits next time, with some headroom
+            size_t grown = std::max(capacity * 2, frameTotal + frameTotal / 4);
+            block.reset(new unsigned char[grown]);
+            capacity = grown;
+        }
+
+        offset = 0;
+        lastOffset = 0;
+        fallbackBytes = 0;
+        frameFallbacks = 0;
+    }
+
+    size_t getUsed() const { return offset + fallbackBytes; }
+    size_t getCapacity() const { return capacity; }
+    size_t getHighWater() const { return highWater; }
+    uint32_t getFallbackCount() const { return fallbackCount; }
+    uint32_t getLastFrameFallbacks() const { return lastFrameFallbacks; }
+
+private:
+    void releaseFallbacks() {
+        for (const Fallback& fallback : fallbacks) {
+            ::operator delete(fallback.memory, std::align_val_t(fallback.alignment));
+        }
+        fallbacks.clear();
+    }
+};
+
+// STL allocator over a FrameArena; containers using it must not outlive the
+// frame they were filled in. Without an arena it falls back to the heap, so
+// systems used outside the engine still work.
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    FrameArena* arena;
+
+    explicit ArenaAllocator(FrameArena* owner) noexcept : arena(owner) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(size_t n) {
+        if (!arena) return std::allocator<T>().allocate(n);
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (!arena) {
+            std::allocator<T>().deallocate(p, n);
+            return;
+        }
+        arena->deallocate(p, n * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena == other.arena; }
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept { return arena != other.arena; }
+};
+
+template<typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // FRAME_ARENA_H
@@ -0,0 +1,241 @@
+#ifndef HEAP_TRACKER_H
+#define HEAP_TRACKER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Heap accounting is on in WASM builds, where ALLOW_MEMORY_GROWTH makes the
+// heap's size a budget, and off natively (the benchmark counts allocations
+// with its own hook, and reads these counts instead when tracking is on).
+// -DHEAP_TRACKING=0/1 overrides either default.
+#ifndef HEAP_TRACKING
+    #ifdef __EMSCRIPTEN__
+        #define HEAP_TRACKING 1
+    #else
+        #define HEAP_TRACKING 0
+    #endif
+#endif
+
+// Subsystem an allocation is charged to; names only exist for export
+enum class AllocTag : uint8_t {
+    OTHER,        // Anything outside a tagged scope
+    ENTITIES,     // Entity creation, spawning and per-entity logic
+    PARTICLES,    // Visual effects
+    AI,           // Wolf and enemy decision making
+    GRID,         // Spatial grid, obstacle index, flow field, chunks
+    EXPORTS,      // Render buffers, snapshots and encoded state
+    COUNT
+};
+
+inline const char* allocTagName(AllocTag tag) {
+    static const char* names[] = {
+        "other", "entities", "particles", "ai", "grid", "exports"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(AllocTag::COUNT),
+                  "alloc tag name table out of date");
+    return names[static_cast<size_t>(tag)];
+}
+
+// Tagged accounting behind the global operator new/delete
+//
+// With HEAP_TRACKING on, src/memory/heap_tracker.cpp replaces the global
+// operator new/delete. Every block gets a small header holding its size and
+// the tag that was current on the allocating thread, so a delete is charged
+// back to the subsystem that allocated it wherever it is freed. HEAP_SCOPE(tag)
+// sets the current tag for the enclosing scope; scopes nest and restore.
+//
+// Per tag the tracker keeps live bytes, their peak, total allocations and
+// allocations in the current frame. After every allocation the WASM linear
+// memory size is compared with the last one seen; when it grew, a growth
+// event is stored with the tick that was running and the tag that asked, so
+// a heap that grows mid-match names its cause. Budgets are per tag and only
+// reported (overBudget), never enforced by failing an allocation.
+//
+// Counters are relaxed atomics, so job workers allocate without locks. All
+// state is constant-initialised: allocations made during static
+// initialisation are counted before any constructor has run.
+class HeapTracker {
+public:
+    static constexpr size_t TAG_COUNT = static_cast<size_t>(AllocTag::COUNT);
+    static constexpr size_t MAX_GROWTH_EVENTS = 32;   // Most recent kept
+
+    struct TagStats {
+        size_t liveBytes;
+        size_t peakBytes;
+        size_t budgetBytes;          // 0 = no budget
+        uint64_t allocations;        // All time
+        uint32_t frameAllocations;   // During the last completed frame
+        uint32_t peakFrameAllocations;
+    };
+
+    struct GrowthEvent {
+        uint32_t frame;       // Engine tick that was running
+        AllocTag tag;         // Tag of the allocation that grew the heap
+        size_t requestBytes;
+        size_t fromBytes;
+        size_t toBytes;
+    };
+
+private:
+    struct Counters {
+        std::atomic<size_t> liveBytes{0};
+        std::atomic<size_t> peakBytes{0};
+        std::atomic<size_t> budgetBytes{0};
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint32_t> frameAllocations{0};
+        std::atomic<uint32_t> lastFrameAllocations{0};
+        std::atomic<uint32_t> peakFrameAllocations{0};
+    };
+
+    Counters counters[TAG_COUNT];
+    GrowthEvent growth[MAX_GROWTH_EVENTS] = {};
+    std::atomic<uint32_t> growthCount{0};
+    std::atomic<size_t> heapBytes{0};
+    std::atomic<uint32_t> frame{0};
+
+    static AllocTag& currentTag() {
+        static thread_local AllocTag tag = AllocTag::OTHER;
+        return tag;
+    }
+
+    constexpr HeapTracker() = default;
+
+public:
+    HeapTracker(const HeapTracker&) = delete;
+    HeapTracker& operator=(const HeapTracker&) = delete;
+
+    static HeapTracker& getInstance() {
+        static HeapTracker instance;
+        return instance;
+    }
+
+    // Size of the WASM linear memory, or 0 where there is none
+    static size_t linearMemoryBytes() {
+#ifdef __wasm__
+        return __builtin_wasm_memory_size(0) * 65536;
+#else
+        return 0;
+#endif
+    }
+
+    static AllocTag tag() { return currentTag(); }
+
+    // Current tag for the calling thread; returns the previous one
+    static AllocTag swapTag(AllocTag tag) {
+        AllocTag previous = currentTag();
+        currentTag() = tag;
+        return previous;
+    }
+
+    class Scope {
+        AllocTag previous;
+
+    public:
+        explicit Scope(AllocTag tag) : previous(swapTag(tag)) {}
+        ~Scope() { swapTag(previous); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // Called by the allocation hook with the block's user size
+    void onAllocate(AllocTag tag, size_t bytes) {
+        Counters& c = counters[static_cast<size_t>(tag)];
+        size_t live = c.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        if (live > c.peakBytes.load(std::memory_order_relaxed)) {
+            c.peakBytes.store(live, std::memory_order_relaxed);
+        }
+        c.allocations.fetch_add(1, std::memory_order_relaxed);
+        c.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+
+        size_t heap = linearMemoryBytes();
+        size_t seen = heapBytes.load(std::memory_order_relaxed);
+        if (heap > seen && heapBytes.compare_exchange_strong(seen, heap, std::memory_order_relaxed)) {
+            // The first sighting is the initial heap, not growth
+            if (seen != 0) recordGrowth(tag, bytes, seen, heap);
+        }
+    }
+
+    void onFree(AllocTag tag, size_t bytes) {
+        counters[static_cast<size_t>(tag)].liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    // Tick that growth events are stamped with
+    void setFrame(uint32_t tick) { frame.store(tick, std::memory_order_relaxed); }
+
+    // Close the frame's allocation counts. Call once per update, between frames.
+    void endFrame() {
+        for (Counters& c : counters) {
+            uint32_t n = c.frameAllocations.exchange(0, std::memory_order_relaxed);
+            c.lastFrameAllocations.store(n, std::memory_order_relaxed);
+            if (n > c.peakFrameAllocations.load(std::memory_order_relaxed)) {
+                c.peakFrameAllocations.store(n, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void setBudget(AllocTag tag, size_t bytes) {
+        counters[static_cast<size_t>(tag)].budgetBytes.store(bytes, std::memory_order_relaxed);
+    }
+
+    TagStats stats(AllocTag tag) const {
+        const Counters& c = counters[static_cast<size_t>(tag)];
+        return {
+            c.liveBytes.load(std::memory_order_relaxed),
+            c.peakBytes.load(std::memory_order_relaxed),
+            c.budgetBytes.load(std::memory_order_relaxed),
+            c.allocations.load(std::memory_order_relaxed),
+            c.lastFrameAllocations.load(std::memory_order_relaxed),
+            c.peakFrameAllocations.load(std::memory_order_relaxed)
+        };
+    }
+
+    bool overBudget(AllocTag tag) const {
+        TagStats s = stats(tag);
+        return s.budgetBytes != 0 && s.liveBytes > s.budgetBytes;
+    }
+
+    size_t heapSize() const { return heapBytes.load(std::memory_order_relaxed); }
+
+    // Growth events, oldest first; index < growthEventCount()
+    size_t growthEventCount() const {
+        uint32_t n = growthCount.load(std::memory_order_acquire);
+        return n < MAX_GROWTH_EVENTS ? n : MAX_GROWTH_EVENTS;
+    }
+
+    const GrowthEvent& growthEvent(size_t index) const {
+        uint32_t n = growthCount.load(std::memory_order_acquire);
+        size_t first = n > MAX_GROWTH_EVENTS ? n - MAX_GROWTH_EVENTS : 0;
+        return growth[(first + index) % MAX_GROWTH_EVENTS];
+    }
+
+    // Peaks, frame counts and growth events; live bytes and budgets stay
+    void resetStatistics() {
+        for (Counters& c : counters) {
+            c.peakBytes.store(c.liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            c.peakFrameAllocations.store(0, std::memory_order_relaxed);
+        }
+        growthCount.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    // Growth is rare (a handful of times per session), so one writer at a
+    // time is enough: the compare-exchange above already picked it
+    void recordGrowth(AllocTag tag, size_t bytes, size_t from, size_t to) {
+        uint32_t n = growthCount.load(std::memory_order_relaxed);
+        growth[n % MAX_GROWTH_EVENTS] = {frame.load(std::memory_order_relaxed), tag, bytes, from, to};
+        growthCount.store(n + 1, std::memory_order_release);
+    }
+};
+
+#if HEAP_TRACKING
+    #define HEAP_SCOPE(tag) HeapTracker::Scope heapScope_##tag(AllocTag::tag)
+    #define HEAP_SET_FRAME(tick) HeapTracker::getInstance().setFrame(tick)
+    #define HEAP_END_FRAME() HeapTracker::getInstance().endFrame()
+#else
+    #define HEAP_SCOPE(tag)
+    #define HEAP_SET_FRAME(tick)
+    #define HEAP_END_FRAME()
+#endif
+
+#endif // HEAP_TRACKER_H
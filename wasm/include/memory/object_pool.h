@@ -1,178 +1,182 @@
 #ifndef OBJECT_POOL_H
 #define OBJECT_POOL_H
 
+#include "../utils/error_handler.h"
 #include <vector>
-#include <queue>
 #include <memory>
+#include <new>
+#include <cstddef>
 #include <functional>
-#include <type_traits>
+#include <thread>
+#include <utility>
 
-// Modern object pool implementation for efficient memory management
-// Reduces allocation overhead and improves cache locality
+namespace emscripten { class val; }
+
+// Typed slab pool
+//
+// Slots for T are carved out of contiguous slabs; free slots are chained
+// through an intrusive free list stored in the slots themselves, so allocate()
+// and deallocate() are a pointer pop and push. Slabs are only ever added,
+// never released, so every object the pool hands out stays owned by it and
+// a workload that fits the slabs already reserved never reaches the heap.
+// Running out just adds another slab of the same size.
+//
+// Entity types route their class operator new/delete here (see
+// poolAllocate below), so plain std::make_unique<Projectile>(...) and the
+// unique_ptr<Entity> that owns the object both go through the pool. Each
+// such type keeps one pool per thread (a thread_local in its static
+// pool()), so engines on different threads never share a free list. The
+// pool and its slabs go when the thread exits, so its entities must be
+// gone by then. A pool is only used by the thread that made it: an object
+// must be freed on the thread that allocated it (a server pins each match
+// to one thread for this). Both mistakes are caught:
+// touching a pool from another thread fails the owner check, and a slot
+// from another thread's pool fails the slab check in deallocate() and is
+// dropped rather than mixed into this pool's free list.
 template<typename T>
 class ObjectPool {
 private:
-    struct PoolDeleter {
-        ObjectPool* pool;
-        
-        void operator()(T* ptr) {
-            if (pool && ptr) {
-                pool->returnObject(ptr);
-            }
-        }
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
     };
-    
-    using UniquePtr = std::unique_ptr<T, PoolDeleter>;
-    
-    std::vector<std::unique_ptr<T>> pool;
-    std::queue<T*> available;
-    size_t maxSize;
-    size_t currentSize;
-    std::function<void(T*)> resetFunc;
-    
+
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+    size_t slotsPerSlab;
+    Slot* freeList;
+    size_t capacity;
+    size_t inUse;
+    size_t peakInUse;
+    size_t allocations;
+    std::thread::id owner;   // The thread that made the pool
+
+    void grow() {
+        slabs.emplace_back(new Slot[slotsPerSlab]);
+        Slot* slab = slabs.back().get();
+        // Chain in address order so fresh objects are handed out sequentially
+        for (size_t i = slotsPerSlab; i-- > 0;) {
+            slab[i].next = freeList;
+            freeList = &slab[i];
+        }
+        capacity += slotsPerSlab;
+    }
+
 public:
-    explicit ObjectPool(size_t initialSize = 100, size_t maxSize = 1000)
-        : maxSize(maxSize), currentSize(0) {
-        reserve(initialSize);
+    struct Stats {
+        size_t capacity;
+        size_t inUse;
+        size_t peakInUse;
+        size_t slabs;
+        size_t allocations;
+    };
+
+    explicit ObjectPool(size_t slabSize)
+        : slotsPerSlab(slabSize > 0 ? slabSize : 1), freeList(nullptr),
+          capacity(0), inUse(0), peakInUse(0), allocations(0),
+          owner(std::this_thread::get_id()) {
+        grow();
     }
-    
-    // Set custom reset function for objects
-    void setResetFunction(std::function<void(T*)> func) {
-        resetFunc = func;
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Uninitialized storage for one T
+    void* allocate() {
+        checkOwner();
+        if (!freeList) grow();
+        Slot* slot = freeList;
+        freeList = slot->next;
+        inUse++;
+        allocations++;
+        if (inUse > peakInUse) peakInUse = inUse;
+        return slot->storage;
     }
-    
-    // Pre-allocate objects
-    void reserve(size_t count) {
-        for (size_t i = 0; i < count && currentSize < maxSize; ++i) {
-            auto obj = std::make_unique<T>();
-            available.push(obj.get());
-            pool.push_back(std::move(obj));
-            currentSize++;
+
+    // Storage from allocate(); the object must already be destroyed
+    void deallocate(void* memory) {
+        if (!memory) return;
+        checkOwner();
+        if (!GAME_CHECK_AT(ErrorSeverity::ERROR, ErrorType::MEMORY_ERROR, owns(memory),
+                           "pool slot %p freed on thread %zx is not from this thread's pool",
+                           memory, threadTag(std::this_thread::get_id()))) {
+            return;
         }
+        Slot* slot = reinterpret_cast<Slot*>(memory);
+        slot->next = freeList;
+        freeList = slot;
+        inUse--;
     }
-    
-    // Get object from pool (with constructor arguments)
+
+    // Construct in pool storage, for owners that do not go through
+    // T's operator new
+    struct Deleter {
+        ObjectPool* pool;
+        void operator()(T* object) const {
+            if (!object) return;
+            object->~T();
+            pool->deallocate(object);
+        }
+    };
+    using UniquePtr = std::unique_ptr<T, Deleter>;
+
     template<typename... Args>
     UniquePtr acquire(Args&&... args) {
-        T* obj = nullptr;
-        
-        if (!available.empty()) {
-            // Reuse existing object
-            obj = available.front();
-            available.pop();
-            
-            // Reconstruct in-place
-            obj->~T();
-            new(obj) T(std::forward<Args>(args)...);
-        } else if (currentSize < maxSize) {
-            // Create new object
-            auto newObj = std::make_unique<T>(std::forward<Args>(args)...);
-            obj = newObj.release();
-            currentSize++;
-        } else {
-            // Pool exhausted, create temporary object
-            // This will be deleted normally, not returned to pool
-            return UniquePtr(new T(std::forward<Args>(args)...), PoolDeleter{nullptr});
-        }
-        
-        return UniquePtr(obj, PoolDeleter{this});
+        void* memory = allocate();
+        return UniquePtr(new (memory) T(std::forward<Args>(args)...), Deleter{this});
     }
-    
-    // Return object to pool
-    void returnObject(T* obj) {
-        if (!obj || available.size() >= maxSize) {
-            delete obj;
-            return;
-        }
-        
-        // Reset object state
-        if (resetFunc) {
-            resetFunc(obj);
-        } else {
-            // Default reset: call reset method if it exists
-            if constexpr (requires { obj->reset(); }) {
-                obj->reset();
-            }
-        }
-        
-        available.push(obj);
+
+    // Add slabs until at least count slots exist
+    void reserve(size_t count) {
+        while (capacity < count) grow();
     }
-    
-    // Get pool statistics
-    size_t getAvailableCount() const { return available.size(); }
-    size_t getTotalCount() const { return currentSize; }
-    size_t getInUseCount() const { return currentSize - available.size(); }
-    
-    // Clear all objects
-    void clear() {
-        while (!available.empty()) {
-            available.pop();
+
+    Stats getStats() const {
+        return {capacity, inUse, peakInUse, slabs.size(), allocations};
+    }
+    size_t getInUseCount() const { return inUse; }
+    size_t getCapacity() const { return capacity; }
+
+    // Whether memory is a slot of this pool's slabs
+    bool owns(const void* memory) const {
+        const Slot* slot = static_cast<const Slot*>(memory);
+        for (const auto& slab : slabs) {
+            if (slot >= slab.get() && slot < slab.get() + slotsPerSlab) return true;
         }
-        pool.clear();
-        currentSize = 0;
+        return false;
     }
-    
-    ~ObjectPool() {
-        clear();
+
+private:
+    static size_t threadTag(std::thread::id id) { return std::hash<std::thread::id>()(id); }
+
+    void checkOwner() const {
+        GAME_ASSERT(owner == std::this_thread::get_id(),
+                    "pool of thread %zx used from thread %zx",
+                    threadTag(owner), threadTag(std::this_thread::get_id()));
     }
 };
 
-// Specialized pool for POD types with faster allocation
+// Helpers for class-specific operator new/delete. A subclass that does not
+// declare its own pair would arrive here with a different size and is sent to
+// the global heap instead of overrunning a slot.
 template<typename T>
-class FastObjectPool {
-    static_assert(std::is_trivially_copyable_v<T>, 
-                  "FastObjectPool only works with POD types");
-    
-private:
-    std::vector<T> storage;
-    std::vector<T*> available;
-    size_t maxSize;
-    
-public:
-    explicit FastObjectPool(size_t initialSize = 100, size_t maxSize = 1000)
-        : maxSize(maxSize) {
-        reserve(initialSize);
-    }
-    
-    void reserve(size_t count) {
-        size_t oldSize = storage.size();
-        storage.resize(oldSize + count);
-        
-        for (size_t i = oldSize; i < storage.size(); ++i) {
-            available.push_back(&storage[i]);
-        }
-    }
-    
-    T* acquire() {
-        if (available.empty()) {
-            if (storage.size() < maxSize) {
-                reserve(std::min(size_t(100), maxSize - storage.size()));
-            } else {
-                return nullptr;
-            }
-        }
-        
-        T* obj = available.back();
-        available.pop_back();
-        *obj = T{}; // Reset to default
-        return obj;
-    }
-    
-    void release(T* obj) {
-        if (obj >= &storage[0] && obj < &storage[0] + storage.size()) {
-            available.push_back(obj);
-        }
+inline void* poolAllocate(ObjectPool<T>& pool, size_t size) {
+    return size == sizeof(T) ? pool.allocate() : ::operator new(size);
+}
+
+template<typename T>
+inline void poolDeallocate(ObjectPool<T>& pool, void* memory, size_t size) {
+    if (size == sizeof(T)) {
+        pool.deallocate(memory);
+    } else {
+        ::operator delete(memory);
     }
-    
-    size_t getAvailableCount() const { return available.size(); }
-    size_t getTotalCount() const { return storage.size(); }
-};
+}
 
-// Global pools for common entity types
+// Pool statistics for the entity types that use pools
 namespace Pools {
-    extern ObjectPool<class Projectile> projectilePool;
-    extern ObjectPool<class Particle> particlePool;
-    extern FastObjectPool<struct CollisionPair> collisionPool;
+    // Sets stats.pools = {projectiles, enemies, wolves}, each
+    // {capacity, inUse, peak, slabs, allocations}
+    void exportStatistics(emscripten::val& stats);
 }
 
-#endif // OBJECT_POOL_H
\ No newline at end of file
+#endif // OBJECT_POOL_H
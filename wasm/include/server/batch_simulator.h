@@ -0,0 +1,347 @@
+#ifndef BATCH_SIMULATOR_H
+#define BATCH_SIMULATOR_H
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "../game_engine.h"
+#include "../systems/obstacle_generator.h"
+#include "../systems/gameplay_events.h"
+#include "../utils/handle_table.h"
+#include "../utils/platform.h"
+
+// Headless batch of matches for balance sweeps and bot training
+//
+// run() plays Settings::matches independent matches, one GameEngine each,
+// as fast as the CPU allows: there is no tick clock, a match is stepped in
+// a tight loop until the player dies or maxSeconds of simulated time pass.
+// Matches are dealt round-robin to Settings::workers threads (1 runs them on
+// the calling thread, the only option without pthreads); like MatchHost,
+// each engine is built and destroyed on the thread that steps it, so its
+// pooled entities stay in that thread's slabs.
+//
+// Everything read-only is shared rather than per match: the Config
+// constants, the policy, and with a layoutSeed one obstacle layout that
+// every engine places instead of generating its own (so a sweep compares
+// runs on the same map). Match m is seeded with baseSeed + m, so any single
+// match can be replayed on its own.
+//
+// A policy drives the player before every tick. The default, kitePolicy,
+// keeps its distance from the nearest enemy, shoots at it and swings the
+// sword at anything in reach; turretPolicy fights the same way without
+// moving. Per-match outcomes are collected from the
+// gameplay event stream into the flat arrays of Results, one entry per
+// match, ready to be handed to JS or written out as columns.
+class BatchSimulator {
+public:
+    // Input for one tick; bot is the match's own random stream
+    using Policy = void (*)(GameEngine& engine, uint32_t tick, SimRandom& bot, void* user);
+
+    struct Settings {
+        int matches = 100;
+        int workers = 1;
+        uint32_t baseSeed = SimRandom::DEFAULT_SEED;
+        uint32_t layoutSeed = 0;       // 0 = every match generates its own obstacles
+        int obstacleCount = 10;        // For the shared layout
+        float worldWidth = 2000.0f;
+        float worldHeight = 2000.0f;
+        float tickRate = Config::SIMULATION_TICK_RATE;
+        float maxSeconds = 300.0f;     // Simulated time per match at most
+        Policy policy = nullptr;       // null = kitePolicy
+        void* policyUser = nullptr;
+    };
+
+    // One entry per match, in match order
+    struct Results {
+        std::vector<uint32_t> seed;
+        std::vector<int32_t> waveReached;
+        std::vector<float> secondsSurvived;
+        std::vector<uint8_t> died;              // 1 when the player ran out of lives
+        std::vector<float> damageTaken;         // After blocks
+        std::vector<float> damageDealt;         // By the player
+        std::vector<int32_t> kills;             // Credited to the player
+        std::vector<int32_t> timedKills;        // Enemy and wolf kills seen from their first hit
+        std::vector<float> meanTimeToKillMs;    // First hit to kill over timedKills; 0 without them
+        std::vector<int32_t> score;
+
+        void resize(size_t count) {
+            seed.assign(count, 0);
+            waveReached.assign(count, 0);
+            secondsSurvived.assign(count, 0);
+            died.assign(count, 0);
+            damageTaken.assign(count, 0);
+            damageDealt.assign(count, 0);
+            kills.assign(count, 0);
+            timedKills.assign(count, 0);
+            meanTimeToKillMs.assign(count, 0);
+            score.assign(count, 0);
+        }
+        size_t size() const { return seed.size(); }
+    };
+
+    struct Summary {
+        int matches;
+        double meanWave;
+        int maxWave;
+        double meanSeconds;
+        double deathRate;
+        double meanDamageTaken;
+        int matchesWithKills;       // Matches with at least one timed kill
+        double meanTimeToKillMs;    // Over those matches; 0 when there are none
+        double wallMs;              // Whole run
+        double ticksPerSecond;      // Simulated ticks per wall second, all workers
+    };
+
+private:
+    // First hit on an entity, by handle slot; a kill closes it
+    struct Engagement {
+        int32_t id;
+        uint32_t tick;
+    };
+
+    Settings settings;
+    Results results;
+    std::vector<ObstacleGenerator::Placement> layout;
+    std::atomic<uint64_t> ticksRun{0};
+    double wallMs = 0;
+
+    void runMatch(size_t index, std::vector<Engagement>& engagements) {
+        uint32_t matchSeed = settings.baseSeed + static_cast<uint32_t>(index);
+        GameEngine engine(settings.worldWidth, settings.worldHeight, 0);
+        engine.setSeed(matchSeed);
+        engine.setFixedTimestep(settings.tickRate, 1);
+        engine.setAdaptiveQuality(false);
+        engine.setObstacleLayout(settings.layoutSeed ? &layout : nullptr);
+        engine.startGame();
+
+        Policy policy = settings.policy ? settings.policy : &kitePolicy;
+        SimRandom bot(matchSeed, 1);
+        const float dt = engine.getFixedTimestep();
+        const uint32_t maxTicks = static_cast<uint32_t>(settings.maxSeconds * settings.tickRate);
+        const int playerId = engine.getPlayerId();
+
+        float taken = 0, dealt = 0;
+        int kills = 0, timedKills = 0;
+        double killTicks = 0;
+        engagements.clear();
+
+        // Outcomes from the event queue, from index `from` on, as of tick `at`
+        const EventQueue& events = engine.getGameplayEventQueue();
+        auto tally = [&](size_t from, uint32_t at) {
+            using Type = GameplayEvent::Type;
+            for (size_t e = from; e < events.size(); e++) {
+                const GameplayEvent& event = events[e];
+                if (event.type == Type::PLAYER_HIT) {
+                    taken += event.amount;
+                } else if (event.type == Type::HIT) {
+                    if (event.sourceId == playerId) dealt += event.amount;
+                    size_t slot = static_cast<uint32_t>(event.targetId) & HandleTable::INDEX_MASK;
+                    if (slot >= engagements.size()) engagements.resize(slot + 1, {-1, 0});
+                    if (engagements[slot].id != event.targetId) engagements[slot] = {event.targetId, at};
+                } else if (event.type == Type::KILL) {
+                    if (event.sourceId == playerId) kills++;
+                    size_t slot = static_cast<uint32_t>(event.targetId) & HandleTable::INDEX_MASK;
+                    if (slot < engagements.size() && engagements[slot].id == event.targetId) {
+                        killTicks += at - engagements[slot].tick;
+                        timedKills++;
+                        engagements[slot].id = -1;
+                    }
+                }
+            }
+        };
+
+        uint32_t tick = 0;
+        while (tick < maxTicks && !engine.isGameOver()) {
+            // Actions that resolve at once (a sword swing) report into the
+            // queue update() is about to clear
+            size_t queued = events.size();
+            policy(engine, tick, bot, settings.policyUser);
+            tally(queued, tick + 1);
+            engine.update(dt);
+            tick++;
+            tally(0, tick);
+        }
+
+        results.seed[index] = matchSeed;
+        results.waveReached[index] = engine.getWaveNumber();
+        results.secondsSurvived[index] = tick * dt;
+        results.died[index] = engine.isGameOver() ? 1 : 0;
+        results.damageTaken[index] = taken;
+        results.damageDealt[index] = dealt;
+        results.kills[index] = kills;
+        results.timedKills[index] = timedKills;
+        results.meanTimeToKillMs[index] = timedKills ? static_cast<float>(killTicks / timedKills * dt * 1000.0) : 0.0f;
+        results.score[index] = engine.getScore();
+        ticksRun.fetch_add(tick, std::memory_order_relaxed);
+    }
+
+    void runWorker(int worker, int workerCount) {
+        std::vector<Engagement> engagements;
+        for (size_t m = static_cast<size_t>(worker); m < results.size(); m += workerCount) {
+            runMatch(m, engagements);
+        }
+    }
+
+public:
+    BatchSimulator() : BatchSimulator(Settings()) {}
+    explicit BatchSimulator(const Settings& batchSettings) { configure(batchSettings); }
+
+    BatchSimulator(const BatchSimulator&) = delete;
+    BatchSimulator& operator=(const BatchSimulator&) = delete;
+
+    void configure(const Settings& batchSettings) {
+        settings = batchSettings;
+        settings.matches = std::max(settings.matches, 0);
+        settings.workers = std::max(settings.workers, 1);
+        settings.tickRate = std::max(settings.tickRate, 1.0f);
+        settings.maxSeconds = std::max(settings.maxSeconds, 0.0f);
+    }
+    const Settings& getSettings() const { return settings; }
+
+    // Plays every match and returns when the last one ends. Results from a
+    // previous run are replaced.
+    const Results& run() {
+        results.resize(static_cast<size_t>(settings.matches));
+        ticksRun.store(0, std::memory_order_relaxed);
+        buildLayout();
+
+        double start = Platform::now();
+        int workerCount = std::min(settings.workers, std::max(settings.matches, 1));
+        if (workerCount == 1) {
+            runWorker(0, 1);
+        } else {
+            // Each worker writes only its own matches' entries
+            std::vector<std::thread> threads;
+            for (int w = 0; w < workerCount; w++) {
+                threads.emplace_back([this, w, workerCount]() { runWorker(w, workerCount); });
+            }
+            for (std::thread& thread : threads) thread.join();
+        }
+        wallMs = Platform::now() - start;
+        return results;
+    }
+
+    const Results& getResults() const { return results; }
+    const std::vector<ObstacleGenerator::Placement>& getLayout() const { return layout; }
+
+    Summary summarize() const {
+        Summary s = {static_cast<int>(results.size()), 0, 0, 0, 0, 0, 0, 0, wallMs, 0};
+        for (size_t m = 0; m < results.size(); m++) {
+            s.meanWave += results.waveReached[m];
+            s.maxWave = std::max(s.maxWave, static_cast<int>(results.waveReached[m]));
+            s.meanSeconds += results.secondsSurvived[m];
+            s.deathRate += results.died[m];
+            s.meanDamageTaken += results.damageTaken[m];
+            if (results.timedKills[m] > 0) {
+                s.meanTimeToKillMs += results.meanTimeToKillMs[m];
+                s.matchesWithKills++;
+            }
+        }
+        if (s.matches > 0) {
+            s.meanWave /= s.matches;
+            s.meanSeconds /= s.matches;
+            s.deathRate /= s.matches;
+            s.meanDamageTaken /= s.matches;
+        }
+        if (s.matchesWithKills > 0) s.meanTimeToKillMs /= s.matchesWithKills;
+        if (wallMs > 0) s.ticksPerSecond = ticksRun.load(std::memory_order_relaxed) / (wallMs / 1000.0);
+        return s;
+    }
+
+    // Backs away from the nearest enemy or wolf inside 200 units and circles
+    // otherwise; shoots at it every few ticks and attacks it in sword reach
+    static void kitePolicy(GameEngine& engine, uint32_t tick, SimRandom& bot, void*) {
+        const Entity* self = findPlayer(engine);
+        if (!self) return;
+        float nearestSq = 0;
+        const Entity* nearest = findNearestThreat(engine, *self, nearestSq);
+
+        float angle = tick * 0.02f;
+        if (!nearest) {
+            engine.updatePlayerInput(std::cos(angle), std::sin(angle),
+                                     self->position.x + std::cos(angle), self->position.y + std::sin(angle));
+            return;
+        }
+        float dx = nearest->position.x - self->position.x, dy = nearest->position.y - self->position.y;
+        float distance = std::sqrt(nearestSq);
+        float moveX = std::cos(angle), moveY = std::sin(angle);
+        if (distance < 200.0f && distance > 0.0f) {
+            moveX = -dx / distance;
+            moveY = -dy / distance;
+        }
+        engine.updatePlayerInput(moveX, moveY, nearest->position.x, nearest->position.y);
+        if (distance <= Config::SWORD_RANGE) {
+            engine.performAttack(engine.getPlayerId(), std::atan2(dy, dx));
+        } else if (bot.nextInt(6) == 0) {
+            engine.playerShoot(nearest->position.x, nearest->position.y);
+        }
+    }
+
+    // Holds its ground: never moves, shoots at the nearest enemy or wolf
+    // every few ticks and attacks it in sword reach. Unlike kitePolicy it
+    // gets hit, so it measures how hard the waves press a player who stands
+    // and fights.
+    static void turretPolicy(GameEngine& engine, uint32_t, SimRandom& bot, void*) {
+        const Entity* self = findPlayer(engine);
+        if (!self) return;
+        float nearestSq = 0;
+        const Entity* nearest = findNearestThreat(engine, *self, nearestSq);
+        if (!nearest) {
+            engine.updatePlayerInput(0, 0, self->position.x + 1, self->position.y);
+            return;
+        }
+        float dx = nearest->position.x - self->position.x, dy = nearest->position.y - self->position.y;
+        engine.updatePlayerInput(0, 0, nearest->position.x, nearest->position.y);
+        if (std::sqrt(nearestSq) <= Config::SWORD_RANGE) {
+            engine.performAttack(engine.getPlayerId(), std::atan2(dy, dx));
+        } else if (bot.nextInt(6) == 0) {
+            engine.playerShoot(nearest->position.x, nearest->position.y);
+        }
+    }
+
+private:
+    // The engine's player while it is in play
+    static const Entity* findPlayer(const GameEngine& engine) {
+        int playerId = engine.getPlayerId();
+        for (const auto& entity : engine.getEntities()) {
+            if (entity->id == playerId) return entity->active ? entity.get() : nullptr;
+        }
+        return nullptr;
+    }
+
+    // Closest live enemy or wolf, with its squared distance
+    static const Entity* findNearestThreat(const GameEngine& engine, const Entity& self, float& nearestSq) {
+        const Entity* nearest = nullptr;
+        for (const auto& entity : engine.getEntities()) {
+            if (!entity->active || (entity->type != EntityType::ENEMY && entity->type != EntityType::WOLF)) continue;
+            float dx = entity->position.x - self.position.x, dy = entity->position.y - self.position.y;
+            float distSq = dx * dx + dy * dy;
+            if (!nearest || distSq < nearestSq) {
+                nearest = entity.get();
+                nearestSq = distSq;
+            }
+        }
+        return nearest;
+    }
+
+    // The shared layout, placed the way startGame() generates one
+    void buildLayout() {
+        layout.clear();
+        if (!settings.layoutSeed) return;
+        ObstacleGenerator::Params params;
+        params.worldWidth = settings.worldWidth;
+        params.worldHeight = settings.worldHeight;
+        params.safeCenter = Vector2(settings.worldWidth / 2, settings.worldHeight / 2);
+        params.safeRadius = Config::OBSTACLE_SPAWN_CLEARANCE;
+        params.gap = Config::OBSTACLE_PASSAGE_WIDTH;
+        params.count = settings.obstacleCount;
+        SimRandom rng(settings.layoutSeed);
+        ObstacleGenerator::generate(params, rng, nullptr,
+            [this](const ObstacleGenerator::Placement& p) { layout.push_back(p); });
+    }
+};
+
+#endif // BATCH_SIMULATOR_H
@@ -0,0 +1,348 @@
+#ifndef MATCH_HOST_H
+#define MATCH_HOST_H
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include "../game_engine.h"
+#include "../systems/command_buffer.h"
+#include "../systems/state_codec.h"
+#include "../utils/platform.h"
+
+// Headless host running many matches in one native process
+//
+// Every match is its own GameEngine, single-threaded inside (no job
+// workers), and is pinned for life to one of the host's worker threads: the
+// least loaded one when it was created. Pinning keeps a match's entities in
+// the slab pools of the thread that made them and makes density a plain
+// number, matches per worker. Each worker wakes once per tick, drains its
+// matches' input into their command rings, runs update() and encodes one
+// state packet per client with that client's own StateCodec, against the last
+// sequence the client acknowledged.
+//
+// A match whose update() runs past Settings::tickBudgetMs is counted as an
+// overrun. A worker that falls behind passes the real elapsed time on, and
+// the engine's substep budget drops what it cannot catch up, so a slow match
+// costs its neighbours at most a few ticks.
+//
+// submit(), acknowledge() and the match calls may come from any thread, but
+// not concurrently with start() or stop(); the packet sink runs on the
+// match's worker thread.
+class MatchHost {
+public:
+    struct Settings {
+        int workers = 1;
+        float tickRate = Config::SIMULATION_TICK_RATE;
+        float tickBudgetMs = 4.0f;     // Per match and tick
+        float worldWidth = 2000.0f;
+        float worldHeight = 2000.0f;
+    };
+
+    // (match id, client id, packet); the bytes are only valid during the call
+    using PacketSink = std::function<void(int, int, const uint8_t*, size_t)>;
+
+    struct Stats {
+        int matches;
+        int clients;
+        uint64_t ticks;            // Match updates run
+        uint64_t overruns;         // Updates slower than the tick budget
+        uint64_t packets;
+        uint64_t packetBytes;
+        double busyMs;             // Worker time spent in updates and encoding
+        double maxTickMs;          // Slowest single match update
+    };
+
+    static constexpr int MAX_CLIENTS_PER_MATCH = 8;
+
+private:
+    struct Client {
+        StateCodec codec;
+        std::atomic<uint32_t> acked{0};
+    };
+
+    struct Match {
+        int id;
+        uint32_t seed;
+        std::unique_ptr<GameEngine> engine;   // Built on the worker thread
+        std::atomic<int> playerId{-1};
+        std::atomic<int> clientCount{0};
+        std::unique_ptr<Client> clients[MAX_CLIENTS_PER_MATCH];
+        std::atomic<bool> ending{false};
+        std::atomic<bool> over{false};         // Game over; the host decides what follows
+
+        std::mutex inboxMutex;
+        std::vector<CommandBuffer::Command> inbox;
+        std::vector<CommandBuffer::Command> draining;
+    };
+
+    struct Worker {
+        std::thread thread;
+        std::vector<std::shared_ptr<Match>> matches;   // Only touched by the thread
+        std::mutex mutex;                              // Guards adopting
+        std::vector<std::shared_ptr<Match>> adopting;
+        std::atomic<int> load{0};
+
+        std::atomic<uint64_t> ticks{0};
+        std::atomic<uint64_t> overruns{0};
+        std::atomic<uint64_t> packets{0};
+        std::atomic<uint64_t> packetBytes{0};
+        std::atomic<uint64_t> busyMicros{0};
+        std::atomic<uint64_t> maxTickMicros{0};
+    };
+
+    Settings settings;
+    PacketSink sink;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> running{false};
+    std::atomic<int> nextMatchId{1};
+
+    std::mutex registryMutex;                      // Guards registry
+    std::vector<std::shared_ptr<Match>> registry;
+
+    std::shared_ptr<Match> findMatch(int matchId) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const auto& match : registry) {
+            if (match->id == matchId) return match;
+        }
+        return nullptr;
+    }
+
+    void startMatch(Match& match) {
+        match.engine = std::make_unique<GameEngine>(settings.worldWidth, settings.worldHeight, 0);
+        match.engine->setSeed(match.seed);
+        match.engine->setFixedTimestep(settings.tickRate, Config::MAX_SUBSTEPS);
+        // An authoritative match keeps its full substep budget whatever the
+        // host's load; there is nothing to render
+        match.engine->setAdaptiveQuality(false);
+        match.engine->startGame();
+        match.playerId.store(match.engine->getPlayerId(), std::memory_order_release);
+    }
+
+    void tickMatch(Worker& worker, Match& match, float deltaSeconds) {
+        GameEngine& engine = *match.engine;
+        {
+            std::lock_guard<std::mutex> lock(match.inboxMutex);
+            match.draining.swap(match.inbox);
+        }
+        CommandBuffer& commands = engine.getCommands();
+        for (const CommandBuffer::Command& command : match.draining) {
+            commands.push(command);
+        }
+        match.draining.clear();
+
+        double start = Platform::now();
+        engine.update(deltaSeconds);
+        double updateMs = Platform::now() - start;
+        if (engine.isGameOver()) match.over.store(true, std::memory_order_release);
+
+        int clients = match.clientCount.load(std::memory_order_acquire);
+        for (int c = 0; c < clients; c++) {
+            Client& client = *match.clients[c];
+            const std::vector<uint8_t>& packet =
+                client.codec.encode(engine.getEntities(), client.acked.load(std::memory_order_acquire));
+            worker.packets.fetch_add(1, std::memory_order_relaxed);
+            worker.packetBytes.fetch_add(packet.size(), std::memory_order_relaxed);
+            if (sink) sink(match.id, c, packet.data(), packet.size());
+        }
+        double totalMs = Platform::now() - start;
+
+        uint64_t tickMicros = static_cast<uint64_t>(updateMs * 1000.0);
+        worker.ticks.fetch_add(1, std::memory_order_relaxed);
+        worker.busyMicros.fetch_add(static_cast<uint64_t>(totalMs * 1000.0), std::memory_order_relaxed);
+        if (updateMs > settings.tickBudgetMs) worker.overruns.fetch_add(1, std::memory_order_relaxed);
+        if (tickMicros > worker.maxTickMicros.load(std::memory_order_relaxed)) {
+            worker.maxTickMicros.store(tickMicros, std::memory_order_relaxed);
+        }
+    }
+
+    void workerLoop(Worker& worker) {
+        using Clock = std::chrono::steady_clock;
+        const auto tick = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / settings.tickRate));
+        auto last = Clock::now();
+        auto next = last + tick;
+
+        while (running.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_until(next);
+            auto now = Clock::now();
+            float elapsed = std::chrono::duration<float>(now - last).count();
+            last = now;
+            // Behind by more than a tick: resync instead of bursting
+            next = std::max(next + tick, now);
+
+            std::vector<std::shared_ptr<Match>> adopted;
+            {
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                adopted.swap(worker.adopting);
+            }
+            // Engines (and their pooled entities) belong to this thread
+            for (auto& match : adopted) {
+                startMatch(*match);
+                worker.matches.push_back(std::move(match));
+            }
+
+            for (size_t i = 0; i < worker.matches.size();) {
+                Match& match = *worker.matches[i];
+                if (match.ending.load(std::memory_order_acquire)) {
+                    match.engine.reset();
+                    worker.matches[i] = std::move(worker.matches.back());
+                    worker.matches.pop_back();
+                    worker.load.fetch_sub(1, std::memory_order_relaxed);
+                    continue;
+                }
+                tickMatch(worker, match, elapsed);
+                i++;
+            }
+        }
+
+        for (auto& match : worker.matches) match->engine.reset();
+        worker.matches.clear();
+    }
+
+public:
+    MatchHost() : MatchHost(Settings()) {}
+    explicit MatchHost(const Settings& hostSettings) : settings(hostSettings) {
+        settings.workers = std::max(settings.workers, 1);
+        settings.tickRate = std::max(settings.tickRate, 1.0f);
+    }
+
+    ~MatchHost() { stop(); }
+
+    MatchHost(const MatchHost&) = delete;
+    MatchHost& operator=(const MatchHost&) = delete;
+
+    // Set before start()
+    void setPacketSink(PacketSink packetSink) { sink = std::move(packetSink); }
+
+    void start() {
+        if (running.exchange(true)) return;
+        for (int i = 0; i < settings.workers; i++) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+        for (auto& worker : workers) {
+            Worker* owned = worker.get();
+            owned->thread = std::thread([this, owned]() { workerLoop(*owned); });
+        }
+    }
+
+    // Ends every match; the engines are destroyed on their own threads
+    void stop() {
+        if (!running.exchange(false)) return;
+        for (auto& worker : workers) worker->thread.join();
+        workers.clear();
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.clear();
+    }
+
+    // Queues a new match on the least loaded worker; it starts ticking from
+    // the worker's next wake-up. Returns the match id, or -1 when stopped.
+    int createMatch(uint32_t seed) {
+        if (!running.load(std::memory_order_acquire)) return -1;
+        auto match = std::make_shared<Match>();
+        match->id = nextMatchId.fetch_add(1, std::memory_order_relaxed);
+        match->seed = seed;
+
+        Worker* target = workers.front().get();
+        for (auto& worker : workers) {
+            if (worker->load.load(std::memory_order_relaxed) < target->load.load(std::memory_order_relaxed)) {
+                target = worker.get();
+            }
+        }
+        target->load.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            registry.push_back(match);
+        }
+        std::lock_guard<std::mutex> lock(target->mutex);
+        target->adopting.push_back(match);
+        return match->id;
+    }
+
+    void endMatch(int matchId) {
+        std::shared_ptr<Match> match;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            auto it = std::find_if(registry.begin(), registry.end(),
+                                   [matchId](const std::shared_ptr<Match>& m) { return m->id == matchId; });
+            if (it == registry.end()) return;
+            match = *it;
+            registry.erase(it);
+        }
+        match->ending.store(true, std::memory_order_release);
+    }
+
+    // A client receiving this match's state; returns its id within the
+    // match, or -1 when the match is gone or full
+    int addClient(int matchId) {
+        std::shared_ptr<Match> match = findMatch(matchId);
+        if (!match) return -1;
+        std::lock_guard<std::mutex> lock(match->inboxMutex);
+        int index = match->clientCount.load(std::memory_order_relaxed);
+        if (index >= MAX_CLIENTS_PER_MATCH) return -1;
+        match->clients[index] = std::make_unique<Client>();
+        match->clients[index]->codec.setWorldBounds(settings.worldWidth, settings.worldHeight);
+        match->clientCount.store(index + 1, std::memory_order_release);
+        return index;
+    }
+
+    // The last state packet the client decoded; 0 asks for a keyframe
+    void acknowledge(int matchId, int clientId, uint32_t sequence) {
+        std::shared_ptr<Match> match = findMatch(matchId);
+        if (!match || clientId < 0 || clientId >= match->clientCount.load(std::memory_order_acquire)) return;
+        match->clients[clientId]->acked.store(sequence, std::memory_order_release);
+    }
+
+    // Input for the match's next tick. The match is authoritative for who
+    // acts: the command always drives the match's own player.
+    bool submit(int matchId, CommandBuffer::Command command) {
+        std::shared_ptr<Match> match = findMatch(matchId);
+        if (!match) return false;
+        command.id = match->playerId.load(std::memory_order_acquire);
+        if (command.id < 0) return false;
+        std::lock_guard<std::mutex> lock(match->inboxMutex);
+        if (match->inbox.size() >= CommandBuffer::CAPACITY) return false;
+        match->inbox.push_back(command);
+        return true;
+    }
+
+    bool isMatchOver(int matchId) {
+        std::shared_ptr<Match> match = findMatch(matchId);
+        return match && match->over.load(std::memory_order_acquire);
+    }
+    
+    // -1 until the match has started on its worker
+    int getPlayerId(int matchId) {
+        std::shared_ptr<Match> match = findMatch(matchId);
+        return match ? match->playerId.load(std::memory_order_acquire) : -1;
+    }
+
+    Stats getStats() {
+        Stats stats = {0, 0, 0, 0, 0, 0, 0, 0};
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            stats.matches = static_cast<int>(registry.size());
+            for (const auto& match : registry) stats.clients += match->clientCount.load(std::memory_order_relaxed);
+        }
+        for (const auto& worker : workers) {
+            stats.ticks += worker->ticks.load(std::memory_order_relaxed);
+            stats.overruns += worker->overruns.load(std::memory_order_relaxed);
+            stats.packets += worker->packets.load(std::memory_order_relaxed);
+            stats.packetBytes += worker->packetBytes.load(std::memory_order_relaxed);
+            stats.busyMs += worker->busyMicros.load(std::memory_order_relaxed) / 1000.0;
+            stats.maxTickMs = std::max(stats.maxTickMs,
+                                       worker->maxTickMicros.load(std::memory_order_relaxed) / 1000.0);
+        }
+        return stats;
+    }
+
+    int getWorkerCount() const { return settings.workers; }
+    const Settings& getSettings() const { return settings; }
+};
+
+#endif // MATCH_HOST_H
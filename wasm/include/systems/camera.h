@@ -0,0 +1,62 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <algorithm>
+#include "../math/vector2.h"
+
+// Viewport that follows a target through the world
+//
+// (x, y) is the top-left corner in world units. update() eases toward
+// centering the target and keeps the view inside the world; a world smaller
+// than the viewport pins the view to the origin. Presentation only: the
+// simulation never reads it, so it is not part of recorded state.
+class Camera {
+public:
+    float x, y;           // Top-left corner
+    float width, height;  // Viewport size
+    float smoothing;      // Fraction of the remaining distance covered per update
+
+    Camera() : x(0), y(0), width(800), height(600), smoothing(0.1f) {}
+    Camera(float w, float h) : x(0), y(0), width(w), height(h), smoothing(0.1f) {}
+
+    void update(float targetX, float targetY, float worldWidth, float worldHeight) {
+        float desiredX = targetX - width / 2;
+        float desiredY = targetY - height / 2;
+
+        x += (desiredX - x) * smoothing;
+        y += (desiredY - y) * smoothing;
+
+        x = std::max(0.0f, std::min(worldWidth - width, x));
+        y = std::max(0.0f, std::min(worldHeight - height, y));
+    }
+
+    // Jump straight to the target (spawn, restart)
+    void snapTo(float targetX, float targetY, float worldWidth, float worldHeight) {
+        float previous = smoothing;
+        smoothing = 1.0f;
+        update(targetX, targetY, worldWidth, worldHeight);
+        smoothing = previous;
+    }
+
+    void setViewport(float w, float h) {
+        width = w;
+        height = h;
+    }
+
+    Vector2 worldToScreen(float worldX, float worldY) const {
+        return Vector2(worldX - x, worldY - y);
+    }
+
+    Vector2 screenToWorld(float screenX, float screenY) const {
+        return Vector2(screenX + x, screenY + y);
+    }
+
+    bool isOnScreen(float worldX, float worldY, float radius = 0) const {
+        return worldX + radius >= x &&
+               worldX - radius <= x + width &&
+               worldY + radius >= y &&
+               worldY - radius <= y + height;
+    }
+};
+
+#endif // CAMERA_H
@@ -0,0 +1,336 @@
+#ifndef CHUNK_MANAGER_H
+#define CHUNK_MANAGER_H
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include "../entities/entity.h"
+#include "../config/game_config.h"
+#include "../utils/bit_stream.h"
+#include "../utils/sim_context.h"
+
+// Streamed world: square chunks generated on demand and frozen when left
+//
+// The world is cut into chunks of chunkSize world units. Only the live window
+// - the player's chunk and loadRadius chunks around it - holds entities and
+// is simulated; the keep window, one chunk wider, is where entities may
+// wander before they are frozen, so standing on a chunk border does not
+// thrash. A chunk's content is generated from the world seed and its
+// coordinates the first time it enters the live window, independent of the
+// order chunks are visited in. Whatever is in a chunk when it leaves the keep
+// window is serialized into it (RECORD_BYTES per entity) and rebuilt from
+// those bytes when it comes back, so kills and damage persist while the
+// memory and per-tick cost stay proportional to the play area.
+//
+// The manager only tracks chunk records and converts between Spawn
+// descriptors and bytes; GameEngine creates and removes the entities.
+class ChunkManager {
+public:
+    struct Coord {
+        int32_t x;
+        int32_t y;
+
+        bool operator==(const Coord& other) const { return x == other.x && y == other.y; }
+        bool operator!=(const Coord& other) const { return !(*this == other); }
+    };
+
+    struct Bounds {
+        float minX;
+        float minY;
+        float maxX;
+        float maxY;
+
+        float width() const { return maxX - minX; }
+        float height() const { return maxY - minY; }
+    };
+
+    // What is needed to rebuild an entity
+    struct Spawn {
+        EntityType type;
+        uint8_t variant;     // Obstacle shape, power-up type, 1 for an alpha wolf
+        bool destructible;   // Obstacles
+        float x;             // World position
+        float y;
+        float width;         // Obstacles; a circle's width is its diameter
+        float height;
+        float rotation;
+        float health;        // Fraction of max health
+    };
+
+    // type 3, variant 3, destructible 1, pad 1 | x 16 | y 16 (chunk-local) |
+    // width 12 | height 12 (quarter units) | rotation 8 | health 8
+    static constexpr size_t RECORD_BYTES = 10;
+
+private:
+    static constexpr float SIZE_QUANTUM = 0.25f;
+    static constexpr uint32_t SIZE_MAX_STEPS = (1u << 12) - 1;
+    static constexpr float TWO_PI = 6.28318530718f;
+
+    struct Chunk {
+        bool generated;              // Seeded content has been produced
+        bool loaded;                 // Entities are live in the engine
+        uint32_t storedCount;        // Records in stored
+        std::vector<uint8_t> stored;
+    };
+
+    std::unordered_map<uint64_t, Chunk> chunks;
+    std::vector<uint8_t> recordScratch;
+    uint32_t worldSeed;
+    float chunkSize;
+    int loadRadius;
+    int32_t cols;     // Chunks covering the world
+    int32_t rows;
+    Vector2 safePoint;  // Player spawn, kept clear of generated content
+    Coord center;
+    bool hasCenter;
+
+    static uint64_t key(Coord c) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(c.x)) << 32) | static_cast<uint32_t>(c.y);
+    }
+
+    // Stable per-chunk seed (murmur3 finalizer over seed and coordinates)
+    uint32_t chunkSeed(Coord c) const {
+        uint32_t h = worldSeed ^ (static_cast<uint32_t>(c.x) * 0x9E3779B1u) ^
+                     (static_cast<uint32_t>(c.y) * 0x85EBCA77u);
+        h ^= h >> 16;
+        h *= 0x85EBCA6Bu;
+        h ^= h >> 13;
+        h *= 0xC2B2AE35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+    Chunk& chunkAt(Coord c) {
+        return chunks.try_emplace(key(c), Chunk{false, false, 0, {}}).first->second;
+    }
+
+    bool inWindow(Coord c, int radius) const {
+        return hasCenter && std::abs(c.x - center.x) <= radius && std::abs(c.y - center.y) <= radius;
+    }
+
+    Bounds windowBounds(int radius) const {
+        int32_t x0 = std::max(0, center.x - radius);
+        int32_t y0 = std::max(0, center.y - radius);
+        int32_t x1 = std::min(cols - 1, center.x + radius);
+        int32_t y1 = std::min(rows - 1, center.y + radius);
+        return {x0 * chunkSize, y0 * chunkSize, (x1 + 1) * chunkSize, (y1 + 1) * chunkSize};
+    }
+
+    static uint32_t quantize(float value, float quantum, uint32_t maxSteps) {
+        float steps = std::round(value / quantum);
+        return static_cast<uint32_t>(std::clamp(steps, 0.0f, static_cast<float>(maxSteps)));
+    }
+
+    void encode(Coord c, const Spawn& spawn, Chunk& chunk) {
+        float localQuantum = chunkSize / 65536.0f;
+        float rotation = std::fmod(spawn.rotation, TWO_PI);
+        if (rotation < 0) rotation += TWO_PI;
+
+        BitWriter writer(recordScratch);
+        writer.write(static_cast<uint32_t>(spawn.type), 3);
+        writer.write(spawn.variant, 3);
+        writer.writeBool(spawn.destructible);
+        writer.write(0, 1);
+        writer.write(quantize(spawn.x - c.x * chunkSize, localQuantum, 0xFFFF), 16);
+        writer.write(quantize(spawn.y - c.y * chunkSize, localQuantum, 0xFFFF), 16);
+        writer.write(quantize(spawn.width, SIZE_QUANTUM, SIZE_MAX_STEPS), 12);
+        writer.write(quantize(spawn.height, SIZE_QUANTUM, SIZE_MAX_STEPS), 12);
+        writer.write(quantize(rotation, TWO_PI / 256.0f, 255), 8);
+        // A live entity never comes back with zero health
+        writer.write(std::max(1u, quantize(spawn.health, 1.0f / 255.0f, 255)), 8);
+        writer.finish();
+
+        chunk.stored.insert(chunk.stored.end(), recordScratch.begin(), recordScratch.end());
+        chunk.storedCount++;
+    }
+
+    void decode(Coord c, const Chunk& chunk, std::vector<Spawn>& out) const {
+        float localQuantum = chunkSize / 65536.0f;
+        for (uint32_t i = 0; i < chunk.storedCount; i++) {
+            BitReader reader(chunk.stored.data() + i * RECORD_BYTES, RECORD_BYTES);
+            Spawn spawn;
+            spawn.type = static_cast<EntityType>(reader.read(3));
+            spawn.variant = static_cast<uint8_t>(reader.read(3));
+            spawn.destructible = reader.readBool();
+            reader.read(1);
+            spawn.x = c.x * chunkSize + reader.read(16) * localQuantum;
+            spawn.y = c.y * chunkSize + reader.read(16) * localQuantum;
+            spawn.width = reader.read(12) * SIZE_QUANTUM;
+            spawn.height = reader.read(12) * SIZE_QUANTUM;
+            spawn.rotation = reader.read(8) * (TWO_PI / 256.0f);
+            spawn.health = reader.read(8) / 255.0f;
+            out.push_back(spawn);
+        }
+    }
+
+    // Seeded content: scattered obstacles, a few enemies and sometimes a
+    // power-up. Nothing is placed near the player spawn.
+    void generate(Coord c, std::vector<Spawn>& out) const {
+        SimRandom rng(chunkSeed(c));
+        float originX = c.x * chunkSize;
+        float originY = c.y * chunkSize;
+        float margin = Config::OBSTACLE_MAX_RADIUS;
+        float minSize = Config::OBSTACLE_MIN_RADIUS * 2;
+        float maxSize = Config::OBSTACLE_MAX_RADIUS * 2;
+        auto clearOfSpawn = [this](float x, float y, float radius) {
+            float dx = x - safePoint.x;
+            float dy = y - safePoint.y;
+            float clear = radius + Config::CHUNK_SAFE_RADIUS;
+            return dx * dx + dy * dy > clear * clear;
+        };
+
+        for (int i = 0; i < Config::CHUNK_OBSTACLES; i++) {
+            Spawn spawn = {EntityType::OBSTACLE, 0, rng.nextInt(100) < 30, 0, 0, 0, 0, 0, 1.0f};
+            spawn.x = originX + rng.range(margin, chunkSize - margin);
+            spawn.y = originY + rng.range(margin, chunkSize - margin);
+            int shape = rng.nextInt(3);
+            spawn.variant = static_cast<uint8_t>(shape);
+            spawn.width = rng.range(minSize, maxSize);
+            spawn.height = shape == 2 ? rng.range(minSize, maxSize) : spawn.width;
+            spawn.rotation = shape == 0 ? 0.0f : rng.range(0.0f, TWO_PI);
+            if (clearOfSpawn(spawn.x, spawn.y, std::max(spawn.width, spawn.height))) {
+                out.push_back(spawn);
+            }
+        }
+
+        for (int i = 0; i < Config::CHUNK_ENEMIES; i++) {
+            Spawn spawn = {EntityType::ENEMY, 0, false, 0, 0, 0, 0, 0, 1.0f};
+            spawn.x = originX + rng.range(margin, chunkSize - margin);
+            spawn.y = originY + rng.range(margin, chunkSize - margin);
+            if (clearOfSpawn(spawn.x, spawn.y, chunkSize * 0.5f)) {
+                out.push_back(spawn);
+            }
+        }
+
+        if (rng.nextInt(100) < Config::CHUNK_POWERUP_CHANCE) {
+            Spawn spawn = {EntityType::POWERUP, 0, false, 0, 0, 0, 0, 0, 1.0f};
+            spawn.variant = static_cast<uint8_t>(rng.nextInt(7));
+            spawn.x = originX + rng.range(margin, chunkSize - margin);
+            spawn.y = originY + rng.range(margin, chunkSize - margin);
+            out.push_back(spawn);
+        }
+    }
+
+public:
+    ChunkManager()
+        : worldSeed(0), chunkSize(Config::CHUNK_SIZE), loadRadius(Config::CHUNK_LOAD_RADIUS),
+          cols(1), rows(1), center{0, 0}, hasCenter(false) {}
+
+    // New world layout; drops every chunk record
+    void configure(uint32_t seed, float size, int radius, float worldWidth, float worldHeight) {
+        worldSeed = seed;
+        chunkSize = std::max(size, 2.0f * Config::OBSTACLE_MAX_RADIUS + 1.0f);
+        loadRadius = std::max(radius, 0);
+        setWorldBounds(worldWidth, worldHeight);
+        reset();
+    }
+
+    // Keeps the records; the windows are recomputed on the next setCenter()
+    void setWorldBounds(float worldWidth, float worldHeight) {
+        cols = std::max(1, static_cast<int32_t>(std::ceil(worldWidth / chunkSize)));
+        rows = std::max(1, static_cast<int32_t>(std::ceil(worldHeight / chunkSize)));
+        safePoint = Vector2(worldWidth / 2, worldHeight / 2);
+        hasCenter = false;
+    }
+
+    void setWorldSeed(uint32_t seed) { worldSeed = seed; }
+
+    // Forget all chunks; the world regenerates from the seed
+    void reset() {
+        chunks.clear();
+        hasCenter = false;
+    }
+
+    Coord coordAt(float x, float y) const {
+        int32_t cx = static_cast<int32_t>(std::floor(x / chunkSize));
+        int32_t cy = static_cast<int32_t>(std::floor(y / chunkSize));
+        return {std::clamp(cx, 0, cols - 1), std::clamp(cy, 0, rows - 1)};
+    }
+
+    // Recentre on the player's chunk; true when the windows moved
+    bool setCenter(Coord c) {
+        if (hasCenter && c == center) return false;
+        center = c;
+        hasCenter = true;
+        return true;
+    }
+
+    bool isLive(Coord c) const { return inWindow(c, loadRadius); }
+    bool isKept(Coord c) const { return inWindow(c, loadRadius + 1); }
+    Bounds liveBounds() const { return windowBounds(loadRadius); }
+    Bounds keptBounds() const { return windowBounds(loadRadius + 1); }
+
+    // Append an entity leaving the keep window to its chunk's record
+    void freeze(const Spawn& spawn) {
+        Coord c = coordAt(spawn.x, spawn.y);
+        encode(c, spawn, chunkAt(c));
+    }
+
+    // Chunks outside the keep window stop counting as loaded; their content
+    // has been frozen into them by then
+    void releaseOutsideWindow() {
+        for (auto& entry : chunks) {
+            Chunk& chunk = entry.second;
+            Coord c = {static_cast<int32_t>(entry.first >> 32), static_cast<int32_t>(entry.first & 0xFFFFFFFFu)};
+            if (chunk.loaded && !isKept(c)) {
+                chunk.loaded = false;
+            }
+        }
+    }
+
+    // Chunks of the live window that are not loaded yet, row by row
+    void collectLoads(std::vector<Coord>& out) const {
+        out.clear();
+        if (!hasCenter) return;
+        for (int32_t y = std::max(0, center.y - loadRadius); y <= std::min(rows - 1, center.y + loadRadius); y++) {
+            for (int32_t x = std::max(0, center.x - loadRadius); x <= std::min(cols - 1, center.x + loadRadius); x++) {
+                auto it = chunks.find(key({x, y}));
+                if (it == chunks.end() || !it->second.loaded) {
+                    out.push_back({x, y});
+                }
+            }
+        }
+    }
+
+    // Mark a chunk loaded and write what it holds into out (appended):
+    // generated content on the first visit, then anything frozen into it
+    void load(Coord c, std::vector<Spawn>& out) {
+        Chunk& chunk = chunkAt(c);
+        if (chunk.loaded) return;
+        if (!chunk.generated) {
+            generate(c, out);
+            chunk.generated = true;
+        }
+        decode(c, chunk, out);
+        chunk.stored.clear();
+        chunk.stored.shrink_to_fit();
+        chunk.storedCount = 0;
+        chunk.loaded = true;
+    }
+
+    float getChunkSize() const { return chunkSize; }
+    int getLoadRadius() const { return loadRadius; }
+    Coord getCenter() const { return center; }
+
+    int loadedCount() const {
+        int count = 0;
+        for (const auto& entry : chunks) count += entry.second.loaded ? 1 : 0;
+        return count;
+    }
+
+    // Chunks visited and not loaded
+    int storedCount() const {
+        return static_cast<int>(chunks.size()) - loadedCount();
+    }
+
+    size_t storedBytes() const {
+        size_t bytes = 0;
+        for (const auto& entry : chunks) bytes += entry.second.stored.size();
+        return bytes;
+    }
+};
+
+#endif // CHUNK_MANAGER_H
@@ -0,0 +1,82 @@
+#ifndef COLLISION_LAYERS_H
+#define COLLISION_LAYERS_H
+
+#include "../entities/entity_type.h"
+#include <cstdint>
+
+// Which entity types respond to each other, and how
+//
+// RULES is an EntityType x EntityType table built at compile time. Each entry
+// names the response CollisionSystem runs for a touching pair and whether
+// the handler wants the pair's entities swapped (handlers take the player,
+// or the projectile, first). A pair with Response::NONE has no effect. Every
+// type's collision layer is its own bit. Its default mask holds the layers it
+// has a response with, so the broadphase drops pairs that would do nothing
+// before any distance math. Entities carry their own layer and mask
+// (Entity::collisionLayer / collisionMask), initialised from here.
+namespace CollisionLayers {
+    constexpr int TYPE_COUNT = static_cast<int>(EntityType::PARTICLE) + 1;
+    static_assert(TYPE_COUNT <= 16, "collision layers are 16-bit masks");
+
+    enum class Response : uint8_t {
+        NONE,
+        PLAYER_ENEMY,   // Contact damage, block and parry (enemies and wolves)
+        PICKUP,         // Player takes a power-up
+        PROJECTILE,     // Projectile hits an enemy, wolf or obstacle
+        OBSTACLE,       // Pushed out of (or stopped at) an obstacle
+        SEPARATE        // Enemies push apart
+    };
+
+    struct Rule {
+        Response response;
+        bool swap;   // Call the handler with (b, a)
+    };
+
+    struct Table {
+        Rule rules[TYPE_COUNT][TYPE_COUNT];
+        uint16_t masks[TYPE_COUNT];
+    };
+
+    constexpr uint16_t bit(EntityType type) { return static_cast<uint16_t>(1u << static_cast<int>(type)); }
+
+    constexpr Table build() {
+        Table table{};
+        // first is the handler's first argument; the reverse order swaps
+        auto set = [&table](EntityType first, EntityType second, Response response) {
+            int a = static_cast<int>(first);
+            int b = static_cast<int>(second);
+            table.rules[a][b] = {response, false};
+            if (a != b) table.rules[b][a] = {response, true};
+            table.masks[a] |= bit(second);
+            table.masks[b] |= bit(first);
+        };
+        set(EntityType::PLAYER, EntityType::ENEMY, Response::PLAYER_ENEMY);
+        set(EntityType::PLAYER, EntityType::WOLF, Response::PLAYER_ENEMY);
+        set(EntityType::PLAYER, EntityType::POWERUP, Response::PICKUP);
+        set(EntityType::PROJECTILE, EntityType::ENEMY, Response::PROJECTILE);
+        set(EntityType::PROJECTILE, EntityType::WOLF, Response::PROJECTILE);
+        set(EntityType::PROJECTILE, EntityType::OBSTACLE, Response::PROJECTILE);
+        set(EntityType::PLAYER, EntityType::OBSTACLE, Response::OBSTACLE);
+        set(EntityType::ENEMY, EntityType::OBSTACLE, Response::OBSTACLE);
+        set(EntityType::WOLF, EntityType::OBSTACLE, Response::OBSTACLE);
+        set(EntityType::POWERUP, EntityType::OBSTACLE, Response::OBSTACLE);
+        set(EntityType::ENEMY, EntityType::ENEMY, Response::SEPARATE);
+        return table;
+    }
+
+    inline constexpr Table RULES = build();
+
+    constexpr const Rule& rule(EntityType a, EntityType b) {
+        return RULES.rules[static_cast<int>(a)][static_cast<int>(b)];
+    }
+
+    constexpr uint16_t layerOf(EntityType type) { return bit(type); }
+    constexpr uint16_t maskOf(EntityType type) { return RULES.masks[static_cast<int>(type)]; }
+
+    static_assert(rule(EntityType::PROJECTILE, EntityType::POWERUP).response == Response::NONE,
+                  "projectiles pass over power-ups");
+    static_assert(rule(EntityType::OBSTACLE, EntityType::PROJECTILE).swap,
+                  "the projectile handler takes the projectile first");
+}
+
+#endif // COLLISION_LAYERS_H
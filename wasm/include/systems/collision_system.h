@@ -8,94 +8,340 @@
 #include "../entities/projectile.h"
 #include "../entities/powerup.h"
 #include "../entities/obstacle.h"
-#include "../effects/visual_effects.h"
+#include "collision_layers.h"
+#include "gameplay_events.h"
+#include "../entities/entity_store.h"
+#include "spatial_hash_grid.h"
+#include "obstacle_index.h"
+#include "job_system.h"
+#include "../utils/performance_monitor.h"
+#include "../utils/frame_tracer.h"
+#include "../math/vector_math.h"
 #include <vector>
 #include <memory>
+#include <utility>
 
 class CollisionSystem {
 private:
-    VisualEffects* vfx;
+    // Candidate pair produced by the broadphase
+    struct CollisionPair {
+        Entity* a;
+        Entity* b;
+    };
+    
+    EventQueue* events;   // Side effects of the responses; dropped when null
+    JobSystem* jobs;
+    SpatialHashGrid spatialGrid;
+    std::vector<CollisionPair> candidatePairs;
+    std::vector<uint8_t> pairOverlaps;
+    
+    // Dynamic-vs-obstacle pairs laid out for VectorMath::circleBoxOverlap,
+    // one lane per pair; pair holds the index into candidatePairs
+    struct ObstacleBatch {
+        std::vector<uint32_t> pair;
+        std::vector<float> cx, cy, cr;
+        std::vector<float> bx, by, cosR, sinR, halfW, halfH, round;
+        std::vector<uint8_t> overlap;
+        
+        void clear() {
+            pair.clear();
+            cx.clear(); cy.clear(); cr.clear();
+            bx.clear(); by.clear(); cosR.clear(); sinR.clear();
+            halfW.clear(); halfH.clear(); round.clear();
+        }
+        
+        void push(uint32_t index, const Entity& mover, const Obstacle& obstacle) {
+            pair.push_back(index);
+            cx.push_back(mover.position.x);
+            cy.push_back(mover.position.y);
+            cr.push_back(mover.radius);
+            bx.push_back(obstacle.position.x);
+            by.push_back(obstacle.position.y);
+            cosR.push_back(obstacle.cosR);
+            sinR.push_back(obstacle.sinR);
+            halfW.push_back(obstacle.halfWidth);
+            halfH.push_back(obstacle.halfHeight);
+            round.push_back(obstacle.cornerRadius);
+        }
+    };
+    ObstacleBatch obstacleBatch;
+    std::vector<Entity*> nearbyBuffer;
+    std::vector<Entity*> staticBuffer;
     int collisionChecks;
+    int broadphaseCandidates;
+    int narrowphaseHits;
+    int obstaclesDestroyed;
     
 public:
-    CollisionSystem(VisualEffects* effects = nullptr)
-        : vfx(effects), collisionChecks(0) {}
+    CollisionSystem(EventQueue* eventQueue = nullptr)
+        : events(eventQueue), jobs(nullptr), collisionChecks(0),
+          broadphaseCandidates(0), narrowphaseHits(0), obstaclesDestroyed(0) {}
     
-    void checkCollisions(std::vector<std::unique_ptr<Entity>>& entities, Player* player) {
-        collisionChecks = 0;
-        
-        // Check player collisions
-        if (player && player->active) {
-            for (auto& entity : entities) {
-                if (!entity || !entity->active || entity.get() == player) continue;
-                
-                if (player->collidesWith(*entity)) {
-                    handleCollision(player, entity.get());
-                    collisionChecks++;
-                }
+    void setWorldBounds(float width, float height) {
+        spatialGrid.setWorldBounds(width, height);
+    }
+    
+    // Grid over part of the world (a streamed world's live area)
+    void setBounds(float minX, float minY, float width, float height) {
+        spatialGrid.setBounds(minX, minY, width, height);
+    }
+    
+    // Run the narrowphase overlap tests on the job system
+    void setJobSystem(JobSystem* jobSystem) { jobs = jobSystem; }
+    
+    void setEventQueue(EventQueue* eventQueue) { events = eventQueue; }
+    
+    // The first dynamicCount entities (the player included) go through the
+    // spatial grid and are tested against each other. Obstacles never move,
+    // so they stay out of the grid: each dynamic entity is paired with the
+    // obstacles the static index reports under it, and obstacle pairs are
+    // never formed. The index must be current (rebuildIfDirty) on entry.
+    void checkCollisions(std::vector<std::unique_ptr<Entity>>& entities, size_t dynamicCount,
+                         const ObstacleIndex& statics) {
+        obstaclesDestroyed = 0;
+        broadphase(entities, dynamicCount, statics);
+        narrowphase();
+        collisionChecks = narrowphaseHits;
+    }
+    
+    // Same pipeline, with the broadphase reading positions from the SoA store
+    // (which holds dynamic entities only)
+    void checkCollisions(const EntityStore& store, const ObstacleIndex& statics) {
+        obstaclesDestroyed = 0;
+        broadphase(store, statics);
+        narrowphase();
+        collisionChecks = narrowphaseHits;
+    }
+    
+    // Response for a touching pair, looked up in CollisionLayers::RULES
+    void handleCollision(Entity* a, Entity* b) {
+        using Response = CollisionLayers::Response;
+        const CollisionLayers::Rule& rule = CollisionLayers::rule(a->type, b->type);
+        if (rule.swap) std::swap(a, b);
+        switch (rule.response) {
+            case Response::PLAYER_ENEMY:   // Wolves too: a Wolf is an Enemy
+                handlePlayerEnemyCollision(static_cast<Player*>(a), static_cast<Enemy*>(b));
+                break;
+            case Response::PICKUP:
+                handlePlayerPowerUpCollision(static_cast<Player*>(a), static_cast<PowerUp*>(b));
+                break;
+            case Response::PROJECTILE:
+                handleProjectileCollision(static_cast<Projectile*>(a), b);
+                break;
+            case Response::OBSTACLE:
+                handleObstacleCollision(a, b);
+                break;
+            case Response::SEPARATE:
+                separateEntities(a, b);
+                break;
+            case Response::NONE:
+                break;
+        }
+    }
+    
+private:
+    // Gather unique candidate pairs from the spatial grid. Each pair is
+    // emitted once, from the entity with the lower id, and only when the two
+    // collision filters accept each other. Fast movers occupy
+    // and query the box around their whole step, so the swept test in the
+    // narrowphase sees everything they passed.
+    void broadphase(std::vector<std::unique_ptr<Entity>>& entities, size_t dynamicCount,
+                    const ObstacleIndex& statics) {
+        TRACE_ZONE("collision.broadphase");
+        spatialGrid.clear();
+        for (size_t i = 0; i < dynamicCount; i++) {
+            Entity* entity = entities[i].get();
+            if (!entity || !entity->active) continue;
+            if (entity->movedFast()) {
+                float minX, minY, maxX, maxY;
+                entity->sweptBounds(minX, minY, maxX, maxY);
+                spatialGrid.insertRect(entity, minX, minY, maxX, maxY);
+            } else {
+                spatialGrid.insert(entity);
             }
         }
         
-        // Check entity-entity collisions
-        for (size_t i = 0; i < entities.size(); i++) {
-            if (!entities[i] || !entities[i]->active) continue;
+        candidatePairs.clear();
+        float cell = spatialGrid.getCellSize();
+        for (size_t i = 0; i < dynamicCount; i++) {
+            Entity* entity = entities[i].get();
+            if (!entity || !entity->active) continue;
             
-            for (size_t j = i + 1; j < entities.size(); j++) {
-                if (!entities[j] || !entities[j]->active) continue;
-                
-                if (entities[i]->collidesWith(*entities[j])) {
-                    handleCollision(entities[i].get(), entities[j].get());
-                    collisionChecks++;
+            float minX, minY, maxX, maxY;
+            entity->sweptBounds(minX, minY, maxX, maxY);
+            if (entity->movedFast()) {
+                spatialGrid.queryRect(minX - cell, minY - cell, maxX + cell, maxY + cell,
+                                      nearbyBuffer, entity);
+            } else {
+                spatialGrid.getNearby(entity, nearbyBuffer);
+            }
+            for (Entity* other : nearbyBuffer) {
+                if (entity->id < other->id && entity->collidesWithLayer(*other)) {
+                    candidatePairs.push_back({entity, other});
                 }
             }
+            addStaticPairs(entity, minX, minY, maxX, maxY, statics);
         }
+        
+        broadphaseCandidates = static_cast<int>(candidatePairs.size());
     }
     
-    void handleCollision(Entity* a, Entity* b) {
-        // Player-Enemy collision
-        if (a->type == EntityType::PLAYER && b->type == EntityType::ENEMY) {
-            handlePlayerEnemyCollision(static_cast<Player*>(a), static_cast<Enemy*>(b));
-        }
-        else if (b->type == EntityType::PLAYER && a->type == EntityType::ENEMY) {
-            handlePlayerEnemyCollision(static_cast<Player*>(b), static_cast<Enemy*>(a));
+    void broadphase(const EntityStore& store, const ObstacleIndex& statics) {
+        TRACE_ZONE("collision.broadphase");
+        spatialGrid.clear();
+        for (size_t i = 0; i < store.size(); i++) {
+            if (!store.active[i]) continue;
+            float minX, minY, maxX, maxY;
+            stepBounds(store, i, minX, minY, maxX, maxY);
+            spatialGrid.insertRect(store.handles[i], minX, minY, maxX, maxY);
         }
         
-        // Player-Wolf collision
-        else if (a->type == EntityType::PLAYER && b->type == EntityType::WOLF) {
-            handlePlayerWolfCollision(static_cast<Player*>(a), static_cast<Wolf*>(b));
-        }
-        else if (b->type == EntityType::PLAYER && a->type == EntityType::WOLF) {
-            handlePlayerWolfCollision(static_cast<Player*>(b), static_cast<Wolf*>(a));
+        candidatePairs.clear();
+        float cell = spatialGrid.getCellSize();
+        for (size_t i = 0; i < store.size(); i++) {
+            if (!store.active[i]) continue;
+            
+            Entity* entity = store.handles[i];
+            float minX, minY, maxX, maxY;
+            stepBounds(store, i, minX, minY, maxX, maxY);
+            spatialGrid.queryRect(minX - cell, minY - cell, maxX + cell, maxY + cell,
+                                  nearbyBuffer, entity);
+            for (Entity* other : nearbyBuffer) {
+                if (entity->id < other->id && entity->collidesWithLayer(*other)) {
+                    candidatePairs.push_back({entity, other});
+                }
+            }
+            addStaticPairs(entity, minX, minY, maxX, maxY, statics);
         }
         
-        // Projectile collisions
-        else if (a->type == EntityType::PROJECTILE) {
-            handleProjectileCollision(static_cast<Projectile*>(a), b);
+        broadphaseCandidates = static_cast<int>(candidatePairs.size());
+    }
+    
+    // Obstacles touching a dynamic entity's step bounds; no query at all
+    // for an entity whose mask leaves obstacles out
+    void addStaticPairs(Entity* entity, float minX, float minY, float maxX, float maxY,
+                        const ObstacleIndex& statics) {
+        if (!(entity->collisionMask & CollisionLayers::layerOf(EntityType::OBSTACLE))) return;
+        statics.queryBounds(minX, minY, maxX, maxY, staticBuffer);
+        for (Entity* obstacle : staticBuffer) {
+            if (entity->collidesWithLayer(*obstacle)) {
+                candidatePairs.push_back({entity, obstacle});
+            }
         }
-        else if (b->type == EntityType::PROJECTILE) {
-            handleProjectileCollision(static_cast<Projectile*>(b), a);
+    }
+    
+    // Circle bounds of a store row, stretched over the step for fast movers
+    // (same rule as Entity::movedFast)
+    static void stepBounds(const EntityStore& store, size_t i,
+                           float& minX, float& minY, float& maxX, float& maxY) {
+        float r = store.radius[i];
+        float x0 = store.x[i], y0 = store.y[i];
+        float x1 = x0, y1 = y0;
+        float dx = x0 - store.px[i], dy = y0 - store.py[i];
+        float limit = r * Config::SWEPT_MIN_TRAVEL;
+        if (dx * dx + dy * dy > limit * limit) {
+            x1 = store.px[i];
+            y1 = store.py[i];
         }
-        
-        // Player-PowerUp collision
-        else if (a->type == EntityType::PLAYER && b->type == EntityType::POWERUP) {
-            handlePlayerPowerUpCollision(static_cast<Player*>(a), static_cast<PowerUp*>(b));
+        minX = std::min(x0, x1) - r;
+        minY = std::min(y0, y1) - r;
+        maxX = std::max(x0, x1) + r;
+        maxY = std::max(y0, y1) + r;
+    }
+    
+    // The broadphase puts the obstacle second in its pairs
+    static bool isObstaclePair(const CollisionPair& pair) {
+        return pair.b->type == EntityType::OBSTACLE;
+    }
+    
+    // Exact circle-vs-shape test, swept for fast movers
+    static bool touchesObstacle(const Entity& mover, const Obstacle& obstacle) {
+        if (!mover.active || !obstacle.active) return false;
+        if (obstacle.overlapsCircle(mover.position, mover.radius)) return true;
+        return mover.movedFast() && obstacle.sweptContactTime(mover) >= 0;
+    }
+    
+    // Overlap flags for every obstacle pair: fast movers take the scalar
+    // swept test, the rest go through the batched kernel
+    void testObstaclePairs() {
+        TRACE_ZONE("collision.obstacleBatch");
+        obstacleBatch.clear();
+        for (size_t i = 0; i < candidatePairs.size(); i++) {
+            const CollisionPair& pair = candidatePairs[i];
+            if (!isObstaclePair(pair)) continue;
+            Obstacle& obstacle = *static_cast<Obstacle*>(pair.b);
+            obstacle.syncFrame();
+            if (!pair.a->active || !obstacle.active) {
+                pairOverlaps[i] = 0;
+            } else if (pair.a->movedFast()) {
+                pairOverlaps[i] = touchesObstacle(*pair.a, obstacle) ? 1 : 0;
+            } else {
+                obstacleBatch.push(static_cast<uint32_t>(i), *pair.a, obstacle);
+            }
         }
-        else if (b->type == EntityType::PLAYER && a->type == EntityType::POWERUP) {
-            handlePlayerPowerUpCollision(static_cast<Player*>(b), static_cast<PowerUp*>(a));
+        
+        ObstacleBatch& batch = obstacleBatch;
+        size_t count = batch.pair.size();
+        batch.overlap.resize(count);
+        VectorMath::circleBoxOverlap(batch.cx.data(), batch.cy.data(), batch.cr.data(),
+                                     batch.bx.data(), batch.by.data(),
+                                     batch.cosR.data(), batch.sinR.data(),
+                                     batch.halfW.data(), batch.halfH.data(), batch.round.data(),
+                                     count, batch.overlap.data());
+        for (size_t k = 0; k < count; k++) {
+            pairOverlaps[batch.pair[k]] = batch.overlap[k];
         }
+    }
+    
+    // Exact overlap test and response for every candidate pair
+    void narrowphase() {
+        TRACE_ZONE("collision.narrowphase");
+        narrowphaseHits = 0;
+        pairOverlaps.resize(candidatePairs.size());
+        testObstaclePairs();
         
-        // Obstacle collisions
-        else if (a->type == EntityType::OBSTACLE || b->type == EntityType::OBSTACLE) {
-            handleObstacleCollision(a, b);
+        // The overlap tests only read, so they run in parallel; responses
+        // mutate entities and push events, so they stay serial and in pair
+        // order. Flagged pairs are re-tested to drop any that an earlier
+        // response already separated or deactivated. Without workers,
+        // entity pairs are tested right before their response instead.
+        bool parallel = jobs && jobs->getWorkerCount() > 0;
+        if (parallel) {
+            jobs->parallelFor(candidatePairs.size(), JobSystem::DEFAULT_MIN_CHUNK,
+                [this](size_t begin, size_t end) {
+                    PERF_TIMER(NARROWPHASE_CHUNK);
+                    TRACE_ZONE("collision.narrowphaseChunk");
+                    for (size_t i = begin; i < end; i++) {
+                        const CollisionPair& pair = candidatePairs[i];
+                        if (isObstaclePair(pair)) continue;
+                        pairOverlaps[i] = pair.a->collidesWith(*pair.b) ? 1 : 0;
+                    }
+                });
         }
         
-        // Enemy-Enemy separation
-        else if (a->type == EntityType::ENEMY && b->type == EntityType::ENEMY) {
-            separateEntities(a, b);
+        TRACE_ZONE("collision.response");
+        for (size_t i = 0; i < candidatePairs.size(); i++) {
+            const CollisionPair& pair = candidatePairs[i];
+            bool touching;
+            if (isObstaclePair(pair)) {
+                touching = pairOverlaps[i] && touchesObstacle(*pair.a, *static_cast<Obstacle*>(pair.b));
+            } else if (parallel) {
+                touching = pairOverlaps[i] && pair.a->collidesWith(*pair.b);
+            } else {
+                touching = pair.a->collidesWith(*pair.b);
+            }
+            if (touching) {
+                handleCollision(pair.a, pair.b);
+                narrowphaseHits++;
+            }
         }
     }
     
-private:
+    void emit(GameplayEvent::Type type, int sourceId, int targetId, const Vector2& at,
+              const Vector2& dir = Vector2(0, 0), float amount = 0, uint8_t detail = 0) {
+        if (events) events->push(type, sourceId, targetId, at.x, at.y, dir.x, dir.y, amount, detail);
+    }
+    
     void handlePlayerEnemyCollision(Player* player, Enemy* enemy) {
         if (player->invulnerable || player->rolling) return;
         
@@ -112,16 +358,14 @@ private:
                 player->energy = std::min(player->energy + Config::PERFECT_PARRY_ENERGY_RESTORE, 
                                         player->maxEnergy);
                 
-                if (vfx) {
-                    vfx->createHitEffect(player->position, true);
-                }
+                emit(GameplayEvent::Type::PARRY, player->id, enemy->id, player->position,
+                     Vector2(0, 0), Config::PERFECT_PARRY_ENERGY_RESTORE);
             } else {
                 // Normal block - reduced damage
                 damage *= (1.0f - Config::SHIELD_DAMAGE_REDUCTION);
                 
-                if (vfx) {
-                    vfx->createHitEffect(player->position, false);
-                }
+                emit(GameplayEvent::Type::BLOCK, enemy->id, player->id, player->position,
+                     Vector2(0, 0), damage);
             }
         }
         
@@ -135,18 +379,11 @@ private:
             Vector2 knockback = (player->position - enemy->position).normalized() * 10;
             player->velocity += knockback;
             
-            if (vfx) {
-                vfx->createBloodSplatter(player->position, knockback.normalized());
-                vfx->addScreenShake(3);
-            }
+            emit(GameplayEvent::Type::PLAYER_HIT, enemy->id, player->id, player->position,
+                 knockback.normalized(), damage);
         }
     }
     
-    void handlePlayerWolfCollision(Player* player, Wolf* wolf) {
-        // Similar to enemy collision but with wolf-specific behavior
-        handlePlayerEnemyCollision(player, static_cast<Enemy*>(wolf));
-    }
-    
     void handleProjectileCollision(Projectile* projectile, Entity* target) {
         // Don't hit the owner
         if (projectile->ownerId == target->id) return;
@@ -160,16 +397,12 @@ private:
             Vector2 knockback = projectile->direction * 5;
             target->velocity += knockback;
             
-            if (vfx) {
-                vfx->createHitEffect(target->position, false);
-                vfx->createBloodSplatter(target->position, projectile->direction);
-            }
+            emit(GameplayEvent::Type::HIT, projectile->ownerId, target->id, target->position,
+                 projectile->direction, projectile->damage);
             
             // Check if killed
             if (!target->active) {
-                if (vfx) {
-                    vfx->createExplosion(target->position, 0.5f);
-                }
+                emit(GameplayEvent::Type::KILL, projectile->ownerId, target->id, target->position);
             }
         }
         // Hit obstacle
@@ -177,15 +410,15 @@ private:
             Obstacle* obstacle = static_cast<Obstacle*>(target);
             if (obstacle->destructible) {
                 obstacle->takeDamage(projectile->damage);
-                if (!obstacle->active && vfx) {
-                    vfx->createExplosion(obstacle->position, 0.3f);
+                if (!obstacle->active) {
+                    obstaclesDestroyed++;
+                    emit(GameplayEvent::Type::OBSTACLE_DESTROYED, projectile->ownerId, obstacle->id,
+                         obstacle->position);
                 }
             }
             projectile->active = false;
             
-            if (vfx) {
-                vfx->createHitEffect(projectile->position, false);
-            }
+            emit(GameplayEvent::Type::IMPACT, projectile->ownerId, obstacle->id, projectile->position);
         }
     }
     
@@ -193,43 +426,38 @@ private:
         player->applyPowerUp(powerup->powerType);
         powerup->active = false;
         
-        if (vfx) {
-            switch (powerup->powerType) {
-                case PowerUpType::HEALTH:
-                    vfx->createHealEffect(player->position);
-                    break;
-                case PowerUpType::ENERGY:
-                    vfx->createEnergyEffect(player->position);
-                    break;
-                default:
-                    vfx->createHitEffect(player->position, true);
-                    break;
-            }
-        }
-        
-        player->score += Config::SCORE_PER_POWERUP;
+        // Score is credited when the event is applied
+        emit(GameplayEvent::Type::PICKUP, player->id, powerup->id, player->position,
+             Vector2(0, 0), 0, static_cast<uint8_t>(powerup->powerType));
     }
     
     void handleObstacleCollision(Entity* a, Entity* b) {
         // Push entities away from obstacles
         Entity* movable = (a->type == EntityType::OBSTACLE) ? b : a;
-        Entity* obstacle = (a->type == EntityType::OBSTACLE) ? a : b;
+        Obstacle* obstacle = static_cast<Obstacle*>((a->type == EntityType::OBSTACLE) ? a : b);
         
         if (movable->type == EntityType::PROJECTILE) {
             // Projectiles are destroyed by obstacles
             movable->active = false;
-            if (vfx) {
-                vfx->createHitEffect(movable->position, false);
-            }
+            emit(GameplayEvent::Type::IMPACT, static_cast<Projectile*>(movable)->ownerId, obstacle->id,
+                 movable->position);
         } else {
-            // Push entity away
-            Vector2 separation = (movable->position - obstacle->position).normalized();
-            float overlap = (movable->radius + obstacle->radius) - movable->distanceTo(*obstacle);
+            Vector2 normal;
+            float depth = obstacle->penetration(movable->position, movable->radius, normal);
             
-            if (overlap > 0) {
-                movable->position += separation * overlap;
-                movable->velocity = movable->velocity - separation * (movable->velocity.dot(separation));
+            // Swept through without ending inside: stop at the contact point
+            if (depth <= 0) {
+                float t = obstacle->sweptContactTime(*movable);
+                if (t < 0) return;
+                movable->position = Vector2::lerp(movable->previousPosition, movable->position, t);
+                obstacle->penetration(movable->position, movable->radius, normal);
+                movable->velocity = movable->velocity - normal * (movable->velocity.dot(normal));
+                return;
             }
+            
+            // Push entity out along the contact normal
+            movable->position += normal * depth;
+            movable->velocity = movable->velocity - normal * (movable->velocity.dot(normal));
         }
     }
     
@@ -245,6 +473,14 @@ private:
     
 public:
     int getCollisionChecks() const { return collisionChecks; }
+    int getBroadphaseCandidates() const { return broadphaseCandidates; }
+    int getNarrowphaseHits() const { return narrowphaseHits; }
+    // Destructible obstacles killed by the last pass; the static layer needs a rebuild
+    int getObstaclesDestroyed() const { return obstaclesDestroyed; }
+    
+    // Dynamic entities as binned by the last broadphase. Only valid until
+    // entities are next removed (the grid holds raw pointers).
+    SpatialHashGrid& getSpatialGrid() { return spatialGrid; }
 };
 
 #endif // COLLISION_SYSTEM_H
\ No newline at end of file
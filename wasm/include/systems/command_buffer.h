@@ -0,0 +1,111 @@
+#ifndef COMMAND_BUFFER_H
+#define COMMAND_BUFFER_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Input command ring shared with JavaScript
+//
+// JS gets a view of the ring once (GameEngine::getCommandBuffer) and appends
+// fixed-size commands straight into WASM memory; the engine drains it at the
+// start of update(), so a frame's input costs no embind calls of its own and
+// always lands at the same point of the tick. Commands are applied through
+// the regular public methods, so they are recorded like direct calls.
+//
+// Layout, in 32-bit words (layout version 1):
+//   header   [0] write index  [1] read index  [2] capacity  [3] stride
+//   command  [0] op  [1] player id  [2..5] float args  [6..7] reserved
+// Indices run freely and wrap at 2^32; slot = index & (capacity - 1). The
+// producer (JS) only advances write and the engine only advances read, and
+// a full ring (write - read == capacity) rejects new commands. The engine
+// and JS share one thread, so no atomics are needed.
+class CommandBuffer {
+public:
+    static constexpr int VERSION = 1;
+    static constexpr uint32_t CAPACITY = 256;
+    static constexpr int HEADER_WORDS = 4;
+    static constexpr int STRIDE = 8;
+
+    // Values are part of the JS layout (src/game/command-buffer.js)
+    enum class Op : int32_t {
+        NONE = 0,
+        PLAYER_INPUT = 1,   // dx, dy, aimX, aimY
+        PLAYER_SHOOT = 2,   // aimX, aimY
+        BOOST_ON = 3,
+        BOOST_OFF = 4,
+        BLOCK_START = 5,
+        BLOCK_END = 6,
+        ATTACK = 7,         // angle
+        ROLL = 8            // dirX, dirY
+    };
+
+    struct Command {
+        Op op;
+        int32_t id;
+        float v[4];
+        int32_t reserved[2];
+    };
+
+    struct Header {
+        uint32_t write;
+        uint32_t read;
+        uint32_t capacity;
+        uint32_t stride;
+    };
+
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+    static_assert(sizeof(Header) == HEADER_WORDS * 4, "Header layout is shared with JS");
+    static_assert(sizeof(Command) == STRIDE * 4, "Command layout is shared with JS");
+
+private:
+    struct Block {
+        Header header;
+        Command commands[CAPACITY];
+    };
+
+    Block block;
+
+public:
+    CommandBuffer() : block() {
+        block.header.capacity = CAPACITY;
+        block.header.stride = STRIDE;
+    }
+
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+    // Native producers (tools, a server); false when the ring is full
+    bool push(const Command& command) {
+        Header& h = block.header;
+        if (h.write - h.read >= CAPACITY) return false;
+        block.commands[h.write & (CAPACITY - 1)] = command;
+        h.write++;
+        return true;
+    }
+
+    size_t pending() const {
+        uint32_t queued = block.header.write - block.header.read;
+        return queued < CAPACITY ? queued : CAPACITY;
+    }
+
+    // Hand every queued command to fn in order and empty the ring. A
+    // producer that overran the ring only gets its newest CAPACITY commands.
+    template<typename Fn>
+    size_t drain(Fn&& fn) {
+        Header& h = block.header;
+        uint32_t end = h.write;
+        uint32_t read = end - h.read > CAPACITY ? end - CAPACITY : h.read;
+        size_t count = 0;
+        for (; read != end; read++, count++) {
+            fn(block.commands[read & (CAPACITY - 1)]);
+        }
+        h.read = end;
+        return count;
+    }
+
+    // The whole ring for JS, header first
+    uint32_t* words() { return reinterpret_cast<uint32_t*>(&block); }
+    size_t wordCount() const { return sizeof(Block) / 4; }
+};
+
+#endif // COMMAND_BUFFER_H
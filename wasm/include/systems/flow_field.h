@@ -0,0 +1,358 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include "../entities/entity.h"
+#include "../entities/obstacle.h"
+#include "../config/game_config.h"
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Shared flow field toward a single target (the player)
+//
+// The world (or, for a streamed world, the window around the player; see
+// setBounds) is covered by a coarse grid. A cell is blocked while any obstacle,
+// inflated by the agent clearance, covers its centre; each cell keeps a count
+// of the obstacles covering it so a destroyed obstacle can be taken out
+// without re-rasterizing the others. A breadth-first pass from the target
+// cell gives every open cell its step distance, and each cell then stores the
+// neighbour that leads downhill, so an agent's steering direction is a single
+// array lookup however many agents share the field.
+//
+// The distances are recomputed only when the target moves into another cell
+// or the obstacle set changes. Removing an obstacle only ever shortens paths,
+// so it is repaired in place by relaxing outward from the cells it freed.
+class FlowField {
+public:
+    static constexpr float DEFAULT_CELL_SIZE = 40.0f;
+    static constexpr int MAX_CELLS_PER_AXIS = 256;
+    static constexpr uint16_t UNREACHABLE = 0xFFFF;
+
+private:
+    static constexpr int8_t NO_DIRECTION = -1;
+
+    float cellSize;
+    float invCellSize;
+    float originX;
+    float originY;
+    float clearance;
+    int cols;
+    int rows;
+
+    std::vector<uint8_t> coverCount;   // Obstacles covering each cell
+    std::vector<uint16_t> distance;    // Steps to the target cell
+    std::vector<int8_t> direction;     // Index into neighbourOffsets()
+    std::vector<int> frontier;         // BFS queue, reused
+    std::vector<int> changed;          // Cells whose distance dropped in a repair
+
+    int targetCell;
+    bool obstaclesDirty;
+    bool enabled;
+    int recomputeCount;
+    int repairCount;
+
+    struct Offset {
+        int dx;
+        int dy;
+    };
+
+    // Orthogonal neighbours first; BFS expands those only
+    static const Offset* neighbourOffsets() {
+        static const Offset offsets[8] = {
+            {1, 0}, {-1, 0}, {0, 1}, {0, -1},
+            {1, 1}, {-1, 1}, {1, -1}, {-1, -1}
+        };
+        return offsets;
+    }
+
+    static const Vector2* neighbourDirections() {
+        static const float d = 0.70710678f;
+        static const Vector2 directions[8] = {
+            Vector2(1, 0), Vector2(-1, 0), Vector2(0, 1), Vector2(0, -1),
+            Vector2(d, d), Vector2(-d, d), Vector2(d, -d), Vector2(-d, -d)
+        };
+        return directions;
+    }
+
+public:
+    FlowField()
+        : cellSize(DEFAULT_CELL_SIZE), invCellSize(1.0f / DEFAULT_CELL_SIZE),
+          originX(0), originY(0), clearance(Config::ENEMY_RADIUS), cols(0), rows(0),
+          targetCell(-1), obstaclesDirty(true), enabled(true), recomputeCount(0), repairCount(0) {}
+
+    // Resize the grid to cover the world; the next update() rebuilds it
+    void setWorldBounds(float width, float height, float newCellSize = DEFAULT_CELL_SIZE) {
+        setBounds(0, 0, width, height, newCellSize);
+    }
+
+    // Cover [minX, minX + width) x [minY, minY + height); positions outside
+    // clamp to the edge cells
+    void setBounds(float minX, float minY, float width, float height,
+                   float newCellSize = DEFAULT_CELL_SIZE) {
+        originX = minX;
+        originY = minY;
+        cellSize = std::max(newCellSize, 1.0f);
+        cols = std::max(1, static_cast<int>(std::ceil(width / cellSize)));
+        rows = std::max(1, static_cast<int>(std::ceil(height / cellSize)));
+        if (cols > MAX_CELLS_PER_AXIS || rows > MAX_CELLS_PER_AXIS) {
+            cellSize *= std::max(cols, rows) / static_cast<float>(MAX_CELLS_PER_AXIS);
+            cols = std::max(1, static_cast<int>(std::ceil(width / cellSize)));
+            rows = std::max(1, static_cast<int>(std::ceil(height / cellSize)));
+        }
+        invCellSize = 1.0f / cellSize;
+
+        size_t cells = static_cast<size_t>(cols) * rows;
+        coverCount.assign(cells, 0);
+        distance.assign(cells, UNREACHABLE);
+        direction.assign(cells, NO_DIRECTION);
+        targetCell = -1;
+        obstaclesDirty = true;
+    }
+
+    // How far from an obstacle an agent centre must stay
+    void setClearance(float radius) {
+        clearance = std::max(0.0f, radius);
+        obstaclesDirty = true;
+    }
+
+    void setEnabled(bool on) { enabled = on; }
+    bool isEnabled() const { return enabled; }
+
+    // Obstacles were added or the set was replaced; rebuild on next update()
+    void markDirty() { obstaclesDirty = true; }
+
+    // A rasterized obstacle is going away; frees its cells and shortens the
+    // paths through them without a full rebuild
+    void removeObstacle(const Obstacle& obstacle) {
+        if (obstaclesDirty || cols == 0) return;
+
+        changed.clear();
+        frontier.clear();
+        forEachCoveredCell(obstacle, [&](int cell) {
+            if (coverCount[cell] > 0 && --coverCount[cell] == 0) {
+                changed.push_back(cell);
+            }
+        });
+        if (changed.empty() || targetCell < 0) return;
+
+        // Seed each freed cell from its best open neighbour
+        size_t freed = changed.size();
+        for (size_t i = 0; i < freed; i++) {
+            int cell = changed[i];
+            uint16_t best = cell == targetCell ? 0 : bestNeighbourDistance(cell);
+            if (best < distance[cell]) {
+                distance[cell] = best;
+                frontier.push_back(cell);
+            }
+        }
+        relax(0);
+        refreshDirections();
+        repairCount++;
+    }
+
+    // Bring the field up to date for this frame's target position
+    void update(const std::vector<std::unique_ptr<Entity>>& entities, const Vector2& target) {
+        if (!enabled || cols == 0) return;
+
+        if (obstaclesDirty) {
+            rasterize(entities);
+            targetCell = -1;
+        }
+
+        int cell = cellAt(target);
+        if (cell != targetCell) {
+            targetCell = cell;
+            recompute();
+        }
+    }
+
+    // Direction an agent at from should take to reach to. Returns false when
+    // the field does not apply (to is not in the target cell, from is
+    // unreachable, or the two are close enough to seek directly).
+    bool steer(const Vector2& from, const Vector2& to, Vector2& out) const {
+        if (!enabled || targetCell < 0 || cellAt(to) != targetCell) return false;
+
+        int cell = cellAt(from);
+        if (distance[cell] <= 1 && coverCount[cell] == 0) return false;
+
+        int8_t index = direction[cell];
+        if (index == NO_DIRECTION) return false;
+        out = neighbourDirections()[index];
+        return true;
+    }
+
+    uint16_t getDistanceAt(const Vector2& position) const {
+        return cols ? distance[cellAt(position)] : UNREACHABLE;
+    }
+    bool isBlockedAt(const Vector2& position) const {
+        return cols && coverCount[cellAt(position)] > 0;
+    }
+
+    float getCellSize() const { return cellSize; }
+    int getColumns() const { return cols; }
+    int getRows() const { return rows; }
+    int getRecomputeCount() const { return recomputeCount; }
+    int getRepairCount() const { return repairCount; }
+
+private:
+    int cellAt(const Vector2& p) const {
+        int cx = std::clamp(static_cast<int>((p.x - originX) * invCellSize), 0, cols - 1);
+        int cy = std::clamp(static_cast<int>((p.y - originY) * invCellSize), 0, rows - 1);
+        return cy * cols + cx;
+    }
+
+    // Visit the cells whose centre lies inside the obstacle grown by clearance
+    template<typename Fn>
+    void forEachCoveredCell(const Obstacle& obstacle, const Fn& fn) const {
+        bool box = obstacle.shape != ObstacleShape::CIRCLE;
+        float cosR = obstacle.cosR;
+        float sinR = obstacle.sinR;
+        float hw = obstacle.halfWidth;
+        float hh = obstacle.halfHeight;
+
+        float ex = obstacle.extentX + clearance;
+        float ey = obstacle.extentY + clearance;
+
+        float cx = obstacle.position.x - originX;
+        float cy = obstacle.position.y - originY;
+        int x0 = std::max(0, static_cast<int>(std::floor((cx - ex) * invCellSize)));
+        int y0 = std::max(0, static_cast<int>(std::floor((cy - ey) * invCellSize)));
+        int x1 = std::min(cols - 1, static_cast<int>(std::floor((cx + ex) * invCellSize)));
+        int y1 = std::min(rows - 1, static_cast<int>(std::floor((cy + ey) * invCellSize)));
+
+        float limit = clearance * clearance;
+        float circleLimit = (obstacle.radius + clearance) * (obstacle.radius + clearance);
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                float px = (x + 0.5f) * cellSize - cx;
+                float py = (y + 0.5f) * cellSize - cy;
+                bool covered;
+                if (box) {
+                    // Distance from the cell centre to the box, in box space
+                    float lx = std::abs(px * cosR + py * sinR) - hw;
+                    float ly = std::abs(-px * sinR + py * cosR) - hh;
+                    float ox = std::max(lx, 0.0f);
+                    float oy = std::max(ly, 0.0f);
+                    covered = ox * ox + oy * oy <= limit;
+                } else {
+                    covered = px * px + py * py <= circleLimit;
+                }
+                if (covered) fn(y * cols + x);
+            }
+        }
+    }
+
+    void rasterize(const std::vector<std::unique_ptr<Entity>>& entities) {
+        std::fill(coverCount.begin(), coverCount.end(), 0);
+        for (const auto& entity : entities) {
+            if (entity && entity->active && entity->type == EntityType::OBSTACLE) {
+                forEachCoveredCell(*static_cast<const Obstacle*>(entity.get()), [&](int cell) {
+                    if (coverCount[cell] < 255) coverCount[cell]++;
+                });
+            }
+        }
+        obstaclesDirty = false;
+    }
+
+    uint16_t bestNeighbourDistance(int cell) const {
+        int x = cell % cols;
+        int y = cell / cols;
+        uint16_t best = UNREACHABLE;
+        const Offset* offsets = neighbourOffsets();
+        for (int i = 0; i < 4; i++) {
+            int nx = x + offsets[i].dx;
+            int ny = y + offsets[i].dy;
+            if (nx < 0 || ny < 0 || nx >= cols || ny >= rows) continue;
+            int n = ny * cols + nx;
+            if (coverCount[n] == 0 && distance[n] != UNREACHABLE) {
+                best = std::min<uint16_t>(best, distance[n] + 1);
+            }
+        }
+        return best;
+    }
+
+    // Breadth-first relaxation over open cells from the frontier queue
+    void relax(size_t head) {
+        const Offset* offsets = neighbourOffsets();
+        while (head < frontier.size()) {
+            int cell = frontier[head++];
+            uint16_t next = distance[cell] + 1;
+            int x = cell % cols;
+            int y = cell / cols;
+            for (int i = 0; i < 4; i++) {
+                int nx = x + offsets[i].dx;
+                int ny = y + offsets[i].dy;
+                if (nx < 0 || ny < 0 || nx >= cols || ny >= rows) continue;
+                int n = ny * cols + nx;
+                if (coverCount[n] == 0 && next < distance[n]) {
+                    distance[n] = next;
+                    frontier.push_back(n);
+                    changed.push_back(n);
+                }
+            }
+        }
+    }
+
+    void recompute() {
+        std::fill(distance.begin(), distance.end(), UNREACHABLE);
+        frontier.clear();
+        changed.clear();
+
+        // The target is seeded even when it stands inside an inflated cell
+        distance[targetCell] = 0;
+        frontier.push_back(targetCell);
+        relax(0);
+
+        for (int cell = 0; cell < cols * rows; cell++) {
+            direction[cell] = pickDirection(cell);
+        }
+        recomputeCount++;
+    }
+
+    // Directions depend on neighbour distances, so refresh around every
+    // cell a repair touched
+    void refreshDirections() {
+        const Offset* offsets = neighbourOffsets();
+        for (int cell : changed) {
+            int x = cell % cols;
+            int y = cell / cols;
+            direction[cell] = pickDirection(cell);
+            for (int i = 0; i < 8; i++) {
+                int nx = x + offsets[i].dx;
+                int ny = y + offsets[i].dy;
+                if (nx < 0 || ny < 0 || nx >= cols || ny >= rows) continue;
+                int n = ny * cols + nx;
+                direction[n] = pickDirection(n);
+            }
+        }
+    }
+
+    // Downhill neighbour; diagonals only when both orthogonal cells are
+    // open, so agents do not cut obstacle corners. Cells inside an inflated
+    // obstacle also point out of it, toward the nearest reachable cell.
+    int8_t pickDirection(int cell) const {
+        if (cell == targetCell) return NO_DIRECTION;
+
+        int x = cell % cols;
+        int y = cell / cols;
+        uint16_t best = coverCount[cell] == 0 ? distance[cell] : UNREACHABLE;
+        int8_t bestIndex = NO_DIRECTION;
+        const Offset* offsets = neighbourOffsets();
+        for (int i = 0; i < 8; i++) {
+            int nx = x + offsets[i].dx;
+            int ny = y + offsets[i].dy;
+            if (nx < 0 || ny < 0 || nx >= cols || ny >= rows) continue;
+            int n = ny * cols + nx;
+            if (distance[n] >= best) continue;
+            if (coverCount[n] > 0 && n != targetCell) continue;
+            if (i >= 4 && (coverCount[y * cols + nx] > 0 || coverCount[ny * cols + x] > 0)) continue;
+            best = distance[n];
+            bestIndex = static_cast<int8_t>(i);
+        }
+        return bestIndex;
+    }
+};
+
+#endif // FLOW_FIELD_H
@@ -0,0 +1,75 @@
+#ifndef GAMEPLAY_EVENTS_H
+#define GAMEPLAY_EVENTS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Gameplay side effects, recorded where they happen and applied later
+//
+// Collision responses and attacks settle the physical outcome on the spot
+// (damage, knockback, deactivation) and push one POD event for everything
+// else. GameEngine applies the events serially and in push order once the
+// pass is done (particles, screen shake, score), and the whole frame's list
+// stays readable from JS until the next update() as one batch.
+//
+// Layout, in 32-bit words (layout version 1):
+//   [0] type | detail << 8   [1] source id  [2] target id
+//   [3..4] x, y  [5..6] dirX, dirY  [7] amount
+// Source is the entity that caused the event (attacker, shooter, picker) and
+// target the one it happened to; dir is zero unless noted.
+struct GameplayEvent {
+    // Values are part of the JS layout (src/game/engine-events.js)
+    enum class Type : uint8_t {
+        NONE = 0,
+        HIT = 1,                  // Enemy or wolf damaged; dir = knockback (unit), amount = damage
+        PLAYER_HIT = 2,           // Player damaged; dir = knockback (unit), amount = damage
+        BLOCK = 3,                // Player blocked; amount = damage still taken
+        PARRY = 4,                // Perfect parry; amount = energy restored
+        PICKUP = 5,               // Power-up taken; detail = PowerUpType
+        KILL = 6,                 // Enemy or wolf killed; source = credited entity
+        IMPACT = 7,               // Projectile stopped by an obstacle
+        OBSTACLE_DESTROYED = 8
+    };
+
+    Type type;
+    uint8_t detail;
+    uint16_t reserved;
+    int32_t sourceId;
+    int32_t targetId;
+    float x, y;
+    float dirX, dirY;
+    float amount;
+};
+
+class EventQueue {
+public:
+    static constexpr int VERSION = 1;
+    static constexpr int STRIDE = 8;
+
+    static_assert(sizeof(GameplayEvent) == STRIDE * 4, "GameplayEvent layout is shared with JS");
+
+private:
+    std::vector<GameplayEvent> events;
+
+public:
+    EventQueue() { events.reserve(256); }
+
+    void push(GameplayEvent::Type type, int sourceId, int targetId, float x, float y,
+              float dirX = 0, float dirY = 0, float amount = 0, uint8_t detail = 0) {
+        events.push_back({type, detail, 0, sourceId, targetId, x, y, dirX, dirY, amount});
+    }
+
+    void clear() { events.clear(); }
+    size_t size() const { return events.size(); }
+    bool empty() const { return events.empty(); }
+
+    const GameplayEvent& operator[](size_t i) const { return events[i]; }
+    const GameplayEvent* data() const { return events.data(); }
+
+    // Word view for JS; invalidated when the queue grows
+    const int32_t* words() const { return reinterpret_cast<const int32_t*>(events.data()); }
+    size_t wordCount() const { return events.size() * STRIDE; }
+};
+
+#endif // GAMEPLAY_EVENTS_H
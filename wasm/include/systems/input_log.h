@@ -0,0 +1,176 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+// Recorded session: a seed plus every call that changes the simulation
+//
+// GameEngine appends one record per state-changing API call (player input,
+// attacks, entity creation, game state changes) and one STEP record per
+// simulation tick with its delta time, all in call order. Replaying the
+// records against a fresh engine seeded the same way reproduces the session
+// exactly (see GameEngine::runReplay). The checksum taken when recording
+// stopped lets the replay confirm that it did.
+//
+// Serialized as the Header followed by recordCount Records, little-endian,
+// matching the in-memory layout; the same bytes load natively and in WASM.
+class InputLog {
+public:
+    static constexpr uint32_t MAGIC = 0x4C525353;   // "SSRL"
+    static constexpr uint16_t VERSION = 2;
+
+    enum class Op : uint8_t {
+        STEP,                   // v[0] = deltaTime
+        PLAYER_INPUT,           // v = dx, dy, aimX, aimY; every later STEP applies it
+        PLAYER_SHOOT,           // v = aimX, aimY
+        BOOST_ON,               // id = player
+        BOOST_OFF,
+        BLOCK_START,
+        BLOCK_END,
+        ATTACK,                 // id = player, v[0] = angle
+        ROLL,                   // id = player, v = dirX, dirY
+        CREATE_PLAYER,          // v = x, y; id = issued id
+        CREATE_ENEMY,
+        CREATE_WOLF,            // flag = alpha
+        CREATE_PROJECTILE,      // v = x, y, dirX, dirY, damage; arg = owner
+        CREATE_POWERUP,         // arg = type
+        CREATE_OBSTACLE,        // v = x, y, radius; flag = destructible
+        CREATE_SHAPED_OBSTACLE, // v = x, y, width, height, rotation; arg = shape, flag = destructible
+        REMOVE_ENTITY,          // id
+        GENERATE_OBSTACLES,     // arg = count
+        GENERATE_ENHANCED_OBSTACLES, // arg = count, flag = ensurePlayability
+        CLEAR_ENTITIES,
+        START_GAME,
+        PAUSE_GAME,
+        RESUME_GAME,
+        END_GAME,
+        RESTART_GAME,
+        SET_WORLD_BOUNDS,       // v = width, height
+        SET_ENTITY_STORE,       // flag
+        SET_FLOW_FIELD,         // flag
+        SPECIAL_ABILITY,
+        SWITCH_TARGET,          // arg = direction
+        SET_TARGETING,          // flag = enabled, v[0] = disable duration (s)
+        TARGET_BUTTON,          // v[0] = press duration (ms)
+        SET_CHUNKED_WORLD       // flag = enabled, v[0] = chunk size, arg = load radius
+    };
+
+    struct Record {
+        uint32_t tick;          // Engine frame number when the call was made
+        int32_t id;
+        int32_t arg;
+        float v[5];
+        Op op;
+        uint8_t flag;
+        uint16_t reserved;
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t recordSize;
+        uint32_t seed;
+        float worldWidth;
+        float worldHeight;
+        uint32_t recordCount;
+        uint32_t finalChecksum;  // State checksum when recording stopped
+        uint32_t finalTick;
+        uint8_t useEntityStore;
+        uint8_t useFlowField;
+        uint8_t complete;        // finish() was called
+        uint8_t reserved;
+    };
+
+    static_assert(sizeof(Record) == 36, "Record layout is part of the file format");
+    static_assert(sizeof(Header) == 36, "Header layout is part of the file format");
+
+private:
+    Header head;
+    std::vector<Record> records;
+    std::vector<uint8_t> bytes;   // Last serialize() or load()
+    bool recording;
+
+public:
+    InputLog() : head(), recording(false) {}
+
+    void begin(uint32_t seed, float worldWidth, float worldHeight,
+               bool useEntityStore, bool useFlowField) {
+        head = Header();
+        head.magic = MAGIC;
+        head.version = VERSION;
+        head.recordSize = sizeof(Record);
+        head.seed = seed;
+        head.worldWidth = worldWidth;
+        head.worldHeight = worldHeight;
+        head.useEntityStore = useEntityStore ? 1 : 0;
+        head.useFlowField = useFlowField ? 1 : 0;
+        records.clear();
+        recording = true;
+    }
+
+    void append(const Record& record) {
+        if (recording) records.push_back(record);
+    }
+
+    void finish(uint32_t checksum, uint32_t tick) {
+        if (!recording) return;
+        head.finalChecksum = checksum;
+        head.finalTick = tick;
+        head.complete = 1;
+        recording = false;
+    }
+
+    bool isRecording() const { return recording; }
+    const Header& header() const { return head; }
+    const std::vector<Record>& getRecords() const { return records; }
+
+    // Flatten header and records into getBytes()
+    const std::vector<uint8_t>& serialize() {
+        head.recordCount = static_cast<uint32_t>(records.size());
+        bytes.resize(sizeof(Header) + records.size() * sizeof(Record));
+        std::memcpy(bytes.data(), &head, sizeof(Header));
+        if (!records.empty()) {
+            std::memcpy(bytes.data() + sizeof(Header), records.data(), records.size() * sizeof(Record));
+        }
+        return bytes;
+    }
+
+    // Scratch the caller fills before load(size), e.g. from JavaScript
+    uint8_t* loadBuffer(size_t size) {
+        bytes.resize(size);
+        return bytes.data();
+    }
+
+    // Parse loadBuffer contents; false on a bad or truncated log
+    bool load(size_t size) {
+        if (size > bytes.size() || size < sizeof(Header)) return false;
+        return load(bytes.data(), size);
+    }
+
+    bool load(const uint8_t* data, size_t size) {
+        if (size < sizeof(Header)) return false;
+        Header parsed;
+        std::memcpy(&parsed, data, sizeof(Header));
+        if (parsed.magic != MAGIC || parsed.version != VERSION ||
+            parsed.recordSize != sizeof(Record)) {
+            return false;
+        }
+        size_t needed = sizeof(Header) + static_cast<size_t>(parsed.recordCount) * sizeof(Record);
+        if (size < needed) return false;
+
+        head = parsed;
+        records.resize(parsed.recordCount);
+        if (parsed.recordCount > 0) {
+            std::memcpy(records.data(), data + sizeof(Header), parsed.recordCount * sizeof(Record));
+        }
+        recording = false;
+        return true;
+    }
+
+    const std::vector<uint8_t>& getBytes() const { return bytes; }
+};
+
+#endif // INPUT_LOG_H
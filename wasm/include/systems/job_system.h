@@ -0,0 +1,184 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#ifdef THREADING_ENABLED
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#endif
+
+// Persistent worker pool with a chunked parallel-for
+//
+// Built with THREADING_ENABLED (the pthread build, see
+// scripts/build-wasm-threads.sh) the pool keeps its threads parked on a
+// condition variable between jobs; parallelFor() publishes one range job,
+// the workers and the calling thread claim fixed-size chunks from an atomic
+// cursor, and the caller returns once every chunk is done. Without
+// THREADING_ENABLED, or with zero workers, parallelFor() runs the whole range
+// inline, so callers never need a separate serial path.
+//
+// Jobs must only write to their own [begin, end) slice.
+class JobSystem {
+public:
+    static constexpr int MAX_WORKERS = 7;
+    static constexpr size_t DEFAULT_MIN_CHUNK = 256;
+
+    JobSystem() : workerCount(0) {}
+    ~JobSystem() { stop(); }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Worker count that leaves the calling thread one core
+    static int defaultWorkerCount() {
+#ifdef THREADING_ENABLED
+        int cores = static_cast<int>(std::thread::hardware_concurrency());
+        return std::clamp(cores - 1, 0, MAX_WORKERS);
+#else
+        return 0;
+#endif
+    }
+
+    // (Re)start the pool; a no-op in single-threaded builds
+    void start(int workers) {
+        stop();
+#ifdef THREADING_ENABLED
+        workerCount = std::clamp(workers, 0, MAX_WORKERS);
+        quitting = false;
+        generation = 0;
+        busyWorkers = 0;
+        for (int i = 0; i < workerCount; i++) {
+            threads.emplace_back([this]() { workerLoop(); });
+        }
+#else
+        (void)workers;
+#endif
+    }
+
+    void stop() {
+#ifdef THREADING_ENABLED
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quitting = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        threads.clear();
+#endif
+        workerCount = 0;
+    }
+
+    int getWorkerCount() const { return workerCount; }
+
+    // Run fn(begin, end) over [0, count) in chunks of at least minChunk
+    template<typename Fn>
+    void parallelFor(size_t count, size_t minChunk, const Fn& fn) {
+        if (count == 0) return;
+        minChunk = std::max<size_t>(minChunk, 1);
+        if (workerCount == 0 || count < minChunk * 2) {
+            fn(size_t(0), count);
+            return;
+        }
+#ifdef THREADING_ENABLED
+        // A few chunks per thread so uneven chunks still balance out
+        size_t threadsTotal = static_cast<size_t>(workerCount) + 1;
+        size_t chunk = std::max(minChunk, (count + threadsTotal * 4 - 1) / (threadsTotal * 4));
+        run(count, chunk, &invoke<Fn>, &fn);
+#endif
+    }
+
+private:
+    using RangeFn = void (*)(const void* context, size_t begin, size_t end);
+
+    template<typename Fn>
+    static void invoke(const void* context, size_t begin, size_t end) {
+        (*static_cast<const Fn*>(context))(begin, end);
+    }
+
+    int workerCount;
+
+#ifdef THREADING_ENABLED
+    struct Job {
+        RangeFn fn;
+        const void* context;
+        size_t count;
+        size_t chunk;
+        size_t chunkTotal;
+    };
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    Job job;
+    uint64_t generation;
+    int busyWorkers;
+    bool quitting;
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<size_t> chunksDone{0};
+
+    void run(size_t count, size_t chunk, RangeFn fn, const void* context) {
+        {
+            // A worker that woke late for the previous job may still be
+            // spinning on its exhausted cursor; let it finish first
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [&]() { return busyWorkers == 0; });
+            job = {fn, context, count, chunk, (count + chunk - 1) / chunk};
+            nextChunk.store(0, std::memory_order_relaxed);
+            chunksDone.store(0, std::memory_order_relaxed);
+            generation++;
+        }
+        wake.notify_all();
+
+        Job local = job;
+        runChunks(local);
+
+        // Also wait for workers to let go of this job before it is replaced
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&]() {
+            return chunksDone.load(std::memory_order_acquire) == local.chunkTotal && busyWorkers == 0;
+        });
+    }
+
+    void runChunks(const Job& local) {
+        for (;;) {
+            size_t index = nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (index >= local.chunkTotal) break;
+            size_t begin = index * local.chunk;
+            size_t end = std::min(begin + local.chunk, local.count);
+            local.fn(local.context, begin, end);
+            chunksDone.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    void workerLoop() {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [&]() { return quitting || generation != seen; });
+            if (quitting) return;
+
+            seen = generation;
+            Job local = job;
+            busyWorkers++;
+            lock.unlock();
+
+            runChunks(local);
+
+            lock.lock();
+            busyWorkers--;
+            finished.notify_all();
+        }
+    }
+#endif
+};
+
+#endif // JOB_SYSTEM_H
@@ -0,0 +1,227 @@
+#ifndef OBSTACLE_GENERATOR_H
+#define OBSTACLE_GENERATOR_H
+
+#include <cmath>
+#include <algorithm>
+#include "../math/vector2.h"
+#include "../config/game_config.h"
+#include "../memory/frame_arena.h"
+#include "../utils/sim_context.h"
+
+// Blue-noise obstacle layout (Poisson-disk sampling, Bridson's algorithm)
+//
+// A placement is one obstacle or a cluster of 2-4 joined shapes, and its
+// footprint is the circle that bounds it. Placements grow outward from a
+// seed: a random active placement proposes up to OBSTACLE_SAMPLE_ATTEMPTS
+// points in the ring just beyond it, the first point whose footprint keeps
+// `gap` clear of every other footprint, the world edges and the spawn area is
+// taken, and a placement that runs out of attempts retires. With the default
+// gap of two player widths there is always a way between any two placements,
+// so playability holds by construction rather than by a retry budget.
+//
+// Footprint centres are binned in a flat grid whose cells are too small to
+// hold two of them, so rejecting a candidate reads a fixed window of cells
+// whatever the obstacle count. All scratch comes from the frame arena.
+class ObstacleGenerator {
+public:
+    struct Placement {
+        float x;
+        float y;
+        int shape;          // ObstacleShape: 0 circle (width = diameter), 1 square, 2 rectangle
+        float width;
+        float height;
+        float rotation;
+        bool destructible;
+    };
+
+    struct Params {
+        float worldWidth;
+        float worldHeight;
+        Vector2 safeCenter;   // Kept clear (the player spawn)
+        float safeRadius;
+        float gap;            // Clear space between footprints and to the world edge
+        int count;            // Obstacles wanted; fewer when the world fills up
+    };
+
+private:
+    static constexpr int MAX_MEMBERS = 4;
+    static constexpr int SEED_ATTEMPTS = 32;
+    static constexpr float TWO_PI = 6.28318530718f;
+    // Smallest footprint any design can have (a minimum-radius circle)
+    static constexpr float MIN_EXTENT = Config::OBSTACLE_MIN_RADIUS;
+
+    struct Design {
+        Placement members[MAX_MEMBERS];   // Offsets from the footprint centre
+        int memberCount;
+        float extent;                     // Footprint radius
+    };
+
+    struct Sample {
+        float x;
+        float y;
+        float extent;
+    };
+
+    static float memberExtent(const Placement& member) {
+        if (member.shape == 0) return member.width * 0.5f;
+        return 0.5f * std::sqrt(member.width * member.width + member.height * member.height);
+    }
+
+    // Same shape and size mix as the old retry-based generator
+    static Placement makeMember(SimRandom& rng, bool clustered) {
+        const int minR = static_cast<int>(Config::OBSTACLE_MIN_RADIUS);
+        const int spread = static_cast<int>(Config::OBSTACLE_MAX_RADIUS - Config::OBSTACLE_MIN_RADIUS);
+        Placement member = {0, 0, 0, 0, 0, 0, false};
+        if (clustered) {
+            member.shape = rng.nextInt(3);
+        } else {
+            int roll = rng.nextInt(100);
+            member.shape = roll < 33 ? 0 : (roll < 66 ? 1 : 2);
+        }
+        member.destructible = rng.nextInt(100) < (clustered ? 25 : 30);
+
+        if (member.shape == 0) {
+            member.width = 2.0f * (minR + rng.nextInt(spread));
+            member.height = member.width;
+        } else if (member.shape == 1) {
+            member.width = clustered ? 2.0f * minR + rng.nextInt(2 * spread)
+                                     : 1.5f * minR + rng.nextInt(static_cast<int>(1.5f * spread));
+            member.height = member.width;
+            member.rotation = rng.nextInt(clustered ? 4 : 8) * static_cast<float>(M_PI) / 4;
+        } else {
+            float base = clustered ? 2.0f * minR : 1.5f * minR;
+            member.width = base + rng.nextInt(2 * spread);
+            member.height = base + rng.nextInt(2 * spread);
+            member.rotation = rng.nextInt(360) * static_cast<float>(M_PI) / 180.0f;
+        }
+        return member;
+    }
+
+    static Design makeDesign(SimRandom& rng) {
+        Design design;
+        design.extent = 0;
+        if (rng.nextInt(100) < 40) {
+            // Cluster members overlap into one compound shape
+            design.memberCount = 2 + rng.nextInt(MAX_MEMBERS - 1);
+            for (int j = 0; j < design.memberCount; j++) {
+                float angle = (j * TWO_PI) / design.memberCount + rng.nextInt(100) * 0.01f;
+                float distance = 20.0f + rng.nextInt(50);
+                Placement member = makeMember(rng, true);
+                member.x = std::cos(angle) * distance;
+                member.y = std::sin(angle) * distance;
+                design.members[j] = member;
+                design.extent = std::max(design.extent, distance + memberExtent(member));
+            }
+        } else {
+            design.memberCount = 1;
+            design.members[0] = makeMember(rng, false);
+            design.extent = memberExtent(design.members[0]);
+        }
+        return design;
+    }
+
+public:
+    // Emits each obstacle through emit(const Placement&) in world space and
+    // returns how many were emitted
+    template<typename Emit>
+    static int generate(const Params& params, SimRandom& rng, FrameArena* arena, Emit&& emit) {
+        if (params.count <= 0 || params.worldWidth <= 0 || params.worldHeight <= 0) return 0;
+
+        const float gap = std::max(params.gap, 0.0f);
+        const float cellSize = (2.0f * MIN_EXTENT + gap) * 0.70710678f;
+        const float invCell = 1.0f / cellSize;
+        const int cols = std::max(1, static_cast<int>(std::ceil(params.worldWidth * invCell)));
+        const int rows = std::max(1, static_cast<int>(std::ceil(params.worldHeight * invCell)));
+        const size_t cells = static_cast<size_t>(cols) * rows;
+
+        FrameVector<int> grid(cells, -1, ArenaAllocator<int>(arena));
+        FrameVector<Sample> samples{ArenaAllocator<Sample>(arena)};
+        FrameVector<int> active{ArenaAllocator<int>(arena)};
+        size_t expected = std::min(static_cast<size_t>(params.count), cells);
+        samples.reserve(expected);
+        active.reserve(expected);
+        float maxExtent = 0;
+
+        auto fits = [&](float x, float y, float extent) {
+            float edge = extent + gap;
+            if (x < edge || y < edge || x > params.worldWidth - edge || y > params.worldHeight - edge) {
+                return false;
+            }
+            float sx = x - params.safeCenter.x;
+            float sy = y - params.safeCenter.y;
+            float safe = params.safeRadius + extent;
+            if (sx * sx + sy * sy < safe * safe) return false;
+
+            int cx = static_cast<int>(x * invCell);
+            int cy = static_cast<int>(y * invCell);
+            int reach = static_cast<int>(std::ceil((extent + maxExtent + gap) * invCell));
+            int x0 = std::max(0, cx - reach);
+            int x1 = std::min(cols - 1, cx + reach);
+            int y0 = std::max(0, cy - reach);
+            int y1 = std::min(rows - 1, cy + reach);
+            for (int gy = y0; gy <= y1; gy++) {
+                const int* row = grid.data() + static_cast<size_t>(gy) * cols;
+                for (int gx = x0; gx <= x1; gx++) {
+                    int index = row[gx];
+                    if (index < 0) continue;
+                    const Sample& other = samples[index];
+                    float dx = x - other.x;
+                    float dy = y - other.y;
+                    float need = extent + other.extent + gap;
+                    if (dx * dx + dy * dy < need * need) return false;
+                }
+            }
+            return true;
+        };
+
+        int placed = 0;
+        Design design = makeDesign(rng);
+        auto accept = [&](float x, float y) {
+            int index = static_cast<int>(samples.size());
+            samples.push_back({x, y, design.extent});
+            grid[static_cast<size_t>(static_cast<int>(y * invCell)) * cols + static_cast<int>(x * invCell)] = index;
+            active.push_back(index);
+            maxExtent = std::max(maxExtent, design.extent);
+
+            for (int j = 0; j < design.memberCount && placed < params.count; j++) {
+                Placement member = design.members[j];
+                member.x += x;
+                member.y += y;
+                emit(member);
+                placed++;
+            }
+            design = makeDesign(rng);
+        };
+
+        for (int attempt = 0; attempt < SEED_ATTEMPTS && samples.empty(); attempt++) {
+            float x = rng.range(0, params.worldWidth);
+            float y = rng.range(0, params.worldHeight);
+            if (fits(x, y, design.extent)) accept(x, y);
+        }
+
+        while (!active.empty() && placed < params.count) {
+            size_t slot = static_cast<size_t>(rng.nextInt(static_cast<int>(active.size())));
+            Sample from = samples[active[slot]];
+            float minDistance = from.extent + design.extent + gap;
+            bool accepted = false;
+            for (int k = 0; k < Config::OBSTACLE_SAMPLE_ATTEMPTS; k++) {
+                float angle = rng.range(0, TWO_PI);
+                float distance = minDistance * (1.0f + rng.nextFloat());
+                float x = from.x + std::cos(angle) * distance;
+                float y = from.y + std::sin(angle) * distance;
+                if (fits(x, y, design.extent)) {
+                    accept(x, y);
+                    accepted = true;
+                    break;
+                }
+            }
+            if (!accepted) {
+                active[slot] = active.back();
+                active.pop_back();
+            }
+        }
+        return placed;
+    }
+};
+
+#endif // OBSTACLE_GENERATOR_H
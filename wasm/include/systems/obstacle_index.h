@@ -0,0 +1,398 @@
+#ifndef OBSTACLE_INDEX_H
+#define OBSTACLE_INDEX_H
+
+#include "../entities/entity.h"
+#include "../entities/obstacle.h"
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Static acceleration structure for segment, ray and overlap queries against
+// obstacles
+//
+// Obstacles do not move, so the index is a uniform grid built once over their
+// bounds and rebuilt only when the obstacle set changes (spawn, removal, a
+// destructible obstacle dying). Queries walk the cells under the segment in
+// order (Amanatides-Woo DDA) and test each obstacle once against its exact
+// shape: circles as circles, squares and rectangles as rotated boxes rather
+// than their bounding radius. queryBounds() serves the collision pass and
+// tests each obstacle's tight world AABB, so a long rotated wall is not
+// reported across the whole of its bounding circle.
+//
+// Queries stamp visited obstacles, so one index must not be queried from
+// several threads at once.
+class ObstacleIndex {
+public:
+    static constexpr float DEFAULT_CELL_SIZE = 128.0f;
+    static constexpr int MAX_CELLS_PER_AXIS = 256;
+
+    struct RayHit {
+        Entity* obstacle;
+        float t;          // Fraction along the segment, 0..1
+        Vector2 point;
+        Vector2 normal;   // Surface normal at the hit point
+    };
+
+private:
+    struct Shape {
+        Entity* owner;
+        float cx;
+        float cy;
+        float radius;     // Circles only
+        float halfWidth;  // Boxes, in local space
+        float halfHeight;
+        float cosR;
+        float sinR;
+        float extentX;    // Half size of the world AABB
+        float extentY;
+        bool box;
+    };
+
+    std::vector<Shape> shapes;
+    std::vector<int> cellStart;   // cols * rows + 1 offsets into cellItems
+    std::vector<int> cellItems;
+    mutable std::vector<uint32_t> stamps;
+    mutable uint32_t queryStamp;
+    float baseCellSize;
+    float cellSize;
+    float minX;
+    float minY;
+    int cols;
+    int rows;
+    bool dirty;
+
+public:
+    explicit ObstacleIndex(float cell = DEFAULT_CELL_SIZE)
+        : queryStamp(0), baseCellSize(cell), cellSize(cell), minX(0), minY(0), cols(0), rows(0), dirty(true) {}
+
+    // Flag the index for rebuild; the owner calls this whenever obstacles
+    // are added, removed or destroyed
+    void markDirty() { dirty = true; }
+    bool isDirty() const { return dirty; }
+
+    void rebuildIfDirty(const std::vector<std::unique_ptr<Entity>>& entities) {
+        if (dirty) build(entities);
+    }
+
+    void build(const std::vector<std::unique_ptr<Entity>>& entities) {
+        shapes.clear();
+        for (const auto& entity : entities) {
+            if (entity && entity->active && entity->type == EntityType::OBSTACLE) {
+                shapes.push_back(makeShape(static_cast<Obstacle*>(entity.get())));
+            }
+        }
+        buildCells();
+    }
+
+    void build(const std::vector<Entity*>& obstacles) {
+        shapes.clear();
+        for (Entity* entity : obstacles) {
+            if (entity && entity->active && entity->type == EntityType::OBSTACLE) {
+                shapes.push_back(makeShape(static_cast<Obstacle*>(entity)));
+            }
+        }
+        buildCells();
+    }
+
+    size_t size() const { return shapes.size(); }
+
+    // True when any obstacle touches the segment (early-out)
+    bool segmentBlocked(const Vector2& from, const Vector2& to, const Entity* ignore = nullptr) const {
+        return trace(from, to, nullptr, ignore);
+    }
+
+    // Nearest obstacle along the segment; fills hit when something is struck
+    bool raycast(const Vector2& from, const Vector2& to, RayHit& hit, const Entity* ignore = nullptr) const {
+        return trace(from, to, &hit, ignore);
+    }
+
+    // Active obstacles whose tight world AABB (centre +- extentX/extentY)
+    // overlaps the box, each once, in index order: a broadphase test, so
+    // callers still run the exact shape test. Returns the number written to
+    // out (cleared first).
+    size_t queryBounds(float x0, float y0, float x1, float y1, std::vector<Entity*>& out) const {
+        out.clear();
+        if (shapes.empty()) return 0;
+        if (x1 < minX || y1 < minY || x0 > minX + cols * cellSize || y0 > minY + rows * cellSize) return 0;
+
+        if (++queryStamp == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            queryStamp = 1;
+        }
+
+        int cx0 = clampCol(x0), cx1 = clampCol(x1);
+        int cy0 = clampRow(y0), cy1 = clampRow(y1);
+        for (int cy = cy0; cy <= cy1; cy++) {
+            for (int cx = cx0; cx <= cx1; cx++) {
+                int cell = cy * cols + cx;
+                for (int k = cellStart[cell]; k < cellStart[cell + 1]; k++) {
+                    int item = cellItems[k];
+                    if (stamps[item] == queryStamp) continue;
+                    stamps[item] = queryStamp;
+
+                    const Shape& s = shapes[item];
+                    if (!s.owner->active) continue;
+                    if (s.cx + s.extentX < x0 || s.cx - s.extentX > x1 ||
+                        s.cy + s.extentY < y0 || s.cy - s.extentY > y1) {
+                        continue;
+                    }
+                    out.push_back(s.owner);
+                }
+            }
+        }
+        return out.size();
+    }
+
+    // Exact segment test against one obstacle, for callers without an index.
+    // Returns the entry fraction along the segment, or a negative value.
+    static float intersectSegment(const Obstacle& obstacle, const Vector2& from, const Vector2& to) {
+        Vector2 normal;
+        return intersect(makeShape(const_cast<Obstacle*>(&obstacle)), from.x, from.y,
+                         to.x - from.x, to.y - from.y, normal);
+    }
+
+private:
+    // From the obstacle's cached frame; no trig unless it changed shape
+    static Shape makeShape(Obstacle* obstacle) {
+        obstacle->syncFrame();
+        Shape s;
+        s.owner = obstacle;
+        s.cx = obstacle->position.x;
+        s.cy = obstacle->position.y;
+        s.radius = obstacle->radius;
+        s.box = obstacle->shape != ObstacleShape::CIRCLE;
+        s.halfWidth = obstacle->halfWidth;
+        s.halfHeight = obstacle->halfHeight;
+        s.cosR = obstacle->cosR;
+        s.sinR = obstacle->sinR;
+        s.extentX = obstacle->extentX;
+        s.extentY = obstacle->extentY;
+        return s;
+    }
+
+    static void shapeBounds(const Shape& s, float& x0, float& y0, float& x1, float& y1) {
+        x0 = s.cx - s.extentX;
+        y0 = s.cy - s.extentY;
+        x1 = s.cx + s.extentX;
+        y1 = s.cy + s.extentY;
+    }
+
+    void buildCells() {
+        dirty = false;
+        stamps.assign(shapes.size(), 0);
+        queryStamp = 0;
+
+        if (shapes.empty()) {
+            cols = rows = 0;
+            cellStart.assign(1, 0);
+            cellItems.clear();
+            return;
+        }
+
+        float maxX, maxY;
+        shapeBounds(shapes[0], minX, minY, maxX, maxY);
+        for (const Shape& s : shapes) {
+            float x0, y0, x1, y1;
+            shapeBounds(s, x0, y0, x1, y1);
+            minX = std::min(minX, x0);
+            minY = std::min(minY, y0);
+            maxX = std::max(maxX, x1);
+            maxY = std::max(maxY, y1);
+        }
+
+        // Very sparse maps get coarser cells rather than a huge grid
+        float extent = std::max(maxX - minX, maxY - minY);
+        float cell = std::max(baseCellSize, extent / MAX_CELLS_PER_AXIS);
+        cellSize = cell;
+        cols = std::max(1, static_cast<int>(std::ceil((maxX - minX) / cell)));
+        rows = std::max(1, static_cast<int>(std::ceil((maxY - minY) / cell)));
+
+        // Counting sort of (cell, shape) pairs
+        cellStart.assign(static_cast<size_t>(cols) * rows + 1, 0);
+        forEachCell([&](int cell, int) { cellStart[cell + 1]++; });
+        for (size_t i = 1; i < cellStart.size(); i++) cellStart[i] += cellStart[i - 1];
+        cellItems.resize(cellStart.back());
+        std::vector<int> cursor(cellStart.begin(), cellStart.end() - 1);
+        forEachCell([&](int cell, int item) { cellItems[cursor[cell]++] = item; });
+    }
+
+    template<typename Fn>
+    void forEachCell(Fn&& fn) const {
+        for (int i = 0; i < static_cast<int>(shapes.size()); i++) {
+            float x0, y0, x1, y1;
+            shapeBounds(shapes[i], x0, y0, x1, y1);
+            int cx0 = clampCol(x0), cx1 = clampCol(x1);
+            int cy0 = clampRow(y0), cy1 = clampRow(y1);
+            for (int cy = cy0; cy <= cy1; cy++) {
+                for (int cx = cx0; cx <= cx1; cx++) {
+                    fn(cy * cols + cx, i);
+                }
+            }
+        }
+    }
+
+    int clampCol(float x) const {
+        return std::clamp(static_cast<int>((x - minX) / cellSize), 0, cols - 1);
+    }
+
+    int clampRow(float y) const {
+        return std::clamp(static_cast<int>((y - minY) / cellSize), 0, rows - 1);
+    }
+
+    bool trace(const Vector2& from, const Vector2& to, RayHit* hit, const Entity* ignore) const {
+        if (shapes.empty()) return false;
+
+        float dx = to.x - from.x;
+        float dy = to.y - from.y;
+
+        // Clip the segment to the grid bounds
+        float t0 = 0.0f, t1 = 1.0f;
+        float maxX = minX + cols * cellSize;
+        float maxY = minY + rows * cellSize;
+        if (!clipAxis(from.x, dx, minX, maxX, t0, t1) ||
+            !clipAxis(from.y, dy, minY, maxY, t0, t1)) {
+            return false;
+        }
+
+        if (++queryStamp == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            queryStamp = 1;
+        }
+
+        float startX = from.x + dx * t0;
+        float startY = from.y + dy * t0;
+        int cx = clampCol(startX);
+        int cy = clampRow(startY);
+        int stepX = dx > 0 ? 1 : (dx < 0 ? -1 : 0);
+        int stepY = dy > 0 ? 1 : (dy < 0 ? -1 : 0);
+
+        // Segment fraction at which the walk crosses the next cell boundary
+        const float inf = 1e30f;
+        float tDeltaX = stepX ? cellSize / std::abs(dx) : inf;
+        float tDeltaY = stepY ? cellSize / std::abs(dy) : inf;
+        float tMaxX = stepX ? (minX + (cx + (stepX > 0 ? 1 : 0)) * cellSize - from.x) / dx : inf;
+        float tMaxY = stepY ? (minY + (cy + (stepY > 0 ? 1 : 0)) * cellSize - from.y) / dy : inf;
+
+        float bestT = 2.0f;
+        Vector2 bestNormal;
+        const Shape* best = nullptr;
+
+        for (;;) {
+            int cell = cy * cols + cx;
+            for (int k = cellStart[cell]; k < cellStart[cell + 1]; k++) {
+                int item = cellItems[k];
+                if (stamps[item] == queryStamp) continue;
+                stamps[item] = queryStamp;
+
+                const Shape& s = shapes[item];
+                if (s.owner == ignore || !s.owner->active) continue;
+
+                Vector2 normal;
+                float t = intersect(s, from.x, from.y, dx, dy, normal);
+                if (t < 0.0f || t >= bestT) continue;
+                if (!hit) return true;
+                bestT = t;
+                bestNormal = normal;
+                best = &s;
+            }
+
+            // Nothing further along can be nearer than a hit inside this cell
+            float cellExit = std::min(tMaxX, tMaxY);
+            if (best && bestT <= cellExit) break;
+            if (cellExit > t1) break;
+
+            if (tMaxX < tMaxY) {
+                cx += stepX;
+                tMaxX += tDeltaX;
+                if (cx < 0 || cx >= cols) break;
+            } else {
+                cy += stepY;
+                tMaxY += tDeltaY;
+                if (cy < 0 || cy >= rows) break;
+            }
+        }
+
+        if (!best) return false;
+        hit->obstacle = best->owner;
+        hit->t = bestT;
+        hit->point = Vector2(from.x + dx * bestT, from.y + dy * bestT);
+        hit->normal = bestNormal;
+        return true;
+    }
+
+    static bool clipAxis(float origin, float delta, float lo, float hi, float& t0, float& t1) {
+        if (delta == 0.0f) return origin >= lo && origin <= hi;
+        float a = (lo - origin) / delta;
+        float b = (hi - origin) / delta;
+        if (a > b) std::swap(a, b);
+        t0 = std::max(t0, a);
+        t1 = std::min(t1, b);
+        return t0 <= t1;
+    }
+
+    // Entry fraction of segment (px,py)+(dx,dy)*t, t in [0,1], or -1.
+    // A segment starting inside the shape hits at t = 0.
+    static float intersect(const Shape& s, float px, float py, float dx, float dy, Vector2& normal) {
+        float fx = px - s.cx;
+        float fy = py - s.cy;
+
+        if (!s.box) {
+            float a = dx * dx + dy * dy;
+            float c = fx * fx + fy * fy - s.radius * s.radius;
+            if (c <= 0.0f) {
+                normal = Vector2(-dx, -dy).normalized();
+                return 0.0f;
+            }
+            if (a == 0.0f) return -1.0f;
+            float b = fx * dx + fy * dy;
+            float disc = b * b - a * c;
+            if (disc < 0.0f || b > 0.0f) return -1.0f;
+            float t = (-b - std::sqrt(disc)) / a;
+            if (t > 1.0f) return -1.0f;
+            normal = Vector2(fx + dx * t, fy + dy * t).normalized();
+            return t;
+        }
+
+        // Rotate into the box frame and slab test
+        float lx = fx * s.cosR + fy * s.sinR;
+        float ly = -fx * s.sinR + fy * s.cosR;
+        float ldx = dx * s.cosR + dy * s.sinR;
+        float ldy = -dx * s.sinR + dy * s.cosR;
+
+        float tEnter = 0.0f, tExit = 1.0f;
+        int axis = -1;
+        if (!slab(lx, ldx, s.halfWidth, tEnter, tExit, axis, 0) ||
+            !slab(ly, ldy, s.halfHeight, tEnter, tExit, axis, 1)) {
+            return -1.0f;
+        }
+
+        float nx = 0.0f, ny = 0.0f;
+        if (axis == 0) nx = ldx > 0 ? -1.0f : 1.0f;
+        else if (axis == 1) ny = ldy > 0 ? -1.0f : 1.0f;
+        else {
+            // Started inside
+            normal = Vector2(-dx, -dy).normalized();
+            return 0.0f;
+        }
+        normal = Vector2(nx * s.cosR - ny * s.sinR, nx * s.sinR + ny * s.cosR);
+        return tEnter;
+    }
+
+    static bool slab(float origin, float delta, float half, float& tEnter, float& tExit,
+                     int& axis, int axisId) {
+        if (delta == 0.0f) return origin >= -half && origin <= half;
+        float a = (-half - origin) / delta;
+        float b = (half - origin) / delta;
+        if (a > b) std::swap(a, b);
+        if (a > tEnter) {
+            tEnter = a;
+            axis = axisId;
+        }
+        tExit = std::min(tExit, b);
+        return tEnter <= tExit;
+    }
+};
+
+#endif // OBSTACLE_INDEX_H
@@ -0,0 +1,163 @@
+#ifndef QUALITY_GOVERNOR_H
+#define QUALITY_GOVERNOR_H
+
+#include "../config/game_config.h"
+#include "../utils/performance_monitor.h"
+#include <algorithm>
+#include <cstdint>
+
+// Picks a quality level from measured frame times
+//
+// observe() is fed once per update() with the wall time since the previous
+// update. Every EVAL_INTERVAL updates the governor compares the average wall
+// frame against the frame target, and the engine's own update cost (p95 of
+// MetricId::FRAME from PerformanceMonitor) against the engine budget. Two
+// over-budget evaluations in a row step the level down; the level only steps
+// back up after UPSHIFT_EVALS calm evaluations, and never sooner than that
+// after a downshift, so a device hovering at the threshold does not flap.
+//
+// A level scales what costs the device frame time without touching the
+// simulation: particle spawn density (every random draw still happens, so
+// replays and rollback match), the render export's cull margin, and the
+// substep catch-up budget. Level 0 is full quality. Nothing that decides
+// what the simulation does (AI think rates included) may hang off a level:
+// levels follow wall time, which differs between a session, its replay and
+// a rollback peer.
+//
+// pin() fixes a level and stops automatic changes; setLevel() overrides the
+// values a level uses.
+class QualityGovernor {
+public:
+    static constexpr int LEVEL_COUNT = 4;
+    static constexpr int EVAL_INTERVAL = 30;    // Updates per evaluation
+    static constexpr int DOWNSHIFT_EVALS = 2;
+    static constexpr int UPSHIFT_EVALS = 8;
+
+    struct Level {
+        float particleDensity;   // Fraction of effect particles spawned
+        float cullMarginScale;   // Times the engine's cull margin
+        int maxSubsteps;         // Cap on the engine's substep budget
+    };
+
+    struct Settings {
+        float targetFrameMs = 1000.0f / 60.0f;
+        float engineBudgetMs = 8.0f;       // update() cost, p95
+        float downshiftRatio = 1.2f;       // Average frame above target * ratio is over budget
+        float upshiftRatio = 1.05f;        // ... and below target * ratio is calm
+    };
+
+private:
+    Level levels[LEVEL_COUNT];
+    Settings settings;
+    int level;
+    int pinned;            // -1 = automatic
+    bool enabled;
+
+    double frameSumMs;
+    int frames;
+    int overEvals;
+    int calmEvals;
+    float lastFrameMs;     // Average wall frame of the last evaluation
+    float lastEngineMs;    // Engine p95 of the last evaluation
+    uint32_t changes;
+
+public:
+    QualityGovernor()
+        : levels{
+              {1.00f, 1.00f, Config::MAX_SUBSTEPS},
+              {0.60f, 0.75f, 4},
+              {0.35f, 0.50f, 3},
+              {0.15f, 0.25f, 2}
+          },
+          level(0), pinned(-1), enabled(true),
+          frameSumMs(0), frames(0), overEvals(0), calmEvals(0),
+          lastFrameMs(0), lastEngineMs(0), changes(0) {}
+
+    // Turning automatic control off returns to full quality unless pinned
+    void setEnabled(bool on) {
+        enabled = on;
+        if (!on && pinned < 0) setCurrent(0);
+        resetWindow();
+    }
+    bool isEnabled() const { return enabled; }
+
+    void setSettings(const Settings& s) { settings = s; }
+    const Settings& getSettings() const { return settings; }
+
+    // Fix a level (clamped); -1 returns to automatic control
+    void pin(int fixedLevel) {
+        if (fixedLevel < 0) {
+            pinned = -1;
+        } else {
+            pinned = std::min(fixedLevel, LEVEL_COUNT - 1);
+            setCurrent(pinned);
+        }
+        resetWindow();
+    }
+    int getPinned() const { return pinned; }
+
+    void setLevel(int index, const Level& values) {
+        if (index < 0 || index >= LEVEL_COUNT) return;
+        levels[index] = values;
+    }
+    const Level& getLevel(int index) const {
+        return levels[std::clamp(index, 0, LEVEL_COUNT - 1)];
+    }
+
+    int current() const { return level; }
+    const Level& values() const { return levels[level]; }
+
+    // One update's wall time; true when the level changed
+    bool observe(float frameMs) {
+        if (!enabled || pinned >= 0) return false;
+        frameSumMs += std::max(frameMs, 0.0f);
+        if (++frames < EVAL_INTERVAL) return false;
+        return evaluate();
+    }
+
+    float getLastFrameMs() const { return lastFrameMs; }
+    float getLastEngineMs() const { return lastEngineMs; }
+    uint32_t getChangeCount() const { return changes; }
+
+private:
+    bool evaluate() {
+        lastFrameMs = static_cast<float>(frameSumMs / frames);
+        PerformanceMonitor::Summary engine = PerformanceMonitor::getInstance().summarize(MetricId::FRAME);
+        lastEngineMs = static_cast<float>(engine.p95);
+        frameSumMs = 0;
+        frames = 0;
+
+        bool over = lastFrameMs > settings.targetFrameMs * settings.downshiftRatio ||
+                    lastEngineMs > settings.engineBudgetMs;
+        bool calm = lastFrameMs < settings.targetFrameMs * settings.upshiftRatio &&
+                    lastEngineMs < settings.engineBudgetMs * 0.5f;
+        overEvals = over ? overEvals + 1 : 0;
+        calmEvals = calm ? calmEvals + 1 : 0;
+
+        if (overEvals >= DOWNSHIFT_EVALS && level < LEVEL_COUNT - 1) {
+            setCurrent(level + 1);
+            return true;
+        }
+        if (calmEvals >= UPSHIFT_EVALS && level > 0) {
+            setCurrent(level - 1);
+            return true;
+        }
+        return false;
+    }
+
+    void setCurrent(int next) {
+        if (next != level) changes++;
+        level = next;
+        overEvals = 0;
+        calmEvals = 0;
+    }
+
+    void resetWindow() {
+        frameSumMs = 0;
+        frames = 0;
+        overEvals = 0;
+        calmEvals = 0;
+    }
+};
+
+#endif // QUALITY_GOVERNOR_H
@@ -0,0 +1,484 @@
+#ifndef ROLLBACK_BUFFER_H
+#define ROLLBACK_BUFFER_H
+
+#include "../entities/entity.h"
+#include "../entities/player.h"
+#include "../entities/enemy.h"
+#include "../entities/wolf.h"
+#include "../entities/projectile.h"
+#include "../entities/powerup.h"
+#include "../entities/obstacle.h"
+#include "../utils/handle_table.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+// Whole-world saves for rollback netcode
+//
+// Each saved tick is one flat byte block: the owner's globals and the
+// trivially copyable system states (random stream, latched player input,
+// waves, targeting, pending stimuli, handle table) memcpy'd in, then one fixed-size EntityRecord per entity in list
+// order. Nothing in a block points anywhere (entities refer to each other by
+// id), so blocks can be copied, moved or sent as bytes. The ring keeps the last depth ticks; every slot
+// keeps its storage, so saving at a steady entity count allocates nothing.
+//
+// EntityRecord converts between live entities and records. restore() writes
+// records back into the objects already in the list where the id and type
+// still match and only builds the entities that were removed since.
+class RollbackBuffer {
+public:
+    // Appends trivially copyable values to a block
+    class Writer {
+        std::vector<uint8_t>& out;
+
+    public:
+        explicit Writer(std::vector<uint8_t>& block) : out(block) {}
+
+        template<typename T>
+        void put(const T& value) { putArray(&value, 1); }
+
+        template<typename T>
+        void putArray(const T* values, size_t count) {
+            static_assert(std::is_trivially_copyable<T>::value, "snapshot fields must be trivially copyable");
+            size_t at = out.size();
+            out.resize(at + sizeof(T) * count);
+            if (count) std::memcpy(out.data() + at, values, sizeof(T) * count);
+        }
+    };
+
+    // Reads a block back in the order it was written; ok() turns false on
+    // the first read past the end and every later read is skipped
+    class Reader {
+        const uint8_t* data;
+        size_t size;
+        size_t offset;
+        bool valid;
+
+    public:
+        Reader(const uint8_t* bytes, size_t length) : data(bytes), size(length), offset(0), valid(true) {}
+
+        template<typename T>
+        bool get(T& value) { return getArray(&value, 1); }
+
+        template<typename T>
+        bool getArray(T* values, size_t count) {
+            static_assert(std::is_trivially_copyable<T>::value, "snapshot fields must be trivially copyable");
+            size_t bytes = sizeof(T) * count;
+            if (!valid || bytes > size - offset) return valid = false;
+            if (count) std::memcpy(values, data + offset, bytes);
+            offset += bytes;
+            return true;
+        }
+
+        bool ok() const { return valid; }
+    };
+
+    // Everything an entity carries between ticks, for every type. Pointers
+    // are stored as an id (the enemy target) or a flag (the shared flow
+    // field, owned by the engine).
+    struct EntityRecord {
+        int32_t id;
+        uint8_t type;
+        uint8_t active;
+        uint8_t invulnerable;
+        uint8_t reserved;
+        float x, y, previousX, previousY, vx, vy;
+        float rotation, radius, health, maxHealth, invulnerabilityTimer;
+
+        struct PlayerPart {
+            float energy, maxEnergy;
+            float boostCooldown, boostDuration;
+            float blockCooldown, blockDuration, blockStartTime;
+            float attackCooldown, attackAngle;
+            float rollCooldown, rollDuration, rollDirectionX, rollDirectionY;
+            float speedMultiplier, damageMultiplier;
+            float shieldDuration, rapidFireDuration, multiShotDuration;
+            int32_t score, lives, kills;
+            uint8_t flags;   // PLAYER_* bits
+        };
+
+        struct EnemyPart {
+            float damage, speed, attackCooldown, stunDuration;
+            int32_t targetId;
+            uint8_t aiState;
+            uint8_t stunned;
+            uint8_t followsFlowField;
+            // Wolves only
+            uint8_t wolfState;
+            uint8_t isAlpha;
+            float patrolTargetX, patrolTargetY;
+            float lungeCooldown, lungeSpeed, howlCooldown, packCoordinationTimer;
+            float circleX, circleY;
+            float lungeTimer, recoveryTimer;
+            int32_t packIndex, packSize;
+        };
+
+        struct ProjectilePart {
+            float damage, speed, lifetime;
+            int32_t ownerId;
+            float directionX, directionY;
+        };
+
+        struct PowerUpPart {
+            uint8_t powerType;
+            float lifetime, bobOffset, bobSpeed;
+        };
+
+        struct ObstaclePart {
+            uint8_t destructible;
+            uint8_t shape;
+            float durability, width, height, rotation;
+        };
+
+        union {
+            PlayerPart player;
+            EnemyPart enemy;
+            ProjectilePart projectile;
+            PowerUpPart powerUp;
+            ObstaclePart obstacle;
+        };
+
+        static constexpr uint8_t PLAYER_BOOSTING = 1 << 0;
+        static constexpr uint8_t PLAYER_BLOCKING = 1 << 1;
+        static constexpr uint8_t PLAYER_PARRY = 1 << 2;
+        static constexpr uint8_t PLAYER_ATTACKING = 1 << 3;
+        static constexpr uint8_t PLAYER_ROLLING = 1 << 4;
+        static constexpr uint8_t PLAYER_SHIELD = 1 << 5;
+        static constexpr uint8_t PLAYER_RAPID_FIRE = 1 << 6;
+        static constexpr uint8_t PLAYER_MULTI_SHOT = 1 << 7;
+
+        void capture(const Entity& entity) {
+            std::memset(this, 0, sizeof(*this));
+            id = entity.id;
+            type = static_cast<uint8_t>(entity.type);
+            active = entity.active;
+            invulnerable = entity.invulnerable;
+            x = entity.position.x;
+            y = entity.position.y;
+            previousX = entity.previousPosition.x;
+            previousY = entity.previousPosition.y;
+            vx = entity.velocity.x;
+            vy = entity.velocity.y;
+            rotation = entity.rotation;
+            radius = entity.radius;
+            health = entity.health;
+            maxHealth = entity.maxHealth;
+            invulnerabilityTimer = entity.invulnerabilityTimer;
+
+            switch (entity.type) {
+                case EntityType::PLAYER: capturePlayer(static_cast<const Player&>(entity)); break;
+                case EntityType::ENEMY: captureEnemy(static_cast<const Enemy&>(entity)); break;
+                case EntityType::WOLF: {
+                    const Wolf& wolf = static_cast<const Wolf&>(entity);
+                    captureEnemy(wolf);
+                    EnemyPart& e = enemy;
+                    e.wolfState = static_cast<uint8_t>(wolf.wolfState);
+                    e.isAlpha = wolf.isAlpha;
+                    e.patrolTargetX = wolf.patrolTarget.x;
+                    e.patrolTargetY = wolf.patrolTarget.y;
+                    e.lungeCooldown = wolf.lungeCooldown;
+                    e.lungeSpeed = wolf.lungeSpeed;
+                    e.howlCooldown = wolf.howlCooldown;
+                    e.packCoordinationTimer = wolf.packCoordinationTimer;
+                    e.circleX = wolf.circlePosition.x;
+                    e.circleY = wolf.circlePosition.y;
+                    e.lungeTimer = wolf.lungeTimer;
+                    e.recoveryTimer = wolf.recoveryTimer;
+                    e.packIndex = wolf.packIndex;
+                    e.packSize = wolf.packSize;
+                    break;
+                }
+                case EntityType::PROJECTILE: {
+                    const Projectile& p = static_cast<const Projectile&>(entity);
+                    projectile = {p.damage, p.speed, p.lifetime, p.ownerId, p.direction.x, p.direction.y};
+                    break;
+                }
+                case EntityType::POWERUP: {
+                    const PowerUp& p = static_cast<const PowerUp&>(entity);
+                    powerUp = {static_cast<uint8_t>(p.powerType), p.lifetime, p.bobOffset, p.bobSpeed};
+                    break;
+                }
+                case EntityType::OBSTACLE: {
+                    const Obstacle& o = static_cast<const Obstacle&>(entity);
+                    obstacle = {o.destructible, static_cast<uint8_t>(o.shape),
+                                o.durability, o.width, o.height, o.rotation};
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        // A blank entity of this record's type, for apply() to fill in
+        std::unique_ptr<Entity> instantiate() const {
+            Vector2 at(x, y);
+            switch (static_cast<EntityType>(type)) {
+                case EntityType::PLAYER: return std::make_unique<Player>(at);
+                case EntityType::ENEMY: return std::make_unique<Enemy>(at);
+                case EntityType::WOLF: return std::make_unique<Wolf>(at, enemy.isAlpha != 0);
+                case EntityType::PROJECTILE:
+                    return std::make_unique<Projectile>(at, Vector2(projectile.directionX, projectile.directionY),
+                                                        projectile.damage, projectile.ownerId);
+                case EntityType::POWERUP:
+                    return std::make_unique<PowerUp>(at, static_cast<PowerUpType>(powerUp.powerType));
+                case EntityType::OBSTACLE:
+                    return std::make_unique<Obstacle>(at, static_cast<ObstacleShape>(obstacle.shape),
+                                                      obstacle.width, obstacle.height, obstacle.rotation,
+                                                      obstacle.destructible != 0);
+                default:
+                    return nullptr;
+            }
+        }
+
+        // Write back into an entity of the same type. Links (enemy target
+        // and flow field) are left to the caller, which resolves them once
+        // every entity is in place.
+        void apply(Entity& entity) const {
+            entity.id = id;
+            entity.active = active != 0;
+            entity.invulnerable = invulnerable != 0;
+            entity.position = Vector2(x, y);
+            entity.previousPosition = Vector2(previousX, previousY);
+            entity.velocity = Vector2(vx, vy);
+            entity.rotation = rotation;
+            entity.radius = radius;
+            entity.health = health;
+            entity.maxHealth = maxHealth;
+            entity.invulnerabilityTimer = invulnerabilityTimer;
+
+            switch (entity.type) {
+                case EntityType::PLAYER: applyPlayer(static_cast<Player&>(entity)); break;
+                case EntityType::ENEMY: applyEnemy(static_cast<Enemy&>(entity)); break;
+                case EntityType::WOLF: {
+                    Wolf& wolf = static_cast<Wolf&>(entity);
+                    applyEnemy(wolf);
+                    const EnemyPart& e = enemy;
+                    wolf.wolfState = static_cast<Wolf::WolfState>(e.wolfState);
+                    wolf.isAlpha = e.isAlpha != 0;
+                    wolf.patrolTarget = Vector2(e.patrolTargetX, e.patrolTargetY);
+                    wolf.lungeCooldown = e.lungeCooldown;
+                    wolf.lungeSpeed = e.lungeSpeed;
+                    wolf.howlCooldown = e.howlCooldown;
+                    wolf.packCoordinationTimer = e.packCoordinationTimer;
+                    wolf.circlePosition = Vector2(e.circleX, e.circleY);
+                    wolf.lungeTimer = e.lungeTimer;
+                    wolf.recoveryTimer = e.recoveryTimer;
+                    wolf.packIndex = e.packIndex;
+                    wolf.packSize = e.packSize;
+                    break;
+                }
+                case EntityType::PROJECTILE: {
+                    Projectile& p = static_cast<Projectile&>(entity);
+                    p.damage = projectile.damage;
+                    p.speed = projectile.speed;
+                    p.lifetime = projectile.lifetime;
+                    p.ownerId = projectile.ownerId;
+                    p.direction = Vector2(projectile.directionX, projectile.directionY);
+                    break;
+                }
+                case EntityType::POWERUP: {
+                    PowerUp& p = static_cast<PowerUp&>(entity);
+                    p.powerType = static_cast<PowerUpType>(powerUp.powerType);
+                    p.lifetime = powerUp.lifetime;
+                    p.bobOffset = powerUp.bobOffset;
+                    p.bobSpeed = powerUp.bobSpeed;
+                    break;
+                }
+                case EntityType::OBSTACLE: {
+                    Obstacle& o = static_cast<Obstacle&>(entity);
+                    o.destructible = obstacle.destructible != 0;
+                    o.shape = static_cast<ObstacleShape>(obstacle.shape);
+                    o.durability = obstacle.durability;
+                    o.width = obstacle.width;
+                    o.height = obstacle.height;
+                    o.rotation = obstacle.rotation;
+                    o.syncFrame();
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+    private:
+        void capturePlayer(const Player& p) {
+            PlayerPart& s = player;
+            s.energy = p.energy;
+            s.maxEnergy = p.maxEnergy;
+            s.boostCooldown = p.boostCooldown;
+            s.boostDuration = p.boostDuration;
+            s.blockCooldown = p.blockCooldown;
+            s.blockDuration = p.blockDuration;
+            s.blockStartTime = p.blockStartTime;
+            s.attackCooldown = p.attackCooldown;
+            s.attackAngle = p.attackAngle;
+            s.rollCooldown = p.rollCooldown;
+            s.rollDuration = p.rollDuration;
+            s.rollDirectionX = p.rollDirection.x;
+            s.rollDirectionY = p.rollDirection.y;
+            s.speedMultiplier = p.speedMultiplier;
+            s.damageMultiplier = p.damageMultiplier;
+            s.shieldDuration = p.shieldDuration;
+            s.rapidFireDuration = p.rapidFireDuration;
+            s.multiShotDuration = p.multiShotDuration;
+            s.score = p.score;
+            s.lives = p.lives;
+            s.kills = p.kills;
+            s.flags = (p.boosting ? PLAYER_BOOSTING : 0) | (p.blocking ? PLAYER_BLOCKING : 0) |
+                      (p.perfectParryWindow ? PLAYER_PARRY : 0) | (p.attacking ? PLAYER_ATTACKING : 0) |
+                      (p.rolling ? PLAYER_ROLLING : 0) | (p.hasShield ? PLAYER_SHIELD : 0) |
+                      (p.rapidFire ? PLAYER_RAPID_FIRE : 0) | (p.multiShot ? PLAYER_MULTI_SHOT : 0);
+        }
+
+        void applyPlayer(Player& p) const {
+            const PlayerPart& s = player;
+            p.energy = s.energy;
+            p.maxEnergy = s.maxEnergy;
+            p.boostCooldown = s.boostCooldown;
+            p.boostDuration = s.boostDuration;
+            p.blockCooldown = s.blockCooldown;
+            p.blockDuration = s.blockDuration;
+            p.blockStartTime = s.blockStartTime;
+            p.attackCooldown = s.attackCooldown;
+            p.attackAngle = s.attackAngle;
+            p.rollCooldown = s.rollCooldown;
+            p.rollDuration = s.rollDuration;
+            p.rollDirection = Vector2(s.rollDirectionX, s.rollDirectionY);
+            p.speedMultiplier = s.speedMultiplier;
+            p.damageMultiplier = s.damageMultiplier;
+            p.shieldDuration = s.shieldDuration;
+            p.rapidFireDuration = s.rapidFireDuration;
+            p.multiShotDuration = s.multiShotDuration;
+            p.score = s.score;
+            p.lives = s.lives;
+            p.kills = s.kills;
+            p.boosting = (s.flags & PLAYER_BOOSTING) != 0;
+            p.blocking = (s.flags & PLAYER_BLOCKING) != 0;
+            p.perfectParryWindow = (s.flags & PLAYER_PARRY) != 0;
+            p.attacking = (s.flags & PLAYER_ATTACKING) != 0;
+            p.rolling = (s.flags & PLAYER_ROLLING) != 0;
+            p.hasShield = (s.flags & PLAYER_SHIELD) != 0;
+            p.rapidFire = (s.flags & PLAYER_RAPID_FIRE) != 0;
+            p.multiShot = (s.flags & PLAYER_MULTI_SHOT) != 0;
+        }
+
+        void captureEnemy(const Enemy& e) {
+            EnemyPart& s = enemy;
+            s.damage = e.damage;
+            s.speed = e.speed;
+            s.attackCooldown = e.attackCooldown;
+            s.stunDuration = e.stunDuration;
+            s.targetId = e.target ? e.target->id : HandleTable::NULL_HANDLE;
+            s.aiState = static_cast<uint8_t>(e.aiState);
+            s.stunned = e.stunned;
+            s.followsFlowField = e.flowField != nullptr;
+        }
+
+        void applyEnemy(Enemy& e) const {
+            const EnemyPart& s = enemy;
+            e.damage = s.damage;
+            e.speed = s.speed;
+            e.attackCooldown = s.attackCooldown;
+            e.stunDuration = s.stunDuration;
+            e.aiState = static_cast<Enemy::AIState>(s.aiState);
+            e.stunned = s.stunned != 0;
+        }
+    };
+
+    static constexpr uint32_t MAGIC = 0x4B424C52;   // "RLBK"
+    static constexpr uint16_t VERSION = 3;
+
+private:
+    struct Slot {
+        uint32_t frame;
+        bool valid;
+        std::vector<uint8_t> block;
+    };
+
+    std::vector<Slot> ring;
+    size_t next;   // Slot the next save overwrites
+
+public:
+    RollbackBuffer() : next(0) {}
+
+    // Keep the last depth saves; 0 turns saving off. Drops what is held.
+    void setDepth(int depth) {
+        ring.clear();
+        ring.resize(depth > 0 ? static_cast<size_t>(depth) : 0);
+        for (Slot& slot : ring) slot.valid = false;
+        next = 0;
+    }
+
+    int getDepth() const { return static_cast<int>(ring.size()); }
+    bool isEnabled() const { return !ring.empty(); }
+
+    // Empty block for frame, reusing the oldest slot's storage; a frame
+    // saved again (re-simulated after a rollback) keeps its slot
+    std::vector<uint8_t>& beginSave(uint32_t frame) {
+        Slot* slot = nullptr;
+        for (Slot& held : ring) {
+            if (held.valid && held.frame == frame) slot = &held;
+        }
+        if (!slot) {
+            slot = &ring[next];
+            next = (next + 1) % ring.size();
+        }
+        slot->frame = frame;
+        slot->valid = true;
+        slot->block.clear();
+        return slot->block;
+    }
+
+    // Block saved for frame, or null when it has left the ring
+    const std::vector<uint8_t>* find(uint32_t frame) const {
+        for (const Slot& slot : ring) {
+            if (slot.valid && slot.frame == frame) return &slot.block;
+        }
+        return nullptr;
+    }
+
+    // Forget saves newer than frame (their timeline was just rewritten);
+    // the next save reuses their slots first
+    void discardAfter(uint32_t frame) {
+        for (size_t i = 0; i < ring.size(); i++) {
+            Slot& slot = ring[i];
+            if (slot.valid && slot.frame > frame) slot.valid = false;
+        }
+        for (size_t i = 0; i < ring.size(); i++) {
+            if (ring[i].valid && ring[i].frame == frame) {
+                next = (i + 1) % ring.size();
+                break;
+            }
+        }
+    }
+
+    void clear() {
+        for (Slot& slot : ring) slot.valid = false;
+        next = 0;
+    }
+
+    // Oldest and newest frames held; false when nothing is
+    bool frameRange(uint32_t& oldest, uint32_t& newest) const {
+        bool any = false;
+        for (const Slot& slot : ring) {
+            if (!slot.valid) continue;
+            if (!any || slot.frame < oldest) oldest = slot.frame;
+            if (!any || slot.frame > newest) newest = slot.frame;
+            any = true;
+        }
+        return any;
+    }
+
+    size_t bytesUsed() const {
+        size_t total = 0;
+        for (const Slot& slot : ring) {
+            if (slot.valid) total += slot.block.size();
+        }
+        return total;
+    }
+};
+
+#endif // ROLLBACK_BUFFER_H
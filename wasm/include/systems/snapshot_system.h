@@ -0,0 +1,225 @@
+#ifndef SNAPSHOT_SYSTEM_H
+#define SNAPSHOT_SYSTEM_H
+
+#include "../entities/entity.h"
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+
+// Dirty tracking and delta snapshots of entity state
+//
+// capture() compares every active entity with the values recorded at the
+// previous capture and stamps spawns and changes with a sequence number;
+// entities that disappeared go into a fixed ring of despawns. buildSince()
+// then writes a binary blob with only what changed after a sequence the
+// consumer already holds, so static obstacles are sent exactly once.
+//
+// Blob layout (little-endian):
+//   header   u8 version, u8 flags (bit0 full), u16 reserved,
+//            u32 sequence, u32 baseSequence,
+//            u8 gameState, u8 reserved, u16 wave, i32 score,
+//            u16 entityCount, u16 despawnCount
+//   entity   i32 id, u8 type, u8 flags (bit0 spawned), u16 reserved,
+//            f32 x, y, vx, vy, rotation, health
+//            + f32 radius, maxHealth when spawned
+//   despawn  i32 id
+// A full snapshot (flag bit0) lists every live entity as spawned; the
+// consumer should drop any state it had before applying it.
+class SnapshotSystem {
+public:
+    static constexpr uint8_t VERSION = 1;
+    static constexpr uint8_t FLAG_FULL = 1;
+    static constexpr uint8_t ENTITY_SPAWNED = 1;
+    static constexpr size_t DESPAWN_RING_SIZE = 1024;
+
+    struct Globals {
+        uint8_t gameState;
+        uint16_t wave;
+        int32_t score;
+    };
+
+private:
+    struct Tracked {
+        int id;
+        uint8_t type;
+        float x, y, vx, vy, rotation, health;
+        float radius, maxHealth;
+        uint32_t spawnSequence;
+        uint32_t changedSequence;
+        uint32_t seenSequence;
+    };
+
+    struct Despawn {
+        int id;
+        uint32_t sequence;
+    };
+
+    std::vector<Tracked> tracked;
+    std::unordered_map<int, size_t> trackedIndex;
+    Despawn despawns[DESPAWN_RING_SIZE];
+    size_t despawnHead;              // Next slot to write
+    size_t despawnCount;             // Valid entries, up to DESPAWN_RING_SIZE
+    uint32_t oldestDespawnSequence;  // Sequences before this may be missing
+    uint32_t sequence;
+    std::vector<uint8_t> blob;
+
+public:
+    SnapshotSystem()
+        : despawnHead(0), despawnCount(0), oldestDespawnSequence(0), sequence(0) {
+        blob.reserve(4096);
+    }
+
+    uint32_t getSequence() const { return sequence; }
+
+    // Record the current entity state under a new sequence number
+    uint32_t capture(const std::vector<std::unique_ptr<Entity>>& entities) {
+        sequence++;
+
+        for (const auto& entity : entities) {
+            if (!entity || !entity->active) continue;
+
+            auto it = trackedIndex.find(entity->id);
+            if (it == trackedIndex.end()) {
+                Tracked t;
+                t.id = entity->id;
+                load(t, *entity);
+                t.spawnSequence = sequence;
+                t.changedSequence = sequence;
+                t.seenSequence = sequence;
+                trackedIndex[t.id] = tracked.size();
+                tracked.push_back(t);
+            } else {
+                Tracked& t = tracked[it->second];
+                if (differs(t, *entity)) {
+                    load(t, *entity);
+                    t.changedSequence = sequence;
+                }
+                t.seenSequence = sequence;
+            }
+        }
+
+        // Anything not seen this pass has despawned
+        for (size_t i = 0; i < tracked.size();) {
+            if (tracked[i].seenSequence != sequence) {
+                pushDespawn(tracked[i].id);
+                removeTracked(i);
+            } else {
+                i++;
+            }
+        }
+
+        return sequence;
+    }
+
+    // Build the delta from baseSequence to the latest capture
+    const std::vector<uint8_t>& buildSince(uint32_t baseSequence, const Globals& globals) {
+        // Fall back to a full snapshot when the despawn ring no longer
+        // reaches back to the consumer's sequence
+        bool full = baseSequence == 0 || baseSequence > sequence ||
+                    (despawnCount == DESPAWN_RING_SIZE && baseSequence < oldestDespawnSequence);
+
+        blob.clear();
+        put<uint8_t>(VERSION);
+        put<uint8_t>(full ? FLAG_FULL : 0);
+        put<uint16_t>(0);
+        put<uint32_t>(sequence);
+        put<uint32_t>(full ? 0 : baseSequence);
+        put<uint8_t>(globals.gameState);
+        put<uint8_t>(0);
+        put<uint16_t>(globals.wave);
+        put<int32_t>(globals.score);
+
+        size_t countsOffset = blob.size();
+        put<uint16_t>(0);
+        put<uint16_t>(0);
+
+        uint16_t entityCount = 0;
+        for (const Tracked& t : tracked) {
+            bool spawned = full || t.spawnSequence > baseSequence;
+            if (!spawned && t.changedSequence <= baseSequence) continue;
+
+            put<int32_t>(t.id);
+            put<uint8_t>(t.type);
+            put<uint8_t>(spawned ? ENTITY_SPAWNED : 0);
+            put<uint16_t>(0);
+            put<float>(t.x);
+            put<float>(t.y);
+            put<float>(t.vx);
+            put<float>(t.vy);
+            put<float>(t.rotation);
+            put<float>(t.health);
+            if (spawned) {
+                put<float>(t.radius);
+                put<float>(t.maxHealth);
+            }
+            entityCount++;
+        }
+
+        uint16_t despawnTotal = 0;
+        if (!full) {
+            for (size_t n = 0; n < despawnCount; n++) {
+                const Despawn& d = despawns[(despawnHead + DESPAWN_RING_SIZE - despawnCount + n) % DESPAWN_RING_SIZE];
+                if (d.sequence > baseSequence) {
+                    put<int32_t>(d.id);
+                    despawnTotal++;
+                }
+            }
+        }
+
+        std::memcpy(&blob[countsOffset], &entityCount, sizeof(entityCount));
+        std::memcpy(&blob[countsOffset + 2], &despawnTotal, sizeof(despawnTotal));
+        return blob;
+    }
+
+    const std::vector<uint8_t>& getBlob() const { return blob; }
+
+private:
+    template<typename T>
+    void put(T value) {
+        size_t offset = blob.size();
+        blob.resize(offset + sizeof(T));
+        std::memcpy(&blob[offset], &value, sizeof(T));
+    }
+
+    static void load(Tracked& t, const Entity& e) {
+        t.type = static_cast<uint8_t>(e.type);
+        t.x = e.position.x;
+        t.y = e.position.y;
+        t.vx = e.velocity.x;
+        t.vy = e.velocity.y;
+        t.rotation = e.rotation;
+        t.health = e.health;
+        t.radius = e.radius;
+        t.maxHealth = e.maxHealth;
+    }
+
+    static bool differs(const Tracked& t, const Entity& e) {
+        return t.x != e.position.x || t.y != e.position.y ||
+               t.vx != e.velocity.x || t.vy != e.velocity.y ||
+               t.rotation != e.rotation || t.health != e.health;
+    }
+
+    void pushDespawn(int id) {
+        if (despawnCount == DESPAWN_RING_SIZE) {
+            // Overwriting the oldest entry; consumers older than it need a full snapshot
+            oldestDespawnSequence = despawns[despawnHead].sequence;
+        } else {
+            despawnCount++;
+        }
+        despawns[despawnHead] = {id, sequence};
+        despawnHead = (despawnHead + 1) % DESPAWN_RING_SIZE;
+    }
+
+    void removeTracked(size_t i) {
+        trackedIndex.erase(tracked[i].id);
+        if (i != tracked.size() - 1) {
+            tracked[i] = tracked.back();
+            trackedIndex[tracked[i].id] = i;
+        }
+        tracked.pop_back();
+    }
+};
+
+#endif // SNAPSHOT_SYSTEM_H
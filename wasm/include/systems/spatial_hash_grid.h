@@ -1,25 +1,82 @@
 #ifndef SPATIAL_HASH_GRID_H
 #define SPATIAL_HASH_GRID_H
 
-#include <unordered_map>
 #include <vector>
+#include <cstdint>
 #include "../entities/entity.h"
 
-// Spatial hash grid for efficient collision detection
+// Spatial grid for efficient collision detection
+//
+// The world is covered by a dense array of cells. Entities are appended with
+// insert() and bucketed by a counting sort the first time the grid is queried
+// after a change, so a frame's clear/insert/query cycle reuses the same
+// buffers and does not touch the heap once they have grown to fit.
+// Positions outside the covered area are clamped into the edge cells. The
+// area may start anywhere (setBounds), so a streamed world only pays for the
+// region around the player.
 class SpatialHashGrid {
 private:
     static constexpr int CELL_SIZE = 100;
-    std::unordered_map<int, std::vector<Entity*>> grid;
-    
-    int hashPosition(float x, float y) const;
-    
+    static constexpr float DEFAULT_WORLD_SIZE = 2000.0f;
+
+    // One (cell, item) pair per cell an entity overlaps
+    struct CellEntry {
+        int cell;
+        int item;
+    };
+
+    float cellSize;
+    float invCellSize;
+    float originX;
+    float originY;
+    int cols;
+    int rows;
+
+    std::vector<Entity*> items;
+    std::vector<uint32_t> itemStamps;  // Last query that reported each item
+    std::vector<CellEntry> pending;    // Unsorted entries from insert()
+    std::vector<int> cellStart;        // cols * rows + 1 offsets into cellItems
+    std::vector<int> cellItems;        // Item indices grouped by cell
+    uint32_t queryStamp;
+    bool dirty;
+
+    int cellX(float x) const;
+    int cellY(float y) const;
+    void build();
+
 public:
-    SpatialHashGrid() = default;
+    SpatialHashGrid();
     ~SpatialHashGrid() = default;
-    
+
+    // Resize the cell array to cover the world; invalidates current contents
+    void setWorldBounds(float width, float height, float newCellSize = CELL_SIZE);
+    // Cover [minX, minX + width) x [minY, minY + height) instead
+    void setBounds(float minX, float minY, float width, float height, float newCellSize = CELL_SIZE);
+
     void clear();
     void insert(Entity* entity);
+    // Insert with bounds taken from the caller (e.g. an EntityStore row)
+    void insert(Entity* entity, float x, float y, float radius);
+    // Insert covering a box, e.g. the path of a fast mover
+    void insertRect(Entity* entity, float minX, float minY, float maxX, float maxY);
+
+    // Write active entities overlapping the region into out (cleared first).
+    // Each entity is reported once per query. Returns the number written.
+    size_t queryRect(float minX, float minY, float maxX, float maxY,
+                     std::vector<Entity*>& out, const Entity* exclude = nullptr);
+    size_t queryRadius(float x, float y, float radius,
+                       std::vector<Entity*>& out, const Entity* exclude = nullptr);
+    size_t getNearby(const Entity* entity, std::vector<Entity*>& out);
+
+    // Allocating variant kept for existing callers
     std::vector<Entity*> getNearby(Entity* entity);
+
+    float getCellSize() const { return cellSize; }
+    float getOriginX() const { return originX; }
+    float getOriginY() const { return originY; }
+    int getColumns() const { return cols; }
+    int getRows() const { return rows; }
+    size_t getItemCount() const { return items.size(); }
 };
 
-#endif // SPATIAL_HASH_GRID_H
\ No newline at end of file
+#endif // SPATIAL_HASH_GRID_H
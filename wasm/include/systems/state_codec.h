@@ -0,0 +1,377 @@
+#ifndef STATE_CODEC_H
+#define STATE_CODEC_H
+
+#include "../entities/entity.h"
+#include "../utils/bit_stream.h"
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Bit-packed, quantized entity state for multiplayer sync
+//
+// Each packet is a delta against a baseline the receiver acknowledged
+// (or against nothing, for a keyframe). Both sides keep a small ring of past
+// quantized snapshots keyed by sequence number; entities whose quantized
+// fields match the baseline are not sent at all.
+//
+// Quantization: position to 1/8 px on a grid starting at -128 px (bit width
+// sized to the world), velocity to 1/64 px/frame in 12 signed bits, rotation
+// to 10 bits, health to a byte as a fraction of max health, type to 3 bits.
+//
+// Packet (LSB-first bit stream):
+//   u8 magic 'S', u8 version, u32 sequence, u32 baseline (0 = keyframe),
+//   u5 position bits, u16 changed count, u16 despawn count
+//   changed  id delta, u5 field mask (pos, vel, angle, health, type),
+//            then the fields present in the mask
+//   despawn  id delta
+// Ids are sent as deltas from the previous id in the same list, with a
+// 2-bit width class (4, 8, 16 or 32 bits).
+class StateCodec {
+public:
+    static constexpr uint8_t MAGIC = 0x53;
+    static constexpr uint8_t VERSION = 1;
+    static constexpr float POSITION_QUANTUM = 0.125f;
+    static constexpr float POSITION_ORIGIN = -128.0f;
+    static constexpr float VELOCITY_QUANTUM = 1.0f / 64.0f;
+    static constexpr int VELOCITY_BITS = 12;
+    static constexpr int ANGLE_BITS = 10;
+    static constexpr int HEALTH_BITS = 8;
+    static constexpr int TYPE_BITS = 3;
+    static constexpr size_t BASELINE_RING_SIZE = 32;
+
+    // Decoded entity, 8 words: id, type (int32), x, y, vx, vy, rotation,
+    // health fraction (float32)
+    struct DecodedEntity {
+        int32_t id;
+        int32_t type;
+        float x;
+        float y;
+        float vx;
+        float vy;
+        float rotation;
+        float health;
+    };
+    static constexpr int DECODED_STRIDE = 8;
+
+private:
+    enum FieldMask : uint32_t {
+        FIELD_POSITION = 1 << 0,
+        FIELD_VELOCITY = 1 << 1,
+        FIELD_ANGLE = 1 << 2,
+        FIELD_HEALTH = 1 << 3,
+        FIELD_TYPE = 1 << 4,
+        FIELD_ALL = 0x1f
+    };
+    static constexpr int FIELD_BITS = 5;
+
+    struct Quantized {
+        uint32_t id;
+        uint32_t x;
+        uint32_t y;
+        int32_t vx;
+        int32_t vy;
+        uint16_t angle;
+        uint8_t health;
+        uint8_t type;
+    };
+
+    struct Baseline {
+        uint32_t sequence;
+        std::vector<Quantized> records;
+    };
+
+    int positionBits;
+    uint32_t encodeSequence;
+    Baseline encodeRing[BASELINE_RING_SIZE];
+    Baseline decodeRing[BASELINE_RING_SIZE];
+    std::vector<Quantized> current;
+    std::vector<uint8_t> packet;
+    std::vector<uint8_t> input;
+    std::vector<DecodedEntity> decoded;
+
+public:
+    StateCodec() : positionBits(16), encodeSequence(0) {
+        for (auto& b : encodeRing) b.sequence = 0;
+        for (auto& b : decodeRing) b.sequence = 0;
+        setWorldBounds(2000.0f, 2000.0f);
+    }
+
+    // Size the position fields so the whole world (plus margin) fits
+    void setWorldBounds(float width, float height) {
+        float extent = std::max(width, height) - 2.0f * POSITION_ORIGIN;
+        uint32_t steps = static_cast<uint32_t>(extent / POSITION_QUANTUM) + 1;
+        positionBits = 1;
+        while (positionBits < 31 && (1u << positionBits) < steps) positionBits++;
+    }
+
+    // Encode the active entities against a previously sent sequence; pass 0
+    // (or an expired sequence) for a keyframe. The returned buffer stays valid
+    // until the next encode.
+    const std::vector<uint8_t>& encode(const std::vector<std::unique_ptr<Entity>>& entities,
+                                       uint32_t baselineSequence) {
+        current.clear();
+        for (const auto& entity : entities) {
+            if (entity && entity->active) {
+                current.push_back(quantize(*entity));
+            }
+        }
+        std::sort(current.begin(), current.end(),
+                  [](const Quantized& a, const Quantized& b) { return a.id < b.id; });
+
+        const Baseline* baseline = findBaseline(encodeRing, baselineSequence);
+        static const std::vector<Quantized> empty;
+        const std::vector<Quantized>& base = baseline ? baseline->records : empty;
+
+        uint32_t sequence = ++encodeSequence;
+        if (sequence == 0) sequence = ++encodeSequence;  // 0 means "no baseline"
+
+        BitWriter writer(packet);
+        writer.write(MAGIC, 8);
+        writer.write(VERSION, 8);
+        writer.write(sequence, 32);
+        writer.write(baseline ? baselineSequence : 0, 32);
+        writer.write(static_cast<uint32_t>(positionBits), 5);
+
+        // Counts are known only after the merge; reserve fixed-width slots
+        size_t countsBit = writer.bitsWritten();
+        writer.write(0, 16);
+        writer.write(0, 16);
+
+        uint32_t changedCount = 0;
+        uint32_t prevId = 0;
+        size_t b = 0;
+        for (const Quantized& q : current) {
+            while (b < base.size() && base[b].id < q.id) b++;
+            uint32_t mask = FIELD_ALL;
+            if (b < base.size() && base[b].id == q.id) {
+                mask = diff(base[b], q);
+                if (mask == 0) continue;
+            }
+            writeId(writer, q.id - prevId);
+            prevId = q.id;
+            writer.write(mask, FIELD_BITS);
+            writeFields(writer, q, mask);
+            changedCount++;
+        }
+
+        uint32_t despawnCount = 0;
+        prevId = 0;
+        size_t c = 0;
+        for (const Quantized& old : base) {
+            while (c < current.size() && current[c].id < old.id) c++;
+            if (c < current.size() && current[c].id == old.id) continue;
+            writeId(writer, old.id - prevId);
+            prevId = old.id;
+            despawnCount++;
+        }
+
+        writer.finish();
+        patchCounts(countsBit, changedCount, despawnCount);
+
+        storeBaseline(encodeRing, sequence, current);
+        return packet;
+    }
+
+    // Scratch buffer JS copies an incoming packet into before decode()
+    uint8_t* prepareInput(size_t length) {
+        input.resize(length);
+        return input.data();
+    }
+
+    // Decode the packet in the input buffer; returns its sequence, or 0 when
+    // it is malformed or its baseline is no longer held (request a keyframe)
+    uint32_t decode(size_t length) {
+        return decode(input.data(), std::min(length, input.size()));
+    }
+
+    uint32_t decode(const uint8_t* bytes, size_t length) {
+        BitReader reader(bytes, length);
+        if (reader.read(8) != MAGIC || reader.read(8) != VERSION) return 0;
+
+        uint32_t sequence = reader.read(32);
+        uint32_t baselineSequence = reader.read(32);
+        int bits = static_cast<int>(reader.read(5));
+        uint32_t changedCount = reader.read(16);
+        uint32_t despawnCount = reader.read(16);
+        if (sequence == 0 || reader.hasOverflowed()) return 0;
+
+        static const std::vector<Quantized> empty;
+        const std::vector<Quantized>* base = &empty;
+        if (baselineSequence != 0) {
+            const Baseline* baseline = findBaseline(decodeRing, baselineSequence);
+            if (!baseline) return 0;
+            base = &baseline->records;
+        }
+
+        // Changed records arrive sorted by id; merge them over the baseline
+        current.clear();
+        size_t b = 0;
+        uint32_t id = 0;
+        for (uint32_t n = 0; n < changedCount; n++) {
+            id += readId(reader);
+            while (b < base->size() && (*base)[b].id < id) current.push_back((*base)[b++]);
+
+            Quantized q{};
+            if (b < base->size() && (*base)[b].id == id) q = (*base)[b++];
+            q.id = id;
+            readFields(reader, q, reader.read(FIELD_BITS), bits);
+            current.push_back(q);
+        }
+        while (b < base->size()) current.push_back((*base)[b++]);
+
+        // Drop despawned ids (also sorted)
+        id = 0;
+        size_t keep = 0, scan = 0;
+        for (uint32_t n = 0; n < despawnCount; n++) {
+            id += readId(reader);
+            while (scan < current.size() && current[scan].id < id) current[keep++] = current[scan++];
+            if (scan < current.size() && current[scan].id == id) scan++;
+        }
+        while (scan < current.size()) current[keep++] = current[scan++];
+        current.resize(keep);
+
+        if (reader.hasOverflowed()) return 0;
+
+        storeBaseline(decodeRing, sequence, current);
+
+        decoded.resize(current.size());
+        for (size_t i = 0; i < current.size(); i++) {
+            dequantize(current[i], decoded[i]);
+        }
+        return sequence;
+    }
+
+    const std::vector<uint8_t>& getPacket() const { return packet; }
+    const std::vector<DecodedEntity>& getDecoded() const { return decoded; }
+    uint32_t getEncodeSequence() const { return encodeSequence; }
+
+private:
+    Quantized quantize(const Entity& e) const {
+        Quantized q;
+        uint32_t maxPos = (1u << positionBits) - 1;
+        q.id = static_cast<uint32_t>(e.id);
+        q.x = quantizeUnsigned((e.position.x - POSITION_ORIGIN) / POSITION_QUANTUM, maxPos);
+        q.y = quantizeUnsigned((e.position.y - POSITION_ORIGIN) / POSITION_QUANTUM, maxPos);
+        q.vx = quantizeSigned(e.velocity.x / VELOCITY_QUANTUM, VELOCITY_BITS);
+        q.vy = quantizeSigned(e.velocity.y / VELOCITY_QUANTUM, VELOCITY_BITS);
+
+        float turn = e.rotation / (2.0f * static_cast<float>(M_PI));
+        turn -= std::floor(turn);
+        q.angle = static_cast<uint16_t>(static_cast<uint32_t>(std::lround(turn * (1 << ANGLE_BITS))) &
+                                        ((1u << ANGLE_BITS) - 1));
+
+        float health = e.maxHealth > 0 ? e.health / e.maxHealth : 0.0f;
+        q.health = static_cast<uint8_t>(quantizeUnsigned(health * 255.0f, 255));
+        q.type = static_cast<uint8_t>(e.type);
+        return q;
+    }
+
+    static void dequantize(const Quantized& q, DecodedEntity& out) {
+        out.id = static_cast<int32_t>(q.id);
+        out.type = q.type;
+        out.x = q.x * POSITION_QUANTUM + POSITION_ORIGIN;
+        out.y = q.y * POSITION_QUANTUM + POSITION_ORIGIN;
+        out.vx = q.vx * VELOCITY_QUANTUM;
+        out.vy = q.vy * VELOCITY_QUANTUM;
+        out.rotation = q.angle * (2.0f * static_cast<float>(M_PI) / (1 << ANGLE_BITS));
+        out.health = q.health / 255.0f;
+    }
+
+    static uint32_t quantizeUnsigned(float value, uint32_t maxValue) {
+        if (!(value > 0.0f)) return 0;
+        float rounded = std::round(value);
+        return rounded >= static_cast<float>(maxValue) ? maxValue : static_cast<uint32_t>(rounded);
+    }
+
+    static int32_t quantizeSigned(float value, int bits) {
+        int32_t limit = (1 << (bits - 1)) - 1;
+        float rounded = std::round(value);
+        if (rounded > limit) return limit;
+        if (rounded < -limit) return -limit;
+        return static_cast<int32_t>(rounded);
+    }
+
+    static uint32_t diff(const Quantized& a, const Quantized& b) {
+        uint32_t mask = 0;
+        if (a.x != b.x || a.y != b.y) mask |= FIELD_POSITION;
+        if (a.vx != b.vx || a.vy != b.vy) mask |= FIELD_VELOCITY;
+        if (a.angle != b.angle) mask |= FIELD_ANGLE;
+        if (a.health != b.health) mask |= FIELD_HEALTH;
+        if (a.type != b.type) mask |= FIELD_TYPE;
+        return mask;
+    }
+
+    void writeFields(BitWriter& w, const Quantized& q, uint32_t mask) const {
+        uint32_t velMask = (1u << VELOCITY_BITS) - 1;
+        if (mask & FIELD_POSITION) {
+            w.write(q.x, positionBits);
+            w.write(q.y, positionBits);
+        }
+        if (mask & FIELD_VELOCITY) {
+            w.write(static_cast<uint32_t>(q.vx) & velMask, VELOCITY_BITS);
+            w.write(static_cast<uint32_t>(q.vy) & velMask, VELOCITY_BITS);
+        }
+        if (mask & FIELD_ANGLE) w.write(q.angle, ANGLE_BITS);
+        if (mask & FIELD_HEALTH) w.write(q.health, HEALTH_BITS);
+        if (mask & FIELD_TYPE) w.write(q.type, TYPE_BITS);
+    }
+
+    static void readFields(BitReader& r, Quantized& q, uint32_t mask, int bits) {
+        if (mask & FIELD_POSITION) {
+            q.x = r.read(bits);
+            q.y = r.read(bits);
+        }
+        if (mask & FIELD_VELOCITY) {
+            q.vx = signExtend(r.read(VELOCITY_BITS), VELOCITY_BITS);
+            q.vy = signExtend(r.read(VELOCITY_BITS), VELOCITY_BITS);
+        }
+        if (mask & FIELD_ANGLE) q.angle = static_cast<uint16_t>(r.read(ANGLE_BITS));
+        if (mask & FIELD_HEALTH) q.health = static_cast<uint8_t>(r.read(HEALTH_BITS));
+        if (mask & FIELD_TYPE) q.type = static_cast<uint8_t>(r.read(TYPE_BITS));
+    }
+
+    static int32_t signExtend(uint32_t value, int bits) {
+        uint32_t sign = 1u << (bits - 1);
+        return static_cast<int32_t>((value ^ sign) - sign);
+    }
+
+    static void writeId(BitWriter& w, uint32_t delta) {
+        if (delta < (1u << 4)) { w.write(0, 2); w.write(delta, 4); }
+        else if (delta < (1u << 8)) { w.write(1, 2); w.write(delta, 8); }
+        else if (delta < (1u << 16)) { w.write(2, 2); w.write(delta, 16); }
+        else { w.write(3, 2); w.write(delta, 32); }
+    }
+
+    static uint32_t readId(BitReader& r) {
+        static const int widths[4] = {4, 8, 16, 32};
+        return r.read(widths[r.read(2)]);
+    }
+
+    void patchCounts(size_t bitOffset, uint32_t changedCount, uint32_t despawnCount) {
+        // The 32 count bits may straddle bytes; rewrite them one bit at a time
+        uint32_t counts = (changedCount & 0xffff) | ((despawnCount & 0xffff) << 16);
+        for (int i = 0; i < 32; i++) {
+            size_t bit = bitOffset + i;
+            uint8_t& byte = packet[bit / 8];
+            uint8_t flag = static_cast<uint8_t>(1u << (bit % 8));
+            byte = (counts >> i) & 1 ? (byte | flag) : (byte & ~flag);
+        }
+    }
+
+    static const Baseline* findBaseline(const Baseline (&ring)[BASELINE_RING_SIZE], uint32_t sequence) {
+        if (sequence == 0) return nullptr;
+        const Baseline& b = ring[sequence % BASELINE_RING_SIZE];
+        return b.sequence == sequence ? &b : nullptr;
+    }
+
+    static void storeBaseline(Baseline (&ring)[BASELINE_RING_SIZE], uint32_t sequence,
+                              const std::vector<Quantized>& records) {
+        Baseline& b = ring[sequence % BASELINE_RING_SIZE];
+        b.sequence = sequence;
+        b.records.assign(records.begin(), records.end());
+    }
+};
+
+#endif // STATE_CODEC_H
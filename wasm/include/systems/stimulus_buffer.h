@@ -0,0 +1,167 @@
+#ifndef STIMULUS_BUFFER_H
+#define STIMULUS_BUFFER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+// A noise something made, audible within radius of where it happened
+struct Stimulus {
+    enum class Kind : uint8_t {
+        MOVEMENT,             // Sprinting, boosting or rolling
+        SHOT,
+        ATTACK,
+        OBSTACLE_DESTROYED
+    };
+
+    float x, y;
+    float radius;
+    float intensity;      // 1 = ordinary, 2 = loud
+    int32_t sourceId;     // Entity that made it, or -1
+    Kind kind;
+};
+
+// Noise events shared by every listener
+//
+// Sources emit() once per event instead of each listener polling each
+// source. Emitted stimuli are pending until beginTick(), which makes them
+// the tick's audible set (dropping the previous one) and bins each into
+// every cell its radius overlaps, counting-sorted like SpatialHashGrid. A
+// listener then only reads the stimuli binned in its own cell, so hearing
+// costs O(stimuli + listeners) per tick rather than one test per listener
+// per source. Positions outside the covered area are clamped into the edge
+// cells; the exact distance test keeps that correct.
+class StimulusBuffer {
+public:
+    static constexpr float DEFAULT_CELL_SIZE = 256.0f;
+    static constexpr float DEFAULT_WORLD_SIZE = 2000.0f;
+
+private:
+    struct CellEntry {
+        int cell;
+        int item;
+    };
+
+    float cellSize;
+    float invCellSize;
+    float originX;
+    float originY;
+    int cols;
+    int rows;
+
+    std::vector<Stimulus> pending;     // Emitted since the last beginTick()
+    std::vector<Stimulus> current;     // Audible this tick
+    std::vector<CellEntry> entries;
+    std::vector<int> cellStart;        // cols * rows + 1 offsets into cellItems
+    std::vector<int> cellItems;        // Indices into current, grouped by cell
+
+    int cellX(float x) const {
+        return std::clamp(static_cast<int>((x - originX) * invCellSize), 0, cols - 1);
+    }
+    int cellY(float y) const {
+        return std::clamp(static_cast<int>((y - originY) * invCellSize), 0, rows - 1);
+    }
+
+    void build() {
+        entries.clear();
+        for (size_t i = 0; i < current.size(); i++) {
+            const Stimulus& s = current[i];
+            int x0 = cellX(s.x - s.radius), x1 = cellX(s.x + s.radius);
+            int y0 = cellY(s.y - s.radius), y1 = cellY(s.y + s.radius);
+            for (int cy = y0; cy <= y1; cy++) {
+                for (int cx = x0; cx <= x1; cx++) {
+                    entries.push_back({cy * cols + cx, static_cast<int>(i)});
+                }
+            }
+        }
+
+        std::fill(cellStart.begin(), cellStart.end(), 0);
+        for (const CellEntry& e : entries) cellStart[e.cell + 1]++;
+        for (size_t c = 1; c < cellStart.size(); c++) cellStart[c] += cellStart[c - 1];
+        cellItems.resize(entries.size());
+        for (const CellEntry& e : entries) {
+            // Emission order within a cell, so ties resolve the same every run
+            cellItems[cellStart[e.cell]++] = e.item;
+        }
+        for (size_t c = cellStart.size() - 1; c > 0; c--) cellStart[c] = cellStart[c - 1];
+        cellStart[0] = 0;
+    }
+
+public:
+    StimulusBuffer() : cellSize(0), invCellSize(0), originX(0), originY(0), cols(0), rows(0) {
+        setWorldBounds(DEFAULT_WORLD_SIZE, DEFAULT_WORLD_SIZE);
+    }
+
+    void setWorldBounds(float width, float height, float newCellSize = DEFAULT_CELL_SIZE) {
+        setBounds(0, 0, width, height, newCellSize);
+    }
+
+    // Cover [minX, minX + width) x [minY, minY + height); the audible set is re-binned
+    void setBounds(float minX, float minY, float width, float height, float newCellSize = DEFAULT_CELL_SIZE) {
+        cellSize = newCellSize > 0 ? newCellSize : DEFAULT_CELL_SIZE;
+        invCellSize = 1.0f / cellSize;
+        originX = minX;
+        originY = minY;
+        cols = std::max(1, static_cast<int>(width * invCellSize) + 1);
+        rows = std::max(1, static_cast<int>(height * invCellSize) + 1);
+        cellStart.assign(static_cast<size_t>(cols) * rows + 1, 0);
+        build();
+    }
+
+    // Audible from the next beginTick()
+    void emit(Stimulus::Kind kind, float x, float y, float radius, float intensity, int32_t sourceId = -1) {
+        if (radius <= 0) return;
+        pending.push_back({x, y, radius, intensity, sourceId, kind});
+    }
+
+    void beginTick() {
+        current.swap(pending);
+        pending.clear();
+        build();
+    }
+
+    void clear() {
+        pending.clear();
+        current.clear();
+        build();
+    }
+
+    // Every audible stimulus whose radius reaches (x, y), in emission order
+    template<typename Fn>
+    void forEachAudible(float x, float y, Fn&& fn) const {
+        int cell = cellY(y) * cols + cellX(x);
+        for (int k = cellStart[cell]; k < cellStart[cell + 1]; k++) {
+            const Stimulus& s = current[cellItems[k]];
+            float dx = s.x - x, dy = s.y - y;
+            if (dx * dx + dy * dy <= s.radius * s.radius) fn(s);
+        }
+    }
+
+    // Highest intensity audible at (x, y), the nearest on a tie; null when
+    // nothing is. Stimuli from ignoreId (the listener itself) are skipped.
+    const Stimulus* loudestAt(float x, float y, int32_t ignoreId = -1) const {
+        const Stimulus* best = nullptr;
+        float bestDistSq = 0;
+        forEachAudible(x, y, [&](const Stimulus& s) {
+            if (ignoreId >= 0 && s.sourceId == ignoreId) return;
+            float dx = s.x - x, dy = s.y - y;
+            float distSq = dx * dx + dy * dy;
+            if (!best || s.intensity > best->intensity ||
+                (s.intensity == best->intensity && distSq < bestDistSq)) {
+                best = &s;
+                bestDistSq = distSq;
+            }
+        });
+        return best;
+    }
+
+    size_t size() const { return current.size(); }
+    const Stimulus& operator[](size_t i) const { return current[i]; }
+
+    // Stimuli waiting for the next tick, for world saves
+    const std::vector<Stimulus>& getPending() const { return pending; }
+    void setPending(const Stimulus* stimuli, size_t count) { pending.assign(stimuli, stimuli + count); }
+};
+
+#endif // STIMULUS_BUFFER_H
@@ -0,0 +1,355 @@
+#ifndef TARGETING_SYSTEM_H
+#define TARGETING_SYSTEM_H
+
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include "../entities/entity.h"
+#include "../config/game_config.h"
+#include "../utils/sim_context.h"
+#include "../utils/handle_table.h"
+#include "spatial_hash_grid.h"
+
+// A targetable entity in range, as seen from the player
+struct TargetCandidate {
+    Entity* entity;
+    float angle;       // atan2 around the player
+    float distance;
+};
+
+// Targetable entities around the player, gathered once per tick
+//
+// gather() runs at the end of a tick, while the collision grid still holds
+// every dynamic entity, and keeps the ids the grid reports within
+// MAX_TARGET_DISTANCE + GATHER_MARGIN of the player, in angle order. The
+// order is updated rather than rebuilt: survivors keep their rank,
+// newcomers go last and an insertion sort repairs what moved, which is
+// close to linear since the ring around the player changes little from one
+// tick to the next. Ids are kept rather than pointers, so a candidate that
+// dies and is cleaned up simply no longer resolves.
+//
+// query() turns the ids into the current candidate list: resolved,
+// re-tested against the current positions and re-sorted by the same
+// insertion pass. The gathered ids plus the entities created since
+// (extraIds) cover every true candidate only while the player's
+// displacement since the gather plus the enemy's stays within
+// GATHER_MARGIN. query() checks the player's side alone and scans every
+// dynamic entity once the player is further than GATHER_MARGIN from where
+// the ids were gathered, or before the first gather; enemies are covered
+// because the engine gathers at the end of every tick and queries before
+// the next one moves anything. Within that bound both paths give the same
+// list, so replays and rollback target exactly as the original run did.
+class TargetCandidates {
+public:
+    static constexpr float GATHER_MARGIN = 100.0f;
+
+    using List = std::vector<TargetCandidate>;
+    using EntityList = std::vector<std::unique_ptr<Entity>>;
+
+private:
+    struct SlotRank {
+        int id;
+        int rank;
+    };
+
+    std::vector<int> ids;              // By angle around the gather centre
+    std::vector<SlotRank> slotRanks;   // Previous rank by handle slot, during gather()
+    std::vector<Entity*> gathered;     // Grid query scratch
+    std::vector<Entity*> ranked;       // Survivors by previous rank
+    List list;
+    Vector2 center;
+    bool valid;
+
+    static bool before(const TargetCandidate& a, const TargetCandidate& b) {
+        return a.angle < b.angle || (a.angle == b.angle && a.entity->id < b.entity->id);
+    }
+
+    // Nearly sorted input, so this is close to linear
+    static void insertionSort(List& items) {
+        for (size_t i = 1; i < items.size(); i++) {
+            TargetCandidate item = items[i];
+            size_t j = i;
+            while (j > 0 && before(item, items[j - 1])) {
+                items[j] = items[j - 1];
+                j--;
+            }
+            items[j] = item;
+        }
+    }
+
+    void consider(Entity* entity, const Entity& player, float range) {
+        if (!entity || !isTargetable(*entity)) return;
+        float dx = entity->position.x - player.position.x;
+        float dy = entity->position.y - player.position.y;
+        float distance = std::sqrt(dx * dx + dy * dy);
+        if (distance <= range) list.push_back({entity, std::atan2(dy, dx), distance});
+    }
+
+public:
+    TargetCandidates() : center(0, 0), valid(false) {}
+
+    static bool isTargetable(const Entity& entity) {
+        return entity.active &&
+               (entity.type == EntityType::ENEMY || entity.type == EntityType::WOLF);
+    }
+
+    // Forget the gathered set; the next query scans
+    void invalidate() {
+        ids.clear();
+        valid = false;
+    }
+
+    void gather(SpatialHashGrid& grid, const Entity& player) {
+        grid.queryRadius(player.position.x, player.position.y,
+                         Config::MAX_TARGET_DISTANCE + GATHER_MARGIN, gathered);
+
+        for (size_t r = 0; r < ids.size(); r++) {
+            size_t slot = static_cast<uint32_t>(ids[r]) & HandleTable::INDEX_MASK;
+            if (slot >= slotRanks.size()) slotRanks.resize(slot + 1, {-1, -1});
+            slotRanks[slot] = {ids[r], static_cast<int>(r)};
+        }
+        ranked.assign(ids.size(), nullptr);
+        list.clear();
+        for (Entity* entity : gathered) {
+            if (!isTargetable(*entity)) continue;
+            size_t slot = static_cast<uint32_t>(entity->id) & HandleTable::INDEX_MASK;
+            if (slot < slotRanks.size() && slotRanks[slot].id == entity->id) {
+                ranked[slotRanks[slot].rank] = entity;
+            } else {
+                list.push_back({entity, 0, 0});
+            }
+        }
+        for (int id : ids) {
+            size_t slot = static_cast<uint32_t>(id) & HandleTable::INDEX_MASK;
+            slotRanks[slot] = {-1, -1};
+        }
+
+        // Survivors in their old order, then newcomers
+        size_t newcomers = list.size();
+        for (Entity* entity : ranked) {
+            if (entity) list.push_back({entity, 0, 0});
+        }
+        std::rotate(list.begin(), list.begin() + newcomers, list.end());
+        for (TargetCandidate& c : list) {
+            c.angle = std::atan2(c.entity->position.y - player.position.y,
+                                 c.entity->position.x - player.position.x);
+        }
+        insertionSort(list);
+
+        ids.clear();
+        for (const TargetCandidate& c : list) ids.push_back(c.entity->id);
+        list.clear();
+        center = player.position;
+        valid = true;
+    }
+
+    // Candidates within MAX_TARGET_DISTANCE now, by angle then id.
+    // lookup(id) returns the live entity or null. Valid until the next call.
+    template<typename Lookup>
+    const List& query(const Entity& player, const EntityList& entities, size_t count,
+                      const std::vector<int>& extraIds, Lookup&& lookup) {
+        const float range = Config::MAX_TARGET_DISTANCE;
+        list.clear();
+        if (valid && player.position.distanceTo(center) <= GATHER_MARGIN) {
+            for (int id : ids) consider(lookup(id), player, range);
+            for (int id : extraIds) consider(lookup(id), player, range);
+        } else {
+            for (size_t i = 0; i < count; i++) consider(entities[i].get(), player, range);
+        }
+        insertionSort(list);
+        return list;
+    }
+
+    size_t gatheredCount() const { return ids.size(); }
+};
+
+// Target lock for the player, driven by the mobile target button
+//
+// The lock follows the closest enemy or wolf within
+// Config::MAX_TARGET_DISTANCE and turns the player to face it every tick.
+// Walking out of range drops the lock until the button is pressed again. A
+// quick press cycles targets clockwise by angle around the player, a long
+// press suspends targeting for TARGET_DISABLE_DURATION. The target is held by
+// entity id, so removals never leave it dangling, and all timing reads the
+// simulation clock so a replayed session targets the same way.
+//
+// Candidates come from TargetCandidates through a callable, only invoked
+// when the lock needs a new target; holding a lock costs one id lookup.
+// Plain data, so a world save copies it as is.
+class TargetingSystem {
+public:
+    struct Button {
+        float x, y, radius;
+        bool active;
+        bool visible;
+        double touchStartTime;
+        double disabledUntil;
+        int touchId;
+
+        Button() : x(0), y(0), radius(40), active(false), visible(true),
+                   touchStartTime(0), disabledUntil(0), touchId(-1) {}
+    };
+
+    using CandidateList = TargetCandidates::List;
+
+private:
+    int targetId;
+    bool lockEnabled;
+    double disabledUntil;
+    bool autoDisabled;   // Target walked out of range; stays off until a press
+    Button button;
+
+public:
+    TargetingSystem()
+        : targetId(-1), lockEnabled(true), disabledUntil(0), autoDisabled(false) {}
+
+    // Default button placement for a viewport (bottom right, above the
+    // action buttons)
+    void layoutButton(float viewportWidth, float viewportHeight) {
+        button.x = viewportWidth - 50;
+        button.y = viewportHeight - 280;
+    }
+
+    // Nearest candidate, the lower id on a tie
+    static int findClosest(const CandidateList& candidates) {
+        const TargetCandidate* closest = nullptr;
+        for (const TargetCandidate& c : candidates) {
+            if (!closest || c.distance < closest->distance ||
+                (c.distance == closest->distance && c.entity->id < closest->entity->id)) {
+                closest = &c;
+            }
+        }
+        return closest ? closest->entity->id : -1;
+    }
+
+    // direction > 0 picks the next target by angle, otherwise the previous.
+    // candidates are in TargetCandidates::query() order.
+    void switchTarget(int direction, const CandidateList& candidates) {
+        if (candidates.empty()) {
+            targetId = -1;
+            return;
+        }
+
+        auto it = std::find_if(candidates.begin(), candidates.end(),
+                               [this](const TargetCandidate& c) { return c.entity->id == targetId; });
+        if (it == candidates.end()) {
+            targetId = findClosest(candidates);
+            return;
+        }
+
+        size_t current = static_cast<size_t>(it - candidates.begin());
+        size_t size = candidates.size();
+        size_t next = direction > 0 ? (current + 1) % size : (current + size - 1) % size;
+        targetId = candidates[next].entity->id;
+    }
+
+    void enable() {
+        lockEnabled = true;
+        disabledUntil = 0;
+        autoDisabled = false;
+    }
+
+    // durationSeconds <= 0 disables until enable()
+    void disable(float durationSeconds) {
+        lockEnabled = false;
+        disabledUntil = durationSeconds > 0 ? Sim::now() + durationSeconds * 1000.0 : 0;
+        targetId = -1;
+    }
+
+    // Per tick: expire a suspension, validate the lock and face the target.
+    // lookup(id) returns the live entity or null; candidates() returns the
+    // current CandidateList.
+    template<typename Lookup, typename Candidates>
+    void update(Entity* player, Lookup&& lookup, Candidates&& candidates) {
+        if (!lockEnabled && disabledUntil > 0 && Sim::now() >= disabledUntil) {
+            enable();
+        }
+        if (!lockEnabled || !player || !player->active) {
+            targetId = -1;
+            return;
+        }
+
+        Entity* target = targetId >= 0 ? lookup(targetId) : nullptr;
+        if (target && target->active) {
+            if (player->distanceTo(*target) > Config::MAX_TARGET_DISTANCE) {
+                lockEnabled = false;
+                autoDisabled = true;
+                targetId = -1;
+                return;
+            }
+        } else {
+            targetId = findClosest(candidates());
+            target = targetId >= 0 ? lookup(targetId) : nullptr;
+        }
+
+        if (target) {
+            player->rotation = std::atan2(target->position.y - player->position.y,
+                                          target->position.x - player->position.x);
+        }
+    }
+
+    // A completed press of pressDurationMs. Any press re-arms a lock dropped
+    // for range; otherwise quick presses cycle and long presses suspend.
+    // candidates() is only called with a player.
+    template<typename Candidates>
+    void press(float pressDurationMs, const Entity* player, Candidates&& candidates) {
+        if (autoDisabled) {
+            enable();
+            targetId = player ? findClosest(candidates()) : -1;
+            return;
+        }
+        if (Sim::now() < button.disabledUntil) return;
+
+        if (pressDurationMs < Config::TARGET_LONG_PRESS) {
+            if (player) switchTarget(1, candidates());
+        } else {
+            disable(Config::TARGET_DISABLE_DURATION / 1000.0f);
+            button.disabledUntil = Sim::now() + Config::TARGET_DISABLE_DURATION;
+        }
+    }
+
+    // Touch tracking for the on-screen button (screen coordinates)
+    bool touchStart(float x, float y, int touchId) {
+        float dx = x - button.x;
+        float dy = y - button.y;
+        if (button.active || dx * dx + dy * dy > button.radius * button.radius) return false;
+        button.active = true;
+        button.touchId = touchId;
+        button.touchStartTime = Sim::now();
+        return true;
+    }
+
+    // Press duration in ms when touchId ends a press on the button, else -1
+    float touchEnd(int touchId) {
+        if (!button.active || button.touchId != touchId) return -1.0f;
+        button.active = false;
+        button.touchId = -1;
+        return static_cast<float>(Sim::now() - button.touchStartTime);
+    }
+
+    void reset() {
+        targetId = -1;
+        enable();
+        button.active = false;
+        button.touchId = -1;
+        button.disabledUntil = 0;
+    }
+
+    int getTargetId() const { return targetId; }
+    bool hasTarget() const { return targetId >= 0; }
+    bool isLockEnabled() const { return lockEnabled; }
+    bool isEnabled() const { return lockEnabled && !autoDisabled; }
+    bool isAutoDisabled() const { return autoDisabled; }
+    Button& getButton() { return button; }
+    const Button& getButton() const { return button; }
+
+    float buttonDisableRemaining() const {
+        double remaining = button.disabledUntil - Sim::now();
+        return remaining > 0 ? static_cast<float>(remaining / 1000.0) : 0.0f;
+    }
+};
+
+#endif // TARGETING_SYSTEM_H
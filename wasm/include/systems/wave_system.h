@@ -4,12 +4,21 @@
 #include "../entities/enemy.h"
 #include "../entities/wolf.h"
 #include "../entities/powerup.h"
+#include "../entities/entity_counts.h"
 #include "../config/game_config.h"
+#include "../config/engine_features.h"
+#include "../memory/frame_arena.h"
+#include "../utils/sim_context.h"
 #include <vector>
 #include <memory>
 #include <cstdlib>
 
+// Waves never look at the world: the owner passes in its live entity counts
+// and adopts what update() appends to the spawn batch.
 class WaveSystem {
+public:
+    using SpawnBatch = std::vector<std::unique_ptr<Entity>>;
+    
 private:
     int currentWave;
     int enemiesSpawnedThisWave;
@@ -21,6 +30,8 @@ private:
     float enemySpawnTimer;
     float wolfSpawnTimer;
     float powerUpSpawnTimer;
+    FrameArena* arena;  // Scratch for spawn bookkeeping; may be null
+    Vector2 spawnOrigin;  // Corner of the spawn area passed to update()
     
 public:
     WaveSystem()
@@ -33,9 +44,20 @@ public:
           waveTransitionTimer(0),
           enemySpawnTimer(0),
           wolfSpawnTimer(0),
-          powerUpSpawnTimer(0) {}
+          powerUpSpawnTimer(0),
+          arena(nullptr),
+          spawnOrigin(0, 0) {}
+    
+    void setFrameArena(FrameArena* frameArena) { arena = frameArena; }
     
-    void update(float deltaTime, std::vector<std::unique_ptr<Entity>>& entities,
+    // update() spawns inside [origin, origin + size); a streamed world moves
+    // the area with the player
+    void setSpawnOrigin(float x, float y) { spawnOrigin = Vector2(x, y); }
+    
+    // live must not include anything dead (run after the owner's cleanup).
+    // New entities are appended to spawned; the caps (MAX_ENEMIES,
+    // MAX_WOLVES, MAX_POWERUPS) hold a spawn back until there is room.
+    void update(float deltaTime, const EntityCounts& live, SpawnBatch& spawned,
                 float worldWidth, float worldHeight) {
         
         // Update spawn timers
@@ -44,38 +66,40 @@ public:
         powerUpSpawnTimer -= deltaTime;
         
         if (waveActive) {
+            size_t firstSpawn = spawned.size();
+            
             // Spawn enemies
-            if (enemySpawnTimer <= 0 && enemiesSpawnedThisWave < enemiesRequiredThisWave) {
-                spawnEnemy(entities, worldWidth, worldHeight);
+            if (enemySpawnTimer <= 0 && enemiesSpawnedThisWave < enemiesRequiredThisWave &&
+                live.of(EntityType::ENEMY) < Config::MAX_ENEMIES) {
+                spawnEnemy(spawned, worldWidth, worldHeight);
                 enemiesSpawnedThisWave++;
                 enemySpawnTimer = Config::ENEMY_SPAWN_RATE / 1000.0f;  // Convert ms to seconds
             }
             
-            // Spawn wolves (after wave 3)
+            // Spawn wolves (after wave 3); a pack may run past the cap
             if (currentWave > 3 && wolfSpawnTimer <= 0 && 
-                wolvesSpawnedThisWave < wolvesRequiredThisWave) {
-                spawnWolf(entities, worldWidth, worldHeight);
+                wolvesSpawnedThisWave < wolvesRequiredThisWave &&
+                live.of(EntityType::WOLF) < Config::MAX_WOLVES) {
+                spawnWolf(spawned, worldWidth, worldHeight);
                 wolvesSpawnedThisWave++;
                 wolfSpawnTimer = Config::WOLF_WAVE_SPAWN_DELAY / 1000.0f;  // Convert ms to seconds
             }
             
             // Spawn power-ups
             if (powerUpSpawnTimer <= 0) {
-                spawnPowerUp(entities, worldWidth, worldHeight);
+                if (live.of(EntityType::POWERUP) < Config::MAX_POWERUPS) {
+                    spawnPowerUp(spawned, worldWidth, worldHeight);
+                }
                 powerUpSpawnTimer = Config::POWERUP_SPAWN_RATE / 1000.0f;  // Convert ms to seconds
             }
             
             // Check if wave is complete
             if (enemiesSpawnedThisWave >= enemiesRequiredThisWave &&
                 wolvesSpawnedThisWave >= wolvesRequiredThisWave) {
-                
-                // Count remaining enemies
-                int remainingEnemies = 0;
-                for (const auto& entity : entities) {
-                    if (entity && entity->active && 
-                        (entity->type == EntityType::ENEMY || entity->type == EntityType::WOLF)) {
-                        remainingEnemies++;
-                    }
+                int remainingEnemies = live.hostiles();
+                for (size_t i = firstSpawn; i < spawned.size(); i++) {
+                    EntityType type = spawned[i]->type;
+                    if (type == EntityType::ENEMY || type == EntityType::WOLF) remainingEnemies++;
                 }
                 
                 if (remainingEnemies == 0) {
@@ -101,40 +125,39 @@ public:
         enemiesSpawnedThisWave = 0;
         
         // Calculate wolves for next wave (after wave 3)
-        if (currentWave > 3) {
+        if (Features::WOLF_AI && currentWave > 3) {
             wolvesRequiredThisWave = (currentWave - 3) * 2;
             wolvesSpawnedThisWave = 0;
         }
     }
     
-    void spawnEnemy(std::vector<std::unique_ptr<Entity>>& entities,
-                    float worldWidth, float worldHeight) {
+    void spawnEnemy(SpawnBatch& entities, float worldWidth, float worldHeight) {
         // Random spawn position at edge of screen
-        Vector2 spawnPos = getRandomEdgePosition(worldWidth, worldHeight);
+        Vector2 spawnPos = spawnOrigin + getRandomEdgePosition(worldWidth, worldHeight);
         
         auto enemy = std::make_unique<Enemy>(spawnPos);
         entities.push_back(std::move(enemy));
     }
     
-    void spawnWolf(std::vector<std::unique_ptr<Entity>>& entities,
-                   float worldWidth, float worldHeight) {
-        Vector2 spawnPos = getRandomEdgePosition(worldWidth, worldHeight);
+    void spawnWolf(SpawnBatch& entities, float worldWidth, float worldHeight) {
+#if ENGINE_FEATURE_WOLF_AI
+        Vector2 spawnPos = spawnOrigin + getRandomEdgePosition(worldWidth, worldHeight);
         
         // 20% chance for alpha wolf
-        bool isAlpha = (rand() % 100) < 20;
+        bool isAlpha = Sim::randomInt(100) < 20;
         auto wolf = std::make_unique<Wolf>(spawnPos, isAlpha);
         
         // If alpha, try to form a pack
         if (isAlpha) {
-            std::vector<Wolf*> pack;
+            FrameVector<Wolf*> pack{ArenaAllocator<Wolf*>(arena)};
             pack.push_back(wolf.get());
             
             // Spawn 2-4 additional wolves for the pack
-            int packSize = 2 + rand() % 3;
+            int packSize = 2 + Sim::randomInt(3);
             for (int i = 0; i < packSize; i++) {
                 Vector2 packPos = spawnPos;
-                packPos.x += (rand() % 100 - 50);
-                packPos.y += (rand() % 100 - 50);
+                packPos.x += (Sim::randomInt(100) - 50);
+                packPos.y += (Sim::randomInt(100) - 50);
                 
                 auto packWolf = std::make_unique<Wolf>(packPos, false);
                 pack.push_back(packWolf.get());
@@ -148,24 +171,18 @@ public:
         }
         
         entities.push_back(std::move(wolf));
+#else
+        (void)entities;
+        (void)worldWidth;
+        (void)worldHeight;
+#endif
     }
     
-    void spawnPowerUp(std::vector<std::unique_ptr<Entity>>& entities,
-                      float worldWidth, float worldHeight) {
-        // Count existing power-ups
-        int powerUpCount = 0;
-        for (const auto& entity : entities) {
-            if (entity && entity->active && entity->type == EntityType::POWERUP) {
-                powerUpCount++;
-            }
-        }
-        
-        if (powerUpCount >= Config::MAX_POWERUPS) return;
-        
+    void spawnPowerUp(SpawnBatch& entities, float worldWidth, float worldHeight) {
         // Random position (not at edges)
         Vector2 spawnPos(
-            100 + rand() % (int)(worldWidth - 200),
-            100 + rand() % (int)(worldHeight - 200)
+            spawnOrigin.x + 100 + Sim::randomInt((int)(worldWidth - 200)),
+            spawnOrigin.y + 100 + Sim::randomInt((int)(worldHeight - 200))
         );
         
         // Random power-up type
@@ -179,32 +196,32 @@ public:
             PowerUpType::MULTI_SHOT
         };
         
-        PowerUpType type = types[rand() % 7];
+        PowerUpType type = types[Sim::randomInt(7)];
         
         auto powerUp = std::make_unique<PowerUp>(spawnPos, type);
         entities.push_back(std::move(powerUp));
     }
     
     Vector2 getRandomEdgePosition(float worldWidth, float worldHeight) {
-        int edge = rand() % 4;
+        int edge = Sim::randomInt(4);
         Vector2 pos;
         
         switch (edge) {
             case 0: // Top
-                pos.x = rand() % (int)worldWidth;
+                pos.x = Sim::randomInt((int)worldWidth);
                 pos.y = -50;
                 break;
             case 1: // Right
                 pos.x = worldWidth + 50;
-                pos.y = rand() % (int)worldHeight;
+                pos.y = Sim::randomInt((int)worldHeight);
                 break;
             case 2: // Bottom
-                pos.x = rand() % (int)worldWidth;
+                pos.x = Sim::randomInt((int)worldWidth);
                 pos.y = worldHeight + 50;
                 break;
             case 3: // Left
                 pos.x = -50;
-                pos.y = rand() % (int)worldHeight;
+                pos.y = Sim::randomInt((int)worldHeight);
                 break;
         }
         
@@ -0,0 +1,88 @@
+#ifndef BIT_STREAM_H
+#define BIT_STREAM_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Little-endian bit packing for network payloads
+// Bits are appended LSB-first through a 64-bit accumulator and flushed a byte
+// at a time, so writing n fields costs n shifts rather than per-bit loops.
+class BitWriter {
+private:
+    std::vector<uint8_t>* out;
+    uint64_t scratch;
+    int scratchBits;
+
+public:
+    explicit BitWriter(std::vector<uint8_t>& buffer)
+        : out(&buffer), scratch(0), scratchBits(0) {
+        out->clear();
+    }
+
+    // Write the low `bits` bits of value (bits <= 32)
+    void write(uint32_t value, int bits) {
+        if (bits <= 0) return;
+        uint64_t mask = (bits >= 32) ? 0xffffffffull : ((1ull << bits) - 1);
+        scratch |= (static_cast<uint64_t>(value) & mask) << scratchBits;
+        scratchBits += bits;
+        while (scratchBits >= 8) {
+            out->push_back(static_cast<uint8_t>(scratch));
+            scratch >>= 8;
+            scratchBits -= 8;
+        }
+    }
+
+    void writeBool(bool value) { write(value ? 1 : 0, 1); }
+
+    // Pad to a byte boundary and return the byte length
+    size_t finish() {
+        if (scratchBits > 0) {
+            out->push_back(static_cast<uint8_t>(scratch));
+            scratch = 0;
+            scratchBits = 0;
+        }
+        return out->size();
+    }
+
+    size_t bitsWritten() const { return out->size() * 8 + scratchBits; }
+};
+
+class BitReader {
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t bytePos;
+    uint64_t scratch;
+    int scratchBits;
+    bool overflow;
+
+public:
+    BitReader(const uint8_t* bytes, size_t length)
+        : data(bytes), size(length), bytePos(0),
+          scratch(0), scratchBits(0), overflow(false) {}
+
+    // Read `bits` bits (bits <= 32); reading past the end yields zeros and
+    // sets the overflow flag
+    uint32_t read(int bits) {
+        if (bits <= 0) return 0;
+        while (scratchBits < bits) {
+            if (bytePos < size) {
+                scratch |= static_cast<uint64_t>(data[bytePos++]) << scratchBits;
+            } else {
+                overflow = true;
+            }
+            scratchBits += 8;
+        }
+        uint64_t mask = (bits >= 32) ? 0xffffffffull : ((1ull << bits) - 1);
+        uint32_t value = static_cast<uint32_t>(scratch & mask);
+        scratch >>= bits;
+        scratchBits -= bits;
+        return value;
+    }
+
+    bool readBool() { return read(1) != 0; }
+    bool hasOverflowed() const { return overflow; }
+};
+
+#endif // BIT_STREAM_H
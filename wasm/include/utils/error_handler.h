@@ -1,15 +1,18 @@
 #ifndef ERROR_HANDLER_H
 #define ERROR_HANDLER_H
 
-#include <string>
+#include "platform.h"
+#include <atomic>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <exception>
-#include <functional>
-#include <unordered_map>
-#include <emscripten/emscripten.h>
-#include <emscripten/val.h>
+#include <string>
+#include <utility>
 
 // Error types
-enum class ErrorType {
+enum class ErrorType : uint8_t {
     INITIALIZATION_ERROR,
     MEMORY_ERROR,
     PHYSICS_ERROR,
@@ -20,6 +23,33 @@ enum class ErrorType {
     UNKNOWN_ERROR
 };
 
+enum class ErrorSeverity : uint8_t {
+    DEBUG,
+    WARNING,
+    ERROR,
+    FATAL
+};
+
+// Checks below this severity are compiled out, condition included. Release
+// builds (NDEBUG) keep WARNING and up; -DERROR_MIN_SEVERITY=n overrides.
+#ifndef ERROR_MIN_SEVERITY
+    #ifdef NDEBUG
+        #define ERROR_MIN_SEVERITY 1
+    #else
+        #define ERROR_MIN_SEVERITY 0
+    #endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define GAME_LIKELY(x) __builtin_expect(!!(x), 1)
+    #define GAME_COLD __attribute__((cold, noinline))
+    #define GAME_PRINTF(fmt, args) __attribute__((format(printf, fmt, args)))
+#else
+    #define GAME_LIKELY(x) (x)
+    #define GAME_COLD
+    #define GAME_PRINTF(fmt, args)
+#endif
+
 // Custom exception class
 class GameException : public std::exception {
 private:
@@ -27,222 +57,272 @@ private:
     std::string message;
     std::string context;
     int errorCode;
-    
+
 public:
     GameException(ErrorType t, const std::string& msg, const std::string& ctx = "", int code = -1)
         : type(t), message(msg), context(ctx), errorCode(code) {}
-    
+
     const char* what() const noexcept override {
         return message.c_str();
     }
-    
+
     ErrorType getType() const { return type; }
     const std::string& getContext() const { return context; }
     int getErrorCode() const { return errorCode; }
 };
 
-// Error handler singleton
+// Fixed-size error ring
+//
+// The check macros below cost one predicted branch while they pass. Only a
+// failing check calls report(), which is cold and out of line: it formats
+// the message into a fixed record (no heap), stamps it and publishes it.
+// File, line and expression are string literals, stored as pointers.
+//
+// Any thread may report. A writer claims a slot with one fetch_add and
+// publishes it through the slot's sequence number, so reporting never
+// locks; when the ring wraps, the oldest records are overwritten. Readers
+// (the export) copy a slot and keep it only if its sequence did not change
+// meanwhile, so a record overwritten during the copy is skipped, not torn.
 class ErrorHandler {
-private:
-    static ErrorHandler* instance;
-    
-    struct ErrorInfo {
+public:
+    static constexpr size_t RING_SIZE = 64;
+    static constexpr size_t MESSAGE_SIZE = 96;
+
+    struct Record {
+        uint64_t sequence;      // Order of reporting, from 1
+        double time;            // ms, Platform::now() clock
+        const char* file;
+        const char* expression;
+        uint32_t line;
         ErrorType type;
-        std::string message;
-        std::string context;
-        int count;
-        double lastOccurrence;
-        
-        ErrorInfo() : type(ErrorType::UNKNOWN_ERROR), count(0), lastOccurrence(0) {}
+        ErrorSeverity severity;
+        char message[MESSAGE_SIZE];
+    };
+
+    // Called for every reported error, on the reporting thread
+    using Callback = void (*)(const Record& record, void* user);
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};   // 0 = empty, odd = being written
+        Record record;
     };
-    
-    std::unordered_map<std::string, ErrorInfo> errorLog;
-    std::function<void(const GameException&)> errorCallback;
-    bool debugMode;
-    size_t maxErrorLogSize;
-    
-    ErrorHandler() : debugMode(false), maxErrorLogSize(1000) {}
-    
+
+    static_assert((RING_SIZE & (RING_SIZE - 1)) == 0, "RING_SIZE must be a power of two");
+
+    Slot slots[RING_SIZE];
+    std::atomic<uint64_t> written{0};
+    std::atomic<bool> debugMode{false};
+    std::atomic<Callback> callback{nullptr};
+    std::atomic<void*> callbackUser{nullptr};
+
+    ErrorHandler() = default;
+
 public:
+    ErrorHandler(const ErrorHandler&) = delete;
+    ErrorHandler& operator=(const ErrorHandler&) = delete;
+
     static ErrorHandler& getInstance() {
-        if (!instance) {
-            instance = new ErrorHandler();
-        }
-        return *instance;
+        static ErrorHandler instance;
+        return instance;
     }
-    
-    // Set debug mode
-    void setDebugMode(bool enabled) {
-        debugMode = enabled;
-        if (enabled) {
-            EM_ASM(console.log("🐛 Debug mode enabled for WASM Game Engine"));
-        }
+
+    static constexpr int MIN_SEVERITY = ERROR_MIN_SEVERITY;
+
+    static constexpr bool enabled(ErrorSeverity severity) {
+        return static_cast<int>(severity) >= MIN_SEVERITY;
     }
-    
-    // Set error callback for JavaScript
-    void setErrorCallback(std::function<void(const GameException&)> callback) {
-        errorCallback = callback;
+
+    // Echo every report to the console
+    void setDebugMode(bool on) { debugMode.store(on, std::memory_order_relaxed); }
+    bool isDebugMode() const { return debugMode.load(std::memory_order_relaxed); }
+
+    void setCallback(Callback fn, void* user = nullptr) {
+        callbackUser.store(user, std::memory_order_relaxed);
+        callback.store(fn, std::memory_order_release);
     }
-    
-    // Handle an error
-    void handleError(const GameException& error) {
-        // Log to error history
-        std::string key = std::to_string(static_cast<int>(error.getType())) + ":" + error.what();
-        ErrorInfo& info = errorLog[key];
-        info.type = error.getType();
-        info.message = error.what();
-        info.context = error.getContext();
-        info.count++;
-        info.lastOccurrence = emscripten_get_now();
-        
-        // Limit error log size
-        if (errorLog.size() > maxErrorLogSize) {
-            // Remove oldest entry
-            auto oldest = errorLog.begin();
-            for (auto it = errorLog.begin(); it != errorLog.end(); ++it) {
-                if (it->second.lastOccurrence < oldest->second.lastOccurrence) {
-                    oldest = it;
-                }
-            }
-            errorLog.erase(oldest);
-        }
-        
-        // Log to console in debug mode
-        if (debugMode) {
-            EM_ASM({
-                console.error("🔴 WASM Error:", {
-                    type: $0,
-                    message: UTF8ToString($1),
-                    context: UTF8ToString($2),
-                    code: $3
-                });
-            }, static_cast<int>(error.getType()), 
-               error.what(), 
-               error.getContext().c_str(), 
-               error.getErrorCode());
+
+    // Failure path of the macros. Always returns false, so a check can be
+    // used as an expression: if (!GAME_VERIFY(...)) return;
+    GAME_COLD GAME_PRINTF(7, 8)
+    bool report(ErrorType type, ErrorSeverity severity, const char* file, uint32_t line,
+                const char* expression, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        reportV(type, severity, file, line, expression, format, args);
+        va_end(args);
+        return false;
+    }
+
+    GAME_COLD
+    void reportV(ErrorType type, ErrorSeverity severity, const char* file, uint32_t line,
+                 const char* expression, const char* format, va_list args) {
+        uint64_t sequence = written.fetch_add(1, std::memory_order_relaxed) + 1;
+        Slot& slot = slots[(sequence - 1) & (RING_SIZE - 1)];
+        slot.sequence.store(sequence * 2 - 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        Record& r = slot.record;
+        r.sequence = sequence;
+        r.time = Platform::now();
+        r.file = file;
+        r.expression = expression;
+        r.line = line;
+        r.type = type;
+        r.severity = severity;
+        std::vsnprintf(r.message, MESSAGE_SIZE, format, args);
+        slot.sequence.store(sequence * 2, std::memory_order_release);
+
+        if (isDebugMode()) {
+            char text[MESSAGE_SIZE + 160];
+            std::snprintf(text, sizeof(text), "WASM error (%d) %s:%u %s: %s",
+                          static_cast<int>(type), file, line, expression, r.message);
+            Platform::logError(text);
         }
-        
-        // Call error callback if set
-        if (errorCallback) {
-            errorCallback(error);
+        if (Callback fn = callback.load(std::memory_order_acquire)) {
+            fn(r, callbackUser.load(std::memory_order_relaxed));
         }
     }
-    
-    // Report error to JavaScript
-    emscripten::val getErrorReport() {
-        emscripten::val report = emscripten::val::object();
-        emscripten::val errors = emscripten::val::array();
-        
-        for (const auto& [key, info] : errorLog) {
-            emscripten::val errorObj = emscripten::val::object();
-            errorObj.set("type", static_cast<int>(info.type));
-            errorObj.set("message", info.message);
-            errorObj.set("context", info.context);
-            errorObj.set("count", info.count);
-            errorObj.set("lastOccurrence", info.lastOccurrence);
-            errors.call<void>("push", errorObj);
+
+    // Reports since start (or clear); more than RING_SIZE means some were overwritten
+    uint64_t totalReported() const { return written.load(std::memory_order_relaxed); }
+
+    // Copy out the records still in the ring, oldest first. Returns the count.
+    size_t snapshot(Record* out, size_t capacity) const {
+        uint64_t end = written.load(std::memory_order_acquire);
+        uint64_t begin = end > RING_SIZE ? end - RING_SIZE : 0;
+        size_t count = 0;
+        for (uint64_t s = begin + 1; s <= end && count < capacity; s++) {
+            const Slot& slot = slots[(s - 1) & (RING_SIZE - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != s * 2) continue;
+            out[count] = slot.record;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != s * 2) continue;
+            count++;
         }
-        
-        report.set("errors", errors);
-        report.set("totalErrors", errorLog.size());
-        report.set("debugMode", debugMode);
-        
-        return report;
+        return count;
     }
-    
-    // Clear error log
-    void clearErrorLog() {
-        errorLog.clear();
+
+    // Call while no thread is reporting
+    void clear() {
+        for (Slot& slot : slots) slot.sequence.store(0, std::memory_order_relaxed);
+        written.store(0, std::memory_order_relaxed);
     }
-    
-    // Check if we should suppress repeated errors
-    bool shouldSuppressError(const std::string& errorKey) {
-        auto it = errorLog.find(errorKey);
-        if (it != errorLog.end()) {
-            double now = emscripten_get_now();
-            // Suppress if same error occurred within 100ms
-            if (now - it->second.lastOccurrence < 100) {
-                return true;
-            }
-        }
-        return false;
+
+    // Exceptions caught at the export boundary
+    void handleError(const GameException& error) {
+        report(error.getType(), ErrorSeverity::ERROR, "exception", 0, "GameException",
+               "%s (%s)", error.what(), error.getContext().c_str());
     }
 };
 
-// Assertion macros for debug builds
-#ifdef DEBUG_BUILD
-    #define GAME_ASSERT(condition, message) \
-        do { \
-            if (!(condition)) { \
-                throw GameException(ErrorType::UNKNOWN_ERROR, \
-                                  std::string("Assertion failed: ") + message, \
-                                  __FILE__ + std::string(":") + std::to_string(__LINE__)); \
-            } \
-        } while(0)
-    
-    #define GAME_ASSERT_BOUNDS(value, min, max, name) \
-        do { \
-            if ((value) < (min) || (value) > (max)) { \
-                throw GameException(ErrorType::BOUNDS_ERROR, \
-                                  std::string(name) + " out of bounds: " + std::to_string(value), \
-                                  __FILE__ + std::string(":") + std::to_string(__LINE__)); \
-            } \
-        } while(0)
-    
-    #define GAME_ASSERT_NOT_NULL(ptr, name) \
-        do { \
-            if (!(ptr)) { \
-                throw GameException(ErrorType::INVALID_PARAMETER, \
-                                  std::string(name) + " is null", \
-                                  __FILE__ + std::string(":") + std::to_string(__LINE__)); \
-            } \
-        } while(0)
-#else
-    #define GAME_ASSERT(condition, message)
-    #define GAME_ASSERT_BOUNDS(value, min, max, name)
-    #define GAME_ASSERT_NOT_NULL(ptr, name)
-#endif
+// Checks. The condition is evaluated once, and only when its severity is
+// compiled in; the message is a printf format, formatted only on failure.
+#define GAME_CHECK_AT(severity, type, condition, ...) \
+    ((!ErrorHandler::enabled(severity) || GAME_LIKELY(condition)) || \
+     ErrorHandler::getInstance().report(type, severity, __FILE__, __LINE__, #condition, __VA_ARGS__))
+
+// Expression form: true when the check passed (or is compiled out)
+#define GAME_VERIFY(condition, ...) \
+    GAME_CHECK_AT(ErrorSeverity::ERROR, ErrorType::UNKNOWN_ERROR, condition, __VA_ARGS__)
+
+#define GAME_ASSERT(condition, ...) \
+    ((void)GAME_CHECK_AT(ErrorSeverity::ERROR, ErrorType::UNKNOWN_ERROR, condition, __VA_ARGS__))
+
+#define GAME_DEBUG_ASSERT(condition, ...) \
+    ((void)GAME_CHECK_AT(ErrorSeverity::DEBUG, ErrorType::UNKNOWN_ERROR, condition, __VA_ARGS__))
+
+#define GAME_ASSERT_BOUNDS(value, min, max, name) \
+    ((void)GAME_CHECK_AT(ErrorSeverity::ERROR, ErrorType::BOUNDS_ERROR, \
+                         (value) >= (min) && (value) <= (max), \
+                         "%s out of bounds: %g not in [%g, %g]", name, \
+                         static_cast<double>(value), static_cast<double>(min), static_cast<double>(max)))
+
+#define GAME_ASSERT_NOT_NULL(ptr, name) \
+    ((void)GAME_CHECK_AT(ErrorSeverity::ERROR, ErrorType::INVALID_PARAMETER, (ptr) != nullptr, \
+                         "%s is null", name))
 
 // Error handling macros
+#if defined(__cpp_exceptions)
 #define TRY_GAME_OPERATION(operation, errorType, context) \
     try { \
         operation; \
     } catch (const std::exception& e) { \
-        ErrorHandler::getInstance().handleError( \
-            GameException(errorType, e.what(), context)); \
+        ErrorHandler::getInstance().report(errorType, ErrorSeverity::ERROR, __FILE__, __LINE__, \
+                                           context, "%s", e.what()); \
     } catch (...) { \
-        ErrorHandler::getInstance().handleError( \
-            GameException(errorType, "Unknown error", context)); \
+        ErrorHandler::getInstance().report(errorType, ErrorSeverity::ERROR, __FILE__, __LINE__, \
+                                           context, "Unknown error"); \
     }
+#else
+#define TRY_GAME_OPERATION(operation, errorType, context) operation;
+#endif
 
-// Safe wrapper for WASM exports
-template<typename ReturnType, typename... Args>
+// Safe wrapper for WASM exports, with the callable's own type (no
+// std::function). Without exceptions it is a plain forwarding call.
+template<typename Fn, typename ReturnType>
 class SafeExport {
 private:
-    std::function<ReturnType(Args...)> func;
+    Fn func;
     ReturnType defaultValue;
-    std::string name;
-    
+    const char* name;
+
 public:
-    SafeExport(std::function<ReturnType(Args...)> f, ReturnType def, const std::string& n)
-        : func(f), defaultValue(def), name(n) {}
-    
-    ReturnType operator()(Args... args) {
+    SafeExport(Fn f, ReturnType def, const char* n)
+        : func(std::move(f)), defaultValue(std::move(def)), name(n) {}
+
+    template<typename... Args>
+    ReturnType operator()(Args&&... args) {
+#if defined(__cpp_exceptions)
         try {
-            return func(args...);
+            return func(std::forward<Args>(args)...);
         } catch (const GameException& e) {
             ErrorHandler::getInstance().handleError(e);
-            return defaultValue;
         } catch (const std::exception& e) {
-            ErrorHandler::getInstance().handleError(
-                GameException(ErrorType::UNKNOWN_ERROR, e.what(), name));
-            return defaultValue;
+            ErrorHandler::getInstance().report(ErrorType::UNKNOWN_ERROR, ErrorSeverity::ERROR,
+                                               "export", 0, name, "%s", e.what());
         } catch (...) {
-            ErrorHandler::getInstance().handleError(
-                GameException(ErrorType::UNKNOWN_ERROR, "Unknown error in " + name, name));
-            return defaultValue;
+            ErrorHandler::getInstance().report(ErrorType::UNKNOWN_ERROR, ErrorSeverity::ERROR,
+                                               "export", 0, name, "Unknown error");
         }
+        return defaultValue;
+#else
+        return func(std::forward<Args>(args)...);
+#endif
     }
 };
 
-#endif // ERROR_HANDLER_H
\ No newline at end of file
+template<typename Fn, typename ReturnType>
+SafeExport<Fn, ReturnType> makeSafeExport(Fn f, ReturnType def, const char* name) {
+    return SafeExport<Fn, ReturnType>(std::move(f), std::move(def), name);
+}
+
+// Function-pointer form for bindings: safeExport<&fn> is a plain function
+// with fn's signature that returns a value-initialised result on failure
+template<typename Sig>
+struct SafeExportFn;
+
+template<typename ReturnType, typename... Args>
+struct SafeExportFn<ReturnType (*)(Args...)> {
+    template<ReturnType (*Fn)(Args...)>
+    static ReturnType call(Args... args) {
+        return SafeExport<ReturnType (*)(Args...), ReturnType>(Fn, ReturnType(), "export")(args...);
+    }
+};
+
+template<typename... Args>
+struct SafeExportFn<void (*)(Args...)> {
+    template<void (*Fn)(Args...)>
+    static void call(Args... args) {
+#if defined(__cpp_exceptions)
+        TRY_GAME_OPERATION(Fn(args...), ErrorType::UNKNOWN_ERROR, "export")
+#else
+        Fn(args...);
+#endif
+    }
+};
+
+template<auto Fn>
+constexpr auto safeExport = &SafeExportFn<decltype(Fn)>::template call<Fn>;
+
+#endif // ERROR_HANDLER_H
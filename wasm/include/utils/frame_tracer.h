@@ -0,0 +1,168 @@
+#ifndef FRAME_TRACER_H
+#define FRAME_TRACER_H
+
+#include "platform.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+// Scoped-zone tracer for finding slow frames
+//
+// TRACE_ZONE("name") records a begin time and a duration for the enclosing
+// scope. Zones nest naturally: the viewer stacks them by time per thread, so
+// no depth is stored. Every recording thread owns a ring of fixed-size events
+// and only ever writes its own ring, so workers trace without locks; a full
+// ring overwrites its oldest events. Names must be string literals (only the
+// pointer is stored).
+//
+// dumpChromeTrace(frames) turns the last frames into Chrome trace-event JSON,
+// loadable in chrome://tracing or ui.perfetto.dev. Call it between updates,
+// while no worker is recording.
+class FrameTracer {
+public:
+    static constexpr int MAX_LANES = 8;                // Main thread + JobSystem workers
+    static constexpr size_t MAIN_LANE_EVENTS = 32768;  // Roughly 300 busy frames
+    static constexpr size_t WORKER_LANE_EVENTS = 8192;
+
+    struct Event {
+        const char* name;
+        double start;      // ms, Platform::now() clock
+        float duration;    // ms
+        uint32_t frame;
+    };
+
+private:
+    struct Lane {
+        std::unique_ptr<Event[]> events;
+        size_t capacity = 0;
+        std::atomic<uint64_t> written{0};
+    };
+
+    Lane lanes[MAX_LANES];
+    std::atomic<int> laneCount{0};
+    std::atomic<bool> enabled{true};
+    std::atomic<uint32_t> frame{0};
+
+    FrameTracer() = default;
+
+    // The first thread to record (the engine's main thread) gets the large
+    // lane; its buffer is allocated by the owning thread on first use.
+    // Threads past MAX_LANES are not traced.
+    Lane* laneForThread() {
+        static thread_local int lane = -1;
+        if (lane < 0) {
+            lane = laneCount.fetch_add(1, std::memory_order_relaxed);
+            if (lane < MAX_LANES) {
+                Lane& owned = lanes[lane];
+                owned.capacity = lane == 0 ? MAIN_LANE_EVENTS : WORKER_LANE_EVENTS;
+                owned.events.reset(new Event[owned.capacity]);
+            }
+        }
+        return lane < MAX_LANES ? &lanes[lane] : nullptr;
+    }
+
+public:
+    FrameTracer(const FrameTracer&) = delete;
+    FrameTracer& operator=(const FrameTracer&) = delete;
+
+    static FrameTracer& getInstance() {
+        static FrameTracer instance;
+        return instance;
+    }
+
+    static double now() { return Platform::now(); }
+
+    void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Called once per engine update; events are tagged with the current frame
+    void beginFrame() { frame.fetch_add(1, std::memory_order_relaxed); }
+    uint32_t getFrame() const { return frame.load(std::memory_order_relaxed); }
+
+    void record(const char* name, double start, double end) {
+        if (!isEnabled()) return;
+        Lane* lane = laneForThread();
+        if (!lane) return;
+        uint64_t n = lane->written.load(std::memory_order_relaxed);
+        lane->events[n % lane->capacity] = {name, start, static_cast<float>(end - start),
+                                            frame.load(std::memory_order_relaxed)};
+        lane->written.store(n + 1, std::memory_order_release);
+    }
+
+    class Zone {
+        const char* name;
+        double startTime;
+
+    public:
+        explicit Zone(const char* zoneName) : name(zoneName), startTime(now()) {}
+        ~Zone() { FrameTracer::getInstance().record(name, startTime, now()); }
+    };
+
+    // Events of the last frames (the current frame included) still held in
+    // the rings, as {"traceEvents":[...]}. One tid per lane.
+    std::string dumpChromeTrace(uint32_t frames) const {
+        uint32_t current = getFrame();
+        uint32_t firstFrame = frames >= current ? 0 : current - frames + 1;
+
+        std::string json;
+        json.reserve(64 * 1024);
+        json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        char line[256];
+
+        int lanesUsed = std::min(laneCount.load(std::memory_order_relaxed), MAX_LANES);
+        for (int l = 0; l < lanesUsed; l++) {
+            const Lane& lane = lanes[l];
+            uint64_t written = lane.written.load(std::memory_order_acquire);
+            if (written == 0) continue;
+
+            char threadName[16];
+            if (l == 0) {
+                std::snprintf(threadName, sizeof(threadName), "main");
+            } else {
+                std::snprintf(threadName, sizeof(threadName), "worker-%d", l);
+            }
+            std::snprintf(line, sizeof(line),
+                "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                "\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",", l, threadName);
+            json += line;
+            first = false;
+
+            uint64_t oldest = written > lane.capacity ? written - lane.capacity : 0;
+            for (uint64_t i = oldest; i < written; i++) {
+                const Event& e = lane.events[i % lane.capacity];
+                if (e.frame < firstFrame) continue;
+                std::snprintf(line, sizeof(line),
+                    ",{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                    "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u}}",
+                    e.name, l, e.start * 1000.0, e.duration * 1000.0, e.frame);
+                json += line;
+            }
+        }
+
+        json += "]}";
+        return json;
+    }
+
+    // Drop recorded events. Call while no other thread is recording.
+    void clear() {
+        for (Lane& lane : lanes) lane.written.store(0, std::memory_order_relaxed);
+    }
+};
+
+// Tracing is cheap enough to leave on; define TRACE_DISABLED to compile it out
+#ifndef TRACE_DISABLED
+    #define TRACE_CONCAT_INNER(a, b) a##b
+    #define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+    #define TRACE_ZONE(name) FrameTracer::Zone TRACE_CONCAT(traceZone_, __LINE__)(name)
+    #define TRACE_FRAME() FrameTracer::getInstance().beginFrame()
+#else
+    #define TRACE_ZONE(name)
+    #define TRACE_FRAME()
+#endif
+
+#endif // FRAME_TRACER_H
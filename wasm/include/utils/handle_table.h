@@ -0,0 +1,131 @@
+#ifndef HANDLE_TABLE_H
+#define HANDLE_TABLE_H
+
+#include "error_handler.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Generational handles for objects kept in a dense, swap-removed array
+//
+// A handle packs a slot index (low INDEX_BITS) and that slot's generation
+// (the bits above). Each slot records where its object currently sits in the
+// owner's dense array, so resolving a handle is two array reads. Releasing a
+// slot bumps its generation, so a handle kept past its object's removal
+// resolves to nothing instead of to whatever reuses the slot. Handles are
+// always positive; 0 is never issued.
+class HandleTable {
+public:
+    static constexpr int INDEX_BITS = 16;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t MAX_GENERATION = (1u << (31 - INDEX_BITS)) - 1;
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+    static constexpr int NULL_HANDLE = 0;
+
+private:
+    struct Slot {
+        uint32_t dense;       // Position in the owner's array, or INVALID_INDEX
+        uint32_t generation;  // 1..MAX_GENERATION
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    size_t liveCount;
+
+public:
+    HandleTable() : liveCount(0) {}
+
+    // Issue a handle for an object stored at dense; NULL_HANDLE when full
+    int allocate(uint32_t dense) {
+        uint32_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            if (!GAME_CHECK_AT(ErrorSeverity::WARNING, ErrorType::ENTITY_ERROR, slots.size() <= INDEX_MASK,
+                               "handle table full (%zu slots)", slots.size())) {
+                return NULL_HANDLE;
+            }
+            index = static_cast<uint32_t>(slots.size());
+            slots.push_back({INVALID_INDEX, 1});
+        }
+        slots[index].dense = dense;
+        liveCount++;
+        return makeHandle(index, slots[index].generation);
+    }
+
+    // Dense position for handle, or INVALID_INDEX when it is stale or bogus
+    uint32_t resolve(int handle) const {
+        if (handle <= 0) return INVALID_INDEX;
+        uint32_t index = static_cast<uint32_t>(handle) & INDEX_MASK;
+        if (index >= slots.size()) return INVALID_INDEX;
+        const Slot& slot = slots[index];
+        if (slot.generation != static_cast<uint32_t>(handle) >> INDEX_BITS) return INVALID_INDEX;
+        return slot.dense;
+    }
+
+    bool isValid(int handle) const { return resolve(handle) != INVALID_INDEX; }
+
+    // Record that the object moved within the dense array
+    void relocate(int handle, uint32_t dense) {
+        if (!GAME_VERIFY(resolve(handle) != INVALID_INDEX, "relocate of stale handle %d", handle)) return;
+        slots[static_cast<uint32_t>(handle) & INDEX_MASK].dense = dense;
+    }
+
+    // Invalidate handle; its slot is reused with the next generation
+    bool release(int handle) {
+        if (resolve(handle) == INVALID_INDEX) return false;
+        uint32_t index = static_cast<uint32_t>(handle) & INDEX_MASK;
+        Slot& slot = slots[index];
+        slot.dense = INVALID_INDEX;
+        slot.generation = slot.generation >= MAX_GENERATION ? 1 : slot.generation + 1;
+        freeSlots.push_back(index);
+        liveCount--;
+        return true;
+    }
+
+    // Release every live handle. Generations are kept, so handles issued
+    // before the reset stay stale afterwards.
+    void releaseAll() {
+        freeSlots.clear();
+        for (uint32_t i = static_cast<uint32_t>(slots.size()); i-- > 0;) {
+            Slot& slot = slots[i];
+            if (slot.dense != INVALID_INDEX) {
+                slot.dense = INVALID_INDEX;
+                slot.generation = slot.generation >= MAX_GENERATION ? 1 : slot.generation + 1;
+            }
+            freeSlots.push_back(i);
+        }
+        liveCount = 0;
+    }
+
+    // Whole table, slots and free list, for world saves
+    // (systems/rollback_buffer.h); loadState() keeps the vectors' storage
+    template<typename Writer>
+    void saveState(Writer& out) const {
+        out.put(static_cast<uint32_t>(slots.size()));
+        out.put(static_cast<uint32_t>(freeSlots.size()));
+        out.put(static_cast<uint32_t>(liveCount));
+        out.putArray(slots.data(), slots.size());
+        out.putArray(freeSlots.data(), freeSlots.size());
+    }
+
+    template<typename Reader>
+    bool loadState(Reader& in) {
+        uint32_t slotCount = 0, freeCount = 0, live = 0;
+        if (!in.get(slotCount) || !in.get(freeCount) || !in.get(live)) return false;
+        slots.resize(slotCount);
+        freeSlots.resize(freeCount);
+        liveCount = live;
+        return in.getArray(slots.data(), slots.size()) && in.getArray(freeSlots.data(), freeSlots.size());
+    }
+
+    size_t size() const { return liveCount; }
+    size_t capacity() const { return slots.size(); }
+
+    static int makeHandle(uint32_t index, uint32_t generation) {
+        return static_cast<int>((generation << INDEX_BITS) | index);
+    }
+};
+
+#endif // HANDLE_TABLE_H
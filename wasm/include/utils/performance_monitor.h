@@ -1,212 +1,264 @@
 #ifndef PERFORMANCE_MONITOR_H
 #define PERFORMANCE_MONITOR_H
 
-#include <emscripten/emscripten.h>
-#include <string>
-#include <unordered_map>
-#include <deque>
-#include <chrono>
+#include "platform.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Metrics are identified at compile time; names only exist for export
+enum class MetricId : uint8_t {
+    FRAME,          // Whole update() call
+    PHYSICS,
+    COLLISION,
+    AI,
+    EFFECTS,
+    WAVES,
+    RENDER_EXPORT,
+    NETWORK_ENCODE,
+    NARROWPHASE_CHUNK, // One narrowphase slice, on whichever thread ran it
+    COUNT
+};
+
+inline const char* metricName(MetricId id) {
+    static const char* names[] = {
+        "frame", "physics", "collision", "ai", "effects", "waves",
+        "renderExport", "networkEncode", "narrowphaseChunk"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(MetricId::COUNT),
+                  "metric name table out of date");
+    return names[static_cast<size_t>(id)];
+}
 
 // Performance monitoring system for profiling and optimization
+//
+// JavaScript export lives with the bindings (src/utils/performance_monitor.cpp)
+// so the monitor itself has no Emscripten dependency.
+//
+// Every recording thread owns one lane: a fixed ring of recent samples plus
+// running count, sum, min and max per metric. Recording only touches the
+// caller's own lane (a thread_local index picks it), so workers record
+// without locks; the atomics are relaxed and exist so the exporting thread
+// can read lanes while they are written. Percentiles are estimated at export
+// time from the rings of all lanes, so the hot path stays O(1).
 class PerformanceMonitor {
 public:
-    struct Metric {
+    static constexpr int MAX_LANES = 8;         // Main thread + JobSystem workers
+    static constexpr size_t WINDOW = 64;        // Samples per metric per lane
+    static constexpr size_t METRIC_COUNT = static_cast<size_t>(MetricId::COUNT);
+
+    // Merged view of one metric across lanes
+    struct Summary {
         double current;
-        double average;
-        double min;
+        double average;   // Over the recent window
+        double mean;      // All time
+        double min;       // All time
         double max;
-        size_t samples;
-        std::deque<double> history;
-        
-        Metric() : current(0), average(0), min(1e9), max(0), samples(0) {}
-        
-        void update(double value) {
-            current = value;
-            min = std::min(min, value);
-            max = std::max(max, value);
-            
-            history.push_back(value);
-            if (history.size() > 60) { // Keep last 60 frames
-                history.pop_front();
-            }
-            
-            // Calculate moving average
-            double sum = 0;
-            for (double v : history) {
-                sum += v;
-            }
-            average = sum / history.size();
-            samples++;
+        double p50;
+        double p95;
+        double p99;
+        uint64_t samples;
+    };
+
+private:
+    struct Series {
+        std::atomic<float> ring[WINDOW];
+        std::atomic<uint64_t> count{0};
+        std::atomic<double> sum{0};
+        std::atomic<float> min{1e30f};
+        std::atomic<float> max{0};
+        std::atomic<float> current{0};
+
+        void record(float value) {
+            uint64_t n = count.load(std::memory_order_relaxed);
+            ring[n & (WINDOW - 1)].store(value, std::memory_order_relaxed);
+            sum.store(sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+            if (value < min.load(std::memory_order_relaxed)) min.store(value, std::memory_order_relaxed);
+            if (value > max.load(std::memory_order_relaxed)) max.store(value, std::memory_order_relaxed);
+            current.store(value, std::memory_order_relaxed);
+            count.store(n + 1, std::memory_order_release);
         }
-        
+
         void reset() {
-            current = 0;
-            average = 0;
-            min = 1e9;
-            max = 0;
-            samples = 0;
-            history.clear();
+            count.store(0, std::memory_order_relaxed);
+            sum.store(0, std::memory_order_relaxed);
+            min.store(1e30f, std::memory_order_relaxed);
+            max.store(0, std::memory_order_relaxed);
+            current.store(0, std::memory_order_relaxed);
         }
     };
-    
-private:
-    std::unordered_map<std::string, Metric> metrics;
-    std::unordered_map<std::string, double> timers;
-    
-    // Frame time tracking
+
+    struct Lane {
+        Series series[METRIC_COUNT];
+    };
+
+    static_assert((WINDOW & (WINDOW - 1)) == 0, "WINDOW must be a power of two");
+
+    Lane lanes[MAX_LANES];
+    std::atomic<int> laneCount{0};
+    std::atomic<bool> enabled{true};
+
+    // Frame time tracking (main thread only)
     double lastFrameTime;
     double deltaTime;
     double fps;
-    std::deque<double> frameHistory;
-    
+    double frameRing[WINDOW];
+    double frameSum;
+    size_t frameCount;
+
     // Memory tracking
     size_t currentMemory;
     size_t peakMemory;
-    
-    static PerformanceMonitor* instance;
-    
-public:
-    PerformanceMonitor() : lastFrameTime(0), deltaTime(0), fps(0), 
-                           currentMemory(0), peakMemory(0) {}
-    
-    static PerformanceMonitor& getInstance() {
-        if (!instance) {
-            instance = new PerformanceMonitor();
+
+    PerformanceMonitor()
+        : lastFrameTime(0), deltaTime(0), fps(0), frameRing(), frameSum(0), frameCount(0),
+          currentMemory(0), peakMemory(0) {}
+
+    // One lane per thread, claimed on the thread's first record; threads
+    // past MAX_LANES share the last lane (their samples may interleave)
+    Lane& laneForThread() {
+        static thread_local int lane = -1;
+        if (lane < 0) {
+            lane = std::min(laneCount.fetch_add(1, std::memory_order_relaxed), MAX_LANES - 1);
         }
-        return *instance;
+        return lanes[lane];
     }
-    
-    // Timer functions
-    void startTimer(const std::string& name) {
-        timers[name] = emscripten_get_now();
+
+public:
+    PerformanceMonitor(const PerformanceMonitor&) = delete;
+    PerformanceMonitor& operator=(const PerformanceMonitor&) = delete;
+
+    static PerformanceMonitor& getInstance() {
+        static PerformanceMonitor instance;
+        return instance;
     }
-    
-    void endTimer(const std::string& name) {
-        auto it = timers.find(name);
-        if (it != timers.end()) {
-            double elapsed = emscripten_get_now() - it->second;
-            metrics[name].update(elapsed);
-            timers.erase(it);
-        }
+
+    static double now() { return Platform::now(); }
+
+    void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Record a sample (ms for timers) from any thread
+    void recordMetric(MetricId id, double value) {
+        if (!isEnabled()) return;
+        laneForThread().series[static_cast<size_t>(id)].record(static_cast<float>(value));
     }
-    
+
     // Scoped timer for RAII-style timing
     class ScopedTimer {
-        std::string name;
+        MetricId id;
         double startTime;
-        
+
     public:
-        explicit ScopedTimer(const std::string& timerName) 
-            : name(timerName), startTime(emscripten_get_now()) {}
-        
+        explicit ScopedTimer(MetricId metric) : id(metric), startTime(now()) {}
+
         ~ScopedTimer() {
-            double elapsed = emscripten_get_now() - startTime;
-            PerformanceMonitor::getInstance().recordMetric(name, elapsed);
+            PerformanceMonitor::getInstance().recordMetric(id, now() - startTime);
         }
     };
-    
-    // Record custom metric
-    void recordMetric(const std::string& name, double value) {
-        metrics[name].update(value);
-    }
-    
+
     // Frame tracking
     void beginFrame() {
-        double currentTime = emscripten_get_now();
+        double currentTime = now();
         if (lastFrameTime > 0) {
             deltaTime = currentTime - lastFrameTime;
-            frameHistory.push_back(deltaTime);
-            if (frameHistory.size() > 60) {
-                frameHistory.pop_front();
-            }
-            
-            // Calculate FPS
-            double avgFrameTime = 0;
-            for (double ft : frameHistory) {
-                avgFrameTime += ft;
-            }
-            avgFrameTime /= frameHistory.size();
-            fps = 1000.0 / avgFrameTime;
+            size_t slot = frameCount % WINDOW;
+            if (frameCount >= WINDOW) frameSum -= frameRing[slot];
+            frameRing[slot] = deltaTime;
+            frameSum += deltaTime;
+            frameCount++;
+
+            double avgFrameTime = frameSum / std::min(frameCount, WINDOW);
+            fps = avgFrameTime > 0 ? 1000.0 / avgFrameTime : 0;
         }
         lastFrameTime = currentTime;
     }
-    
+
     void endFrame() {
         // Update memory usage
         updateMemoryUsage();
     }
-    
+
     // Memory tracking
     void updateMemoryUsage() {
-        // Get WASM memory usage
-        size_t memoryUsage = EM_ASM_INT({
-            if (typeof performance !== 'undefined' && performance.memory) {
-                return performance.memory.usedJSHeapSize;
-            }
-            return 0;
-        });
-        
-        currentMemory = memoryUsage;
+        currentMemory = Platform::jsHeapUsed();
         peakMemory = std::max(peakMemory, currentMemory);
     }
-    
-    // Get metrics
-    const Metric* getMetric(const std::string& name) const {
-        auto it = metrics.find(name);
-        return (it != metrics.end()) ? &it->second : nullptr;
+
+    // Merge one metric across lanes. Cold path: copies the rings and sorts.
+    Summary summarize(MetricId id) const {
+        Summary summary = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+        float window[MAX_LANES * WINDOW];
+        size_t windowCount = 0;
+        double sum = 0;
+        float minValue = 1e30f;
+        float maxValue = 0;
+
+        int lanesUsed = std::min(laneCount.load(std::memory_order_relaxed), MAX_LANES);
+        for (int l = 0; l < lanesUsed; l++) {
+            const Series& s = lanes[l].series[static_cast<size_t>(id)];
+            uint64_t n = s.count.load(std::memory_order_acquire);
+            if (n == 0) continue;
+            summary.samples += n;
+            sum += s.sum.load(std::memory_order_relaxed);
+            minValue = std::min(minValue, s.min.load(std::memory_order_relaxed));
+            maxValue = std::max(maxValue, s.max.load(std::memory_order_relaxed));
+            if (summary.current == 0) {
+                summary.current = s.current.load(std::memory_order_relaxed);
+            }
+            size_t recent = static_cast<size_t>(std::min<uint64_t>(n, WINDOW));
+            for (size_t i = 0; i < recent; i++) {
+                window[windowCount++] = s.ring[i].load(std::memory_order_relaxed);
+            }
+        }
+        if (summary.samples == 0) return summary;
+
+        summary.mean = sum / summary.samples;
+        summary.min = minValue;
+        summary.max = maxValue;
+
+        double windowSum = 0;
+        for (size_t i = 0; i < windowCount; i++) windowSum += window[i];
+        summary.average = windowSum / windowCount;
+
+        auto percentile = [&](double q) {
+            size_t k = static_cast<size_t>(q * (windowCount - 1) + 0.5);
+            std::nth_element(window, window + k, window + windowCount);
+            return static_cast<double>(window[k]);
+        };
+        summary.p50 = percentile(0.50);
+        summary.p95 = percentile(0.95);
+        summary.p99 = percentile(0.99);
+        return summary;
     }
-    
+
     double getFPS() const { return fps; }
     double getDeltaTime() const { return deltaTime; }
     size_t getCurrentMemory() const { return currentMemory; }
     size_t getPeakMemory() const { return peakMemory; }
-    
-    // Export metrics to JavaScript
-    emscripten::val exportMetrics() {
-        emscripten::val result = emscripten::val::object();
-        
-        result.set("fps", fps);
-        result.set("deltaTime", deltaTime);
-        result.set("memoryUsed", currentMemory);
-        result.set("memoryPeak", peakMemory);
-        
-        emscripten::val metricsObj = emscripten::val::object();
-        for (const auto& [name, metric] : metrics) {
-            emscripten::val metricObj = emscripten::val::object();
-            metricObj.set("current", metric.current);
-            metricObj.set("average", metric.average);
-            metricObj.set("min", metric.min);
-            metricObj.set("max", metric.max);
-            metricObj.set("samples", metric.samples);
-            metricsObj.set(name, metricObj);
-        }
-        result.set("metrics", metricsObj);
-        
-        return result;
-    }
-    
-    // Reset all metrics
+
+    // Reset all metrics. Call while no other thread is recording.
     void reset() {
-        metrics.clear();
-        timers.clear();
-        frameHistory.clear();
+        for (Lane& lane : lanes) {
+            for (Series& series : lane.series) series.reset();
+        }
+        frameSum = 0;
+        frameCount = 0;
         lastFrameTime = 0;
         deltaTime = 0;
         fps = 0;
     }
 };
 
-// Convenience macros for performance monitoring
-#ifdef DEBUG_BUILD
-    #define PERF_TIMER(name) PerformanceMonitor::ScopedTimer _timer_##name(#name)
-    #define PERF_START(name) PerformanceMonitor::getInstance().startTimer(#name)
-    #define PERF_END(name) PerformanceMonitor::getInstance().endTimer(#name)
-    #define PERF_RECORD(name, value) PerformanceMonitor::getInstance().recordMetric(#name, value)
+// Convenience macros for performance monitoring. Recording is cheap enough
+// to leave in release builds; define PERF_DISABLED to compile it out.
+#ifndef PERF_DISABLED
+    #define PERF_TIMER(id) PerformanceMonitor::ScopedTimer perfTimer_##id(MetricId::id)
+    #define PERF_RECORD(id, value) PerformanceMonitor::getInstance().recordMetric(MetricId::id, value)
 #else
-    #define PERF_TIMER(name)
-    #define PERF_START(name)
-    #define PERF_END(name)
-    #define PERF_RECORD(name, value)
+    #define PERF_TIMER(id)
+    #define PERF_RECORD(id, value)
 #endif
 
-#endif // PERFORMANCE_MONITOR_H
\ No newline at end of file
+#endif // PERFORMANCE_MONITOR_H
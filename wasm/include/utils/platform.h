@@ -0,0 +1,55 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#include <cstddef>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/emscripten.h>
+#else
+#include <chrono>
+#include <cstdio>
+#endif
+
+// Host services used by the engine core
+//
+// Everything under include/ reaches the host through here, so the core
+// (entities, systems, AI, effects) also builds natively, e.g. for
+// benchmarks/engine_benchmark.cpp. Types that talk to JavaScript
+// (emscripten::val, bindings) stay in the bindings layer: game_engine_bindings.cpp,
+// bindings.cpp and the EMSCRIPTEN_BINDINGS blocks in src/.
+namespace Platform {
+    // Monotonic time in milliseconds
+    inline double now() {
+#ifdef __EMSCRIPTEN__
+        return emscripten_get_now();
+#else
+        using Clock = std::chrono::steady_clock;
+        return std::chrono::duration<double, std::milli>(Clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    // JS heap in use where the browser reports it, otherwise 0
+    inline size_t jsHeapUsed() {
+#ifdef __EMSCRIPTEN__
+        return static_cast<size_t>(EM_ASM_INT({
+            if (typeof performance !== 'undefined' && performance.memory) {
+                return performance.memory.usedJSHeapSize;
+            }
+            return 0;
+        }));
+#else
+        return 0;
+#endif
+    }
+
+    // One line to the console (stderr natively)
+    inline void logError(const char* text) {
+#ifdef __EMSCRIPTEN__
+        EM_ASM({ console.error(UTF8ToString($0)); }, text);
+#else
+        std::fprintf(stderr, "%s\n", text);
+#endif
+    }
+}
+
+#endif // PLATFORM_H
@@ -0,0 +1,101 @@
+#ifndef RENDER_BUFFER_H
+#define RENDER_BUFFER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+// Packed render state shared with JavaScript through the WASM heap
+//
+// The engine fills persistent arrays of fixed-size records once per frame and
+// hands JS a typed_memory_view over them, so the renderer reads positions
+// straight out of linear memory instead of receiving one object per entity.
+// Every field is 32 bits wide; JS indexes a Float32Array with
+// `record * STRIDE + field` and reads the integer fields through an
+// Int32Array over the same bytes. Views must be re-fetched each frame: they
+// are invalidated whenever the buffer or the WASM memory grows.
+namespace RenderLayout {
+    // Bump whenever a record layout below changes
+    constexpr int VERSION = 1;
+
+    // Entity record, 10 words:
+    //   0 id (int32)    1 type (int32)   2 x        3 y      4 vx
+    //   5 vy            6 rotation       7 radius   8 health 9 maxHealth
+    constexpr int ENTITY_STRIDE = 10;
+
+    // Particle record, 5 words:
+    //   0 x   1 y   2 size   3 alpha   4 palette index (int32)
+    constexpr int PARTICLE_STRIDE = 5;
+    
+    // Entity records are grouped by type, in EntityType order, and the type
+    // counts array (one int32 per EntityType) gives each group's size; the
+    // PARTICLE slot holds the particle record count.
+    constexpr int TYPE_COUNT = 7;
+}
+
+struct EntityRenderRecord {
+    int32_t id;
+    int32_t type;
+    float x;
+    float y;
+    float vx;
+    float vy;
+    float rotation;
+    float radius;
+    float health;
+    float maxHealth;
+};
+
+struct ParticleRenderRecord {
+    float x;
+    float y;
+    float size;
+    float alpha;
+    int32_t color;
+};
+
+static_assert(sizeof(EntityRenderRecord) == RenderLayout::ENTITY_STRIDE * 4,
+              "EntityRenderRecord must match RenderLayout::ENTITY_STRIDE");
+static_assert(sizeof(ParticleRenderRecord) == RenderLayout::PARTICLE_STRIDE * 4,
+              "ParticleRenderRecord must match RenderLayout::PARTICLE_STRIDE");
+
+// Growable record array that keeps its storage between frames
+template<typename Record>
+class RenderBuffer {
+private:
+    std::vector<Record> records;
+    size_t count;
+
+public:
+    explicit RenderBuffer(size_t initialCapacity = 0) : count(0) {
+        records.resize(initialCapacity);
+    }
+
+    void begin() { count = 0; }
+
+    Record& push() {
+        if (count == records.size()) {
+            records.resize(records.empty() ? 64 : records.size() * 2);
+        }
+        return records[count++];
+    }
+
+    // Start a frame of exactly n records, for callers that fill them out of order
+    Record* assign(size_t n) {
+        if (n > records.size()) {
+            records.resize(std::max(n, records.size() * 2));
+        }
+        count = n;
+        return records.data();
+    }
+
+    size_t size() const { return count; }
+    const Record* data() const { return records.data(); }
+
+    // Record storage viewed as 32-bit floats, for typed_memory_view
+    const float* floats() const { return reinterpret_cast<const float*>(records.data()); }
+    size_t floatCount() const { return count * (sizeof(Record) / sizeof(float)); }
+};
+
+#endif // RENDER_BUFFER_H
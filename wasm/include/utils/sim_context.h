@@ -0,0 +1,98 @@
+#ifndef SIM_CONTEXT_H
+#define SIM_CONTEXT_H
+
+#include <cstdint>
+
+// Seeded random stream (PCG32). Same seed, same sequence, on every platform.
+class SimRandom {
+private:
+    uint64_t state;
+    uint64_t increment;
+
+public:
+    static constexpr uint32_t DEFAULT_SEED = 0x5EED1234u;
+
+    explicit SimRandom(uint32_t seed = DEFAULT_SEED, uint32_t stream = 0) { reseed(seed, stream); }
+
+    void reseed(uint32_t seed, uint32_t stream = 0) {
+        state = 0;
+        increment = (static_cast<uint64_t>(stream) << 1) | 1u;
+        nextU32();
+        state += seed;
+        nextU32();
+    }
+
+    uint32_t nextU32() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + increment;
+        uint32_t xorshifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+        uint32_t rot = static_cast<uint32_t>(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+    }
+
+    // Uniform in [0, bound); 0 when bound <= 0
+    int nextInt(int bound) {
+        if (bound <= 0) return 0;
+        return static_cast<int>((static_cast<uint64_t>(nextU32()) * static_cast<uint32_t>(bound)) >> 32);
+    }
+
+    // Uniform in [0, 1)
+    float nextFloat() { return (nextU32() >> 8) * (1.0f / 16777216.0f); }
+
+    float range(float lo, float hi) { return lo + (hi - lo) * nextFloat(); }
+};
+
+// Simulation-wide random stream and clock
+//
+// Gameplay code draws randomness and reads time through Sim:: below instead of
+// rand() or the wall clock, so a session replays exactly from its seed and
+// input log. Each GameEngine owns a context and binds it (SimContext::Scope)
+// for the duration of every call that can reach gameplay code; the binding is
+// per thread, so engines on different threads do not share streams. Code
+// running with nothing bound (tools, the native benchmark) uses a default
+// context with a fixed seed.
+struct SimContext {
+    SimRandom random;
+    double clockMs = 0;    // Simulated time, advanced once per tick
+
+    void reset(uint32_t seed) {
+        random.reseed(seed);
+        clockMs = 0;
+    }
+
+    static SimContext& fallback() {
+        static thread_local SimContext context;
+        return context;
+    }
+
+    static SimContext*& bound() {
+        static thread_local SimContext* context = nullptr;
+        return context;
+    }
+
+    static SimContext& current() {
+        SimContext* context = bound();
+        return context ? *context : fallback();
+    }
+
+    // Bind a context for the enclosing scope; nests
+    class Scope {
+        SimContext* previous;
+
+    public:
+        explicit Scope(SimContext& context) : previous(bound()) { bound() = &context; }
+        ~Scope() { bound() = previous; }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+};
+
+namespace Sim {
+    inline SimRandom& random() { return SimContext::current().random; }
+    inline int randomInt(int bound) { return random().nextInt(bound); }
+    inline float randomFloat() { return random().nextFloat(); }
+    inline float randomRange(float lo, float hi) { return random().range(lo, hi); }
+    inline double now() { return SimContext::current().clockMs; }
+}
+
+#endif // SIM_CONTEXT_H
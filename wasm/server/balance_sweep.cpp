@@ -0,0 +1,121 @@
+// Headless balance sweep over many simulated matches
+//
+// Builds natively next to the dedicated server (scripts/build-server.sh).
+// Plays --matches matches on a BatchSimulator (server/batch_simulator.h),
+// spread over --workers threads with no tick clock, each driven by the
+// --policy bot (kite, the default, or turret, which stands and fights),
+// and prints the aggregate outcome. --layout-seed makes
+// every match play on the same obstacle layout; --csv prints one row per
+// match instead (seed, wave, seconds, died, damage taken, damage dealt,
+// kills, mean time-to-kill, score) for a spreadsheet or a notebook. The
+// time-to-kill is left empty for a match without kills.
+//
+//   balance_sweep [--matches N] [--workers N] [--seconds S] [--seed N]
+//                 [--layout-seed N] [--policy kite|turret] [--csv]
+
+#include "../include/server/batch_simulator.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+struct Options {
+    int matches = 1000;
+    int workers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    float seconds = 300.0f;
+    uint32_t seed = SimRandom::DEFAULT_SEED;
+    uint32_t layoutSeed = 0;
+    const char* policyName = "kite";
+    BatchSimulator::Policy policy = &BatchSimulator::kitePolicy;
+    bool csv = false;
+};
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        auto value = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "missing value for %s\n", argv[i]);
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        if (!std::strcmp(argv[i], "--matches")) options.matches = std::max(1, std::atoi(value()));
+        else if (!std::strcmp(argv[i], "--workers")) options.workers = std::max(1, std::atoi(value()));
+        else if (!std::strcmp(argv[i], "--seconds")) options.seconds = std::max(1.0f, static_cast<float>(std::atof(value())));
+        else if (!std::strcmp(argv[i], "--seed")) options.seed = static_cast<uint32_t>(std::strtoul(value(), nullptr, 10));
+        else if (!std::strcmp(argv[i], "--layout-seed")) options.layoutSeed = static_cast<uint32_t>(std::strtoul(value(), nullptr, 10));
+        else if (!std::strcmp(argv[i], "--policy")) {
+            options.policyName = value();
+            if (!std::strcmp(options.policyName, "kite")) options.policy = &BatchSimulator::kitePolicy;
+            else if (!std::strcmp(options.policyName, "turret")) options.policy = &BatchSimulator::turretPolicy;
+            else {
+                std::fprintf(stderr, "unknown policy %s (kite or turret)\n", options.policyName);
+                std::exit(2);
+            }
+        }
+        else if (!std::strcmp(argv[i], "--csv")) options.csv = true;
+        else {
+            std::fprintf(stderr,
+                "usage: %s [--matches N] [--workers N] [--seconds S] [--seed N]\n"
+                "       [--layout-seed N] [--policy kite|turret] [--csv]\n", argv[0]);
+            std::exit(2);
+        }
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options = parseOptions(argc, argv);
+
+    BatchSimulator::Settings settings;
+    settings.matches = options.matches;
+    settings.workers = options.workers;
+    settings.baseSeed = options.seed;
+    settings.layoutSeed = options.layoutSeed;
+    settings.maxSeconds = options.seconds;
+    settings.policy = options.policy;
+    BatchSimulator batch(settings);
+
+    if (!options.csv) {
+        std::printf("balance sweep: %d matches on %d workers, up to %.0f s each, %s layout, %s bot\n",
+                    options.matches, options.workers, options.seconds,
+                    options.layoutSeed ? "shared" : "per-match", options.policyName);
+    }
+    const BatchSimulator::Results& results = batch.run();
+
+    if (options.csv) {
+        std::printf("seed,wave,seconds,died,damage_taken,damage_dealt,kills,ttk_ms,score\n");
+        for (size_t m = 0; m < results.size(); m++) {
+            char ttk[32] = "";
+            if (results.timedKills[m] > 0) {
+                std::snprintf(ttk, sizeof(ttk), "%.1f", results.meanTimeToKillMs[m]);
+            }
+            std::printf("%u,%d,%.2f,%d,%.1f,%.1f,%d,%s,%d\n",
+                        results.seed[m], results.waveReached[m], results.secondsSurvived[m],
+                        results.died[m], results.damageTaken[m], results.damageDealt[m],
+                        results.kills[m], ttk, results.score[m]);
+        }
+        return 0;
+    }
+
+    BatchSimulator::Summary summary = batch.summarize();
+    std::printf("\nsummary over %.1f s wall\n", summary.wallMs / 1000.0);
+    std::printf("  wave reached     mean %.2f   max %d\n", summary.meanWave, summary.maxWave);
+    std::printf("  survived         mean %.1f s   died in %.1f%% of matches\n",
+                summary.meanSeconds, 100.0 * summary.deathRate);
+    std::printf("  damage taken     mean %.1f\n", summary.meanDamageTaken);
+    if (summary.matchesWithKills == 0) {
+        std::printf("  time to kill     no kills\n");
+    } else {
+        std::printf("  time to kill     mean %.0f ms\n", summary.meanTimeToKillMs);
+    }
+    std::printf("  throughput       %.0f ticks/s (%.0fx real time)\n",
+                summary.ticksPerSecond, summary.ticksPerSecond / Config::SIMULATION_TICK_RATE);
+    return 0;
+}
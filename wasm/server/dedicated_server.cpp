@@ -0,0 +1,221 @@
+// Headless dedicated server for the engine core
+//
+// Builds natively (no Emscripten): see scripts/build-server.sh. Runs
+// --matches authoritative matches on a MatchHost (server/match_host.h), one
+// GameEngine each, spread over --workers threads at the fixed tick rate.
+// Every match streams StateCodec packets to --clients loopback clients,
+// which decode them, acknowledge the sequence and drive the match's player
+// with scripted input, so the numbers include the codec on both ends. The
+// transport is left to the deployment (whatever carries bytes to the
+// browser can call addClient/submit/acknowledge and forward the packets).
+//
+// Once a second it prints throughput and worker load, and at the end the
+// matches per core the run sustained and the estimate at full load.
+//
+//   dedicated_server [--matches N] [--workers N] [--clients N] [--seconds S]
+//                    [--tick-rate HZ] [--budget-ms MS] [--seed N]
+
+#include "../include/server/match_host.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int matches = 64;
+    int workers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    int clients = 2;
+    float seconds = 10.0f;
+    float tickRate = Config::SIMULATION_TICK_RATE;
+    float budgetMs = 4.0f;
+    uint32_t seed = SimRandom::DEFAULT_SEED;
+};
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        auto value = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "missing value for %s\n", argv[i]);
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        if (!std::strcmp(argv[i], "--matches")) options.matches = std::max(1, std::atoi(value()));
+        else if (!std::strcmp(argv[i], "--workers")) options.workers = std::max(1, std::atoi(value()));
+        else if (!std::strcmp(argv[i], "--clients")) {
+            options.clients = std::clamp(std::atoi(value()), 0, MatchHost::MAX_CLIENTS_PER_MATCH);
+        }
+        else if (!std::strcmp(argv[i], "--seconds")) options.seconds = std::max(0.1f, static_cast<float>(std::atof(value())));
+        else if (!std::strcmp(argv[i], "--tick-rate")) options.tickRate = std::max(1.0f, static_cast<float>(std::atof(value())));
+        else if (!std::strcmp(argv[i], "--budget-ms")) options.budgetMs = std::max(0.01f, static_cast<float>(std::atof(value())));
+        else if (!std::strcmp(argv[i], "--seed")) options.seed = static_cast<uint32_t>(std::strtoul(value(), nullptr, 10));
+        else {
+            std::fprintf(stderr,
+                "usage: %s [--matches N] [--workers N] [--clients N] [--seconds S]\n"
+                "       [--tick-rate HZ] [--budget-ms MS] [--seed N]\n", argv[0]);
+            std::exit(2);
+        }
+    }
+    return options;
+}
+
+// The far end of one match's connections. Only the match's worker thread
+// touches it (through the packet sink).
+struct LoopbackMatch {
+    StateCodec codecs[MatchHost::MAX_CLIENTS_PER_MATCH];
+    uint64_t packets = 0;
+    uint64_t rejected = 0;       // Packets that did not decode (baseline gone)
+    uint64_t entities = 0;       // Decoded entities, summed over packets
+    SimRandom input;
+    float angle = 0;
+};
+
+class Loopback {
+    std::mutex mutex;
+    std::unordered_map<int, std::shared_ptr<LoopbackMatch>> matches;
+
+public:
+    void add(int matchId, uint32_t seed) {
+        auto match = std::make_shared<LoopbackMatch>();
+        match->input.reseed(seed, 1);
+        std::lock_guard<std::mutex> lock(mutex);
+        matches[matchId] = std::move(match);
+    }
+
+    std::shared_ptr<LoopbackMatch> find(int matchId) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = matches.find(matchId);
+        return it == matches.end() ? nullptr : it->second;
+    }
+
+    void totals(uint64_t& packets, uint64_t& rejected, uint64_t& entities) {
+        std::lock_guard<std::mutex> lock(mutex);
+        packets = rejected = entities = 0;
+        for (const auto& entry : matches) {
+            packets += entry.second->packets;
+            rejected += entry.second->rejected;
+            entities += entry.second->entities;
+        }
+    }
+};
+
+// A bot circling the arena and firing, sent with every client 0 packet
+void driveBot(MatchHost& host, int matchId, LoopbackMatch& match) {
+    match.angle += 0.03f;
+    CommandBuffer::Command move = {CommandBuffer::Op::PLAYER_INPUT, 0,
+        {std::cos(match.angle), std::sin(match.angle), 1000.0f, 1000.0f}, {0, 0}};
+    host.submit(matchId, move);
+    if (match.input.nextInt(10) == 0) {
+        CommandBuffer::Command shoot = {CommandBuffer::Op::PLAYER_SHOOT, 0,
+            {match.input.range(0, 2000), match.input.range(0, 2000), 0, 0}, {0, 0}};
+        host.submit(matchId, shoot);
+    }
+}
+
+int createMatch(MatchHost& host, Loopback& loopback, uint32_t seed, int clients) {
+    int matchId = host.createMatch(seed);
+    loopback.add(matchId, seed);
+    for (int c = 0; c < clients; c++) host.addClient(matchId);
+    return matchId;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options = parseOptions(argc, argv);
+
+    MatchHost::Settings settings;
+    settings.workers = options.workers;
+    settings.tickRate = options.tickRate;
+    settings.tickBudgetMs = options.budgetMs;
+    MatchHost host(settings);
+    Loopback loopback;
+
+    host.setPacketSink([&host, &loopback](int matchId, int clientId, const uint8_t* bytes, size_t size) {
+        std::shared_ptr<LoopbackMatch> match = loopback.find(matchId);
+        if (!match) return;
+        StateCodec& codec = match->codecs[clientId];
+        uint32_t sequence = codec.decode(bytes, size);
+        match->packets++;
+        if (sequence == 0) {
+            match->rejected++;
+        } else {
+            match->entities += codec.getDecoded().size();
+        }
+        host.acknowledge(matchId, clientId, sequence);
+        if (clientId == 0) driveBot(host, matchId, *match);
+    });
+
+    host.start();
+    std::vector<int> matchIds;
+    uint32_t nextSeed = options.seed;
+    for (int m = 0; m < options.matches; m++) {
+        matchIds.push_back(createMatch(host, loopback, nextSeed++, options.clients));
+    }
+    std::printf("dedicated server: %d matches on %d workers, %d clients each, %.0f Hz, %.2f ms budget\n",
+                options.matches, options.workers, options.clients, options.tickRate, options.budgetMs);
+
+    using Clock = std::chrono::steady_clock;
+    auto begin = Clock::now();
+    auto nextReport = begin + std::chrono::seconds(1);
+    MatchHost::Stats previous = host.getStats();
+    int restarted = 0;
+    double second = 0;
+
+    while (std::chrono::duration<double>(Clock::now() - begin).count() < options.seconds) {
+        std::this_thread::sleep_until(nextReport);
+        nextReport += std::chrono::seconds(1);
+        second += 1;
+
+        // A finished match frees its slot for a new one
+        for (int& matchId : matchIds) {
+            if (host.isMatchOver(matchId)) {
+                host.endMatch(matchId);
+                matchId = createMatch(host, loopback, nextSeed++, options.clients);
+                restarted++;
+            }
+        }
+
+        MatchHost::Stats stats = host.getStats();
+        double busy = (stats.busyMs - previous.busyMs) / (10.0 * options.workers);
+        uint64_t packets = stats.packets - previous.packets;
+        std::printf("  %3.0fs  ticks/s %7llu  busy %5.1f%%  overruns %5llu  max tick %6.3f ms  bytes/packet %6.1f\n",
+                    second, static_cast<unsigned long long>(stats.ticks - previous.ticks), busy,
+                    static_cast<unsigned long long>(stats.overruns - previous.overruns), stats.maxTickMs,
+                    packets ? static_cast<double>(stats.packetBytes - previous.packetBytes) / packets : 0.0);
+        previous = stats;
+    }
+
+    double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+    MatchHost::Stats stats = host.getStats();
+    host.stop();
+    uint64_t packets, rejected, entities;
+    loopback.totals(packets, rejected, entities);
+
+    double busyShare = stats.busyMs / (elapsed * 1000.0 * options.workers);
+    double perCore = static_cast<double>(options.matches) / options.workers;
+    double ticksExpected = elapsed * options.tickRate * options.matches;
+    std::printf("\nsummary over %.1f s\n", elapsed);
+    std::printf("  match ticks      %llu (%.1f%% of the nominal rate)\n",
+                static_cast<unsigned long long>(stats.ticks), 100.0 * stats.ticks / ticksExpected);
+    std::printf("  mean tick        %.4f ms   max %.3f ms   overruns %llu\n",
+                stats.ticks ? stats.busyMs / stats.ticks : 0.0, stats.maxTickMs,
+                static_cast<unsigned long long>(stats.overruns));
+    std::printf("  packets          %llu decoded, %llu rejected, %.1f entities each\n",
+                static_cast<unsigned long long>(packets - rejected), static_cast<unsigned long long>(rejected),
+                packets > rejected ? static_cast<double>(entities) / (packets - rejected) : 0.0);
+    std::printf("  matches restarted %d\n", restarted);
+    std::printf("  density          %.1f matches/worker at %.1f%% busy (~%.0f at full load)\n",
+                perCore, 100.0 * busyShare, busyShare > 0 ? perCore / busyShare : 0.0);
+    return 0;
+}
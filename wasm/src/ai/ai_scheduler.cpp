@@ -0,0 +1,4 @@
+#include "../../include/ai/ai_scheduler.h"
+
+// AI scheduler implementation
+// Most methods are inline in the header
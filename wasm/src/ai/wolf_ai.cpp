@@ -1,12 +1,13 @@
 #include "../../include/ai/wolf_ai.h"
-#include <chrono>
+#include "../../include/utils/frame_tracer.h"
+#include "../../include/memory/heap_tracker.h"
 #include <iostream>
 
 namespace AI {
 
 // Wolf Implementation
 Wolf::Wolf(float x, float y, bool isAlpha) 
-    : Entity(EntityType::WOLF, Vector2(x, y), 20.0f), isAlpha(isAlpha) {
+    : Entity(EntityType::WOLF, Vector2(x, y), 20.0f), isAlpha(isAlpha), facing(1.0f, 0.0f) {
     maxHealth = isAlpha ? 150.0f : 100.0f;
     health = maxHealth;
 }
@@ -24,27 +25,56 @@ void Wolf::takeDamage(float damage) {
 
 // WolfAI Implementation
 WolfAI::WolfAI(std::shared_ptr<Wolf> wolf) 
-    : wolf(wolf), state(WolfState::IDLE), role(WolfRole::HUNTER),
+    : wolf(wolf), obstacleIndex(nullptr), flowField(nullptr), stimuli(nullptr),
+      state(WolfState::IDLE), role(WolfRole::HUNTER),
       target(nullptr), lastSeenTime(0), investigateTimer(0),
-      communicationCooldown(0), alertLevel(0), patrolIndex(0),
+      communicationCooldown(0), clockMs(0), cachedCanSeePlayer(false),
+      coverScanPending(false), alertLevel(0), soundMemory(), soundHead(0), soundCount(0), patrolIndex(0),
       searchPattern(0), lastPlayerTime(0),
-      rng(std::chrono::steady_clock::now().time_since_epoch().count()),
-      randomDist(0.0f, 1.0f) {
+      rng(Sim::random().nextU32()) {
     generatePatrolPath();
 }
 
-void WolfAI::update(float deltaTime, const Entity* player,
-                   const std::vector<std::shared_ptr<WolfAI>>& packMembers,
-                   const std::vector<Entity*>& obstacles) {
+int WolfAI::update(float deltaTime, const Entity* player, WolfPack* pack,
+                   const std::vector<Entity*>& obstacles,
+                   bool runPerception) {
+    return think(deltaTime, player, pack, obstacles, runPerception,
+          runPerception ? sensePlayer(player) : 0);
+}
+
+int WolfAI::updateSensed(float deltaTime, const Entity* player, WolfPack* pack,
+                          const std::vector<Entity*>& obstacles, uint8_t senses) {
+    return think(deltaTime, player, pack, obstacles, true, senses);
+}
+
+int WolfAI::think(float deltaTime, const Entity* player, WolfPack* pack,
+                   const std::vector<Entity*>& obstacles,
+                   bool runPerception, uint8_t senses) {
+    HEAP_SCOPE(AI);
+    clockMs += deltaTime * 1000.0f;
+    
     // Update cooldowns
     communicationCooldown = std::max(0.0f, communicationCooldown - deltaTime);
     
-    // Update pack awareness
-    updatePackAwareness(packMembers);
-    
-    // Perception checks
-    bool canSeePlayer = checkLineOfSight(player, obstacles);
-    SoundMemory* heardSound = checkForSounds(player);
+    // Perception checks, or the results of the last perception tick
+    bool canSeePlayer = cachedCanSeePlayer;
+    const SoundMemory* heardSound = nullptr;
+    int work = 0;
+    if (runPerception) {
+        TRACE_ZONE("wolf.perception");
+        work = AIScheduler::WORK_PERCEPTION;
+        updatePackAwareness(pack);
+        // checkLineOfSight only casts for a wolf that passed the cone test
+        if (senses & VectorMath::SENSE_SIGHT) work += AIScheduler::WORK_SIGHT_LINE;
+        canSeePlayer = checkLineOfSight(player, obstacles, senses);
+        cachedCanSeePlayer = canSeePlayer;
+        heardSound = checkForSounds(player, senses);
+        if (coverScanPending) {
+            checkCoverSpots(obstacles);
+            coverScanPending = false;
+            work += AIScheduler::WORK_COVER_SCAN;
+        }
+    }
     
     // State machine
     switch (state) {
@@ -67,9 +97,23 @@ void WolfAI::update(float deltaTime, const Entity* player,
             handleSearchState(deltaTime, canSeePlayer, heardSound, player, obstacles);
             break;
     }
-    
-    // Clean old sound memories
-    cleanSoundMemory();
+    return work;
+}
+
+AIScheduler::Tier WolfAI::getScheduleTier() const {
+    switch (state) {
+        case WolfState::HUNT:
+        case WolfState::FLANK:
+            return AIScheduler::Tier::ACTIVE;
+        case WolfState::INVESTIGATE:
+        case WolfState::SEARCH:
+            return AIScheduler::Tier::ALERT;
+        case WolfState::PATROL:
+            return AIScheduler::Tier::AMBIENT;
+        case WolfState::IDLE:
+        default:
+            return AIScheduler::Tier::DORMANT;
+    }
 }
 
 void WolfAI::handleIdleState(float dt, bool canSeePlayer, const SoundMemory* heardSound, const Entity* player) {
@@ -79,7 +123,7 @@ void WolfAI::handleIdleState(float dt, bool canSeePlayer, const SoundMemory* hea
         enterInvestigateState(heardSound->position);
     } else {
         // Occasionally start patrolling
-        if (randomDist(rng) < 0.01f) {
+        if (rng.nextFloat() < 0.01f) {
             state = WolfState::PATROL;
             generatePatrolPath();
         }
@@ -147,8 +191,7 @@ void WolfAI::handleHuntState(float dt, bool canSeePlayer, const Entity* player,
                              const std::vector<Entity*>& obstacles) {
     if (!canSeePlayer) {
         // Lost sight - go to last seen position
-        auto currentTime = std::chrono::steady_clock::now().time_since_epoch().count() / 1000000.0f;
-        if (currentTime - lastSeenTime < MEMORY_DURATION * 1000) {
+        if (clockMs - lastSeenTime < MEMORY_DURATION * 1000) {
             enterInvestigateState(lastSeenPosition);
         } else {
             enterSearchState();
@@ -158,20 +201,19 @@ void WolfAI::handleHuntState(float dt, bool canSeePlayer, const Entity* player,
     
     // Update last seen position
     lastSeenPosition = Vector2(player->position.x, player->position.y);
-    lastSeenTime = std::chrono::steady_clock::now().time_since_epoch().count() / 1000000.0f;
+    lastSeenTime = clockMs;
     
     // Check if pack members are nearby for coordination
-    std::vector<std::shared_ptr<WolfAI>> nearbyPackMembers;
-    for (auto& member : packMembers) {
-        float dist = getDistance(Vector2(wolf->x(), wolf->y()), Vector2(member->wolf->x(), member->wolf->y()));
-        if (dist < COMMUNICATION_RANGE && member->state == WolfState::HUNT) {
-            nearbyPackMembers.push_back(member);
+    huntingScratch.clear();
+    for (WolfAI* member : packMembers) {
+        if (member->state == WolfState::HUNT) {
+            huntingScratch.push_back(member);
         }
     }
     
     // Coordinate attack
-    if (!nearbyPackMembers.empty() && communicationCooldown <= 0) {
-        coordinateAttack(nearbyPackMembers, player);
+    if (!huntingScratch.empty() && communicationCooldown <= 0) {
+        coordinateAttack(huntingScratch, player);
     }
     
     // Calculate intercept point instead of chasing directly
@@ -231,7 +273,7 @@ void WolfAI::handleSearchState(float dt, bool canSeePlayer, const SoundMemory* h
     // Fan out search pattern from last known position
     float searchRadius = 100.0f + searchPattern * 50.0f;
     float searchAngle = (searchPattern * M_PI / 4.0f) + 
-                       (std::chrono::steady_clock::now().time_since_epoch().count() / 1000000.0f * 0.001f);
+                       (clockMs * 0.001f);
     
     Vector2 searchPos;
     searchPos.x = lastSeenPosition.x + std::cos(searchAngle) * searchRadius;
@@ -245,16 +287,15 @@ void WolfAI::handleSearchState(float dt, bool canSeePlayer, const SoundMemory* h
         // Reached search point
         searchPattern = (searchPattern + 1) % 8;
         
-        // Check likely hiding spots
-        checkCoverSpots(obstacles);
+        // Check likely hiding spots on the next perception tick
+        coverScanPending = true;
     } else {
         // Move to search point
         moveTowards(searchPos, INVESTIGATE_SPEED, dt);
     }
     
     // Give up search after some time
-    auto currentTime = std::chrono::steady_clock::now().time_since_epoch().count() / 1000000.0f;
-    if (currentTime - lastSeenTime > MEMORY_DURATION * 2000) {
+    if (clockMs - lastSeenTime > MEMORY_DURATION * 2000) {
         state = WolfState::IDLE;
         searchPattern = 0;
     }
@@ -264,7 +305,7 @@ void WolfAI::enterHuntState(const Entity* player) {
     state = WolfState::HUNT;
     target = player;
     lastSeenPosition = Vector2(player->position.x, player->position.y);
-    lastSeenTime = std::chrono::steady_clock::now().time_since_epoch().count() / 1000000.0f;
+    lastSeenTime = clockMs;
     alertLevel = 2;
     
     // Call for backup
@@ -284,22 +325,33 @@ void WolfAI::enterSearchState() {
     alertLevel = 1;
 }
 
-bool WolfAI::checkLineOfSight(const Entity* player, const std::vector<Entity*>& obstacles) {
-    float dx = player->position.x - wolf->x();
-    float dy = player->position.y - wolf->y();
-    float dist = std::sqrt(dx * dx + dy * dy);
-    
-    if (dist > SIGHT_RANGE) return false;
-    
-    // Check if player is in front of wolf (vision cone)
-    float angleToPlayer = std::atan2(dy, dx);
-    float angleDiff = std::abs(normalizeAngle(angleToPlayer - wolf->getRotation()));
-    if (angleDiff > VISION_CONE_ANGLE / 2.0f) return false;
+uint8_t WolfAI::sensePlayer(const Entity* player) const {
+    float x = wolf->x(), y = wolf->y();
+    float fx = wolf->getFacing().x, fy = wolf->getFacing().y;
+    float distSq;
+    uint8_t senses;
+    VectorMath::senseTarget(&x, &y, &fx, &fy, 1, player->position.x, player->position.y,
+                            SIGHT_RANGE, VISION_CONE_COS_HALF, HEARING_RANGE, &distSq, &senses);
+    return senses;
+}
+
+bool WolfAI::checkLineOfSight(const Entity* player, const std::vector<Entity*>& obstacles, uint8_t senses) {
+    // Range and vision cone were tested by senseTarget
+    if (!(senses & VectorMath::SENSE_SIGHT)) return false;
     
     // Check for obstacles blocking view
+    Vector2 eye(wolf->x(), wolf->y());
+    if (obstacleIndex) {
+        return !obstacleIndex->segmentBlocked(eye, player->position);
+    }
+    
     for (const auto& obstacle : obstacles) {
-        if (lineIntersectsCircle(Vector2(wolf->x(), wolf->y()), Vector2(player->position.x, player->position.y),
-                                Vector2(obstacle->position.x, obstacle->position.y), obstacle->radius)) {
+        if (obstacle->type == EntityType::OBSTACLE) {
+            // Exact shape, not the bounding radius
+            if (ObstacleIndex::intersectSegment(*static_cast<const Obstacle*>(obstacle), eye, player->position) >= 0) {
+                return false;
+            }
+        } else if (lineIntersectsCircle(eye, player->position, obstacle->position, obstacle->radius)) {
             return false;
         }
     }
@@ -307,25 +359,51 @@ bool WolfAI::checkLineOfSight(const Entity* player, const std::vector<Entity*>&
     return true;
 }
 
-SoundMemory* WolfAI::checkForSounds(const Entity* player) {
-    // Check if player made noise (moving fast, shooting, etc.)
-    float playerSpeed = std::sqrt(player->velocity.x * player->velocity.x + player->velocity.y * player->velocity.y);
-    float dist = getDistance(Vector2(wolf->x(), wolf->y()), Vector2(player->position.x, player->position.y));
-    
-    if (dist < HEARING_RANGE) {
-        if (playerSpeed > 150.0f) { // Player is moving fast
-            SoundMemory sound;
-            sound.position = Vector2(player->position.x, player->position.y);
-            sound.intensity = playerSpeed > 200.0f ? 2.0f : 1.0f;
-            sound.timestamp = std::chrono::steady_clock::now().time_since_epoch().count() / 1000000.0f;
-            soundMemory.push_back(sound);
-            return &soundMemory.back();
-        }
+bool WolfAI::movementStimulus(const Entity* player, Stimulus& out) {
+    float speedSq = player->velocity.x * player->velocity.x + player->velocity.y * player->velocity.y;
+    if (speedSq <= NOISY_SPEED * NOISY_SPEED) return false;
+    out = {player->position.x, player->position.y, HEARING_RANGE,
+           speedSq > LOUD_SPEED * LOUD_SPEED ? 2.0f : 1.0f, player->id, Stimulus::Kind::MOVEMENT};
+    return true;
+}
+
+const SoundMemory* WolfAI::checkForSounds(const Entity* player, uint8_t senses) {
+    // The loudest noise reaching this wolf, from the shared buffer's cell
+    if (stimuli) {
+        const Stimulus* heard = stimuli->loudestAt(wolf->x(), wolf->y());
+        return heard ? rememberSound(*heard) : nullptr;
     }
     
+    // No buffer: only the player's movement, and the range test was done
+    // by senseTarget
+    Stimulus movement;
+    if ((senses & VectorMath::SENSE_HEARING) && movementStimulus(player, movement)) {
+        return rememberSound(movement);
+    }
     return nullptr;
 }
 
+const SoundMemory* WolfAI::rememberSound(const Stimulus& sound) {
+    SoundMemory& slot = soundMemory[soundHead];
+    slot.position = Vector2(sound.x, sound.y);
+    slot.intensity = sound.intensity;
+    slot.timestamp = clockMs;
+    soundHead = (soundHead + 1) % MAX_SOUND_MEMORY;
+    soundCount = std::min(soundCount + 1, MAX_SOUND_MEMORY);
+    return &slot;
+}
+
+size_t WolfAI::getRecentSounds(SoundMemory* out, size_t capacity) const {
+    size_t count = 0;
+    for (int n = 0; n < soundCount && count < capacity; n++) {
+        const SoundMemory& sound = soundMemory[(soundHead - 1 - n + MAX_SOUND_MEMORY) % MAX_SOUND_MEMORY];
+        // Newest first, so the first expired one ends the list
+        if (clockMs - sound.timestamp > MEMORY_DURATION * 1000) break;
+        out[count++] = sound;
+    }
+    return count;
+}
+
 Vector2 WolfAI::calculateInterceptPoint(const Entity* player) {
     // Predict where player will be based on current velocity
     if (std::abs(player->velocity.x) < 0.01f && std::abs(player->velocity.y) < 0.01f) {
@@ -358,22 +436,29 @@ void WolfAI::moveTowards(const Vector2& target, float speed, float dt) {
     float dist = std::sqrt(dx * dx + dy * dy);
     
     if (dist > 0.01f) {
+        // Route around obstacles when the shared field leads to the target
+        Vector2 heading(dx / dist, dy / dist);
+        Vector2 fieldHeading;
+        if (flowField && flowField->steer(Vector2(wolf->x(), wolf->y()), target, fieldHeading)) {
+            heading = fieldHeading;
+        }
+        
         float moveSpeed = speed * dt;
-        wolf->position.x += (dx / dist) * moveSpeed;
-        wolf->position.y += (dy / dist) * moveSpeed;
-        wolf->velocity.x = (dx / dist) * speed;
-        wolf->velocity.y = (dy / dist) * speed;
-        wolf->setRotation(std::atan2(dy, dx));
+        wolf->position.x += heading.x * moveSpeed;
+        wolf->position.y += heading.y * moveSpeed;
+        wolf->velocity.x = heading.x * speed;
+        wolf->velocity.y = heading.y * speed;
+        wolf->setHeading(heading);
     }
 }
 
-void WolfAI::coordinateAttack(const std::vector<std::shared_ptr<WolfAI>>& nearbyPackMembers,
+void WolfAI::coordinateAttack(const std::vector<WolfAI*>& nearbyPackMembers,
                               const Entity* player) {
     // Assign roles to pack members
     if (role == WolfRole::HUNTER) {
         // I'm the primary hunter, assign flankers
         int flankerCount = 0;
-        for (auto& member : nearbyPackMembers) {
+        for (WolfAI* member : nearbyPackMembers) {
             if (flankerCount < 2) {
                 member->setRole(WolfRole::FLANKER);
                 member->setState(WolfState::FLANK);
@@ -388,11 +473,11 @@ void WolfAI::coordinateAttack(const std::vector<std::shared_ptr<WolfAI>>& nearby
 }
 
 void WolfAI::alertPackMembers(const Vector2& targetPos) {
-    for (auto& packMember : packMembers) {
+    for (WolfAI* packMember : packMembers) {
         float dist = getDistance(Vector2(wolf->x(), wolf->y()), Vector2(packMember->wolf->x(), packMember->wolf->y()));
         if (dist < COMMUNICATION_RANGE && packMember->state != WolfState::HUNT) {
             packMember->lastSeenPosition = targetPos;
-            packMember->lastSeenTime = std::chrono::steady_clock::now().time_since_epoch().count() / 1000000.0f;
+            packMember->lastSeenTime = packMember->clockMs;
             packMember->alertLevel = std::max(packMember->alertLevel, 1.0f);
             
             if (dist < COMMUNICATION_RANGE / 2.0f) {
@@ -405,13 +490,12 @@ void WolfAI::alertPackMembers(const Vector2& targetPos) {
     }
 }
 
-void WolfAI::updatePackAwareness(const std::vector<std::shared_ptr<WolfAI>>& allWolves) {
-    packMembers.clear();
-    for (const auto& w : allWolves) {
-        if (w.get() != this) {
-            packMembers.push_back(w);
-        }
+void WolfAI::updatePackAwareness(WolfPack* pack) {
+    if (!pack) {
+        packMembers.clear();
+        return;
     }
+    pack->queryMembers(Vector2(wolf->x(), wolf->y()), COMMUNICATION_RANGE, packMembers, this);
 }
 
 void WolfAI::checkCoverSpots(const std::vector<Entity*>& obstacles) {
@@ -440,29 +524,13 @@ void WolfAI::performAttack(Entity* player) {
     }
 }
 
-void WolfAI::cleanSoundMemory() {
-    auto currentTime = std::chrono::steady_clock::now().time_since_epoch().count() / 1000000.0f;
-    soundMemory.erase(
-        std::remove_if(soundMemory.begin(), soundMemory.end(),
-            [currentTime](const SoundMemory& s) {
-                return currentTime - s.timestamp > 5000.0f;
-            }),
-        soundMemory.end()
-    );
-    
-    // Keep only the most recent sounds
-    if (soundMemory.size() > MAX_SOUND_MEMORY) {
-        soundMemory.erase(soundMemory.begin(), soundMemory.begin() + (soundMemory.size() - MAX_SOUND_MEMORY));
-    }
-}
-
 void WolfAI::generatePatrolPath() {
     patrolPath.clear();
-    int numPoints = 4 + static_cast<int>(randomDist(rng) * 3);
-    float radius = 200.0f + randomDist(rng) * 100.0f;
+    int numPoints = 4 + static_cast<int>(rng.nextFloat() * 3);
+    float radius = 200.0f + rng.nextFloat() * 100.0f;
     
     for (int i = 0; i < numPoints; i++) {
-        float angle = (M_PI * 2.0f * i) / numPoints + randomDist(rng) * 0.5f;
+        float angle = (M_PI * 2.0f * i) / numPoints + rng.nextFloat() * 0.5f;
         Vector2 point;
         point.x = wolf->x() + std::cos(angle) * radius;
         point.y = wolf->y() + std::sin(angle) * radius;
@@ -471,7 +539,7 @@ void WolfAI::generatePatrolPath() {
 }
 
 Vector2 WolfAI::estimatePlayerVelocity(const Entity* player) {
-    auto currentTime = std::chrono::steady_clock::now().time_since_epoch().count() / 1000000.0f;
+    float currentTime = clockMs;
     
     if (lastPlayerTime == 0) {
         lastPlayerPosition = Vector2(player->position.x, player->position.y);
@@ -502,12 +570,6 @@ float WolfAI::getDistance(const Vector2& a, const Vector2& b) const {
     return std::sqrt(dx * dx + dy * dy);
 }
 
-float WolfAI::normalizeAngle(float angle) const {
-    while (angle > M_PI) angle -= M_PI * 2.0f;
-    while (angle < -M_PI) angle += M_PI * 2.0f;
-    return angle;
-}
-
 bool WolfAI::lineIntersectsCircle(const Vector2& lineStart, const Vector2& lineEnd,
                                   const Vector2& circleCenter, float radius) const {
     float dx = lineEnd.x - lineStart.x;
@@ -529,40 +591,173 @@ bool WolfAI::lineIntersectsCircle(const Vector2& lineStart, const Vector2& lineE
 }
 
 // WolfPack Implementation
-WolfPack::WolfPack() {
+WolfPack::WolfPack() : obstacleIndex(nullptr), flowField(nullptr), sharedStimuli(nullptr), rolesDirty(false) {
+    grid.setWorldBounds(2000.0f, 2000.0f, GRID_CELL_SIZE);
 }
 
 void WolfPack::addWolf(std::shared_ptr<WolfAI> wolf) {
+    wolf->setObstacleIndex(obstacleIndex);
+    wolf->setFlowField(flowField);
+    wolf->setStimuli(activeStimuli());
+    agentByEntity[wolf->getWolf().get()] = wolf.get();
+    knownStates.push_back(wolf->getState());
     wolves.push_back(wolf);
+    rolesDirty = true;
+}
+
+void WolfPack::setObstacleIndex(const ObstacleIndex* index) {
+    obstacleIndex = index;
+    for (auto& wolf : wolves) {
+        wolf->setObstacleIndex(index);
+    }
+}
+
+void WolfPack::setFlowField(const FlowField* field) {
+    flowField = field;
+    for (auto& wolf : wolves) {
+        wolf->setFlowField(field);
+    }
+}
+
+void WolfPack::setStimuli(const StimulusBuffer* buffer) {
+    sharedStimuli = buffer;
+    for (auto& wolf : wolves) {
+        wolf->setStimuli(activeStimuli());
+    }
+}
+
+void WolfPack::setWorldBounds(float width, float height) {
+    grid.setWorldBounds(width, height, GRID_CELL_SIZE);
+    ownStimuli.setWorldBounds(width, height);
+    rebuildGrid();
 }
 
 void WolfPack::removeWolf(std::shared_ptr<WolfAI> wolf) {
-    wolves.erase(std::remove(wolves.begin(), wolves.end(), wolf), wolves.end());
+    auto it = std::find(wolves.begin(), wolves.end(), wolf);
+    if (it == wolves.end()) return;
+    
+    knownStates.erase(knownStates.begin() + (it - wolves.begin()));
+    wolves.erase(it);
+    agentByEntity.erase(wolf->getWolf().get());
+    wolf->clearPackMembers();
+    
+    // Cached neighbour lists may still point at the removed wolf
+    for (auto& member : wolves) {
+        member->clearPackMembers();
+    }
+    rebuildGrid();
+    rolesDirty = true;
 }
 
-void WolfPack::update(float deltaTime, const Entity* player, const std::vector<Entity*>& obstacles) {
-    // Update each wolf
+void WolfPack::rebuildGrid() {
+    grid.clear();
     for (auto& wolf : wolves) {
-        wolf->update(deltaTime, player, wolves, obstacles);
+        grid.insert(wolf->getWolf().get());
+    }
+}
+
+size_t WolfPack::queryMembers(const Vector2& center, float range,
+                              std::vector<WolfAI*>& out, const WolfAI* exclude) {
+    out.clear();
+    grid.queryRadius(center.x, center.y, range, queryScratch);
+    
+    float rangeSq = range * range;
+    for (Entity* entity : queryScratch) {
+        float dx = entity->position.x - center.x;
+        float dy = entity->position.y - center.y;
+        if (dx * dx + dy * dy >= rangeSq) continue;
+        
+        auto found = agentByEntity.find(entity);
+        if (found != agentByEntity.end() && found->second != exclude) {
+            out.push_back(found->second);
+        }
+    }
+    return out.size();
+}
+
+void WolfPack::update(float deltaTime, const Entity* player, const std::vector<Entity*>& obstacles) {
+    HEAP_SCOPE(AI);
+    scheduler.beginFrame();
+    rebuildGrid();
+    
+    // Without a host buffer the player's movement is the only noise, heard
+    // this update
+    if (!sharedStimuli) {
+        Stimulus movement;
+        if (WolfAI::movementStimulus(player, movement)) {
+            ownStimuli.emit(movement.kind, movement.x, movement.y, movement.radius,
+                            movement.intensity, movement.sourceId);
+        }
+        ownStimuli.beginTick();
+    }
+    
+    // Update each wolf; rotate the starting wolf so the budget does not
+    // always defer the same ones
+    size_t count = wolves.size();
+    size_t start = count ? scheduler.getFrame() % count : 0;
+    sensePlayer(player);
+    for (size_t n = 0; n < count; n++) {
+        size_t index = (start + n) % count;
+        auto& wolf = wolves[index];
+        float distance = std::sqrt(senseDistSq[index]);
+        
+        bool perceive = scheduler.claim(wolf->getScheduleTicket(), wolf->getScheduleTier(), distance);
+        if (perceive) {
+            double startMs = AIScheduler::nowMs();
+            scheduler.charge(wolf->updateSensed(deltaTime, player, this, obstacles, senseFlags[index]));
+            scheduler.reportMs(AIScheduler::nowMs() - startMs);
+        } else {
+            wolf->update(deltaTime, player, this, obstacles, false);
+        }
     }
     
     // Coordinate pack behavior
     coordinatePack();
 }
 
+void WolfPack::sensePlayer(const Entity* player) {
+    // A wolf only moves itself during its update, so testing every wolf up
+    // front sees the same positions the per-wolf tests used to
+    TRACE_ZONE("wolf.sense");
+    size_t count = wolves.size();
+    senseX.resize(count);
+    senseY.resize(count);
+    senseFacingX.resize(count);
+    senseFacingY.resize(count);
+    senseDistSq.resize(count);
+    senseFlags.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        const Wolf& wolf = *wolves[i]->getWolf();
+        senseX[i] = wolf.x();
+        senseY[i] = wolf.y();
+        senseFacingX[i] = wolf.getFacing().x;
+        senseFacingY[i] = wolf.getFacing().y;
+    }
+    VectorMath::senseTarget(senseX.data(), senseY.data(), senseFacingX.data(), senseFacingY.data(),
+                            count, player->position.x, player->position.y,
+                            WolfAI::SIGHT_RANGE, WolfAI::VISION_CONE_COS_HALF, WolfAI::HEARING_RANGE,
+                            senseDistSq.data(), senseFlags.data());
+}
+
 void WolfPack::coordinatePack() {
-    // Find wolves in hunt state
-    std::vector<std::shared_ptr<WolfAI>> huntingWolves;
-    for (auto& wolf : wolves) {
-        if (wolf->getState() == WolfState::HUNT) {
-            huntingWolves.push_back(wolf);
+    // Note state changes since roles were last considered
+    int huntingCount = 0;
+    for (size_t i = 0; i < wolves.size(); i++) {
+        WolfState current = wolves[i]->getState();
+        if (current != knownStates[i]) {
+            knownStates[i] = current;
+            rolesDirty = true;
+        }
+        if (current == WolfState::HUNT) {
+            huntingCount++;
         }
     }
     
     // If multiple wolves are hunting, assign roles
-    if (huntingWolves.size() > 1) {
+    if (rolesDirty && huntingCount > 1) {
         assignRoles();
     }
+    rolesDirty = false;
 }
 
 void WolfPack::assignRoles() {
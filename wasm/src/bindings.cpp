@@ -50,5 +50,7 @@ EMSCRIPTEN_BINDINGS(entity) {
 EMSCRIPTEN_BINDINGS(collision_system) {
     class_<CollisionSystem>("CollisionSystem")
         .constructor<>()
-        .function("getCollisionChecks", &CollisionSystem::getCollisionChecks);
+        .function("getCollisionChecks", &CollisionSystem::getCollisionChecks)
+        .function("getBroadphaseCandidates", &CollisionSystem::getBroadphaseCandidates)
+        .function("getNarrowphaseHits", &CollisionSystem::getNarrowphaseHits);
 }
\ No newline at end of file
@@ -0,0 +1,4 @@
+#include "../../include/entities/entity_counts.h"
+
+// EntityCounts implementation
+// Most methods are inline in the header
@@ -0,0 +1,4 @@
+#include "../../include/entities/entity_store.h"
+
+// Entity store implementation
+// Most methods are inline in the header
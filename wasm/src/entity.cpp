@@ -1,4 +1,4 @@
 #include "../include/entities/entity.h"
 
 // Define the static member
-int Entity::nextId = 1;
\ No newline at end of file
+thread_local int Entity::nextId = 1;
\ No newline at end of file
@@ -1,24 +1,49 @@
 #include "../include/game_engine.h"
-#include <emscripten/bind.h>
-#include <emscripten/val.h>
 #include <cstdlib>
 #include <ctime>
+#include <cstring>
 #include <cmath>
 #include <vector>
 #include <algorithm>
 
-GameEngine::GameEngine(float width, float height)
+GameEngine::GameEngine(float width, float height, int workers)
     : worldWidth(width), worldHeight(height),
-      player(nullptr), nextEntityId(1),
-      collisionSystem(&visualEffects),
+      dynamicCount(0), player(nullptr), nextEntityId(1), useEntityStore(true),
+      entityRenderBuffer(Config::MAX_ENTITIES),
+      particleRenderBuffer(Config::MAX_PARTICLES),
+      renderTypeCounts(), useRenderCulling(true), cullMargin(Config::RENDER_CULL_MARGIN),
+      seed(static_cast<uint32_t>(time(nullptr))), apiDepth(0),
+      collisionSystem(&gameplayEvents), obstacleLayout(nullptr),
+      useChunkedWorld(false),
       physicsTime(0), collisionTime(0), collisionChecks(0),
-      gameState(GameState::MENU), score(0), highScore(0) {
+      broadphaseCandidates(0), narrowphaseHits(0),
+      gameState(GameState::MENU), frameNumber(0),
+      useFixedTimestep(true), fixedTimestep(1.0f / Config::SIMULATION_TICK_RATE),
+      maxSubsteps(Config::MAX_SUBSTEPS), accumulator(0), interpolationAlpha(0),
+      lastSubstepCount(0), droppedTime(0), playerIntent(),
+      score(0), highScore(0) {
+#if ENGINE_FEATURE_CAMERA
+    camera.setViewport(width, height);
+#endif
+#if ENGINE_FEATURE_TARGETING
+    targeting.layoutButton(width, height);
+#endif
     
-    // Initialize random seed
-    srand(time(nullptr));
+    // Unrecorded sessions still differ run to run; setSeed() pins them
+    simContext.reset(seed);
     
     // Reserve space for entities
     entities.reserve(Config::MAX_ENTITIES);
+    collisionSystem.setWorldBounds(worldWidth, worldHeight);
+    stateCodec.setWorldBounds(worldWidth, worldHeight);
+    flowField.setWorldBounds(worldWidth, worldHeight);
+    stimuli.setWorldBounds(worldWidth, worldHeight, Config::STIMULUS_CELL_SIZE);
+    
+    // Parallel passes share one persistent pool
+    jobSystem.start(workers < 0 ? JobSystem::defaultWorkerCount() : workers);
+    collisionSystem.setJobSystem(&jobSystem);
+    visualEffects.setJobSystem(&jobSystem);
+    waveSystem.setFrameArena(&frameArena);
 }
 
 GameEngine::~GameEngine() {
@@ -27,14 +52,21 @@ GameEngine::~GameEngine() {
 
 // Entity management
 int GameEngine::createPlayer(float x, float y) {
+    ApiCall call(*this);
+    HEAP_SCOPE(ENTITIES);
     auto playerEntity = std::make_unique<Player>(Vector2(x, y));
     player = playerEntity.get();
-    int id = playerEntity->id;
-    entities.push_back(std::move(playerEntity));
+    int id = adoptEntity(std::move(playerEntity));
+    record(InputLog::Op::CREATE_PLAYER, id, 0, x, y);
+#if ENGINE_FEATURE_CAMERA
+    camera.snapTo(x, y, worldWidth, worldHeight);
+#endif
     return id;
 }
 
 int GameEngine::createEnemy(float x, float y) {
+    ApiCall call(*this);
+    HEAP_SCOPE(ENTITIES);
     auto enemy = std::make_unique<Enemy>(Vector2(x, y));
     
     // Set player as target if available
@@ -42,12 +74,15 @@ int GameEngine::createEnemy(float x, float y) {
         enemy->setTarget(player);
     }
     
-    int id = enemy->id;
-    entities.push_back(std::move(enemy));
+    int id = adoptEntity(std::move(enemy));
+    record(InputLog::Op::CREATE_ENEMY, id, 0, x, y);
     return id;
 }
 
 int GameEngine::createWolf(float x, float y, bool isAlpha) {
+#if ENGINE_FEATURE_WOLF_AI
+    ApiCall call(*this);
+    HEAP_SCOPE(ENTITIES);
     auto wolf = std::make_unique<Wolf>(Vector2(x, y), isAlpha);
     
     // Set player as target if available
@@ -55,34 +90,50 @@ int GameEngine::createWolf(float x, float y, bool isAlpha) {
         wolf->setTarget(player);
     }
     
-    int id = wolf->id;
-    entities.push_back(std::move(wolf));
+    int id = adoptEntity(std::move(wolf));
+    record(InputLog::Op::CREATE_WOLF, id, 0, x, y, 0, 0, 0, isAlpha);
     return id;
+#else
+    (void)x;
+    (void)y;
+    (void)isAlpha;
+    return -1;
+#endif
 }
 
 int GameEngine::createProjectile(float x, float y, float dirX, float dirY, float damage, int ownerId) {
+    ApiCall call(*this);
+    HEAP_SCOPE(ENTITIES);
     Vector2 direction(dirX, dirY);
     auto projectile = std::make_unique<Projectile>(Vector2(x, y), direction, damage, ownerId);
-    int id = projectile->id;
-    entities.push_back(std::move(projectile));
+    int id = adoptEntity(std::move(projectile));
+    record(InputLog::Op::CREATE_PROJECTILE, id, ownerId, x, y, dirX, dirY, damage);
     return id;
 }
 
 int GameEngine::createPowerUp(float x, float y, int type) {
+    ApiCall call(*this);
+    HEAP_SCOPE(ENTITIES);
     auto powerUp = std::make_unique<PowerUp>(Vector2(x, y), static_cast<PowerUpType>(type));
-    int id = powerUp->id;
-    entities.push_back(std::move(powerUp));
+    int id = adoptEntity(std::move(powerUp));
+    record(InputLog::Op::CREATE_POWERUP, id, type, x, y);
     return id;
 }
 
 int GameEngine::createObstacle(float x, float y, float radius, bool destructible) {
+    ApiCall call(*this);
+    HEAP_SCOPE(ENTITIES);
     auto obstacle = std::make_unique<Obstacle>(Vector2(x, y), radius, destructible);
-    int id = obstacle->id;
-    entities.push_back(std::move(obstacle));
+    int id = adoptEntity(std::move(obstacle));
+    obstacleIndex.markDirty();
+    flowField.markDirty();
+    record(InputLog::Op::CREATE_OBSTACLE, id, 0, x, y, radius, 0, 0, destructible);
     return id;
 }
 
 int GameEngine::createShapedObstacle(float x, float y, int shape, float width, float height, float rotation, bool destructible) {
+    ApiCall call(*this);
+    HEAP_SCOPE(ENTITIES);
     auto obstacle = std::make_unique<Obstacle>(
         Vector2(x, y), 
         static_cast<ObstacleShape>(shape), 
@@ -91,28 +142,93 @@ int GameEngine::createShapedObstacle(float x, float y, int shape, float width, f
         rotation, 
         destructible
     );
-    int id = obstacle->id;
-    entities.push_back(std::move(obstacle));
+    int id = adoptEntity(std::move(obstacle));
+    obstacleIndex.markDirty();
+    flowField.markDirty();
+    record(InputLog::Op::CREATE_SHAPED_OBSTACLE, id, shape, x, y, width, height, rotation, destructible);
     return id;
 }
 
 void GameEngine::removeEntity(int id) {
-    auto it = std::find_if(entities.begin(), entities.end(),
-        [id](const std::unique_ptr<Entity>& e) {
-            return e && e->id == id;
-        });
+    ApiCall call(*this);
+    record(InputLog::Op::REMOVE_ENTITY, id);
+    uint32_t index = entityHandles.resolve(id);
+    if (index == HandleTable::INVALID_INDEX) return;
     
-    if (it != entities.end()) {
-        if (it->get() == player) {
-            player = nullptr;
-        }
-        entities.erase(it);
+    Entity* entity = entities[index].get();
+    if (entity == player) {
+        player = nullptr;
+    }
+    if (entity->type == EntityType::OBSTACLE) {
+        obstacleIndex.markDirty();
+        flowField.removeObstacle(*static_cast<Obstacle*>(entity));
+    }
+    swapRemoveEntity(index);
+}
+
+int GameEngine::adoptEntity(std::unique_ptr<Entity> entity) {
+    size_t index = entities.size();
+    int id = entityHandles.allocate(static_cast<uint32_t>(index));
+    if (id == HandleTable::NULL_HANDLE) return id;
+    entity->id = id;
+    bool isStatic = Entity::isStaticType(entity->type);
+    entityCounts.add(entity->type);
+    entities.push_back(std::move(entity));
+    if (!isStatic) {
+        placeDynamic(index);
+        unculledIds.push_back(id);
+    }
+    return id;
+}
+
+void GameEngine::adoptSpawned(std::vector<std::unique_ptr<Entity>>& batch) {
+    // A system's spawns (waves) join in one go; anything the handle table
+    // cannot hold is dropped
+    for (std::unique_ptr<Entity>& entity : batch) {
+        adoptEntity(std::move(entity));
     }
+    batch.clear();
+}
+
+// Grow the dynamic layer by the entity at index (which sits past it); the
+// first static entity takes its place
+void GameEngine::placeDynamic(size_t index) {
+    if (index != dynamicCount) {
+        std::swap(entities[index], entities[dynamicCount]);
+        entityHandles.relocate(entities[index]->id, static_cast<uint32_t>(index));
+        entityHandles.relocate(entities[dynamicCount]->id, static_cast<uint32_t>(dynamicCount));
+    }
+    dynamicCount++;
+}
+
+void GameEngine::moveEntity(size_t from, size_t to) {
+    if (from == to) return;
+    entities[to] = std::move(entities[from]);
+    entityHandles.relocate(entities[to]->id, static_cast<uint32_t>(to));
+}
+
+// The hole is filled from the end of the same layer, so both stay packed
+void GameEngine::swapRemoveEntity(size_t index) {
+    entityHandles.release(entities[index]->id);
+    entityCounts.remove(entities[index]->type);
+    if (index < dynamicCount) {
+        size_t lastDynamic = --dynamicCount;
+        moveEntity(lastDynamic, index);
+        index = lastDynamic;
+    }
+    moveEntity(entities.size() - 1, index);
+    entities.pop_back();
+}
+
+Player* GameEngine::findPlayer(int playerId) {
+    Entity* entity = findEntityById(playerId);
+    return entity && entity->type == EntityType::PLAYER ? static_cast<Player*>(entity) : nullptr;
 }
 
 // Player controls
 void GameEngine::updatePlayerInput(float dx, float dy, float aimX, float aimY) {
-    if (!player || !player->active) return;
+    ApiCall call(*this);
+    record(InputLog::Op::PLAYER_INPUT, 0, 0, dx, dy, aimX, aimY);
     
     // Normalize input
     Vector2 input(dx, dy);
@@ -121,13 +237,28 @@ void GameEngine::updatePlayerInput(float dx, float dy, float aimX, float aimY) {
         input = input.normalized();
     }
     
+    // Held until the next call; every tick until then accelerates by it
+    playerIntent = {input.x, input.y};
+    if (!player || !player->active) return;
+    
+    // Update player rotation based on aim direction
+    Vector2 aimDirection(aimX - player->position.x, aimY - player->position.y);
+    if (aimDirection.magnitude() > 0.0f) {
+        player->rotation = atan2(aimDirection.y, aimDirection.x);
+    }
+}
+
+// One tick of the latched input: acceleration, speed limit and friction
+void GameEngine::applyPlayerIntent() {
+    if (!player || !player->active) return;
+    
     // Apply acceleration
     float accel = Config::PLAYER_ACCELERATION;
     if (player->boosting) {
         accel *= 2;
     }
     
-    player->velocity += input * accel;
+    player->velocity += Vector2(playerIntent.moveX, playerIntent.moveY) * accel;
     
     // Limit speed
     float maxSpeed = player->getSpeed();
@@ -140,15 +271,11 @@ void GameEngine::updatePlayerInput(float dx, float dy, float aimX, float aimY) {
     if (!player->boosting) {
         player->velocity *= Config::PLAYER_FRICTION;
     }
-    
-    // Update player rotation based on aim direction
-    Vector2 aimDirection(aimX - player->position.x, aimY - player->position.y);
-    if (aimDirection.magnitude() > 0.0f) {
-        player->rotation = atan2(aimDirection.y, aimDirection.x);
-    }
 }
 
 void GameEngine::playerShoot(float aimX, float aimY) {
+    ApiCall call(*this);
+    record(InputLog::Op::PLAYER_SHOOT, 0, 0, aimX, aimY);
     if (!player || !player->active || !player->canShoot()) return;
     
     Vector2 direction(aimX - player->position.x, aimY - player->position.y);
@@ -174,48 +301,65 @@ void GameEngine::playerShoot(float aimX, float aimY) {
         createProjectile(player->position.x, player->position.y,
                        direction.x, direction.y, damage, player->id);
     }
+    stimuli.emit(Stimulus::Kind::SHOT, player->position.x, player->position.y,
+                 Config::STIMULUS_SHOT_RADIUS, 2.0f, player->id);
     
     player->consumeShootEnergy();
 }
 
 void GameEngine::activateBoost(int playerId) {
-    if (player && player->id == playerId) {
-        player->startBoost();
+    ApiCall call(*this);
+    record(InputLog::Op::BOOST_ON, playerId);
+    if (Player* actor = findPlayer(playerId)) {
+        actor->startBoost();
     }
 }
 
 void GameEngine::deactivateBoost(int playerId) {
-    if (player && player->id == playerId) {
-        player->boosting = false;
+    ApiCall call(*this);
+    record(InputLog::Op::BOOST_OFF, playerId);
+    if (Player* actor = findPlayer(playerId)) {
+        actor->boosting = false;
     }
 }
 
 void GameEngine::startBlock(int playerId) {
-    if (player && player->id == playerId) {
-        player->startBlock();
+    ApiCall call(*this);
+    record(InputLog::Op::BLOCK_START, playerId);
+    if (Player* actor = findPlayer(playerId)) {
+        actor->startBlock();
     }
 }
 
 void GameEngine::endBlock(int playerId) {
-    if (player && player->id == playerId) {
-        player->endBlock();
+    ApiCall call(*this);
+    record(InputLog::Op::BLOCK_END, playerId);
+    if (Player* actor = findPlayer(playerId)) {
+        actor->endBlock();
     }
 }
 
 void GameEngine::performAttack(int playerId, float angle) {
-    if (player && player->id == playerId) {
-        player->startAttack(angle);
+    ApiCall call(*this);
+    record(InputLog::Op::ATTACK, playerId, 0, angle);
+    Player* actor = findPlayer(playerId);
+    // Only a swing that starts can hit
+    if (actor && actor->startAttack(angle)) {
+        stimuli.emit(Stimulus::Kind::ATTACK, actor->position.x, actor->position.y,
+                     Config::STIMULUS_ATTACK_RADIUS, 1.0f, actor->id);
+        size_t eventsFrom = gameplayEvents.size();
         
         // Check for enemies in sword range
-        for (auto& entity : entities) {
+        for (size_t i = 0; i < dynamicCount; i++) {
+            Entity* entity = entities[i].get();
             if (!entity || !entity->active) continue;
             
             if (entity->type == EntityType::ENEMY || entity->type == EntityType::WOLF) {
-                float distance = player->distanceTo(*entity);
+                float distance = actor->distanceTo(*entity);
                 
                 if (distance <= Config::SWORD_RANGE) {
                     // Check if enemy is within sword arc
-                    Vector2 toEnemy = entity->position - player->position;
+                    Vector2 toEnemy = entity->position - actor->position;
                     float enemyAngle = atan2(toEnemy.y, toEnemy.x);
                     float angleDiff = abs(enemyAngle - angle);
                     
@@ -224,149 +368,417 @@ void GameEngine::performAttack(int playerId, float angle) {
                     
                     if (angleDiff <= Config::SWORD_ARC / 2) {
                         // Hit the enemy
-                        entity->takeDamage(Config::SWORD_DAMAGE * player->getDamageMultiplier());
+                        float damage = Config::SWORD_DAMAGE * actor->getDamageMultiplier();
+                        entity->takeDamage(damage);
                         
                         // Knockback
                         Vector2 knockback = toEnemy;
+                        Vector2 direction(0, 0);
                         float knockbackMag = knockback.magnitude();
                         if (knockbackMag > 0.0f) {
                             knockback = knockback.normalized() * Config::SWORD_KNOCKBACK;
                             entity->velocity += knockback;
-                            
-                            // Visual effect
-                            visualEffects.createHitEffect(entity->position, false);
-                            visualEffects.createBloodSplatter(entity->position, knockback.normalized());
-                        } else {
-                            // Just apply visual effect without knockback
-                            visualEffects.createHitEffect(entity->position, false);
+                            direction = knockback.normalized();
                         }
+                        gameplayEvents.push(GameplayEvent::Type::HIT, actor->id, entity->id,
+                                            entity->position.x, entity->position.y,
+                                            direction.x, direction.y, damage);
                         
-                        // Score for kill
                         if (!entity->active) {
-                            player->score += Config::SCORE_PER_KILL;
-                            player->kills++;
-                            score += Config::SCORE_PER_KILL;
-                            
-                            visualEffects.createExplosion(entity->position, 0.5f);
+                            gameplayEvents.push(GameplayEvent::Type::KILL, actor->id, entity->id,
+                                                entity->position.x, entity->position.y);
                         }
                     }
                 }
             }
         }
+        applyGameplayEvents(eventsFrom);
     }
 }
 
 void GameEngine::performRoll(int playerId, float dirX, float dirY) {
-    if (player && player->id == playerId) {
+    ApiCall call(*this);
+    record(InputLog::Op::ROLL, playerId, 0, dirX, dirY);
+    if (Player* actor = findPlayer(playerId)) {
         Vector2 direction(dirX, dirY);
         if (direction.magnitude() < 0.1f) {
             // If no direction provided, roll in movement direction
-            float velMag = player->velocity.magnitude();
+            float velMag = actor->velocity.magnitude();
             if (velMag > 0.0f) {
-                direction = player->velocity.normalized();
+                direction = actor->velocity.normalized();
             } else {
                 // Default to rolling right if no velocity
                 direction = Vector2(1.0f, 0.0f);
             }
         }
-        player->startRoll(direction);
+        actor->startRoll(direction);
         
         // Create dust effect
-        visualEffects.createDustCloud(player->position);
+        visualEffects.createDustCloud(actor->position);
+    }
+}
+
+void GameEngine::playerBoost() {
+    if (player && player->active) {
+        activateBoost(player->id);
+    }
+}
+
+// Area blast: heavy damage and knockback to every enemy around the player
+void GameEngine::playerSpecialAbility() {
+    ApiCall call(*this);
+    record(InputLog::Op::SPECIAL_ABILITY);
+    if (!player || !player->active || player->energy < Config::SPECIAL_ENERGY_COST) return;
+    player->energy -= Config::SPECIAL_ENERGY_COST;
+    
+    size_t eventsFrom = gameplayEvents.size();
+    for (size_t i = 0; i < dynamicCount; i++) {
+        Entity* entity = entities[i].get();
+        if (!entity || !entity->active) continue;
+        if (entity->type != EntityType::ENEMY && entity->type != EntityType::WOLF) continue;
+        if (player->distanceTo(*entity) >= Config::SPECIAL_RADIUS) continue;
+        
+        entity->takeDamage(Config::SPECIAL_DAMAGE * player->getDamageMultiplier());
+        Vector2 away = entity->position - player->position;
+        if (away.magnitude() > 0.0f) {
+            entity->velocity = away.normalized() * Config::SPECIAL_KNOCKBACK;
+        }
+        
+        if (!entity->active) {
+            gameplayEvents.push(GameplayEvent::Type::KILL, player->id, entity->id,
+                                entity->position.x, entity->position.y);
+        }
+    }
+    applyGameplayEvents(eventsFrom);
+    visualEffects.createExplosion(player->position, 1.0f);
+}
+
+// The shortcuts forward to the id-based calls, which do the recording
+void GameEngine::playerAttack() {
+    if (player && player->active) {
+        performAttack(player->id, player->rotation);
+    }
+}
+
+void GameEngine::playerRoll(float dirX, float dirY) {
+    if (player && player->active) {
+        performRoll(player->id, dirX, dirY);
+    }
+}
+
+// Joystick moves and aims along the stick; a centred stick keeps the facing
+void GameEngine::setJoystickInput(float x, float y) {
+    if (player && player->active) {
+        updatePlayerInput(x, y, player->position.x + x, player->position.y + y);
     }
 }
 
 // Game loop
 void GameEngine::update(float deltaTime) {
+    // Allocations since the last update, exports included, are one frame
+    HEAP_END_FRAME();
+    if (quality.observe(deltaTime * 1000.0f)) {
+        applyQuality();
+    }
+    // Events are read back per frame; this frame's start with its input
+    gameplayEvents.clear();
+    // Queued input is applied (and recorded) before any tick of this update
+    drainCommands();
     if (gameState != GameState::PLAYING) return;
+    ApiCall call(*this);
+    TRACE_FRAME();
+    TRACE_ZONE("frame");
+    PERF_TIMER(FRAME);
+    
+    physicsTime = 0;
+    collisionTime = 0;
+    
+    if (!useFixedTimestep) {
+        lastSubstepCount = 1;
+        interpolationAlpha = 1.0f;
+        runTick(deltaTime);
+        frameArena.reset();
+        return;
+    }
+    
+    accumulator += std::max(deltaTime, 0.0f);
+    
+    int substeps = 0;
+    int substepBudget = std::min(maxSubsteps, quality.values().maxSubsteps);
+    while (accumulator >= fixedTimestep && substeps < substepBudget &&
+           gameState == GameState::PLAYING) {
+        runTick(fixedTimestep);
+        accumulator -= fixedTimestep;
+        substeps++;
+    }
+    
+    // Out of budget: drop the backlog instead of spiralling further behind
+    if (accumulator >= fixedTimestep) {
+        float keep = std::fmod(accumulator, fixedTimestep);
+        droppedTime += accumulator - keep;
+        accumulator = keep;
+    }
+    
+    lastSubstepCount = substeps;
+    interpolationAlpha = accumulator / fixedTimestep;
     
-    double startTime = emscripten_get_now();
+    // Scratch from this frame's systems is dead now
+    frameArena.reset();
+}
+
+// Commands go through the public methods, so each is recorded on its own
+int GameEngine::drainCommands() {
+    using Op = CommandBuffer::Op;
+    size_t applied = commandBuffer.drain([this](const CommandBuffer::Command& command) {
+        const float* v = command.v;
+        switch (command.op) {
+            case Op::PLAYER_INPUT: updatePlayerInput(v[0], v[1], v[2], v[3]); break;
+            case Op::PLAYER_SHOOT: playerShoot(v[0], v[1]); break;
+            case Op::BOOST_ON: activateBoost(command.id); break;
+            case Op::BOOST_OFF: deactivateBoost(command.id); break;
+            case Op::BLOCK_START: startBlock(command.id); break;
+            case Op::BLOCK_END: endBlock(command.id); break;
+            case Op::ATTACK: performAttack(command.id, v[0]); break;
+            case Op::ROLL: performRoll(command.id, v[0], v[1]); break;
+            default: break;   // NONE or unknown: skipped
+        }
+    });
+    return static_cast<int>(applied);
+}
+
+// One recorded tick, as update() runs it
+void GameEngine::runTick(float deltaTime) {
+    for (size_t i = 0; i < dynamicCount; i++) {
+        entities[i]->storePreviousTransform();
+    }
+    record(InputLog::Op::STEP, 0, 0, deltaTime);
+    step(deltaTime);
+    // Saved between ticks, before any input for the next one
+    if (rollbackAllowed()) {
+        saveWorld(rollback.beginSave(frameNumber));
+    }
+}
+
+// One simulation tick
+void GameEngine::step(float deltaTime) {
+    TRACE_ZONE("step");
+    frameNumber++;
+    HEAP_SET_FRAME(frameNumber);
+    simContext.clockMs += deltaTime * 1000.0;
+    applyPlayerIntent();
+    // Noise made since the last tick is what wolves hear during this one
+    emitPlayerStimuli();
+    stimuli.beginTick();
+    streamChunks();
+    {
+        TRACE_ZONE("obstacleIndex");
+        HEAP_SCOPE(GRID);
+        obstacleIndex.rebuildIfDirty(entities);
+    }
+    if (player && player->active) {
+        TRACE_ZONE("flowField");
+        HEAP_SCOPE(GRID);
+        flowField.update(entities, player->position);
+    }
+#if ENGINE_FEATURE_TARGETING
+    {
+        TRACE_ZONE("targeting");
+        targeting.update(player, [this](int id) { return findEntityById(id); },
+                         [this]() -> const TargetCandidates::List& { return queryTargetCandidates(*player); });
+    }
+#endif
+    double startTime = Platform::now();
     
     // Update physics
     updatePhysics(deltaTime);
     
-    double afterPhysics = emscripten_get_now();
-    physicsTime = afterPhysics - startTime;
+    double afterPhysics = Platform::now();
+    physicsTime += afterPhysics - startTime;
+    PERF_RECORD(PHYSICS, afterPhysics - startTime);
     
     // Update AI
     updateAI(deltaTime);
+    double afterAI = Platform::now();
     
     // Check collisions
-    collisionSystem.checkCollisions(entities, player);
+    size_t eventsFrom = gameplayEvents.size();
+    {
+        TRACE_ZONE("collision");
+        HEAP_SCOPE(GRID);
+        // Every dynamic entity is binned in this pass's grid
+        unculledIds.clear();
+        if (useEntityStore) {
+            // AI and gameplay logic have moved entities since the physics pass
+            entityStore.refresh();
+            collisionSystem.checkCollisions(entityStore, obstacleIndex);
+        } else {
+            collisionSystem.checkCollisions(entities, dynamicCount, obstacleIndex);
+        }
+    }
+    {
+        TRACE_ZONE("gameplayEvents");
+        applyGameplayEvents(eventsFrom);
+    }
     collisionChecks = collisionSystem.getCollisionChecks();
+    broadphaseCandidates = collisionSystem.getBroadphaseCandidates();
+    narrowphaseHits = collisionSystem.getNarrowphaseHits();
     
-    double afterCollisions = emscripten_get_now();
-    collisionTime = afterCollisions - afterPhysics;
+    double afterCollisions = Platform::now();
+    collisionTime += afterCollisions - afterAI;
+    PERF_RECORD(COLLISION, afterCollisions - afterAI);
     
     // Update visual effects
-    visualEffects.update(deltaTime);
-    
-    // Update wave system
-    waveSystem.update(deltaTime, entities, worldWidth, worldHeight);
+    {
+        TRACE_ZONE("effects");
+        PERF_TIMER(EFFECTS);
+        HEAP_SCOPE(PARTICLES);
+        visualEffects.update(deltaTime);
+    }
     
     // Check bounds
     checkBounds();
     
-    // Clean up inactive entities
-    cleanupInactiveEntities();
+#if ENGINE_FEATURE_CAMERA
+    if (player && player->active) {
+        camera.update(player->position.x, player->position.y, worldWidth, worldHeight);
+    }
+    if (isRenderCulling()) {
+        captureVisibleSet();
+    }
+#endif
+#if ENGINE_FEATURE_TARGETING
+    // Same grid, same reason to run before cleanup
+    if (player && player->active) {
+        TRACE_ZONE("targeting.gather");
+        targetCandidates.gather(collisionSystem.getSpatialGrid(), *player);
+    }
+#endif
     
-    // Check game over
+    // Check game over, before cleanup drops a player with no lives left
     if (player && player->lives <= 0) {
         gameState = GameState::GAME_OVER;
         if (score > highScore) {
             highScore = score;
         }
     }
+    
+    // Clean up inactive entities
+    cleanupInactiveEntities();
+    
+    // Update wave system. After cleanup the counts only hold the living.
+    {
+        TRACE_ZONE("waves");
+        PERF_TIMER(WAVES);
+        HEAP_SCOPE(ENTITIES);
+        if (useChunkedWorld) {
+            // Waves arrive at the edge of the live chunks, not the world
+            ChunkManager::Bounds live = chunkManager.liveBounds();
+            waveSystem.setSpawnOrigin(live.minX, live.minY);
+            waveSystem.update(deltaTime, entityCounts, waveSpawns, live.width(), live.height());
+        } else {
+            waveSystem.setSpawnOrigin(0, 0);
+            waveSystem.update(deltaTime, entityCounts, waveSpawns, worldWidth, worldHeight);
+        }
+        adoptSpawned(waveSpawns);
+    }
 }
 
 void GameEngine::updatePhysics(float deltaTime) {
-    // Update player
-    if (player && player->active) {
-        player->update(deltaTime);
+    TRACE_ZONE("physics");
+    HEAP_SCOPE(ENTITIES);
+    if (useEntityStore) {
+        // Integrate every mover in one linear pass, then run per-entity logic
+        entityStore.gather(entities, dynamicCount);
+        jobSystem.parallelFor(entityStore.moverCount(), JobSystem::DEFAULT_MIN_CHUNK,
+            [this, deltaTime](size_t begin, size_t end) {
+                TRACE_ZONE("physics.integrateChunk");
+                entityStore.integrate(begin, end, deltaTime);
+            });
+        entityStore.scatter();
         
-        // Create boost trail
-        if (player->boosting) {
-            visualEffects.createBoostTrail(player->position, "#00ffff", player->velocity);
+        TRACE_ZONE("physics.logic");
+        for (size_t i = 0; i < entityStore.size(); i++) {
+            entityStore.handles[i]->updateLogic(deltaTime);
+        }
+    } else {
+        // Update all dynamic entities (the player is part of the list)
+        for (size_t i = 0; i < dynamicCount; i++) {
+            Entity* entity = entities[i].get();
+            if (entity && entity->active) {
+                entity->update(deltaTime);
+            }
         }
     }
     
-    // Update all entities
-    for (auto& entity : entities) {
-        if (entity && entity->active) {
-            entity->update(deltaTime);
-        }
+    // Create boost trail
+    if (player && player->active && player->boosting) {
+        visualEffects.createBoostTrail(player->position, "#00ffff", player->velocity);
     }
 }
 
 void GameEngine::updateAI(float deltaTime) {
+    TRACE_ZONE("ai");
+    PERF_TIMER(AI);
+    HEAP_SCOPE(AI);
     // Update enemy AI targets
     updateEntityTargets();
 }
 
 void GameEngine::checkBounds() {
-    // Keep player in bounds
-    if (player && player->active) {
-        player->position.x = std::max(player->radius, 
-                                     std::min(worldWidth - player->radius, player->position.x));
-        player->position.y = std::max(player->radius, 
-                                     std::min(worldHeight - player->radius, player->position.y));
+    TRACE_ZONE("bounds");
+    if (!useEntityStore) {
+        // Keep player in bounds
+        if (player && player->active) {
+            player->position.x = std::max(player->radius, 
+                                         std::min(worldWidth - player->radius, player->position.x));
+            player->position.y = std::max(player->radius, 
+                                         std::min(worldHeight - player->radius, player->position.y));
+        }
+        
+        // Remove projectiles that go out of bounds
+        for (size_t i = 0; i < dynamicCount; i++) {
+            Entity* entity = entities[i].get();
+            if (entity && entity->type == EntityType::PROJECTILE) {
+                if (entity->position.x < -50 || entity->position.x > worldWidth + 50 ||
+                    entity->position.y < -50 || entity->position.y > worldHeight + 50) {
+                    entity->active = false;
+                }
+            }
+        }
+        return;
+    }
+    
+    // Collision response has moved entities; pick up their current positions
+    entityStore.refresh();
+    
+    // Keep players in bounds
+    for (size_t i = entityStore.groupBegin(EntityType::PLAYER);
+         i < entityStore.groupEnd(EntityType::PLAYER); i++) {
+        if (!entityStore.active[i]) continue;
+        float r = entityStore.radius[i];
+        Entity* handle = entityStore.handles[i];
+        handle->position.x = std::max(r, std::min(worldWidth - r, entityStore.x[i]));
+        handle->position.y = std::max(r, std::min(worldHeight - r, entityStore.y[i]));
     }
     
     // Remove projectiles that go out of bounds
-    for (auto& entity : entities) {
-        if (entity && entity->type == EntityType::PROJECTILE) {
-            if (entity->position.x < -50 || entity->position.x > worldWidth + 50 ||
-                entity->position.y < -50 || entity->position.y > worldHeight + 50) {
-                entity->active = false;
-            }
+    for (size_t i = entityStore.groupBegin(EntityType::PROJECTILE);
+         i < entityStore.groupEnd(EntityType::PROJECTILE); i++) {
+        if (entityStore.x[i] < -50 || entityStore.x[i] > worldWidth + 50 ||
+            entityStore.y[i] < -50 || entityStore.y[i] > worldHeight + 50) {
+            entityStore.handles[i]->active = false;
         }
     }
 }
 
 // Game state
 void GameEngine::startGame() {
+    ApiCall call(*this);
+    record(InputLog::Op::START_GAME);
     gameState = GameState::PLAYING;
     score = 0;
+    accumulator = 0;
+    interpolationAlpha = 0;
     
     // Clear existing entities
     clearEntities();
@@ -374,23 +786,39 @@ void GameEngine::startGame() {
     // Create player at center
     createPlayer(worldWidth / 2, worldHeight / 2);
     
-    // Generate enhanced obstacles with various shapes and clustering
-    generateEnhancedObstacles(10, true); // Generate 10 obstacles, ensure playability
+    // Generate enhanced obstacles with various shapes and clustering; a
+    // streamed world generates its own per chunk
+    if (useChunkedWorld) return;
+    if (obstacleLayout && !inputLog.isRecording()) {
+        for (const ObstacleGenerator::Placement& placement : *obstacleLayout) {
+            placeObstacle(placement);
+        }
+        obstacleIndex.markDirty();
+        flowField.markDirty();
+    } else {
+        generateEnhancedObstacles(10, true); // Generate 10 obstacles, ensure playability
+    }
 }
 
 void GameEngine::pauseGame() {
+    ApiCall call(*this);
+    record(InputLog::Op::PAUSE_GAME);
     if (gameState == GameState::PLAYING) {
         gameState = GameState::PAUSED;
     }
 }
 
 void GameEngine::resumeGame() {
+    ApiCall call(*this);
+    record(InputLog::Op::RESUME_GAME);
     if (gameState == GameState::PAUSED) {
         gameState = GameState::PLAYING;
     }
 }
 
 void GameEngine::endGame() {
+    ApiCall call(*this);
+    record(InputLog::Op::END_GAME);
     gameState = GameState::GAME_OVER;
     if (score > highScore) {
         highScore = score;
@@ -398,316 +826,871 @@ void GameEngine::endGame() {
 }
 
 void GameEngine::restartGame() {
+    ApiCall call(*this);
+    record(InputLog::Op::RESTART_GAME);
     startGame();
 }
 
 // World management
 void GameEngine::setWorldBounds(float width, float height) {
+    ApiCall call(*this);
+    record(InputLog::Op::SET_WORLD_BOUNDS, 0, 0, width, height);
     worldWidth = width;
     worldHeight = height;
+    collisionSystem.setWorldBounds(width, height);
+    stateCodec.setWorldBounds(width, height);
+    flowField.setWorldBounds(width, height);
+    stimuli.setWorldBounds(width, height, Config::STIMULUS_CELL_SIZE);
+    chunkManager.setWorldBounds(width, height);
+}
+
+void GameEngine::setChunkedWorld(bool enabled, float chunkSize, int loadRadius) {
+    ApiCall call(*this);
+    record(InputLog::Op::SET_CHUNKED_WORLD, 0, loadRadius, chunkSize, 0, 0, 0, 0, enabled);
+    useChunkedWorld = enabled;
+    chunkManager.configure(seed, chunkSize > 0 ? chunkSize : Config::CHUNK_SIZE,
+                           loadRadius >= 0 ? loadRadius : Config::CHUNK_LOAD_RADIUS,
+                           worldWidth, worldHeight);
+    if (!enabled) {
+        // Back to structures covering the whole world
+        collisionSystem.setWorldBounds(worldWidth, worldHeight);
+        flowField.setWorldBounds(worldWidth, worldHeight);
+        stimuli.setWorldBounds(worldWidth, worldHeight, Config::STIMULUS_CELL_SIZE);
+    }
+}
+
+// Recentre the streamed world on the player. Anything outside the keep
+// window is frozen into its chunk (shots in flight are dropped); when the
+// player has changed chunk the live chunks not yet loaded are then brought
+// in, and the collision grid and flow field follow the window.
+void GameEngine::streamChunks() {
+    if (!useChunkedWorld || !player || !player->active) return;
+    ChunkManager::Coord center = chunkManager.coordAt(player->position.x, player->position.y);
+    bool moved = chunkManager.setCenter(center);
+    if (!moved && frameNumber % Config::CHUNK_SWEEP_INTERVAL != 0) return;
+    TRACE_ZONE("chunks");
+    HEAP_SCOPE(GRID);
+    
+    chunkEvictions.clear();
+    for (const auto& entity : entities) {
+        if (entity.get() == player) continue;
+        if (chunkManager.isKept(chunkManager.coordAt(entity->position.x, entity->position.y))) continue;
+        if (entity->active && entity->type != EntityType::PROJECTILE) {
+            chunkManager.freeze(describeForChunk(*entity));
+        }
+        chunkEvictions.push_back(entity->id);
+    }
+    for (int id : chunkEvictions) {
+        evictEntity(id);
+    }
+    if (!moved) return;
+    
+    chunkManager.releaseOutsideWindow();
+    chunkManager.collectLoads(chunkLoads);
+    for (const ChunkManager::Coord& coord : chunkLoads) {
+        chunkSpawns.clear();
+        chunkManager.load(coord, chunkSpawns);
+        for (const ChunkManager::Spawn& spawn : chunkSpawns) {
+            spawnFromChunk(spawn);
+        }
+    }
+    
+    ChunkManager::Bounds kept = chunkManager.keptBounds();
+    collisionSystem.setBounds(kept.minX, kept.minY, kept.width(), kept.height());
+    flowField.setBounds(kept.minX, kept.minY, kept.width(), kept.height());
+    stimuli.setBounds(kept.minX, kept.minY, kept.width(), kept.height(), Config::STIMULUS_CELL_SIZE);
+}
+
+ChunkManager::Spawn GameEngine::describeForChunk(const Entity& entity) const {
+    ChunkManager::Spawn spawn = {entity.type, 0, false, entity.position.x, entity.position.y,
+                                 0, 0, 0, entity.maxHealth > 0 ? entity.health / entity.maxHealth : 1.0f};
+    switch (entity.type) {
+        case EntityType::OBSTACLE: {
+            const Obstacle& obstacle = static_cast<const Obstacle&>(entity);
+            spawn.variant = static_cast<uint8_t>(obstacle.shape);
+            spawn.destructible = obstacle.destructible;
+            spawn.width = obstacle.width;
+            spawn.height = obstacle.height;
+            spawn.rotation = obstacle.rotation;
+            break;
+        }
+        case EntityType::WOLF:
+            spawn.variant = static_cast<const Wolf&>(entity).isAlpha ? 1 : 0;
+            break;
+        case EntityType::POWERUP:
+            spawn.variant = static_cast<uint8_t>(static_cast<const PowerUp&>(entity).powerType);
+            break;
+        default:
+            break;
+    }
+    return spawn;
+}
+
+// Chunk content goes through the regular create calls; inside a tick they
+// are nested, so a replay regenerates them rather than reading them back
+void GameEngine::spawnFromChunk(const ChunkManager::Spawn& spawn) {
+    int id = -1;
+    switch (spawn.type) {
+        case EntityType::OBSTACLE:
+            if (spawn.variant == static_cast<uint8_t>(ObstacleShape::CIRCLE)) {
+                id = createObstacle(spawn.x, spawn.y, spawn.width * 0.5f, spawn.destructible);
+            } else {
+                id = createShapedObstacle(spawn.x, spawn.y, spawn.variant, spawn.width, spawn.height,
+                                          spawn.rotation, spawn.destructible);
+            }
+            break;
+        case EntityType::ENEMY: id = createEnemy(spawn.x, spawn.y); break;
+        case EntityType::WOLF: id = createWolf(spawn.x, spawn.y, spawn.variant != 0); break;
+        case EntityType::POWERUP: id = createPowerUp(spawn.x, spawn.y, spawn.variant); break;
+        default: return;
+    }
+    Entity* entity = findEntityById(id);
+    if (entity && spawn.health < 1.0f) {
+        entity->health = entity->maxHealth * spawn.health;
+    }
+}
+
+// Removal for the chunk streamer: the static index and flow field are
+// rebuilt once for the whole batch instead of repaired per obstacle
+void GameEngine::evictEntity(int id) {
+    uint32_t index = entityHandles.resolve(id);
+    if (index == HandleTable::INVALID_INDEX) return;
+    if (entities[index]->type == EntityType::OBSTACLE) {
+        obstacleIndex.markDirty();
+        flowField.markDirty();
+    }
+    swapRemoveEntity(index);
+}
+
+const ObstacleIndex& GameEngine::getObstacleIndex() {
+    obstacleIndex.rebuildIfDirty(entities);
+    return obstacleIndex;
+}
+
+bool GameEngine::hasLineOfSight(float x1, float y1, float x2, float y2) {
+    return !getObstacleIndex().segmentBlocked(Vector2(x1, y1), Vector2(x2, y2));
+}
+
+void GameEngine::setWorkerCount(int workers) {
+    jobSystem.start(workers);
+}
+
+void GameEngine::setFixedTimestep(float ticksPerSecond, int maxSubstepsPerUpdate) {
+    if (ticksPerSecond > 0) {
+        fixedTimestep = 1.0f / ticksPerSecond;
+    }
+    maxSubsteps = std::max(1, maxSubstepsPerUpdate);
+    accumulator = std::min(accumulator, fixedTimestep);
+}
+
+void GameEngine::setUseFixedTimestep(bool enabled) {
+    useFixedTimestep = enabled;
+    accumulator = 0;
+    interpolationAlpha = enabled ? 0.0f : 1.0f;
+}
+
+void GameEngine::setAdaptiveQuality(bool enabled) {
+    quality.setEnabled(enabled);
+    applyQuality();
+}
+
+void GameEngine::pinQualityLevel(int level) {
+    quality.pin(level);
+    applyQuality();
+}
+
+void GameEngine::setQualityTarget(float frameMs, float engineBudgetMs) {
+    QualityGovernor::Settings settings = quality.getSettings();
+    if (frameMs > 0) settings.targetFrameMs = frameMs;
+    if (engineBudgetMs > 0) settings.engineBudgetMs = engineBudgetMs;
+    quality.setSettings(settings);
+}
+
+void GameEngine::setQualityLevelValues(int level, float particleDensity, float cullMarginScale,
+                                       int maxSubstepsCap) {
+    quality.setLevel(level, {std::clamp(particleDensity, 0.0f, 1.0f), std::max(0.0f, cullMarginScale),
+                             std::max(1, maxSubstepsCap)});
+    applyQuality();
+}
+
+// The cull margin and substep cap are read where they are used
+void GameEngine::applyQuality() {
+    visualEffects.setSpawnDensity(quality.values().particleDensity);
+}
+
+void GameEngine::setMaxParticles(int maxParticles, bool recycleOldest) {
+    visualEffects.setMaxParticles(maxParticles);
+    visualEffects.setDropPolicy(recycleOldest ? ParticleBuffer::DropPolicy::RECYCLE
+                                              : ParticleBuffer::DropPolicy::DROP_NEW);
 }
 
 void GameEngine::generateObstacles(int count) {
+    ApiCall call(*this);
+    record(InputLog::Op::GENERATE_OBSTACLES, 0, count);
     for (int i = 0; i < count; i++) {
-        float x = rand() % (int)worldWidth;
-        float y = rand() % (int)worldHeight;
+        float x = Sim::randomInt((int)worldWidth);
+        float y = Sim::randomInt((int)worldHeight);
         float radius = Config::OBSTACLE_MIN_RADIUS + 
-                      rand() % (int)(Config::OBSTACLE_MAX_RADIUS - Config::OBSTACLE_MIN_RADIUS);
+                      Sim::randomInt((int)(Config::OBSTACLE_MAX_RADIUS - Config::OBSTACLE_MIN_RADIUS));
         
         // Make sure not too close to player spawn
         Vector2 center(worldWidth / 2, worldHeight / 2);
         Vector2 pos(x, y);
         if ((pos - center).magnitude() > radius + Config::PLAYER_RADIUS + 100) {
-            createObstacle(x, y, radius, rand() % 100 < 30); // 30% chance of destructible
+            createObstacle(x, y, radius, Sim::randomInt(100) < 30); // 30% chance of destructible
         }
     }
 }
 
+// Blue-noise layout with clusters (systems/obstacle_generator.h). With
+// ensurePlayability every obstacle keeps a passage clear of its neighbours
+// and the world edge; without it they may touch. Obstacles go straight into
+// the static layer, and the obstacle index and flow field rebuild once.
 void GameEngine::generateEnhancedObstacles(int count, bool ensurePlayability) {
-    // Clear any existing obstacles first (optional)
-    // entities.erase(std::remove_if(entities.begin(), entities.end(),
-    //     [](const std::unique_ptr<Entity>& e) {
-    //         return e && e->type == EntityType::OBSTACLE;
-    //     }), entities.end());
-    
-    // Create a grid to track obstacle density for playability
-    const int gridSize = 100; // Size of each grid cell
-    int gridWidth = (worldWidth + gridSize - 1) / gridSize;
-    int gridHeight = (worldHeight + gridSize - 1) / gridSize;
-    std::vector<std::vector<int>> obstacleGrid(gridHeight, std::vector<int>(gridWidth, 0));
-    
-    // Safe zones around spawn points
-    Vector2 playerSpawn(worldWidth / 2, worldHeight / 2);
-    float safeRadius = 150.0f;
-    
-    // Generate obstacles with various shapes and clustering
-    int obstaclesCreated = 0;
-    int attempts = 0;
-    const int maxAttempts = count * 3; // Prevent infinite loops
-    
-    while (obstaclesCreated < count && attempts < maxAttempts) {
-        attempts++;
-        
-        // Randomly decide on obstacle type and clustering
-        int obstacleType = rand() % 100;
-        bool createCluster = (rand() % 100) < 40; // 40% chance of clustering
-        
-        // Generate base position
-        float baseX = 50 + rand() % (int)(worldWidth - 100);
-        float baseY = 50 + rand() % (int)(worldHeight - 100);
-        Vector2 basePos(baseX, baseY);
-        
-        // Check if too close to player spawn
-        if ((basePos - playerSpawn).magnitude() < safeRadius) {
-            continue;
-        }
-        
-        // Check grid density for playability
-        int gridX = baseX / gridSize;
-        int gridY = baseY / gridSize;
-        if (ensurePlayability && obstacleGrid[gridY][gridX] >= 2) {
-            continue; // Too many obstacles in this grid cell
-        }
-        
-        if (createCluster) {
-            // Create a cluster of 2-4 obstacles that can join to form complex shapes
-            int clusterSize = 2 + rand() % 3;
-            float clusterRadius = 80.0f;
-            
-            for (int j = 0; j < clusterSize && obstaclesCreated < count; j++) {
-                float angle = (j * 2 * M_PI) / clusterSize + (rand() % 100) * 0.01f;
-                float distance = (rand() % 50) + 20;
-                float x = baseX + cos(angle) * distance;
-                float y = baseY + sin(angle) * distance;
-                
-                // Keep within world bounds
-                x = std::max(30.0f, std::min(x, worldWidth - 30.0f));
-                y = std::max(30.0f, std::min(y, worldHeight - 30.0f));
-                
-                // Choose shape for this cluster member
-                int shapeChoice = rand() % 3;
-                bool destructible = (rand() % 100) < 25; // 25% chance of destructible
-                
-                if (shapeChoice == 0) {
-                    // Circle
-                    float radius = Config::OBSTACLE_MIN_RADIUS + 
-                                 rand() % (int)(Config::OBSTACLE_MAX_RADIUS - Config::OBSTACLE_MIN_RADIUS);
-                    createObstacle(x, y, radius, destructible);
-                } else if (shapeChoice == 1) {
-                    // Square
-                    float size = Config::OBSTACLE_MIN_RADIUS * 2 + 
-                               rand() % (int)((Config::OBSTACLE_MAX_RADIUS - Config::OBSTACLE_MIN_RADIUS) * 2);
-                    float rotation = (rand() % 4) * M_PI / 4; // 0, 45, 90, or 135 degrees
-                    createShapedObstacle(x, y, 1, size, size, rotation, destructible);
-                } else {
-                    // Rectangle
-                    float width = Config::OBSTACLE_MIN_RADIUS * 2 + 
-                                rand() % (int)((Config::OBSTACLE_MAX_RADIUS - Config::OBSTACLE_MIN_RADIUS) * 2);
-                    float height = Config::OBSTACLE_MIN_RADIUS * 2 + 
-                                 rand() % (int)((Config::OBSTACLE_MAX_RADIUS - Config::OBSTACLE_MIN_RADIUS) * 2);
-                    float rotation = (rand() % 360) * M_PI / 180.0f;
-                    createShapedObstacle(x, y, 2, width, height, rotation, destructible);
-                }
-                
-                obstaclesCreated++;
-                
-                // Update grid
-                int gx = x / gridSize;
-                int gy = y / gridSize;
-                if (gx >= 0 && gx < gridWidth && gy >= 0 && gy < gridHeight) {
-                    obstacleGrid[gy][gx]++;
-                }
-            }
-        } else {
-            // Create single obstacle
-            bool destructible = (rand() % 100) < 30; // 30% chance of destructible
-            
-            if (obstacleType < 33) {
-                // Circle (33% chance)
-                float radius = Config::OBSTACLE_MIN_RADIUS + 
-                             rand() % (int)(Config::OBSTACLE_MAX_RADIUS - Config::OBSTACLE_MIN_RADIUS);
-                createObstacle(baseX, baseY, radius, destructible);
-            } else if (obstacleType < 66) {
-                // Square (33% chance)
-                float size = Config::OBSTACLE_MIN_RADIUS * 1.5f + 
-                           rand() % (int)((Config::OBSTACLE_MAX_RADIUS - Config::OBSTACLE_MIN_RADIUS) * 1.5f);
-                float rotation = (rand() % 8) * M_PI / 4; // 45-degree increments
-                createShapedObstacle(baseX, baseY, 1, size, size, rotation, destructible);
-            } else {
-                // Rectangle (34% chance)
-                float width = Config::OBSTACLE_MIN_RADIUS * 1.5f + 
-                            rand() % (int)((Config::OBSTACLE_MAX_RADIUS - Config::OBSTACLE_MIN_RADIUS) * 2);
-                float height = Config::OBSTACLE_MIN_RADIUS * 1.5f + 
-                             rand() % (int)((Config::OBSTACLE_MAX_RADIUS - Config::OBSTACLE_MIN_RADIUS) * 2);
-                float rotation = (rand() % 360) * M_PI / 180.0f;
-                createShapedObstacle(baseX, baseY, 2, width, height, rotation, destructible);
-            }
-            
-            obstaclesCreated++;
-            obstacleGrid[gridY][gridX]++;
-        }
-    }
+    ApiCall call(*this);
+    record(InputLog::Op::GENERATE_ENHANCED_OBSTACLES, 0, count, 0, 0, 0, 0, 0, ensurePlayability);
     
-    // If ensurePlayability is true, verify that there's a clear path from spawn to edges
-    if (ensurePlayability) {
-        // Simple check: ensure there aren't too many obstacles in any row/column
-        for (int i = 0; i < gridHeight; i++) {
-            int rowCount = 0;
-            for (int j = 0; j < gridWidth; j++) {
-                rowCount += obstacleGrid[i][j];
-            }
-            // If a row is too blocked, remove some obstacles
-            if (rowCount > gridWidth * 0.6) {
-                // This row is too blocked, we should clear some space
-                // In a real implementation, we'd selectively remove obstacles
-            }
-        }
+    ObstacleGenerator::Params params;
+    params.worldWidth = worldWidth;
+    params.worldHeight = worldHeight;
+    params.safeCenter = Vector2(worldWidth / 2, worldHeight / 2);
+    params.safeRadius = Config::OBSTACLE_SPAWN_CLEARANCE;
+    params.gap = ensurePlayability ? Config::OBSTACLE_PASSAGE_WIDTH : 0.0f;
+    params.count = count;
+    
+    int placed = ObstacleGenerator::generate(params, Sim::random(), &frameArena,
+        [this](const ObstacleGenerator::Placement& p) { placeObstacle(p); });
+    if (placed > 0) {
+        obstacleIndex.markDirty();
+        flowField.markDirty();
     }
 }
 
+void GameEngine::placeObstacle(const ObstacleGenerator::Placement& p) {
+    bool circle = p.shape == static_cast<int>(ObstacleShape::CIRCLE);
+    std::unique_ptr<Obstacle> obstacle = circle
+        ? std::make_unique<Obstacle>(Vector2(p.x, p.y), p.width * 0.5f, p.destructible)
+        : std::make_unique<Obstacle>(Vector2(p.x, p.y), static_cast<ObstacleShape>(p.shape),
+                                     p.width, p.height, p.rotation, p.destructible);
+    adoptEntity(std::move(obstacle));
+}
+
 void GameEngine::clearEntities() {
+    ApiCall call(*this);
+    record(InputLog::Op::CLEAR_ENTITIES);
     entities.clear();
+    dynamicCount = 0;
+    entityHandles.releaseAll();
+    entityCounts.clear();
+    obstacleIndex.markDirty();
+    flowField.markDirty();
     player = nullptr;
+    playerIntent = PlayerIntent();
     visualEffects.clear();
+    visibleIds.clear();
+    unculledIds.clear();
+    chunkManager.reset();
+#if ENGINE_FEATURE_TARGETING
+    targeting.reset();
+    targetCandidates.invalidate();
+#endif
+}
+
+void GameEngine::setUseEntityStore(bool enabled) {
+    ApiCall call(*this);
+    record(InputLog::Op::SET_ENTITY_STORE, 0, 0, 0, 0, 0, 0, 0, enabled);
+    useEntityStore = enabled;
+}
+
+void GameEngine::setUseFlowField(bool enabled) {
+    ApiCall call(*this);
+    record(InputLog::Op::SET_FLOW_FIELD, 0, 0, 0, 0, 0, 0, 0, enabled);
+    flowField.setEnabled(enabled);
+}
+
+#if ENGINE_FEATURE_TARGETING
+// Targeting
+void GameEngine::switchTarget(int direction) {
+    ApiCall call(*this);
+    record(InputLog::Op::SWITCH_TARGET, 0, direction);
+    if (player && player->active) {
+        targeting.switchTarget(direction, queryTargetCandidates(*player));
+    }
+}
+
+void GameEngine::enableTargeting() {
+    ApiCall call(*this);
+    record(InputLog::Op::SET_TARGETING, 0, 0, 0, 0, 0, 0, 0, true);
+    targeting.enable();
+}
+
+// duration in seconds
+void GameEngine::disableTargeting(float duration) {
+    ApiCall call(*this);
+    record(InputLog::Op::SET_TARGETING, 0, 0, duration);
+    targeting.disable(duration);
+}
+
+// pressDuration in milliseconds: quick presses switch target (or re-arm a
+// lock dropped for range), long presses suspend targeting
+void GameEngine::handleTargetingButton(float pressDuration) {
+    ApiCall call(*this);
+    record(InputLog::Op::TARGET_BUTTON, 0, 0, pressDuration);
+    targeting.press(pressDuration, player,
+                    [this]() -> const TargetCandidates::List& { return queryTargetCandidates(*player); });
+}
+
+void GameEngine::onTargetButtonTouchStart(float x, float y, int touchId) {
+    SimContext::Scope scope(simContext);
+    targeting.touchStart(x, y, touchId);
+}
+
+// The press is recorded as its duration, so replays need no touch events
+void GameEngine::onTargetButtonTouchEnd(int touchId) {
+    float pressDuration;
+    {
+        SimContext::Scope scope(simContext);
+        pressDuration = targeting.touchEnd(touchId);
+    }
+    if (pressDuration >= 0) {
+        handleTargetingButton(pressDuration);
+    }
+}
+
+void GameEngine::setTargetButtonPosition(float x, float y) {
+    targeting.getButton().x = x;
+    targeting.getButton().y = y;
+}
+
+// Entities adopted since the last gather are in unculledIds, which the
+// collision pass clears when it rebuilds the grid the gather reads
+const TargetCandidates::List& GameEngine::queryTargetCandidates(const Entity& from) {
+    return targetCandidates.query(from, entities, dynamicCount, unculledIds,
+                                  [this](int id) { return findEntityById(id); });
+}
+
+int GameEngine::getCurrentTargetId() {
+    Entity* target = findEntityById(targeting.getTargetId());
+    return target && target->active ? target->id : -1;
+}
+#endif
+
+// Determinism and replay
+void GameEngine::record(InputLog::Op op, int id, int arg, float v0, float v1,
+                        float v2, float v3, float v4, bool flag) {
+    if (apiDepth != 1 || !inputLog.isRecording()) return;
+    InputLog::Record entry = {frameNumber, id, arg, {v0, v1, v2, v3, v4}, op,
+                              static_cast<uint8_t>(flag ? 1 : 0), 0};
+    inputLog.append(entry);
+}
+
+void GameEngine::setSeed(uint32_t newSeed) {
+    seed = newSeed;
+    simContext.reset(newSeed);
+    chunkManager.setWorldSeed(newSeed);
+}
+
+// Back to a fresh engine's state, so ids, waves and the random stream all
+// start from the same point on record and on replay
+void GameEngine::resetSession(uint32_t newSeed) {
+    clearEntities();
+    entityHandles = HandleTable();
+    if (useChunkedWorld) {
+        useChunkedWorld = false;
+        collisionSystem.setWorldBounds(worldWidth, worldHeight);
+        flowField.setWorldBounds(worldWidth, worldHeight);
+        stimuli.setWorldBounds(worldWidth, worldHeight, Config::STIMULUS_CELL_SIZE);
+    }
+    setSeed(newSeed);
+    waveSystem = WaveSystem();
+    waveSystem.setFrameArena(&frameArena);
+    stimuli.clear();
+    rollback.clear();
+    gameState = GameState::MENU;
+    frameNumber = 0;
+    score = 0;
+    accumulator = 0;
+    interpolationAlpha = 0;
+    droppedTime = 0;
+}
+
+void GameEngine::startRecording(uint32_t newSeed) {
+    resetSession(newSeed);
+    inputLog.begin(seed, worldWidth, worldHeight, useEntityStore, flowField.isEnabled());
+}
+
+void GameEngine::stopRecording() {
+    inputLog.finish(stateChecksum(), frameNumber);
+    inputLog.serialize();
 }
 
-// JavaScript interface
-emscripten::val GameEngine::getEntityPositions() {
-    emscripten::val result = emscripten::val::array();
-    int index = 0;
+// FNV-1a over the gameplay-relevant state. Bit patterns, not values, so any
+// divergence in float math shows up.
+uint32_t GameEngine::stateChecksum() const {
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            hash ^= (value >> (i * 8)) & 0xFF;
+            hash *= 16777619u;
+        }
+    };
+    auto mixFloat = [&mix](float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        mix(bits);
+    };
     
+    mix(frameNumber);
+    mix(static_cast<uint32_t>(score));
+    mix(static_cast<uint32_t>(entities.size()));
     for (const auto& entity : entities) {
-        if (entity && entity->active) {
-            emscripten::val entityData = emscripten::val::object();
-            entityData.set("id", entity->id);
-            entityData.set("type", static_cast<int>(entity->type));
-            entityData.set("x", entity->position.x);
-            entityData.set("y", entity->position.y);
-            entityData.set("vx", entity->velocity.x);
-            entityData.set("vy", entity->velocity.y);
-            entityData.set("rotation", entity->rotation);
-            entityData.set("radius", entity->radius);
-            entityData.set("health", entity->health);
-            entityData.set("maxHealth", entity->maxHealth);
-            result.set(index++, entityData);
+        mix(static_cast<uint32_t>(entity->id));
+        mix(static_cast<uint32_t>(entity->type));
+        mix(entity->active ? 1u : 0u);
+        mixFloat(entity->position.x);
+        mixFloat(entity->position.y);
+        mixFloat(entity->velocity.x);
+        mixFloat(entity->velocity.y);
+        mixFloat(entity->health);
+    }
+    return hash;
+}
+
+void GameEngine::applyRecord(const InputLog::Record& record) {
+    using Op = InputLog::Op;
+    const float* v = record.v;
+    switch (record.op) {
+        case Op::STEP: {
+            ApiCall call(*this);
+            gameplayEvents.clear();
+            runTick(v[0]);
+            frameArena.reset();
+            break;
         }
+        case Op::PLAYER_INPUT: updatePlayerInput(v[0], v[1], v[2], v[3]); break;
+        case Op::PLAYER_SHOOT: playerShoot(v[0], v[1]); break;
+        case Op::BOOST_ON: activateBoost(record.id); break;
+        case Op::BOOST_OFF: deactivateBoost(record.id); break;
+        case Op::BLOCK_START: startBlock(record.id); break;
+        case Op::BLOCK_END: endBlock(record.id); break;
+        case Op::ATTACK: performAttack(record.id, v[0]); break;
+        case Op::ROLL: performRoll(record.id, v[0], v[1]); break;
+        case Op::CREATE_PLAYER: createPlayer(v[0], v[1]); break;
+        case Op::CREATE_ENEMY: createEnemy(v[0], v[1]); break;
+        case Op::CREATE_WOLF: createWolf(v[0], v[1], record.flag != 0); break;
+        case Op::CREATE_PROJECTILE: createProjectile(v[0], v[1], v[2], v[3], v[4], record.arg); break;
+        case Op::CREATE_POWERUP: createPowerUp(v[0], v[1], record.arg); break;
+        case Op::CREATE_OBSTACLE: createObstacle(v[0], v[1], v[2], record.flag != 0); break;
+        case Op::CREATE_SHAPED_OBSTACLE:
+            createShapedObstacle(v[0], v[1], record.arg, v[2], v[3], v[4], record.flag != 0);
+            break;
+        case Op::REMOVE_ENTITY: removeEntity(record.id); break;
+        case Op::GENERATE_OBSTACLES: generateObstacles(record.arg); break;
+        case Op::GENERATE_ENHANCED_OBSTACLES: generateEnhancedObstacles(record.arg, record.flag != 0); break;
+        case Op::CLEAR_ENTITIES: clearEntities(); break;
+        case Op::START_GAME: startGame(); break;
+        case Op::PAUSE_GAME: pauseGame(); break;
+        case Op::RESUME_GAME: resumeGame(); break;
+        case Op::END_GAME: endGame(); break;
+        case Op::RESTART_GAME: restartGame(); break;
+        case Op::SET_WORLD_BOUNDS: setWorldBounds(v[0], v[1]); break;
+        case Op::SET_ENTITY_STORE: setUseEntityStore(record.flag != 0); break;
+        case Op::SET_FLOW_FIELD: setUseFlowField(record.flag != 0); break;
+        case Op::SPECIAL_ABILITY: playerSpecialAbility(); break;
+        case Op::SET_CHUNKED_WORLD: setChunkedWorld(record.flag != 0, v[0], record.arg); break;
+#if ENGINE_FEATURE_TARGETING
+        case Op::SWITCH_TARGET: switchTarget(record.arg); break;
+        case Op::SET_TARGETING:
+            if (record.flag) enableTargeting(); else disableTargeting(v[0]);
+            break;
+        case Op::TARGET_BUTTON: handleTargetingButton(v[0]); break;
+#else
+        // Recorded by a build with targeting; nothing to apply here
+        case Op::SWITCH_TARGET:
+        case Op::SET_TARGETING:
+        case Op::TARGET_BUTTON:
+            break;
+#endif
+    }
+}
+
+// Re-simulate a log on a fresh, single-threaded engine. STEP records run the
+// tick directly instead of going through update(), so the replay runs as fast
+// as the simulation allows.
+GameEngine::ReplayResult GameEngine::runReplay(const InputLog& log) {
+    const InputLog::Header& header = log.header();
+    ReplayResult result = {false, false, false, 0, 0, 0, header.finalChecksum};
+    if (header.magic != InputLog::MAGIC) return result;
+    result.loaded = true;
+    result.complete = header.complete != 0;
+    
+    GameEngine engine(header.worldWidth, header.worldHeight, 0);
+    engine.resetSession(header.seed);
+    engine.useEntityStore = header.useEntityStore != 0;
+    engine.flowField.setEnabled(header.useFlowField != 0);
+    
+    double start = Platform::now();
+    for (const InputLog::Record& record : log.getRecords()) {
+        engine.applyRecord(record);
+        if (record.op == InputLog::Op::STEP) result.ticks++;
     }
+    result.elapsedMs = Platform::now() - start;
     
+    result.checksum = engine.stateChecksum();
+    result.matches = result.complete && result.checksum == header.finalChecksum &&
+                     engine.frameNumber == header.finalTick;
     return result;
 }
 
-emscripten::val GameEngine::getPlayerState() {
-    if (!player || !player->active) {
-        return emscripten::val::null();
-    }
-    
-    emscripten::val state = emscripten::val::object();
-    state.set("id", player->id);
-    state.set("x", player->position.x);
-    state.set("y", player->position.y);
-    state.set("vx", player->velocity.x);
-    state.set("vy", player->velocity.y);
-    state.set("health", player->health);
-    state.set("maxHealth", player->maxHealth);
-    state.set("energy", player->energy);
-    state.set("maxEnergy", player->maxEnergy);
-    state.set("invulnerable", player->invulnerable);
-    state.set("boosting", player->boosting);
-    state.set("boostCooldown", player->boostCooldown);
-    state.set("blocking", player->blocking);
-    state.set("blockCooldown", player->blockCooldown);
-    state.set("perfectParryWindow", player->perfectParryWindow);
-    state.set("attacking", player->attacking);
-    state.set("rolling", player->rolling);
-    state.set("score", player->score);
-    state.set("lives", player->lives);
-    state.set("kills", player->kills);
-    
-    return state;
-}
-
-emscripten::val GameEngine::getGameState() {
-    emscripten::val state = emscripten::val::object();
-    state.set("state", static_cast<int>(gameState));
-    state.set("score", score);
-    state.set("highScore", highScore);
-    state.set("wave", waveSystem.getCurrentWave());
-    
-    return state;
-}
-
-emscripten::val GameEngine::getPerformanceMetrics() {
-    emscripten::val metrics = emscripten::val::object();
-    metrics.set("physicsTime", physicsTime);
-    metrics.set("collisionTime", collisionTime);
-    metrics.set("collisionChecks", collisionChecks);
-    metrics.set("entityCount", static_cast<int>(entities.size()));
-    metrics.set("activeEntities", static_cast<int>(
-        std::count_if(entities.begin(), entities.end(),
-            [](const std::unique_ptr<Entity>& e) { return e && e->active; })
-    ));
-    
-    return metrics;
-}
-
-emscripten::val GameEngine::getVisualEffects() {
-    emscripten::val effects = emscripten::val::object();
-    
-    // Screen shake
-    Vector2 shake = visualEffects.getScreenShakeOffset();
-    effects.set("screenShakeX", shake.x);
-    effects.set("screenShakeY", shake.y);
-    
-    // Particles
-    emscripten::val particles = emscripten::val::array();
-    int index = 0;
-    
-    for (const auto& particle : visualEffects.getParticles()) {
-        if (particle && particle->active) {
-            emscripten::val p = emscripten::val::object();
-            p.set("x", particle->position.x);
-            p.set("y", particle->position.y);
-            p.set("vx", particle->velocity.x);
-            p.set("vy", particle->velocity.y);
-            p.set("size", particle->getSize());
-            p.set("alpha", particle->getAlpha());
-            p.set("color", particle->color);
-            particles.set(index++, p);
+// Rollback
+namespace {
+    // Globals at the head of every world save
+    struct WorldHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint8_t gameState;
+        uint8_t reserved;
+        uint32_t frameNumber;
+        int32_t score;
+        int32_t highScore;
+        int32_t playerId;
+        uint32_t entityCount;
+        uint32_t dynamicCount;
+    };
+}
+
+void GameEngine::setRollbackDepth(int ticks) {
+    rollback.setDepth(std::min(std::max(ticks, 0), Config::ROLLBACK_MAX_DEPTH));
+}
+
+bool GameEngine::saveRollbackState() {
+    if (!rollbackAllowed()) return false;
+    saveWorld(rollback.beginSave(frameNumber));
+    return true;
+}
+
+bool GameEngine::rollbackTo(uint32_t frame) {
+    if (!rollbackAllowed()) return false;
+    const std::vector<uint8_t>* block = rollback.find(frame);
+    if (!block) return false;
+    ApiCall call(*this);
+    if (!restoreWorld(*block)) return false;
+    rollback.discardAfter(frame);
+    return true;
+}
+
+// Fixed ticks straight through runTick, as a replay runs them; the caller
+// applies each tick's input in between by resimulating one tick at a time
+int GameEngine::resimulate(int ticks) {
+    ApiCall call(*this);
+    TRACE_ZONE("rollback.resimulate");
+    gameplayEvents.clear();
+    int ran = 0;
+    while (ran < ticks && gameState == GameState::PLAYING) {
+        runTick(fixedTimestep);
+        frameArena.reset();
+        ran++;
+    }
+    return ran;
+}
+
+int GameEngine::getOldestRollbackFrame() const {
+    uint32_t oldest = 0, newest = 0;
+    return rollback.frameRange(oldest, newest) ? static_cast<int>(oldest) : -1;
+}
+
+void GameEngine::saveWorld(std::vector<uint8_t>& block) const {
+    TRACE_ZONE("rollback.save");
+    RollbackBuffer::Writer out(block);
+    WorldHeader header = {RollbackBuffer::MAGIC, RollbackBuffer::VERSION,
+                          static_cast<uint8_t>(gameState), 0, frameNumber, score, highScore,
+                          player ? player->id : HandleTable::NULL_HANDLE,
+                          static_cast<uint32_t>(entities.size()), static_cast<uint32_t>(dynamicCount)};
+    out.put(header);
+    out.put(simContext);
+    out.put(playerIntent);
+    out.put(waveSystem);
+    out.put(visualEffects.getShakeState());
+#if ENGINE_FEATURE_TARGETING
+    out.put(targeting);
+#endif
+    // Noise emitted during the saved tick is heard in the next one
+    const std::vector<Stimulus>& pendingStimuli = stimuli.getPending();
+    out.put(static_cast<uint32_t>(pendingStimuli.size()));
+    out.putArray(pendingStimuli.data(), pendingStimuli.size());
+    RollbackBuffer::EntityRecord record;
+    for (const auto& entity : entities) {
+        record.capture(*entity);
+        out.put(record);
+    }
+    entityHandles.saveState(out);
+}
+
+bool GameEngine::restoreWorld(const std::vector<uint8_t>& block) {
+    TRACE_ZONE("rollback.restore");
+    RollbackBuffer::Reader in(block.data(), block.size());
+    WorldHeader header;
+    if (!in.get(header) || header.magic != RollbackBuffer::MAGIC ||
+        header.version != RollbackBuffer::VERSION) {
+        return false;
+    }
+    SimContext savedContext;
+    PlayerIntent savedIntent;
+    WaveSystem savedWaves;
+    VisualEffects::ShakeState savedShake;
+    in.get(savedContext);
+    in.get(savedIntent);
+    in.get(savedWaves);
+    in.get(savedShake);
+#if ENGINE_FEATURE_TARGETING
+    TargetingSystem savedTargeting;
+    in.get(savedTargeting);
+#endif
+    uint32_t stimulusCount = 0;
+    in.get(stimulusCount);
+    if (!in.ok() || stimulusCount > block.size() / sizeof(Stimulus)) return false;
+    rollbackStimuli.resize(stimulusCount);
+    in.getArray(rollbackStimuli.data(), rollbackStimuli.size());
+    rollbackRecords.resize(header.entityCount);
+    in.getArray(rollbackRecords.data(), rollbackRecords.size());
+    if (!rollbackHandles.loadState(in) || !in.ok()) return false;
+    
+    // Park the live entities by handle slot; a record whose entity is still
+    // around is written back into it, the rest are rebuilt
+    size_t staticBefore = entities.size() - dynamicCount;
+    rollbackRecycle.resize(entityHandles.capacity());
+    for (auto& entity : entities) {
+        rollbackRecycle[static_cast<uint32_t>(entity->id) & HandleTable::INDEX_MASK] = std::move(entity);
+    }
+    entities.clear();
+    entityCounts.clear();
+    
+    size_t staticKept = 0;
+    bool staticRebuilt = false;
+    for (const RollbackBuffer::EntityRecord& record : rollbackRecords) {
+        EntityType type = static_cast<EntityType>(record.type);
+        uint32_t slot = static_cast<uint32_t>(record.id) & HandleTable::INDEX_MASK;
+        std::unique_ptr<Entity> entity;
+        if (slot < rollbackRecycle.size() && rollbackRecycle[slot] &&
+            rollbackRecycle[slot]->id == record.id && rollbackRecycle[slot]->type == type) {
+            entity = std::move(rollbackRecycle[slot]);
+            if (Entity::isStaticType(type)) staticKept++;
+        } else {
+            entity = record.instantiate();
+            if (Entity::isStaticType(type)) staticRebuilt = true;
         }
+        record.apply(*entity);
+        entityCounts.add(type);
+        entities.push_back(std::move(entity));
     }
+    // Whatever was created after the save goes now
+    rollbackRecycle.clear();
+    
+    dynamicCount = header.dynamicCount;
+    entityHandles = rollbackHandles;
+    simContext = savedContext;
+    playerIntent = savedIntent;
+    waveSystem = savedWaves;
+    visualEffects.setShakeState(savedShake);
+#if ENGINE_FEATURE_TARGETING
+    targeting = savedTargeting;
+    targetCandidates.invalidate();
+#endif
+    stimuli.setPending(rollbackStimuli.data(), rollbackStimuli.size());
+    gameState = static_cast<GameState>(header.gameState);
+    frameNumber = header.frameNumber;
+    score = header.score;
+    highScore = header.highScore;
+    Entity* savedPlayer = findEntityById(header.playerId);
+    player = savedPlayer && savedPlayer->type == EntityType::PLAYER ? static_cast<Player*>(savedPlayer) : nullptr;
     
-    effects.set("particles", particles);
+    // Links between entities, now that every one is back under its id
+    for (size_t i = 0; i < dynamicCount; i++) {
+        Entity* entity = entities[i].get();
+        if (entity->type != EntityType::ENEMY && entity->type != EntityType::WOLF) continue;
+        const RollbackBuffer::EntityRecord::EnemyPart& saved = rollbackRecords[i].enemy;
+        Enemy* enemy = static_cast<Enemy*>(entity);
+        enemy->target = findEntityById(saved.targetId);
+        enemy->flowField = saved.followsFlowField ? &flowField : nullptr;
+        if (entity->type == EntityType::WOLF) {
+            // Handed out together with the flow field
+            static_cast<Wolf*>(entity)->stimuli = enemy->flowField ? &stimuli : nullptr;
+        }
+    }
     
-    return effects;
+    // The static layer only needs re-indexing when its objects changed
+    if (staticRebuilt || staticKept != staticBefore) {
+        obstacleIndex.markDirty();
+        flowField.markDirty();
+    }
+    // The render export tests every dynamic entity until the next tick
+    visibleIds.clear();
+    unculledIds.clear();
+    for (size_t i = 0; i < dynamicCount; i++) {
+        unculledIds.push_back(entities[i]->id);
+    }
+    return true;
 }
 
-emscripten::val GameEngine::getWaveInfo() {
-    emscripten::val info = emscripten::val::object();
-    info.set("currentWave", waveSystem.getCurrentWave());
-    info.set("waveActive", waveSystem.isWaveActive());
-    info.set("transitionTimer", waveSystem.getWaveTransitionTimer());
-    info.set("enemiesRemaining", waveSystem.getEnemiesRemaining());
-    info.set("wolvesRemaining", waveSystem.getWolvesRemaining());
+int GameEngine::packRenderState() {
+    TRACE_ZONE("export.renderState");
+    PERF_TIMER(RENDER_EXPORT);
+    HEAP_SCOPE(EXPORTS);
+    gatherRenderSet();
+    
+    // Group records by type so JS can batch draws per type
+    int32_t offsets[RenderLayout::TYPE_COUNT];
+    std::fill(renderTypeCounts, renderTypeCounts + RenderLayout::TYPE_COUNT, 0);
+    for (const Entity* entity : renderScratch) {
+        renderTypeCounts[static_cast<int>(entity->type)]++;
+    }
+    int32_t running = 0;
+    for (int t = 0; t < RenderLayout::TYPE_COUNT; t++) {
+        offsets[t] = running;
+        running += renderTypeCounts[t];
+    }
+    
+    EntityRenderRecord* records = entityRenderBuffer.assign(renderScratch.size());
+    for (const Entity* entity : renderScratch) {
+        EntityRenderRecord& r = records[offsets[static_cast<int>(entity->type)]++];
+        r.id = entity->id;
+        r.type = static_cast<int32_t>(entity->type);
+        // Positions are blended between the last two fixed steps
+        r.x = entity->previousPosition.x + (entity->position.x - entity->previousPosition.x) * interpolationAlpha;
+        r.y = entity->previousPosition.y + (entity->position.y - entity->previousPosition.y) * interpolationAlpha;
+        r.vx = entity->velocity.x;
+        r.vy = entity->velocity.y;
+        r.rotation = entity->rotation;
+        r.radius = entity->radius;
+        r.health = entity->health;
+        r.maxHealth = entity->maxHealth;
+    }
     
-    return info;
+    const ParticleBuffer& particles = visualEffects.getParticles();
+    particleRenderBuffer.begin();
+#if ENGINE_FEATURE_CAMERA
+    bool cull = isRenderCulling();
+    float margin = effectiveCullMargin();
+    float left = camera.x - margin;
+    float top = camera.y - margin;
+    float right = camera.x + camera.width + margin;
+    float bottom = camera.y + camera.height + margin;
+#endif
+    for (size_t i = 0; i < particles.getCount(); i++) {
+#if ENGINE_FEATURE_CAMERA
+        if (cull && (particles.x[i] < left || particles.x[i] > right ||
+                     particles.y[i] < top || particles.y[i] > bottom)) {
+            continue;
+        }
+#endif
+        ParticleRenderRecord& r = particleRenderBuffer.push();
+        r.x = particles.x[i];
+        r.y = particles.y[i];
+        r.size = particles.getSize(i);
+        r.alpha = particles.getAlpha(i);
+        r.color = particles.color[i];
+    }
+    renderTypeCounts[static_cast<int>(EntityType::PARTICLE)] =
+        static_cast<int32_t>(particleRenderBuffer.size());
+    
+    return static_cast<int>(entityRenderBuffer.size());
+}
+
+// Dynamic entities on screen, from the grid the collision pass just built.
+// Runs before cleanup, while every pointer in the grid is still live.
+void GameEngine::captureVisibleSet() {
+#if ENGINE_FEATURE_CAMERA
+    TRACE_ZONE("cull.capture");
+    SpatialHashGrid& grid = collisionSystem.getSpatialGrid();
+    float margin = effectiveCullMargin();
+    grid.queryRect(camera.x - margin, camera.y - margin,
+                   camera.x + camera.width + margin, camera.y + camera.height + margin,
+                   cullScratch);
+    visibleIds.clear();
+    for (const Entity* entity : cullScratch) {
+        visibleIds.push_back(entity->id);
+    }
+#endif
+}
+
+// Entities to export: the culled set when culling, otherwise all active.
+// The culled set costs the visible ids, the few entities adopted since the
+// last tick and an obstacle index query.
+void GameEngine::gatherRenderSet() {
+    renderScratch.clear();
+#if ENGINE_FEATURE_CAMERA
+    if (isRenderCulling()) {
+        float margin = effectiveCullMargin();
+        float left = camera.x - margin;
+        float top = camera.y - margin;
+        float right = camera.x + camera.width + margin;
+        float bottom = camera.y + camera.height + margin;
+        auto consider = [&](int id) {
+            Entity* entity = findEntityById(id);
+            if (entity && entity->active &&
+                entity->position.x + entity->radius >= left && entity->position.x - entity->radius <= right &&
+                entity->position.y + entity->radius >= top && entity->position.y - entity->radius <= bottom) {
+                renderScratch.push_back(entity);
+            }
+        };
+        for (int id : visibleIds) consider(id);
+        for (int id : unculledIds) consider(id);
+        
+        getObstacleIndex().queryBounds(left, top, right, bottom, cullScratch);
+        for (Entity* obstacle : cullScratch) {
+            if (obstacle->active) renderScratch.push_back(obstacle);
+        }
+        return;
+    }
+#endif
+    for (const auto& entity : entities) {
+        if (entity && entity->active) {
+            renderScratch.push_back(entity.get());
+        }
+    }
 }
 
 // Private methods
 Entity* GameEngine::findEntityById(int id) {
-    auto it = std::find_if(entities.begin(), entities.end(),
-        [id](const std::unique_ptr<Entity>& e) {
-            return e && e->id == id;
-        });
-    
-    return (it != entities.end()) ? it->get() : nullptr;
+    uint32_t index = entityHandles.resolve(id);
+    return index != HandleTable::INVALID_INDEX ? entities[index].get() : nullptr;
+}
+
+// Side effects of one pass, in the order they happened: particles and shake,
+// then score for kills credited to a player and for pickups
+void GameEngine::applyGameplayEvents(size_t from) {
+    using Type = GameplayEvent::Type;
+    for (size_t i = from; i < gameplayEvents.size(); i++) {
+        const GameplayEvent& event = gameplayEvents[i];
+        visualEffects.playEvent(event);
+        if (event.type == Type::KILL) {
+            if (Player* killer = findPlayer(event.sourceId)) {
+                killer->score += Config::SCORE_PER_KILL;
+                killer->kills++;
+                score += Config::SCORE_PER_KILL;
+            }
+        } else if (event.type == Type::PICKUP) {
+            if (Player* picker = findPlayer(event.sourceId)) {
+                picker->score += Config::SCORE_PER_POWERUP;
+            }
+        } else if (event.type == Type::OBSTACLE_DESTROYED) {
+            stimuli.emit(Stimulus::Kind::OBSTACLE_DESTROYED, event.x, event.y,
+                         Config::STIMULUS_OBSTACLE_RADIUS, 2.0f, event.sourceId);
+        }
+    }
 }
 
 void GameEngine::updateEntityTargets() {
-    for (auto& entity : entities) {
+    for (size_t i = 0; i < dynamicCount; i++) {
+        Entity* entity = entities[i].get();
         if (!entity || !entity->active) continue;
         
         if (entity->type == EntityType::ENEMY || entity->type == EntityType::WOLF) {
-            Enemy* enemy = static_cast<Enemy*>(entity.get());
+            Enemy* enemy = static_cast<Enemy*>(entity);
+            enemy->setFlowField(&flowField);
+            if (entity->type == EntityType::WOLF) {
+                static_cast<Wolf*>(entity)->setStimuli(&stimuli);
+            }
             if (!enemy->target && player && player->active) {
                 enemy->setTarget(player);
             }
@@ -715,77 +1698,59 @@ void GameEngine::updateEntityTargets() {
     }
 }
 
+// The player's movement noise: sprinting, or louder while boosting or
+// rolling. Shots and attacks are emitted where they happen.
+void GameEngine::emitPlayerStimuli() {
+    if (!player || !player->active) return;
+    bool loud = player->boosting || player->rolling;
+    if (!loud && player->velocity.magnitude() <= Config::STIMULUS_SPRINT_SPEED) return;
+    stimuli.emit(Stimulus::Kind::MOVEMENT, player->position.x, player->position.y,
+                 Config::STIMULUS_SPRINT_RADIUS, loud ? 2.0f : 1.0f, player->id);
+}
+
 void GameEngine::cleanupInactiveEntities() {
-    // Check if player needs to be nullified before removing entities
-    for (const auto& entity : entities) {
-        if (entity && entity.get() == player && !entity->active) {
+    TRACE_ZONE("cleanup");
+    HEAP_SCOPE(ENTITIES);
+    // Swap-remove: the last entity of the layer fills the hole, so nothing
+    // is shifted
+    size_t i = 0;
+    while (i < dynamicCount) {
+        Entity* entity = entities[i].get();
+        if (entity->active) {
+            i++;
+            continue;
+        }
+        if (entity == player) {
             player = nullptr;
         }
+        swapRemoveEntity(i);
     }
     
-    entities.erase(
-        std::remove_if(entities.begin(), entities.end(),
-            [](const std::unique_ptr<Entity>& e) {
-                return !e || !e->active;
-            }),
-        entities.end()
-    );
+    // The static layer only changes when collision destroyed an obstacle
+    if (collisionSystem.getObstaclesDestroyed() == 0) return;
+    while (i < entities.size()) {
+        Entity* entity = entities[i].get();
+        if (entity->active) {
+            i++;
+            continue;
+        }
+        // A destroyed obstacle leaves the static index
+        obstacleIndex.markDirty();
+        flowField.removeObstacle(*static_cast<Obstacle*>(entity));
+        swapRemoveEntity(i);
+    }
 }
 
 bool GameEngine::isBlocking(int playerId) {
-    if (player && player->id == playerId) {
-        return player->blocking;
+    if (Player* actor = findPlayer(playerId)) {
+        return actor->blocking;
     }
     return false;
 }
 
 bool GameEngine::isPerfectParryWindow(int playerId) {
-    if (player && player->id == playerId) {
-        return player->perfectParryWindow;
+    if (Player* actor = findPlayer(playerId)) {
+        return actor->perfectParryWindow;
     }
     return false;
 }
-
-// Bindings for JavaScript
-using namespace emscripten;
-
-EMSCRIPTEN_BINDINGS(game_engine) {
-    class_<GameEngine>("GameEngine")
-        .constructor<float, float>()
-        .function("createPlayer", &GameEngine::createPlayer)
-        .function("createEnemy", &GameEngine::createEnemy)
-        .function("createWolf", &GameEngine::createWolf)
-        .function("createProjectile", &GameEngine::createProjectile)
-        .function("createPowerUp", &GameEngine::createPowerUp)
-        .function("createObstacle", &GameEngine::createObstacle)
-        .function("createShapedObstacle", &GameEngine::createShapedObstacle)
-        .function("removeEntity", &GameEngine::removeEntity)
-        .function("updatePlayerInput", &GameEngine::updatePlayerInput)
-        .function("playerShoot", &GameEngine::playerShoot)
-        .function("activateBoost", &GameEngine::activateBoost)
-        .function("deactivateBoost", &GameEngine::deactivateBoost)
-        .function("startBlock", &GameEngine::startBlock)
-        .function("endBlock", &GameEngine::endBlock)
-        .function("performAttack", &GameEngine::performAttack)
-        .function("performRoll", &GameEngine::performRoll)
-        .function("update", &GameEngine::update)
-        .function("startGame", &GameEngine::startGame)
-        .function("pauseGame", &GameEngine::pauseGame)
-        .function("resumeGame", &GameEngine::resumeGame)
-        .function("endGame", &GameEngine::endGame)
-        .function("restartGame", &GameEngine::restartGame)
-        .function("setWorldBounds", &GameEngine::setWorldBounds)
-        .function("generateObstacles", &GameEngine::generateObstacles)
-        .function("generateEnhancedObstacles", &GameEngine::generateEnhancedObstacles)
-        .function("clearEntities", &GameEngine::clearEntities)
-        .function("getEntityPositions", &GameEngine::getEntityPositions)
-        .function("getPlayerState", &GameEngine::getPlayerState)
-        .function("getGameState", &GameEngine::getGameState)
-        .function("getPerformanceMetrics", &GameEngine::getPerformanceMetrics)
-        .function("getVisualEffects", &GameEngine::getVisualEffects)
-        .function("getWaveInfo", &GameEngine::getWaveInfo)
-        .function("isBlocking", &GameEngine::isBlocking)
-        .function("isPerfectParryWindow", &GameEngine::isPerfectParryWindow)
-        .function("getScore", &GameEngine::getScore)
-        .function("getHighScore", &GameEngine::getHighScore);
-}
\ No newline at end of file
@@ -0,0 +1,487 @@
+#include "../include/game_engine.h"
+#include <emscripten/bind.h>
+#include <emscripten/val.h>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+// JavaScript interface: everything that builds emscripten::val lives here,
+// so game_engine.cpp (the simulation) also builds natively
+
+emscripten::val GameEngine::raycastObstacles(float x1, float y1, float x2, float y2) {
+    ObstacleIndex::RayHit hit;
+    if (!getObstacleIndex().raycast(Vector2(x1, y1), Vector2(x2, y2), hit)) {
+        return emscripten::val::null();
+    }
+    
+    emscripten::val result = emscripten::val::object();
+    result.set("id", hit.obstacle->id);
+    result.set("x", hit.point.x);
+    result.set("y", hit.point.y);
+    result.set("normalX", hit.normal.x);
+    result.set("normalY", hit.normal.y);
+    result.set("fraction", hit.t);
+    return result;
+}
+
+emscripten::val GameEngine::getEntityPositions() {
+    TRACE_ZONE("export.entityPositions");
+    HEAP_SCOPE(EXPORTS);
+    emscripten::val result = emscripten::val::array();
+    int index = 0;
+    
+    for (const auto& entity : entities) {
+        if (entity && entity->active) {
+            emscripten::val entityData = emscripten::val::object();
+            entityData.set("id", entity->id);
+            entityData.set("type", static_cast<int>(entity->type));
+            entityData.set("x", entity->position.x);
+            entityData.set("y", entity->position.y);
+            entityData.set("vx", entity->velocity.x);
+            entityData.set("vy", entity->velocity.y);
+            entityData.set("rotation", entity->rotation);
+            entityData.set("radius", entity->radius);
+            entityData.set("health", entity->health);
+            entityData.set("maxHealth", entity->maxHealth);
+            result.set(index++, entityData);
+        }
+    }
+    
+    return result;
+}
+
+emscripten::val GameEngine::getPlayerState() {
+    if (!player || !player->active) {
+        return emscripten::val::null();
+    }
+    
+    emscripten::val state = emscripten::val::object();
+    state.set("id", player->id);
+    state.set("x", player->position.x);
+    state.set("y", player->position.y);
+    state.set("vx", player->velocity.x);
+    state.set("vy", player->velocity.y);
+    state.set("health", player->health);
+    state.set("maxHealth", player->maxHealth);
+    state.set("energy", player->energy);
+    state.set("maxEnergy", player->maxEnergy);
+    state.set("invulnerable", player->invulnerable);
+    state.set("boosting", player->boosting);
+    state.set("boostCooldown", player->boostCooldown);
+    state.set("blocking", player->blocking);
+    state.set("blockCooldown", player->blockCooldown);
+    state.set("perfectParryWindow", player->perfectParryWindow);
+    state.set("attacking", player->attacking);
+    state.set("rolling", player->rolling);
+    state.set("score", player->score);
+    state.set("lives", player->lives);
+    state.set("kills", player->kills);
+    
+    return state;
+}
+
+emscripten::val GameEngine::getGameState() {
+    emscripten::val state = emscripten::val::object();
+    state.set("state", static_cast<int>(gameState));
+    state.set("score", score);
+    state.set("highScore", highScore);
+    state.set("wave", waveSystem.getCurrentWave());
+    
+    return state;
+}
+
+emscripten::val GameEngine::getPerformanceMetrics() {
+    emscripten::val metrics = emscripten::val::object();
+    metrics.set("physicsTime", physicsTime);
+    metrics.set("collisionTime", collisionTime);
+    metrics.set("collisionChecks", collisionChecks);
+    metrics.set("broadphaseCandidates", broadphaseCandidates);
+    metrics.set("narrowphaseHits", narrowphaseHits);
+    metrics.set("workerCount", jobSystem.getWorkerCount());
+    metrics.set("substeps", lastSubstepCount);
+    metrics.set("interpolationAlpha", interpolationAlpha);
+    metrics.set("droppedSimulationTime", droppedTime);
+    metrics.set("flowFieldRecomputes", flowField.getRecomputeCount());
+    metrics.set("flowFieldRepairs", flowField.getRepairCount());
+    metrics.set("frameArenaHighWater", static_cast<double>(frameArena.getHighWater()));
+    metrics.set("frameArenaCapacity", static_cast<double>(frameArena.getCapacity()));
+    metrics.set("frameArenaFallbacks", static_cast<int>(frameArena.getFallbackCount()));
+    Pools::exportStatistics(metrics);
+    metrics.set("entityCount", static_cast<int>(entities.size()));
+    // Cleanup has removed the dead by the end of every tick
+    metrics.set("activeEntities", entityCounts.getTotal());
+    metrics.set("enemyCount", entityCounts.of(EntityType::ENEMY));
+    metrics.set("wolfCount", entityCounts.of(EntityType::WOLF));
+    metrics.set("projectileCount", entityCounts.of(EntityType::PROJECTILE));
+    metrics.set("powerUpCount", entityCounts.of(EntityType::POWERUP));
+    metrics.set("obstacleCount", entityCounts.of(EntityType::OBSTACLE));
+    
+    return metrics;
+}
+
+emscripten::val GameEngine::getQualityStats() {
+    const QualityGovernor::Level& values = quality.values();
+    emscripten::val stats = emscripten::val::object();
+    stats.set("level", quality.current());
+    stats.set("pinned", quality.getPinned());
+    stats.set("adaptive", quality.isEnabled());
+    stats.set("frameMs", quality.getLastFrameMs());
+    stats.set("engineMs", quality.getLastEngineMs());
+    stats.set("changes", quality.getChangeCount());
+    stats.set("particleDensity", values.particleDensity);
+    stats.set("cullMargin", effectiveCullMargin());
+    stats.set("maxSubsteps", std::min(maxSubsteps, values.maxSubsteps));
+    return stats;
+}
+
+emscripten::val GameEngine::getVisualEffects() {
+    TRACE_ZONE("export.visualEffects");
+    HEAP_SCOPE(EXPORTS);
+    emscripten::val effects = emscripten::val::object();
+    
+    // Screen shake
+    Vector2 shake = visualEffects.getScreenShakeOffset();
+    effects.set("screenShakeX", shake.x);
+    effects.set("screenShakeY", shake.y);
+    
+    // Particles
+    emscripten::val particles = emscripten::val::array();
+    int index = 0;
+    
+    const ParticleBuffer& buffer = visualEffects.getParticles();
+    for (size_t i = 0; i < buffer.getCount(); i++) {
+        emscripten::val p = emscripten::val::object();
+        p.set("x", buffer.x[i]);
+        p.set("y", buffer.y[i]);
+        p.set("vx", buffer.vx[i]);
+        p.set("vy", buffer.vy[i]);
+        p.set("size", buffer.getSize(i));
+        p.set("alpha", buffer.getAlpha(i));
+        p.set("color", std::string(ParticlePalette::toString(buffer.color[i])));
+        particles.set(index++, p);
+    }
+    
+    effects.set("particles", particles);
+    effects.set("particlesDropped", static_cast<int>(buffer.getDroppedCount()));
+    
+    return effects;
+}
+
+emscripten::val GameEngine::getEntityRenderBuffer() {
+    return emscripten::val(emscripten::typed_memory_view(
+        entityRenderBuffer.floatCount(), entityRenderBuffer.floats()));
+}
+
+emscripten::val GameEngine::getParticleRenderBuffer() {
+    return emscripten::val(emscripten::typed_memory_view(
+        particleRenderBuffer.floatCount(), particleRenderBuffer.floats()));
+}
+
+emscripten::val GameEngine::getRenderTypeCounts() {
+    return emscripten::val(emscripten::typed_memory_view(RenderLayout::TYPE_COUNT, renderTypeCounts));
+}
+
+emscripten::val GameEngine::getParticlePalette() {
+    emscripten::val palette = emscripten::val::array();
+    for (int i = 0; i < ParticlePalette::COUNT; i++) {
+        palette.set(i, std::string(ParticlePalette::toString(i)));
+    }
+    return palette;
+}
+
+emscripten::val GameEngine::getSnapshotSince(uint32_t sequence) {
+    TRACE_ZONE("export.snapshot");
+    HEAP_SCOPE(EXPORTS);
+    // Capture on demand so consumers that never ask pay nothing
+    snapshotSystem.capture(entities);
+    
+    SnapshotSystem::Globals globals;
+    globals.gameState = static_cast<uint8_t>(gameState);
+    globals.wave = static_cast<uint16_t>(waveSystem.getCurrentWave());
+    globals.score = score;
+    
+    const std::vector<uint8_t>& blob = snapshotSystem.buildSince(sequence, globals);
+    return emscripten::val(emscripten::typed_memory_view(blob.size(), blob.data()));
+}
+
+emscripten::val GameEngine::encodeState(uint32_t baselineSequence) {
+    TRACE_ZONE("export.encodeState");
+    PERF_TIMER(NETWORK_ENCODE);
+    HEAP_SCOPE(EXPORTS);
+    // Falls back to a keyframe when the baseline has left the ring
+    const std::vector<uint8_t>& packet = stateCodec.encode(entities, baselineSequence);
+    return emscripten::val(emscripten::typed_memory_view(packet.size(), packet.data()));
+}
+
+emscripten::val GameEngine::getStateDecodeBuffer(int size) {
+    uint8_t* data = stateCodec.prepareInput(size > 0 ? static_cast<size_t>(size) : 0);
+    return emscripten::val(emscripten::typed_memory_view(size > 0 ? static_cast<size_t>(size) : 0, data));
+}
+
+emscripten::val GameEngine::getDecodedEntities() {
+    const std::vector<StateCodec::DecodedEntity>& decoded = stateCodec.getDecoded();
+    // Mixed int32/float32 records; JS reads them through a DataView
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(decoded.data());
+    return emscripten::val(emscripten::typed_memory_view(decoded.size() * sizeof(StateCodec::DecodedEntity), bytes));
+}
+
+emscripten::val GameEngine::getRecording() {
+    const std::vector<uint8_t>& bytes = inputLog.getBytes();
+    return emscripten::val(emscripten::typed_memory_view(bytes.size(), bytes.data()));
+}
+
+emscripten::val GameEngine::getReplayBuffer(int size) {
+    size_t bytes = size > 0 ? static_cast<size_t>(size) : 0;
+    return emscripten::val(emscripten::typed_memory_view(bytes, replayLog.loadBuffer(bytes)));
+}
+
+emscripten::val GameEngine::replayRecording(int size) {
+    ReplayResult result = {false, false, false, 0, 0, 0, 0};
+    if (size > 0 && replayLog.load(static_cast<size_t>(size))) {
+        result = runReplay(replayLog);
+    }
+    emscripten::val out = emscripten::val::object();
+    out.set("loaded", result.loaded);
+    out.set("complete", result.complete);
+    out.set("matches", result.matches);
+    out.set("ticks", result.ticks);
+    out.set("elapsedMs", result.elapsedMs);
+    out.set("checksum", result.checksum);
+    out.set("expectedChecksum", result.expectedChecksum);
+    return out;
+}
+
+emscripten::val GameEngine::getCommandBuffer() {
+    // Int32 view; JS aliases a Float32Array on the same bytes for the args
+    return emscripten::val(emscripten::typed_memory_view(
+        commandBuffer.wordCount(), reinterpret_cast<int32_t*>(commandBuffer.words())));
+}
+
+emscripten::val GameEngine::getGameplayEvents() {
+    // Int32 view; JS aliases a Float32Array for the position and amount words
+    return emscripten::val(emscripten::typed_memory_view(
+        gameplayEvents.wordCount(), gameplayEvents.words()));
+}
+
+emscripten::val GameEngine::getWaveInfo() {
+    emscripten::val info = emscripten::val::object();
+    info.set("currentWave", waveSystem.getCurrentWave());
+    info.set("waveActive", waveSystem.isWaveActive());
+    info.set("transitionTimer", waveSystem.getWaveTransitionTimer());
+    info.set("enemiesRemaining", waveSystem.getEnemiesRemaining());
+    info.set("wolvesRemaining", waveSystem.getWolvesRemaining());
+    info.set("enemiesAlive", entityCounts.of(EntityType::ENEMY));
+    info.set("wolvesAlive", entityCounts.of(EntityType::WOLF));
+    
+    return info;
+}
+
+#if ENGINE_FEATURE_CAMERA
+emscripten::val GameEngine::getCameraInfo() {
+    emscripten::val info = emscripten::val::object();
+    info.set("x", camera.x);
+    info.set("y", camera.y);
+    info.set("width", camera.width);
+    info.set("height", camera.height);
+    info.set("worldWidth", worldWidth);
+    info.set("worldHeight", worldHeight);
+    return info;
+}
+
+emscripten::val GameEngine::worldToScreen(float worldX, float worldY) {
+    Vector2 screen = camera.worldToScreen(worldX, worldY);
+    emscripten::val result = emscripten::val::object();
+    result.set("x", screen.x);
+    result.set("y", screen.y);
+    return result;
+}
+
+emscripten::val GameEngine::screenToWorld(float screenX, float screenY) {
+    Vector2 world = camera.screenToWorld(screenX, screenY);
+    emscripten::val result = emscripten::val::object();
+    result.set("x", world.x);
+    result.set("y", world.y);
+    return result;
+}
+#endif
+
+#if ENGINE_FEATURE_TARGETING
+emscripten::val GameEngine::getTargetButtonState() {
+    SimContext::Scope scope(simContext);
+    const TargetingSystem::Button& button = targeting.getButton();
+    float remaining = targeting.buttonDisableRemaining();
+    
+    emscripten::val state = emscripten::val::object();
+    state.set("x", button.x);
+    state.set("y", button.y);
+    state.set("radius", button.radius);
+    state.set("active", button.active);
+    state.set("visible", button.visible);
+    state.set("disabled", remaining > 0);
+    state.set("disableTimeRemaining", remaining);
+    state.set("hasTarget", getCurrentTargetId() >= 0);
+    state.set("targetingEnabled", targeting.isLockEnabled());
+    state.set("autoDisabled", targeting.isAutoDisabled());
+    return state;
+}
+#endif
+
+// Bindings for JavaScript
+using namespace emscripten;
+
+EMSCRIPTEN_BINDINGS(game_engine) {
+    class_<GameEngine> engine("GameEngine");
+    engine
+        .constructor<float, float>()
+        .function("createPlayer", &GameEngine::createPlayer)
+        .function("createEnemy", &GameEngine::createEnemy)
+        .function("createWolf", &GameEngine::createWolf)
+        .function("createProjectile", &GameEngine::createProjectile)
+        .function("createPowerUp", &GameEngine::createPowerUp)
+        .function("createObstacle", &GameEngine::createObstacle)
+        .function("createShapedObstacle", &GameEngine::createShapedObstacle)
+        .function("removeEntity", &GameEngine::removeEntity)
+        .function("updatePlayerInput", &GameEngine::updatePlayerInput)
+        .function("playerShoot", &GameEngine::playerShoot)
+        .function("activateBoost", &GameEngine::activateBoost)
+        .function("deactivateBoost", &GameEngine::deactivateBoost)
+        .function("startBlock", &GameEngine::startBlock)
+        .function("endBlock", &GameEngine::endBlock)
+        .function("performAttack", &GameEngine::performAttack)
+        .function("performRoll", &GameEngine::performRoll)
+        .function("playerBoost", &GameEngine::playerBoost)
+        .function("playerSpecialAbility", &GameEngine::playerSpecialAbility)
+        .function("playerAttack", &GameEngine::playerAttack)
+        .function("playerRoll", &GameEngine::playerRoll)
+        .function("setJoystickInput", &GameEngine::setJoystickInput)
+        .function("isAttacking", &GameEngine::isAttacking)
+        .function("isRolling", &GameEngine::isRolling)
+        .function("getEntityCount", &GameEngine::getEntityCount)
+        .function("getEntityCountOfType", &GameEngine::getEntityCountOfType)
+        .function("update", &GameEngine::update)
+        .function("startGame", &GameEngine::startGame)
+        .function("pauseGame", &GameEngine::pauseGame)
+        .function("resumeGame", &GameEngine::resumeGame)
+        .function("endGame", &GameEngine::endGame)
+        .function("restartGame", &GameEngine::restartGame)
+        .function("setWorldBounds", &GameEngine::setWorldBounds)
+        .function("generateObstacles", &GameEngine::generateObstacles)
+        .function("generateEnhancedObstacles", &GameEngine::generateEnhancedObstacles)
+        .function("clearEntities", &GameEngine::clearEntities)
+        .function("setMaxParticles", &GameEngine::setMaxParticles)
+        .function("setChunkedWorld", &GameEngine::setChunkedWorld)
+        .function("isChunkedWorld", &GameEngine::isChunkedWorld)
+        .function("getChunkSize", &GameEngine::getChunkSize)
+        .function("getLoadedChunkCount", &GameEngine::getLoadedChunkCount)
+        .function("getStoredChunkCount", &GameEngine::getStoredChunkCount)
+        .function("getStoredChunkBytes", &GameEngine::getStoredChunkBytes)
+        .function("getEntityPositions", &GameEngine::getEntityPositions)
+        .function("getPlayerState", &GameEngine::getPlayerState)
+        .function("getGameState", &GameEngine::getGameState)
+        .function("getPerformanceMetrics", &GameEngine::getPerformanceMetrics)
+        .function("getVisualEffects", &GameEngine::getVisualEffects)
+        .function("getWaveInfo", &GameEngine::getWaveInfo)
+        .function("getSnapshotSince", &GameEngine::getSnapshotSince)
+        .function("getSnapshotSequence", &GameEngine::getSnapshotSequence)
+        .function("getFrameNumber", &GameEngine::getFrameNumber)
+        .function("hasLineOfSight", &GameEngine::hasLineOfSight)
+        .function("raycastObstacles", &GameEngine::raycastObstacles)
+        .function("setWorkerCount", &GameEngine::setWorkerCount)
+        .function("getWorkerCount", &GameEngine::getWorkerCount)
+        .function("setFixedTimestep", &GameEngine::setFixedTimestep)
+        .function("setUseFixedTimestep", &GameEngine::setUseFixedTimestep)
+        .function("isUsingFixedTimestep", &GameEngine::isUsingFixedTimestep)
+        .function("getFixedTimestep", &GameEngine::getFixedTimestep)
+        .function("getInterpolationAlpha", &GameEngine::getInterpolationAlpha)
+        .function("getLastSubstepCount", &GameEngine::getLastSubstepCount)
+        .function("encodeState", &GameEngine::encodeState)
+        .function("getStateDecodeBuffer", &GameEngine::getStateDecodeBuffer)
+        .function("decodeState", &GameEngine::decodeState)
+        .function("getDecodedEntities", &GameEngine::getDecodedEntities)
+        .function("getDecodedEntityCount", &GameEngine::getDecodedEntityCount)
+        .function("getDecodedEntityStride", &GameEngine::getDecodedEntityStride)
+        .function("packRenderState", &GameEngine::packRenderState)
+        .function("getEntityRenderBuffer", &GameEngine::getEntityRenderBuffer)
+        .function("getParticleRenderBuffer", &GameEngine::getParticleRenderBuffer)
+        .function("getParticlePalette", &GameEngine::getParticlePalette)
+        .function("getEntityRenderCount", &GameEngine::getEntityRenderCount)
+        .function("getParticleRenderCount", &GameEngine::getParticleRenderCount)
+        .function("getRenderLayoutVersion", &GameEngine::getRenderLayoutVersion)
+        .function("getEntityRenderStride", &GameEngine::getEntityRenderStride)
+        .function("getParticleRenderStride", &GameEngine::getParticleRenderStride)
+        .function("getRenderTypeCounts", &GameEngine::getRenderTypeCounts)
+        .function("getRenderTypeCount", &GameEngine::getRenderTypeCount)
+        .function("setRenderCulling", &GameEngine::setRenderCulling)
+        .function("isRenderCulling", &GameEngine::isRenderCulling)
+        .function("setCullMargin", &GameEngine::setCullMargin)
+        .function("getCullMargin", &GameEngine::getCullMargin)
+        .function("setAdaptiveQuality", &GameEngine::setAdaptiveQuality)
+        .function("isAdaptiveQuality", &GameEngine::isAdaptiveQuality)
+        .function("pinQualityLevel", &GameEngine::pinQualityLevel)
+        .function("getQualityLevel", &GameEngine::getQualityLevel)
+        .function("getPinnedQualityLevel", &GameEngine::getPinnedQualityLevel)
+        .function("setQualityTarget", &GameEngine::setQualityTarget)
+        .function("setQualityLevelValues", &GameEngine::setQualityLevelValues)
+        .function("getQualityStats", &GameEngine::getQualityStats)
+        .function("isBlocking", &GameEngine::isBlocking)
+        .function("isPerfectParryWindow", &GameEngine::isPerfectParryWindow)
+        .function("getScore", &GameEngine::getScore)
+        .function("getHighScore", &GameEngine::getHighScore)
+        .function("isUsingEntityStore", &GameEngine::isUsingEntityStore)
+        .function("setUseEntityStore", &GameEngine::setUseEntityStore)
+        .function("isUsingFlowField", &GameEngine::isUsingFlowField)
+        .function("setUseFlowField", &GameEngine::setUseFlowField)
+        .function("setSeed", &GameEngine::setSeed)
+        .function("getSeed", &GameEngine::getSeed)
+        .function("startRecording", &GameEngine::startRecording)
+        .function("stopRecording", &GameEngine::stopRecording)
+        .function("isRecording", &GameEngine::isRecording)
+        .function("getRecording", &GameEngine::getRecording)
+        .function("getReplayBuffer", &GameEngine::getReplayBuffer)
+        .function("replayRecording", &GameEngine::replayRecording)
+        .function("stateChecksum", &GameEngine::stateChecksum)
+        .function("setRollbackDepth", &GameEngine::setRollbackDepth)
+        .function("getRollbackDepth", &GameEngine::getRollbackDepth)
+        .function("saveRollbackState", &GameEngine::saveRollbackState)
+        .function("rollbackTo", &GameEngine::rollbackTo)
+        .function("resimulate", &GameEngine::resimulate)
+        .function("canRollbackTo", &GameEngine::canRollbackTo)
+        .function("getOldestRollbackFrame", &GameEngine::getOldestRollbackFrame)
+        .function("getRollbackBytes", &GameEngine::getRollbackBytes)
+        .function("getCommandBuffer", &GameEngine::getCommandBuffer)
+        .function("drainCommands", &GameEngine::drainCommands)
+        .function("getCommandLayoutVersion", &GameEngine::getCommandLayoutVersion)
+        .function("getCommandStride", &GameEngine::getCommandStride)
+        .function("getCommandCapacity", &GameEngine::getCommandCapacity)
+        .function("getGameplayEvents", &GameEngine::getGameplayEvents)
+        .function("getGameplayEventCount", &GameEngine::getGameplayEventCount)
+        .function("getGameplayEventLayoutVersion", &GameEngine::getGameplayEventLayoutVersion)
+        .function("getGameplayEventStride", &GameEngine::getGameplayEventStride)
+        .function("getFeatures", &GameEngine::getFeatures);
+    
+    // Optional modules only bind when compiled in (config/engine_features.h)
+#if ENGINE_FEATURE_CAMERA
+    engine
+        .function("setViewport", &GameEngine::setViewport)
+        .function("getCameraInfo", &GameEngine::getCameraInfo)
+        .function("worldToScreen", &GameEngine::worldToScreen)
+        .function("screenToWorld", &GameEngine::screenToWorld)
+        .function("isOnScreen", &GameEngine::isOnScreen);
+#endif
+#if ENGINE_FEATURE_TARGETING
+    engine
+        .function("switchTarget", &GameEngine::switchTarget)
+        .function("switchToNextTarget", &GameEngine::switchToNextTarget)
+        .function("enableTargeting", &GameEngine::enableTargeting)
+        .function("disableTargeting", &GameEngine::disableTargeting)
+        .function("handleTargetingButton", &GameEngine::handleTargetingButton)
+        .function("onTargetButtonTouchStart", &GameEngine::onTargetButtonTouchStart)
+        .function("onTargetButtonTouchEnd", &GameEngine::onTargetButtonTouchEnd)
+        .function("setTargetButtonPosition", &GameEngine::setTargetButtonPosition)
+        .function("setTargetButtonVisible", &GameEngine::setTargetButtonVisible)
+        .function("getTargetButtonState", &GameEngine::getTargetButtonState)
+        .function("getCurrentTargetId", &GameEngine::getCurrentTargetId)
+        .function("isTargetingEnabled", &GameEngine::isTargetingEnabled)
+        .function("isAutoDisabledDueToDistance", &GameEngine::isAutoDisabledDueToDistance);
+#endif
+}
\ No newline at end of file
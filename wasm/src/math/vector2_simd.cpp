@@ -1,8 +1,12 @@
 #include "../../include/math/vector2_simd.h"
 #include "../../include/math/vector2.h"
+#include "../../include/math/vector_math.h"
+#include <cstdint>
 
 // Implementation file for SIMD vector operations
-// Most methods are inline in the header, but we can add specialized batch operations here
+// Most methods are inline in the header, but we can add specialized batch operations here.
+// The 4-wide SoA kernels live in vector_math.h; the helpers below work on
+// arrays of Vector2SIMD and are kept for existing callers.
 
 namespace VectorMath {
     
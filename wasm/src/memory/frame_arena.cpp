@@ -0,0 +1,4 @@
+#include "../../include/memory/frame_arena.h"
+
+// Frame arena implementation
+// Most methods are inline in the header
@@ -0,0 +1,48 @@
+#include "../../include/memory/heap_tracker.h"
+
+#if HEAP_TRACKING
+#include <cstdlib>
+#include <new>
+
+// Global allocation hook. Each block is preceded by a header with the user
+// size and tag; the header is a full max_align_t so the user pointer keeps
+// malloc's alignment. Over-aligned new/delete are left to the runtime and
+// are not counted.
+namespace {
+    struct alignas(alignof(std::max_align_t)) BlockHeader {
+        size_t size;
+        AllocTag tag;
+    };
+
+    void* trackedAllocate(size_t size) {
+        void* raw = std::malloc(sizeof(BlockHeader) + size);
+        if (!raw) return nullptr;
+        BlockHeader* header = static_cast<BlockHeader*>(raw);
+        header->size = size;
+        header->tag = HeapTracker::tag();
+        HeapTracker::getInstance().onAllocate(header->tag, size);
+        return header + 1;
+    }
+
+    void trackedFree(void* memory) {
+        if (!memory) return;
+        BlockHeader* header = static_cast<BlockHeader*>(memory) - 1;
+        HeapTracker::getInstance().onFree(header->tag, header->size);
+        std::free(header);
+    }
+}
+
+void* operator new(size_t size) {
+    if (void* memory = trackedAllocate(size)) return memory;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size); }
+void operator delete(void* memory) noexcept { trackedFree(memory); }
+void operator delete[](void* memory) noexcept { trackedFree(memory); }
+void operator delete(void* memory, size_t) noexcept { trackedFree(memory); }
+void operator delete[](void* memory, size_t) noexcept { trackedFree(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { trackedFree(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { trackedFree(memory); }
+#endif
@@ -0,0 +1,67 @@
+#include "../../include/server/batch_simulator.h"
+#include <emscripten/bind.h>
+#include <emscripten/val.h>
+
+// Export headless balance batches to JavaScript
+namespace {
+    // Kept between calls: the result arrays are views into it
+    BatchSimulator& batch() {
+        static BatchSimulator instance;
+        return instance;
+    }
+
+    template<typename T>
+    emscripten::val view(const std::vector<T>& column) {
+        return emscripten::val(emscripten::typed_memory_view(column.size(), column.data()));
+    }
+
+    // workers > 1 needs the pthread build; the views stay valid until the next run
+    emscripten::val runBalanceBatch(int matches, int workers, uint32_t baseSeed,
+                                    uint32_t layoutSeed, float maxSeconds) {
+        BatchSimulator::Settings settings;
+        settings.matches = matches;
+#ifdef __EMSCRIPTEN_PTHREADS__
+        settings.workers = workers;
+#else
+        (void)workers;
+        settings.workers = 1;
+#endif
+        settings.baseSeed = baseSeed;
+        settings.layoutSeed = layoutSeed;
+        settings.maxSeconds = maxSeconds;
+        batch().configure(settings);
+        const BatchSimulator::Results& results = batch().run();
+        BatchSimulator::Summary summary = batch().summarize();
+
+        emscripten::val report = emscripten::val::object();
+        report.set("seed", view(results.seed));
+        report.set("waveReached", view(results.waveReached));
+        report.set("secondsSurvived", view(results.secondsSurvived));
+        report.set("died", view(results.died));
+        report.set("damageTaken", view(results.damageTaken));
+        report.set("damageDealt", view(results.damageDealt));
+        report.set("kills", view(results.kills));
+        report.set("timedKills", view(results.timedKills));
+        report.set("meanTimeToKillMs", view(results.meanTimeToKillMs));
+        report.set("score", view(results.score));
+
+        emscripten::val summaryObj = emscripten::val::object();
+        summaryObj.set("matches", summary.matches);
+        summaryObj.set("meanWave", summary.meanWave);
+        summaryObj.set("maxWave", summary.maxWave);
+        summaryObj.set("meanSeconds", summary.meanSeconds);
+        summaryObj.set("deathRate", summary.deathRate);
+        summaryObj.set("meanDamageTaken", summary.meanDamageTaken);
+        summaryObj.set("matchesWithKills", summary.matchesWithKills);
+        summaryObj.set("meanTimeToKillMs", summary.meanTimeToKillMs);
+        summaryObj.set("wallMs", summary.wallMs);
+        summaryObj.set("ticksPerSecond", summary.ticksPerSecond);
+        report.set("summary", summaryObj);
+        return report;
+    }
+}
+
+// Bind batch simulation for JavaScript access
+EMSCRIPTEN_BINDINGS(batch_simulator) {
+    emscripten::function("runBalanceBatch", &runBalanceBatch);
+}
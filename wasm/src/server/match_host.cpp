@@ -0,0 +1,4 @@
+#include "../../include/server/match_host.h"
+
+// MatchHost implementation
+// Most methods are inline in the header
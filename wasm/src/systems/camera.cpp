@@ -0,0 +1,4 @@
+#include "../../include/systems/camera.h"
+
+// Camera implementation
+// Most methods are inline in the header
@@ -0,0 +1,4 @@
+#include "../../include/systems/chunk_manager.h"
+
+// ChunkManager implementation
+// Most methods are inline in the header
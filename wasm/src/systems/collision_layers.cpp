@@ -0,0 +1,4 @@
+#include "../../include/systems/collision_layers.h"
+
+// Collision layers implementation
+// The rule table is built at compile time in the header
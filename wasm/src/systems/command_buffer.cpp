@@ -0,0 +1,4 @@
+#include "../../include/systems/command_buffer.h"
+
+// CommandBuffer implementation
+// Most methods are inline in the header
@@ -0,0 +1,4 @@
+#include "../../include/systems/flow_field.h"
+
+// Flow field implementation
+// Most methods are inline in the header
@@ -0,0 +1,4 @@
+#include "../../include/systems/gameplay_events.h"
+
+// EventQueue implementation
+// Most methods are inline in the header
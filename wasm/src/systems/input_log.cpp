@@ -0,0 +1,4 @@
+#include "../../include/systems/input_log.h"
+
+// InputLog implementation
+// Most methods are inline in the header
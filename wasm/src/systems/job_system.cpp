@@ -0,0 +1,4 @@
+#include "../../include/systems/job_system.h"
+
+// Job system implementation
+// Most methods are inline in the header
@@ -0,0 +1,4 @@
+#include "../../include/systems/obstacle_generator.h"
+
+// ObstacleGenerator implementation
+// Most methods are inline in the header
@@ -0,0 +1,4 @@
+#include "../../include/systems/obstacle_index.h"
+
+// Obstacle index implementation
+// Most methods are inline in the header
@@ -0,0 +1,4 @@
+#include "../../include/systems/quality_governor.h"
+
+// Quality governor implementation
+// Most methods are inline in the header
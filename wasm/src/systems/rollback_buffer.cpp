@@ -0,0 +1,4 @@
+#include "../../include/systems/rollback_buffer.h"
+
+// Rollback buffer implementation
+// Most methods are inline in the header
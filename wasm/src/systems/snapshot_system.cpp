@@ -0,0 +1,4 @@
+#include "../../include/systems/snapshot_system.h"
+
+// Snapshot system implementation
+// Most methods are inline in the header
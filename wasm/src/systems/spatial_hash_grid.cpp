@@ -1,68 +1,158 @@
 #include "../../include/systems/spatial_hash_grid.h"
-#include <unordered_map>
+#include <algorithm>
 
-int SpatialHashGrid::hashPosition(float x, float y) const {
-    int gridX = static_cast<int>(x / CELL_SIZE);
-    int gridY = static_cast<int>(y / CELL_SIZE);
-    return gridX * 73856093 ^ gridY * 19349663; // Large primes for hashing
+SpatialHashGrid::SpatialHashGrid()
+    : cellSize(CELL_SIZE), invCellSize(1.0f / CELL_SIZE), originX(0), originY(0), cols(1), rows(1),
+      queryStamp(0), dirty(false) {
+    setWorldBounds(DEFAULT_WORLD_SIZE, DEFAULT_WORLD_SIZE);
+}
+
+void SpatialHashGrid::setWorldBounds(float width, float height, float newCellSize) {
+    setBounds(0, 0, width, height, newCellSize);
+}
+
+void SpatialHashGrid::setBounds(float minX, float minY, float width, float height, float newCellSize) {
+    originX = minX;
+    originY = minY;
+    cellSize = newCellSize > 0 ? newCellSize : CELL_SIZE;
+    invCellSize = 1.0f / cellSize;
+    cols = std::max(1, static_cast<int>(width * invCellSize) + 1);
+    rows = std::max(1, static_cast<int>(height * invCellSize) + 1);
+    cellStart.assign(cols * rows + 1, 0);
+    clear();
+}
+
+int SpatialHashGrid::cellX(float x) const {
+    int cx = static_cast<int>((x - originX) * invCellSize);
+    return std::clamp(cx, 0, cols - 1);
+}
+
+int SpatialHashGrid::cellY(float y) const {
+    int cy = static_cast<int>((y - originY) * invCellSize);
+    return std::clamp(cy, 0, rows - 1);
 }
 
 void SpatialHashGrid::clear() {
-    grid.clear();
+    // Keep capacity; the next frame refills the same buffers
+    items.clear();
+    itemStamps.clear();
+    pending.clear();
+    cellItems.clear();
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    dirty = false;
 }
 
 void SpatialHashGrid::insert(Entity* entity) {
     if (!entity || !entity->active) return;
-    
+    insert(entity, entity->position.x, entity->position.y, entity->radius);
+}
+
+void SpatialHashGrid::insert(Entity* entity, float x, float y, float radius) {
+    insertRect(entity, x - radius, y - radius, x + radius, y + radius);
+}
+
+void SpatialHashGrid::insertRect(Entity* entity, float minX, float minY, float maxX, float maxY) {
+    int item = static_cast<int>(items.size());
+    items.push_back(entity);
+    itemStamps.push_back(0);
+
     // Insert into all cells the entity overlaps
-    float minX = entity->position.x - entity->radius;
-    float maxX = entity->position.x + entity->radius;
-    float minY = entity->position.y - entity->radius;
-    float maxY = entity->position.y + entity->radius;
-    
-    int startX = static_cast<int>(minX / CELL_SIZE);
-    int endX = static_cast<int>(maxX / CELL_SIZE);
-    int startY = static_cast<int>(minY / CELL_SIZE);
-    int endY = static_cast<int>(maxY / CELL_SIZE);
-    
-    for (int x = startX; x <= endX; x++) {
-        for (int y = startY; y <= endY; y++) {
-            int hash = x * 73856093 ^ y * 19349663;
-            grid[hash].push_back(entity);
+    int startX = cellX(minX);
+    int endX = cellX(maxX);
+    int startY = cellY(minY);
+    int endY = cellY(maxY);
+
+    for (int cy = startY; cy <= endY; cy++) {
+        for (int cx = startX; cx <= endX; cx++) {
+            pending.push_back({cy * cols + cx, item});
         }
     }
+
+    dirty = true;
 }
 
-std::vector<Entity*> SpatialHashGrid::getNearby(Entity* entity) {
-    std::vector<Entity*> nearby;
-    std::unordered_map<int, bool> checked;
-    
-    if (!entity) return nearby;
-    
-    float minX = entity->position.x - entity->radius;
-    float maxX = entity->position.x + entity->radius;
-    float minY = entity->position.y - entity->radius;
-    float maxY = entity->position.y + entity->radius;
-    
-    int startX = static_cast<int>(minX / CELL_SIZE) - 1;
-    int endX = static_cast<int>(maxX / CELL_SIZE) + 1;
-    int startY = static_cast<int>(minY / CELL_SIZE) - 1;
-    int endY = static_cast<int>(maxY / CELL_SIZE) + 1;
-    
-    for (int x = startX; x <= endX; x++) {
-        for (int y = startY; y <= endY; y++) {
-            int hash = x * 73856093 ^ y * 19349663;
-            auto it = grid.find(hash);
-            if (it != grid.end()) {
-                for (Entity* other : it->second) {
-                    if (other != entity && other->active && !checked[other->id]) {
-                        nearby.push_back(other);
-                        checked[other->id] = true;
-                    }
+void SpatialHashGrid::build() {
+    // Counting sort of pending entries into contiguous per-cell ranges
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    for (const CellEntry& entry : pending) {
+        cellStart[entry.cell + 1]++;
+    }
+    for (size_t i = 1; i < cellStart.size(); i++) {
+        cellStart[i] += cellStart[i - 1];
+    }
+
+    cellItems.resize(pending.size());
+    // Each entity's entries are contiguous in pending, so filling from the
+    // back of each cell range keeps items in insertion order.
+    for (size_t i = pending.size(); i-- > 0;) {
+        const CellEntry& entry = pending[i];
+        cellItems[--cellStart[entry.cell + 1]] = entry.item;
+    }
+    // cellStart[c + 1] now holds the start of cell c; shift back into place
+    for (size_t i = 0; i + 1 < cellStart.size(); i++) {
+        cellStart[i] = cellStart[i + 1];
+    }
+    cellStart.back() = static_cast<int>(cellItems.size());
+
+    dirty = false;
+}
+
+size_t SpatialHashGrid::queryRect(float minX, float minY, float maxX, float maxY,
+                                  std::vector<Entity*>& out, const Entity* exclude) {
+    out.clear();
+    if (dirty) build();
+    if (items.empty()) return 0;
+
+    // Fresh stamp per query; on wrap-around reset so stale stamps never match
+    if (++queryStamp == 0) {
+        std::fill(itemStamps.begin(), itemStamps.end(), 0);
+        queryStamp = 1;
+    }
+
+    int startX = cellX(minX);
+    int endX = cellX(maxX);
+    int startY = cellY(minY);
+    int endY = cellY(maxY);
+
+    for (int y = startY; y <= endY; y++) {
+        for (int x = startX; x <= endX; x++) {
+            int cell = y * cols + x;
+            for (int i = cellStart[cell]; i < cellStart[cell + 1]; i++) {
+                int item = cellItems[i];
+                if (itemStamps[item] == queryStamp) continue;
+                itemStamps[item] = queryStamp;
+
+                Entity* other = items[item];
+                if (other != exclude && other->active) {
+                    out.push_back(other);
                 }
             }
         }
     }
-    
+
+    return out.size();
+}
+
+size_t SpatialHashGrid::queryRadius(float x, float y, float radius,
+                                    std::vector<Entity*>& out, const Entity* exclude) {
+    return queryRect(x - radius, y - radius, x + radius, y + radius, out, exclude);
+}
+
+size_t SpatialHashGrid::getNearby(const Entity* entity, std::vector<Entity*>& out) {
+    if (!entity) {
+        out.clear();
+        return 0;
+    }
+
+    // Include the neighbouring ring of cells, as the hashed grid did
+    float margin = entity->radius + cellSize;
+    return queryRect(entity->position.x - margin, entity->position.y - margin,
+                     entity->position.x + margin, entity->position.y + margin,
+                     out, entity);
+}
+
+std::vector<Entity*> SpatialHashGrid::getNearby(Entity* entity) {
+    std::vector<Entity*> nearby;
+    getNearby(static_cast<const Entity*>(entity), nearby);
     return nearby;
-}
\ No newline at end of file
+}
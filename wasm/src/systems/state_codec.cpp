@@ -0,0 +1,4 @@
+#include "../../include/systems/state_codec.h"
+
+// State codec implementation
+// Most methods are inline in the header
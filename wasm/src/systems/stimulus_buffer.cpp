@@ -0,0 +1,4 @@
+#include "../../include/systems/stimulus_buffer.h"
+
+// StimulusBuffer implementation
+// Most methods are inline in the header
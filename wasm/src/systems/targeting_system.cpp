@@ -0,0 +1,4 @@
+#include "../../include/systems/targeting_system.h"
+
+// TargetingSystem implementation
+// Most methods are inline in the header
@@ -0,0 +1,4 @@
+#include "../../include/utils/bit_stream.h"
+
+// Bit stream implementation
+// Most methods are inline in the header
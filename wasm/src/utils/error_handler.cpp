@@ -0,0 +1,49 @@
+#include "../../include/utils/error_handler.h"
+#include <emscripten/bind.h>
+#include <emscripten/val.h>
+
+// Export the error ring to JavaScript
+namespace {
+    emscripten::val getErrorReport() {
+        const ErrorHandler& handler = ErrorHandler::getInstance();
+        ErrorHandler::Record records[ErrorHandler::RING_SIZE];
+        size_t count = handler.snapshot(records, ErrorHandler::RING_SIZE);
+        
+        emscripten::val errors = emscripten::val::array();
+        for (size_t i = 0; i < count; i++) {
+            const ErrorHandler::Record& r = records[i];
+            emscripten::val errorObj = emscripten::val::object();
+            errorObj.set("sequence", static_cast<double>(r.sequence));
+            errorObj.set("type", static_cast<int>(r.type));
+            errorObj.set("severity", static_cast<int>(r.severity));
+            errorObj.set("message", std::string(r.message));
+            errorObj.set("expression", std::string(r.expression));
+            errorObj.set("file", std::string(r.file));
+            errorObj.set("line", r.line);
+            errorObj.set("time", r.time);
+            errors.call<void>("push", errorObj);
+        }
+        
+        emscripten::val report = emscripten::val::object();
+        report.set("errors", errors);
+        report.set("totalErrors", static_cast<double>(handler.totalReported()));
+        report.set("minSeverity", ERROR_MIN_SEVERITY);
+        report.set("debugMode", handler.isDebugMode());
+        return report;
+    }
+    
+    void clearErrorLog() {
+        ErrorHandler::getInstance().clear();
+    }
+    
+    void setErrorDebugMode(bool enabled) {
+        ErrorHandler::getInstance().setDebugMode(enabled);
+    }
+}
+
+// Bind error reporting functions for JavaScript access
+EMSCRIPTEN_BINDINGS(error_handler) {
+    emscripten::function("getErrorReport", &getErrorReport);
+    emscripten::function("clearErrorLog", &clearErrorLog);
+    emscripten::function("setErrorDebugMode", &setErrorDebugMode);
+}
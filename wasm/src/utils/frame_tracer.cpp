@@ -0,0 +1,29 @@
+#include "../../include/utils/frame_tracer.h"
+#include <emscripten/bind.h>
+
+// Export the trace ring to JavaScript
+namespace {
+    std::string dumpTrace(int frames) {
+        return FrameTracer::getInstance().dumpChromeTrace(frames > 0 ? static_cast<uint32_t>(frames) : 0);
+    }
+    
+    void clearTrace() {
+        FrameTracer::getInstance().clear();
+    }
+    
+    void setTracingEnabled(bool enabled) {
+        FrameTracer::getInstance().setEnabled(enabled);
+    }
+    
+    bool isTracingEnabled() {
+        return FrameTracer::getInstance().isEnabled();
+    }
+}
+
+// Bind tracing functions for JavaScript access
+EMSCRIPTEN_BINDINGS(frame_tracer) {
+    emscripten::function("dumpTrace", &dumpTrace);
+    emscripten::function("clearTrace", &clearTrace);
+    emscripten::function("setTracingEnabled", &setTracingEnabled);
+    emscripten::function("isTracingEnabled", &isTracingEnabled);
+}
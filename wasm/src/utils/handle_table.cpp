@@ -0,0 +1,4 @@
+#include "../../include/utils/handle_table.h"
+
+// Handle table implementation
+// Most methods are inline in the header
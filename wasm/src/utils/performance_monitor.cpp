@@ -1,27 +1,103 @@
 #include "../../include/utils/performance_monitor.h"
+#include "../../include/memory/object_pool.h"
+#include "../../include/memory/heap_tracker.h"
 #include <emscripten/bind.h>
-
-// Initialize static member
-PerformanceMonitor* PerformanceMonitor::instance = nullptr;
+#include <string>
 
 // Export performance metrics to JavaScript
 namespace {
+    // Per-tag accounting and the recent heap growth events
+    emscripten::val heapReport() {
+        const HeapTracker& tracker = HeapTracker::getInstance();
+        emscripten::val heap = emscripten::val::object();
+        heap.set("tracking", HEAP_TRACKING != 0);
+        heap.set("heapSize", static_cast<double>(HeapTracker::linearMemoryBytes()));
+        
+        emscripten::val tags = emscripten::val::object();
+        for (size_t i = 0; i < HeapTracker::TAG_COUNT; i++) {
+            AllocTag tag = static_cast<AllocTag>(i);
+            HeapTracker::TagStats s = tracker.stats(tag);
+            emscripten::val tagObj = emscripten::val::object();
+            tagObj.set("liveBytes", static_cast<double>(s.liveBytes));
+            tagObj.set("peakBytes", static_cast<double>(s.peakBytes));
+            tagObj.set("budgetBytes", static_cast<double>(s.budgetBytes));
+            tagObj.set("overBudget", tracker.overBudget(tag));
+            tagObj.set("allocations", static_cast<double>(s.allocations));
+            tagObj.set("frameAllocations", s.frameAllocations);
+            tagObj.set("peakFrameAllocations", s.peakFrameAllocations);
+            tags.set(allocTagName(tag), tagObj);
+        }
+        heap.set("tags", tags);
+        
+        emscripten::val growth = emscripten::val::array();
+        for (size_t i = 0; i < tracker.growthEventCount(); i++) {
+            const HeapTracker::GrowthEvent& event = tracker.growthEvent(i);
+            emscripten::val eventObj = emscripten::val::object();
+            eventObj.set("frame", event.frame);
+            eventObj.set("tag", std::string(allocTagName(event.tag)));
+            eventObj.set("requestBytes", static_cast<double>(event.requestBytes));
+            eventObj.set("fromBytes", static_cast<double>(event.fromBytes));
+            eventObj.set("toBytes", static_cast<double>(event.toBytes));
+            growth.call<void>("push", eventObj);
+        }
+        heap.set("growth", growth);
+        return heap;
+    }
+    
     emscripten::val getPerformanceReport() {
-        return PerformanceMonitor::getInstance().exportMetrics();
+        const PerformanceMonitor& monitor = PerformanceMonitor::getInstance();
+        emscripten::val result = emscripten::val::object();
+        
+        result.set("fps", monitor.getFPS());
+        result.set("deltaTime", monitor.getDeltaTime());
+        result.set("memoryUsed", monitor.getCurrentMemory());
+        result.set("memoryPeak", monitor.getPeakMemory());
+        result.set("enabled", monitor.isEnabled());
+        
+        emscripten::val metricsObj = emscripten::val::object();
+        for (size_t i = 0; i < PerformanceMonitor::METRIC_COUNT; i++) {
+            MetricId id = static_cast<MetricId>(i);
+            PerformanceMonitor::Summary s = monitor.summarize(id);
+            if (s.samples == 0) continue;
+            
+            emscripten::val metricObj = emscripten::val::object();
+            metricObj.set("current", s.current);
+            metricObj.set("average", s.average);
+            metricObj.set("mean", s.mean);
+            metricObj.set("min", s.min);
+            metricObj.set("max", s.max);
+            metricObj.set("p50", s.p50);
+            metricObj.set("p95", s.p95);
+            metricObj.set("p99", s.p99);
+            metricObj.set("samples", static_cast<double>(s.samples));
+            metricsObj.set(metricName(id), metricObj);
+        }
+        result.set("metrics", metricsObj);
+        Pools::exportStatistics(result);
+        result.set("heap", heapReport());
+        
+        return result;
     }
     
     void resetPerformanceMonitor() {
         PerformanceMonitor::getInstance().reset();
+        HeapTracker::getInstance().resetStatistics();
+    }
+    
+    // Budget in bytes for a tag by its export name; 0 clears it
+    bool setHeapBudget(const std::string& tagName, double bytes) {
+        for (size_t i = 0; i < HeapTracker::TAG_COUNT; i++) {
+            AllocTag tag = static_cast<AllocTag>(i);
+            if (tagName == allocTagName(tag)) {
+                HeapTracker::getInstance().setBudget(tag, static_cast<size_t>(std::max(bytes, 0.0)));
+                return true;
+            }
+        }
+        return false;
     }
     
     void setProfilingEnabled(bool enabled) {
-        // This would typically control whether profiling is active
-        // For now, profiling is always active in debug builds
-        #ifdef DEBUG_BUILD
-        EM_ASM({
-            console.log("Profiling is", $0 ? "enabled" : "disabled");
-        }, enabled);
-        #endif
+        PerformanceMonitor::getInstance().setEnabled(enabled);
     }
 }
 
@@ -30,4 +106,6 @@ EMSCRIPTEN_BINDINGS(performance_monitor) {
     emscripten::function("getPerformanceReport", &getPerformanceReport);
     emscripten::function("resetPerformanceMonitor", &resetPerformanceMonitor);
     emscripten::function("setProfilingEnabled", &setProfilingEnabled);
-}
\ No newline at end of file
+    emscripten::function("getHeapReport", &heapReport);
+    emscripten::function("setHeapBudget", &setHeapBudget);
+}
@@ -0,0 +1,4 @@
+#include "../../include/utils/render_buffer.h"
+
+// Render buffer implementation
+// Most methods are inline in the header